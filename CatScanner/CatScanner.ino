@@ -13,6 +13,7 @@
 #include <avr/pgmspace.h>
 #include <Button.h>
 #include <LiquidCrystal.h>
+#include "LcdFrame.h"
 
 
 /*****************
@@ -41,6 +42,10 @@ constexpr uint8_t lcd_pin_d5 = 11;
 constexpr uint8_t lcd_pin_d6 = 12;
 constexpr uint8_t lcd_pin_d7 = 13;
 
+// Only changed characters are sent to the LCD, and no more than fit in
+// lcd_refreshBudgetUs each time through loop.
+constexpr uint16_t lcd_refreshBudgetUs = 500;
+
 constexpr uint8_t led_pin_red = 3;
 constexpr uint8_t led_pin_green = 5;
 constexpr uint8_t led_pin_blue = 6;
@@ -209,6 +214,8 @@ static bool plrMode;
 static OperatingState opState;
 
 static LiquidCrystal lcd(lcd_pin_rs, lcd_pin_e, lcd_pin_d4, lcd_pin_d5, lcd_pin_d6, lcd_pin_d7);
+using pixelPattern::LcdFrame;
+static LcdFrame lcdFrame(lcd, lcd_numCols, lcd_numRows);
 
 static int capSenseRef[numCapSensePins];
 
@@ -260,43 +267,21 @@ void doIntensityStep(uint8_t& intensity, bool& up, uint8_t increment, uint8_t ma
 
 void lcdClearScreen() {
 
-  lcd.clear();
-  delay(1);
-  lcd.setCursor(0, 0);  // zero-based col, line; (0, 0) is upper left corner
-  lcd.print(F("CAT SCANner 9000"));
-}
-
-
-void lcdClearLine(uint8_t line) {
-
-    lcd.setCursor(0, line);
-    for (uint8_t i = 0; i < lcd_numCols; ++i) {
-      lcd.write((uint8_t) ' ');
-    }
-}
-
-
-void lcdWriteLine(uint8_t line, const char* text) {
-
-  lcd.setCursor(0, line);
-  lcd.print(text);
-  uint8_t i = lcd_numCols - strlen(text);
-  while (i != 0) {
-    lcd.write(' ');
-    --i;
-  }
+  lcdFrame.clear();
+  lcdFrame.setCursor(0, 0);  // zero-based col, line; (0, 0) is upper left corner
+  lcdFrame.print(F("CAT SCANner 9000"));
 }
 
 
 void drawCat(uint8_t col, uint8_t line, bool isHappy) {
 
   uint8_t i = isHappy ? 0 : 4;
-  lcd.setCursor(col, line);
-  lcd.write(i++);
-  lcd.write(i++);
-  lcd.setCursor(col, line + 1);
-  lcd.write(i++);
-  lcd.write(i);
+  lcdFrame.setCursor(col, line);
+  lcdFrame.write(i++);
+  lcdFrame.write(i++);
+  lcdFrame.setCursor(col, line + 1);
+  lcdFrame.write(i++);
+  lcdFrame.write(i);
 }
 
 
@@ -305,16 +290,16 @@ void lcdShowCatProgress(int8_t stepNum, bool isHappy) {
   if (stepNum < 0) {
     uint8_t numSteps = -stepNum;
     // Clear the lines and draw the boundary bars.
-    lcdClearLine(2);
-    lcdClearLine(3);
-    lcd.setCursor(0, 2);
-    lcd.write(0xff);
-    lcd.setCursor(0, 3);
-    lcd.write(0xff);
-    lcd.setCursor(1 + (numSteps << 1), 2);
-    lcd.write(0xff);
-    lcd.setCursor(1 + (numSteps << 1), 3);
-    lcd.write(0xff);
+    lcdFrame.clearLine(2);
+    lcdFrame.clearLine(3);
+    lcdFrame.setCursor(0, 2);
+    lcdFrame.write(0xff);
+    lcdFrame.setCursor(0, 3);
+    lcdFrame.write(0xff);
+    lcdFrame.setCursor(1 + (numSteps << 1), 2);
+    lcdFrame.write(0xff);
+    lcdFrame.setCursor(1 + (numSteps << 1), 3);
+    lcdFrame.write(0xff);
   }
   else {
     drawCat(1 + (stepNum << 1), 2, isHappy);
@@ -324,40 +309,39 @@ void lcdShowCatProgress(int8_t stepNum, bool isHappy) {
 
 void lcdTest() {
 
-  lcd.clear();
-  delay(1);
-  lcd.setCursor(0, 0);  // zero-based col, line; (0, 0) is upper left corner
-  lcd.print(F("0123456789ABCDEF"));
-  lcd.setCursor(0, 1);
-  lcd.print(F("-----Line 2-----"));
-  lcd.setCursor(0, 2);
-  lcd.print(F("-----Line 3-----"));
-  lcd.setCursor(0, 3);
-  lcd.print(F("-----Line 4-----"));
-  lcd.setCursor(15, 3);
-  lcd.write((uint8_t) 0xfc);  // ROM code A00:  little table    ROM code A02:  u with umlaut
-  lcd.setCursor(15, 2);
-  lcd.write((uint8_t) 0xfd);  // ROM code A00:  division sign   ROM code A02:  y with accent
-  lcd.setCursor(15, 1);
-  lcd.write((uint8_t) 0xfe);  // ROM code A00:  blank           ROM code A02:  l with titty
-  lcd.setCursor(15, 0);
-  lcd.write((uint8_t) 0xff);  // ROM code A00:  block           ROM code A02:  y with umlaut
-  lcd.setCursor(0, 3);
-  lcd.print(F("z"));
-  lcd.setCursor(0, 2);
-  lcd.print(F("y"));
-  lcd.setCursor(0, 1);
-  lcd.print(F("x"));
-  lcd.setCursor(0, 0);
-  lcd.print(F("w"));
-  lcd.setCursor(9, 3);
-  lcd.print(F("|"));
-  lcd.setCursor(9, 2);
-  lcd.print(F("|"));
-  lcd.setCursor(9, 1);
-  lcd.print(F("|"));
-  lcd.setCursor(9, 0);
-  lcd.print(F("|"));
+  lcdFrame.clear();
+  lcdFrame.setCursor(0, 0);  // zero-based col, line; (0, 0) is upper left corner
+  lcdFrame.print(F("0123456789ABCDEF"));
+  lcdFrame.setCursor(0, 1);
+  lcdFrame.print(F("-----Line 2-----"));
+  lcdFrame.setCursor(0, 2);
+  lcdFrame.print(F("-----Line 3-----"));
+  lcdFrame.setCursor(0, 3);
+  lcdFrame.print(F("-----Line 4-----"));
+  lcdFrame.setCursor(15, 3);
+  lcdFrame.write((uint8_t) 0xfc);  // ROM code A00:  little table    ROM code A02:  u with umlaut
+  lcdFrame.setCursor(15, 2);
+  lcdFrame.write((uint8_t) 0xfd);  // ROM code A00:  division sign   ROM code A02:  y with accent
+  lcdFrame.setCursor(15, 1);
+  lcdFrame.write((uint8_t) 0xfe);  // ROM code A00:  blank           ROM code A02:  l with titty
+  lcdFrame.setCursor(15, 0);
+  lcdFrame.write((uint8_t) 0xff);  // ROM code A00:  block           ROM code A02:  y with umlaut
+  lcdFrame.setCursor(0, 3);
+  lcdFrame.print(F("z"));
+  lcdFrame.setCursor(0, 2);
+  lcdFrame.print(F("y"));
+  lcdFrame.setCursor(0, 1);
+  lcdFrame.print(F("x"));
+  lcdFrame.setCursor(0, 0);
+  lcdFrame.print(F("w"));
+  lcdFrame.setCursor(9, 3);
+  lcdFrame.print(F("|"));
+  lcdFrame.setCursor(9, 2);
+  lcdFrame.print(F("|"));
+  lcdFrame.setCursor(9, 1);
+  lcdFrame.print(F("|"));
+  lcdFrame.setCursor(9, 0);
+  lcdFrame.print(F("|"));
 }
 
 
@@ -377,9 +361,9 @@ void readCapSense(bool (&isTouched)[numCapSensePins]) {
 
 void displayCapSense(bool (&isTouched)[numCapSensePins], bool isLockedIn) {
 
-  lcd.setCursor(16 - numCapSensePins, 1);
+  lcdFrame.setCursor(16 - numCapSensePins, 1);
   for (uint8_t i = 0; i < numCapSensePins; ++i) {
-    lcd.print(isTouched[i] ? isLockedIn ? ':' : '.' : ' ');
+    lcdFrame.print(isTouched[i] ? isLockedIn ? ':' : '.' : ' ');
 #ifdef ENABLE_PRINT_TO_SERIAL
     Serial.print(isTouched[i]);
     Serial.print(" ");
@@ -397,12 +381,12 @@ void displayDiagnosis(bool (&isTouched)[numCapSensePins]) {
   char buf[18];
   
   strcpy_P(buf, (char*) pgm_read_word(&(diagnoses[diagnosisIdx])));
-  lcdWriteLine(2, buf);
+  lcdFrame.writeLine(2, buf);
 
   strcpy_P(buf, (char*) pgm_read_word(&(treatments[diagnosisIdx])));
   bool isHappy = buf[0] == 'h';
   buf[0] = 0x7e;                  // arrow pointing right
-  lcdWriteLine(3, buf);
+  lcdFrame.writeLine(3, buf);
   
   drawCat(14, 2, isHappy);
 }
@@ -423,7 +407,7 @@ void initPins() {
 
 void initLcd() {
 
-  lcd.begin(lcd_numCols, lcd_numRows);
+  lcdFrame.begin();
 
   // Download cat characters to the LCD controller.
   for (uint8_t i = 0; i < 8; ++i) {
@@ -480,6 +464,8 @@ void loop() {
   
   uint32_t now = millis();
 
+  lcdFrame.refresh(lcd_refreshBudgetUs);
+
   switch(opState) {
 
     case OperatingState::INIT_START:
@@ -496,7 +482,7 @@ void loop() {
       break;
 
     case OperatingState::IDLE_RESUME:
-      lcdWriteLine(1, "Here pussy pussy");
+      lcdFrame.writeLine(1, "Here pussy pussy");
       opState = OperatingState::IDLE;
       break;
 
@@ -516,7 +502,7 @@ void loop() {
     case OperatingState::RECALIBRATE_START:
       ledMode = LedMode::UNISON_THROB;
       lcdClearScreen();
-      lcdWriteLine(1, "Calibrating...");
+      lcdFrame.writeLine(1, "Calibrating...");
       lcdShowCatProgress(-numCapSensePins, false);
       stepNum = 0;
       nextStepMs = now + 500;
@@ -534,7 +520,7 @@ void loop() {
           nextStepMs += 250;
         }
         else {
-          lcdWriteLine(1, "Calibrated!");
+          lcdFrame.writeLine(1, "Calibrated!");
           nextStepMs += 1000;
           opState = OperatingState::RECALIBRATE_FINISH;
         }
@@ -553,7 +539,7 @@ void loop() {
     case OperatingState::PHS_START:
       ledMode = LedMode::FAST_THROB;
       lcdClearScreen();
-      lcdWriteLine(1, "Scanning...");
+      lcdFrame.writeLine(1, "Scanning...");
       lcdShowCatProgress(-7, false);
       capSenseNextUpdateMs = now;
       selectionIsLocked = false;
@@ -591,7 +577,7 @@ void loop() {
           if (!selectionIsLocked) {
             for (uint8_t i = 0; i < numCapSensePins; padIsTouched[i++] = false);
           }
-          lcdWriteLine(1, "Done!");
+          lcdFrame.writeLine(1, "Done!");
           lcdShowCatProgress(stepNum, true);
           opState = OperatingState::PHS_FINISH;
         }
@@ -600,7 +586,7 @@ void loop() {
       
     case OperatingState::PHS_FINISH:
       if ((int32_t) (now - nextStepMs) >= 0) {
-          lcdWriteLine(1, "----Diagnosis---");
+          lcdFrame.writeLine(1, "----Diagnosis---");
           displayDiagnosis(padIsTouched);
           opState = returnState;
       }
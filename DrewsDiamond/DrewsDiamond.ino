@@ -14,6 +14,12 @@
 #define DMX_SIZE 27
 #include <DmxSimple.h>
 #include "FastLED.h"
+#include "ExternalControlSelector.h"
+#include "LegacyPatternSequence.h"
+#include "PixelPatternController.h"
+#include "PixelSet.h"
+
+using namespace pixelPattern;
 
 
 
@@ -43,6 +49,9 @@
 #define MODE_PUSHBUTTON_PIN 12
 #define ONBOARD_LED_PIN 13
 
+// FG_INTENSITY_SCALE_FACTOR sets the brightness of sparkles.
+#define FG_INTENSITY_SCALE_FACTOR 255
+
 // BG_INTENSITY_SCALE_FACTOR sets the maximum brightness for backgrounds.  It also
 // sets the brightness of the foreground of patterns that aren't doing some sort
 // of flashing or sparkle effect.  Although the range is 0 to 255, practical
@@ -64,6 +73,7 @@
 
 
 
+
 /**************************************************
  * Pattern Configuration Constants and Structures *
  **************************************************/
@@ -189,27 +199,7 @@ struct patternDef {
 };
 
 
-// This structure contains pattern parameter metadata
-// and a pointer to the pattern function.
-typedef struct patternMetadata patternMetadata_t;
-struct patternMetadata {
-  uint8_t paramStructSize;
-  void    (*loopFun)(patternDef_t*);
-};
-
-
-// The pattern functions are declared here so that we
-// can use them to build the pattern metadata table.
-void rainbow(patternDef_t* patParams);
-void multiWave(patternDef_t* patParams);
-void movingDot(patternDef_t* patParams);
-void sparkle(patternDef_t* patParams);
-void splitRotation(patternDef_t* patParams);
-void solidColor(patternDef_t* patParams);
-void shine(patternDef_t* patParams);
-
-
-// These are the pattern types.  The values are indexes into the pattern metadata table.
+// These are the pattern types.  The values are indexes into the legacy pattern type table.
 #define MOVING_DOT     0
 #define MULTI_WAVE     1
 #define RAINBOW        2
@@ -219,43 +209,46 @@ void shine(patternDef_t* patParams);
 #define SHINE          6
 
 
-// Each pattern metadata entry must be in the element
-// position corresponding to its pattern type constant.
-patternMetadata_t patternMetadataTable[] = {
-  {sizeof(movingDotParams_t)    , movingDot},
-  {sizeof(multiWaveParams_t)    , multiWave},
-  {sizeof(rainbowParams_t)      , rainbow},
-  {sizeof(sparkleParams_t)      , sparkle},
-  {sizeof(splitRotationParams_t), splitRotation},
-  {sizeof(solidColorParams_t)   , solidColor},
-  {sizeof(shineParams_t)        , shine},
+// These are the ways that this sketch's original pattern functions
+// differed from the other sketches' copies.
+#define LEGACY_STYLE (LegacyStyle::random8Sparkle | LegacyStyle::valueDimmedSolid)
+
+// Each legacy pattern type entry must be in the element position
+// corresponding to its pattern type constant.  The patterns are drawn
+// by the framework patterns that replaced the original pattern functions.
+const LegacyPatternType legacyPatternTypes[] = {
+  legacyMovingDot<movingDotParams_t, LEGACY_STYLE>(),
+  legacyMultiWave<multiWaveParams_t, LEGACY_STYLE>(),
+  legacyRainbow<rainbowParams_t, LEGACY_STYLE>(),
+  legacySparkle<sparkleParams_t, SPARKLE_DELAY, MAX_SPARKLE_DENSITY, LEGACY_STYLE>(),
+  legacySplitRotation<splitRotationParams_t>(),
+  legacySolidColor<solidColorParams_t, LEGACY_STYLE>(),
+  legacyShine<shineParams_t>(),
 };
 
 
-// the size of the buffer used when copying pattern parameters from flash to RAM
-#define PAT_PARAMS_BUF_SIZE 32
-
-
-
-/********************************
- * Helper Function Declarations *
- ********************************/
-
-void selectRandomRgb(CRGB* rgbColor, CRGB* rgbColorInverse);
-void selectRandomHue(HSVHue* hue, HSVHue* hueInverse);
-void rotateCrgbRight(CRGB* a, uint8_t length);
-void rotateCrgbLeft(CRGB* a, uint8_t length);
-void replicatePixelPanels();
-
-
 
 /***********
  * Globals *
  ***********/
 
 static CRGB pixelArray[NUM_PHYSICAL_PIXELS];
-static CRGB* pixels = pixelArray + NUM_SKIP_PIXELS;
-static unsigned long nextPatternUpdateMs = 0;
+
+static PixelSet pixelSet(
+    pixelArray,
+    NUM_PHYSICAL_PIXELS,
+    NUM_SKIP_PIXELS,
+    NUM_NONSYMMETRICAL_PIXELS,
+    NUM_PANELS,
+    PANEL_NUM_PIXELS,
+    FG_INTENSITY_SCALE_FACTOR,
+    BG_INTENSITY_SCALE_FACTOR);
+
+static PixelPatternController patternController;
+
+// The pushbutton selection is handled in loop() so that it
+// works the way that it did before the framework was used.
+static ExternalControlSelector patternSelector;
 
 
 
@@ -454,561 +447,12 @@ const patternDef_t patternsDefs[] PROGMEM = {
 // Calculate the number of patterns that make up the entire show.
 #define NUM_PATTERNS (sizeof(patternsDefs) / sizeof(patternDef_t))
 
-
-
-/*****************************
- * Pattern Drawing Functions *
- *****************************/
-
-void shine(patternDef_t* patParams)
-{
-  static shineParams_t* pp;
-  static unsigned long nextShineMs;
-  static bool doingShine = false;
-//  static uint8_t shineStepNum;
-
-  static float n0;
-  static float s;
-  static float w;
-  static float ns;
-
-  unsigned long now = millis();
-
-  if (patParams) {
-    pp = (shineParams_t*) patParams;
-    nextShineMs = now + pp->shineInterval;
-    s = 0.025;
-    w = 6;
-    ns = 255.0 / (float) w;
-    return;
-  }
-
-
-  nextPatternUpdateMs = millis() + pp->delay;
-
-  if (!doingShine && now >= nextShineMs) {
-    n0 = - w;
-    doingShine = true;
-//    Serial.println("starting shine");
-//    Serial.print("s=");
-//    Serial.print(s);
-//    Serial.print("  w=");
-//    Serial.print(w);
-//    Serial.print("  ns=");
-//    Serial.print(ns);
-//    Serial.print("  n0=");
-//    Serial.println(n0);
-  }
-
-  CHSV hsvColor;
-  CRGB rgbColor;
-  hsvColor.h = pp->bgHue;
-  hsvColor.v = BG_INTENSITY_SCALE_FACTOR;
-  for (uint8_t i = 0; i < NUM_PIXELS; ++i) {
-
-    if (doingShine) {
-      if (i < n0 || i > n0 + w) {
-        hsvColor.s = 255;
-      }
-      else {
-        float n = (((float) i) - n0) * ns;
-        float y = quadwave8(n);
-        hsvColor.s = 255 - y;
-//        Serial.print("i=");
-//        Serial.print(i);
-//        Serial.print("  n0=");
-//        Serial.print(n0);
-//        Serial.print("  n=");
-//        Serial.print(n);
-//        Serial.print("  y=");
-//        Serial.print(y);
-//        Serial.print("  hsvColor.s=");
-//        Serial.print(hsvColor.s);
-//        Serial.println("----------");
-      }
-    }
-    else {
-      hsvColor.s = 255;
-    }
-
-    hsv2rgb_rainbow(hsvColor, rgbColor);
-    pixels[i] = rgbColor;  
-  }
-
-  // Make the non-symmetrical pixels the background color.
-  hsvColor.s = 255;
-  hsv2rgb_rainbow(hsvColor, rgbColor);
-  for (uint8_t i = NUM_PIXELS; i < NUM_PIXELS + NUM_NONSYMMETRICAL_PIXELS; pixels[i++] = rgbColor);
-
-  FastLED.show();
-
-  if (doingShine) {
-    n0 += s;
-    if (n0 >= (float) NUM_PIXELS) {
-      doingShine = false;
-      nextShineMs = now + pp->shineInterval;
-//      Serial.println("shine done");
-    }
-  }
-}
-
-
-
-void solidColor(patternDef_t* patParams)
-{
-  static solidColorParams_t* pp;
-  static uint8_t stepNum;
-  static uint8_t stepDir;  // non-zero for start->end, zero for end->start
-
-  if (patParams) {
-    pp = (solidColorParams_t*) patParams;
-    stepNum = pp->startHue;
-    stepDir = 1;
-    return;
-  }
-
-
-  nextPatternUpdateMs = millis() + pp->delay;
-
-  CHSV hsvColor;
-  hsvColor.h = stepNum;
-  hsvColor.s = 255;
-  hsvColor.v = BG_INTENSITY_SCALE_FACTOR;
-  CRGB rgbColor;
-  hsv2rgb_rainbow(hsvColor, rgbColor);
-  fill_solid(pixels, NUM_PIXELS + NUM_NONSYMMETRICAL_PIXELS, rgbColor);
-  FastLED.show();
-
-  if (stepDir) {
-    if (++stepNum == pp->endHue) {
-      stepDir = 0;
-    }
-  }
-  else {
-    if (--stepNum == pp->startHue) {
-      stepDir = 1;
-    }
-  }
-}
-
-
-
-void rainbow(patternDef_t* patParams)
-{
-  static rainbowParams_t* pp;
-  static uint8_t stepNum;
-
-  uint8_t i;
-
-  if (patParams) {
-    pp = (rainbowParams_t*) patParams;
-    stepNum = 0;
-    return;
-  }
-
-  nextPatternUpdateMs = millis() + pp->delay;
-
-  fill_rainbow(pixels, PANEL_NUM_PIXELS, stepNum, 255 / PANEL_NUM_PIXELS);
-  replicatePixelPanels();
-
-  for (i = 0; i < NUM_PIXELS; pixels[i++].nscale8_video(BG_INTENSITY_SCALE_FACTOR));
-
-  FastLED.show();
-
-  if (pp->directionDown) {
-    ++stepNum;
-  }
-  else {
-    --stepNum;
-  }
-}
-
-
-
-void multiWave(patternDef_t* patParams)
-{
-  static multiWaveParams_t* pp;
-  static uint8_t numWaveforms;
-  static HSVHue posHue[MAX_WAVEFORMS];
-  static HSVHue negHue[MAX_WAVEFORMS];
-  static uint16_t angleInterval[MAX_WAVEFORMS];
-  static uint16_t i0[MAX_WAVEFORMS];
-  static uint8_t delayCount[MAX_WAVEFORMS];
-  static uint8_t lastDelay;
-
-  uint8_t w;
-  colorWaveParams_t* waveParam;
-  uint8_t i;
-  uint8_t j;
-  uint16_t t;
-  uint8_t y;
-  CHSV hsvColor;
-  CHSV hsvBlended;
-  uint8_t amountOfOverlay;
-  uint8_t valueSum;
-  CRGB rgbColor;
-  uint8_t scaleFactor;
-
-
-  if (patParams) {
-    pp = (multiWaveParams_t*) patParams;
-
-    numWaveforms = 0;
-
-    // Calculate and save the LED values for each wave at t = 0.    
-    for (w = 0; w < MAX_WAVEFORMS; ++w)
-    {
-      waveParam = pp->waveParams + w;
-
-      if (0 == waveParam->numWaves) {
-        break;
-      }
-      ++numWaveforms;
-
-      if (waveParam->randomHue) {
-        selectRandomHue(&posHue[w], &negHue[w]);
-      }
-      else {
-        posHue[w] = waveParam->posHue;
-        negHue[w] = waveParam->negHue;
-      }
-  
-      // We use 16 bits for the angle interval and "time" so that we have sufficient
-      // resultion to fit a complete set of the requested number of waves.
-      angleInterval[w] = 65535 / (pp->boundedByPanel ? PANEL_NUM_PIXELS : NUM_PIXELS) * abs(waveParam->numWaves);
-
-      i0[w] = 0;
-      
-      delayCount[w] = waveParam->delay > 0 ? waveParam->delay : 1;
-    }
-    
-    lastDelay = 1;
-
-    return;
-  }
-
-
-  unsigned long now = millis();
-
-  bool needToDisplay = false;
-  uint8_t lowestDelayCount = 255;
-  for (w = 0; w < numWaveforms; ++w) {
-    delayCount[w] -= lastDelay;
-    if (0 == delayCount[w]) {
-      delayCount[w] = pp->waveParams[w].delay > 0 ? pp->waveParams[w].delay : 1;
-      needToDisplay = true;
-      if (pp->waveParams[w].directionDown) {
-        if (++i0[w] >= (pp->boundedByPanel ? PANEL_NUM_PIXELS : NUM_PIXELS)) {
-          i0[w] = 0;
-        }
-      }
-      else {
-        if (0 == i0[w]--) {
-          i0[w] = pp->boundedByPanel ? PANEL_NUM_PIXELS - 1 : NUM_PIXELS - 1;
-        }
-      }
-    }
-    // The lowest delay count is the number of ms after which we need to display again.
-    if (delayCount[w] < lowestDelayCount) {
-      lowestDelayCount = delayCount[w];
-    }
-  }
-  nextPatternUpdateMs = now + lowestDelayCount;
-  lastDelay = lowestDelayCount;
-
-  if (!needToDisplay) {
-    return;
-  }
-
-    
-  for (i = 0; i < (pp->boundedByPanel ? PANEL_NUM_PIXELS : NUM_PIXELS); ++i) {
-
-    for (w = 0; w < numWaveforms; ++w) {
-
-      t = ((uint16_t) i + i0[w]) * angleInterval[w] / 256;
-      switch (pp->waveParams[w].waveformType) {
-        case SQUARE_WAVE:
-          y = triwave8(t) >= 128 ? 255 : 0;
-          break;
-        case TRIANGLE_WAVE:
-          y = triwave8(t);
-          break;
-        case QUADRATIC_EASING:
-          y = quadwave8(t);
-          break;
-        case CUBIC_EASING:
-          y = cubicwave8(t);
-          break;
-        case SINE_WAVE:
-        default:
-          y = sin8(t);
-          break;
-      }
-      if (y >= 128) {
-        hsvColor.h = posHue[w];
-        hsvColor.v = (y - 128) * 2;
-      }
-      else {
-        hsvColor.h = negHue[w];
-        // A negative number of waves means make a half wave.
-        hsvColor.v = (pp->waveParams[w].numWaves >= 0) ? (127 - y) * 2 : 0;
-      }
-      hsvColor.s = 255;
-      
-      if (0 == w) {
-        hsvBlended = hsvColor;
-      }
-      else {
-        amountOfOverlay = 255 * (uint16_t) hsvBlended.v / ((uint16_t) hsvColor.v + (uint16_t) hsvBlended.v);
-        valueSum = qadd8(hsvBlended.v, hsvColor.v);
-        nblend(hsvBlended, hsvColor, amountOfOverlay);
-        hsvBlended.v = valueSum;
-      }
-    }
-    
-    hsv2rgb_rainbow(hsvBlended, pixels[i]);
-    pixels[i].nscale8_video(BG_INTENSITY_SCALE_FACTOR);
-  }
-
-  if (pp->boundedByPanel) {
-    replicatePixelPanels();
-  }
-  
-  FastLED.show();
-}
-
-
-
-void movingDot(patternDef_t* patParams)
-{
-  static movingDotParams_t* pp;
-  static uint8_t stepNum;
-  static uint8_t stepDir;    // 0 = away from pixel 0, 1 = toward pixel 0, 2 = hold at far end, 3 = hold at near end
-  static CRGB fgColor;
-  static CRGB bgColor;
-
-  CRGB rgbColor;
-  uint8_t prevStepNum;
-  uint8_t prevStepDir;
-  uint8_t j;
-
-  if (patParams) {
-    pp = (movingDotParams_t*) patParams;
-    
-    stepNum = 0;
-    stepDir = 0;
-
-    selectRandomRgb(&fgColor, &bgColor);
-    if (!pp->randomFgColor) {
-        fgColor = pp->fgColorCode;
-    }
-    if (!pp->randomBgColor) {
-        bgColor = pp->bgColorCode;
-    }
-    fgColor.nscale8_video(BG_INTENSITY_SCALE_FACTOR);
-    bgColor.nscale8_video(BG_INTENSITY_SCALE_FACTOR);
-
-    if (!pp->zipperBg) {
-      fill_solid(pixelArray, NUM_PIXELS, bgColor);
-    }
-
-    return;
-  }
-
-
-  unsigned long now = millis();
-
-  prevStepNum = stepNum;
-  prevStepDir = stepDir;
-  
-  switch (stepDir) {
-
-    // moving away from pixel 0
-    case 0:
-      if (++stepNum >= PANEL_NUM_PIXELS) {
-        stepDir = 2;
-        stepNum = PANEL_NUM_PIXELS - 1;
-        nextPatternUpdateMs = now + pp->holdTimeFarMs;
-      }
-      else {
-        nextPatternUpdateMs = now + pp->delay0;
-      }
-      break;
-
-    // moving toward pixel 0
-    case 1:
-      if (--stepNum == 0) {
-        stepDir = 3;
-      }
-      nextPatternUpdateMs = now + pp->delay1;
-      break;
-
-    // held at far end
-    case 2:
-      if (pp->bidirectional) {
-        stepDir = 1;
-        stepNum = PANEL_NUM_PIXELS - 2;
-      }
-      else {
-        stepDir = 0;
-        stepNum = 0;
-      }
-      break;
-
-    // held at near end
-    case 3:
-      stepDir = 0;
-      nextPatternUpdateMs = now + pp->holdTimeNearMs;
-      break;
-  }
-
-  if (0 == stepDir && 0 != prevStepDir && pp->changeFgColor) {
-    if (pp->zipperBg) {
-      // When doing the zipper effect, change the background color, too.
-      selectRandomRgb(&fgColor, &bgColor);
-      fgColor.nscale8_video(BG_INTENSITY_SCALE_FACTOR);
-      bgColor.nscale8_video(BG_INTENSITY_SCALE_FACTOR);
-    }
-    else {
-      selectRandomRgb(&fgColor, NULL);
-      fgColor.nscale8_video(BG_INTENSITY_SCALE_FACTOR);
-    }
-  }
-
-  rgbColor = ((stepDir == 1 || prevStepDir == 1) && pp->zipperBg) ? CRGB::Black : bgColor;
-  pixels[prevStepNum] = rgbColor;
-  for (j = 1; j < NUM_PANELS; ++j) {
-    pixels[prevStepNum + PANEL_NUM_PIXELS * j] = rgbColor;
-  }
-
-  pixels[stepNum] = fgColor;
-  for (j = 1; j < NUM_PANELS; ++j) {
-    pixels[stepNum + PANEL_NUM_PIXELS * j] = fgColor;
-  }
-  
-  FastLED.show();
-}
-
-
-
-void sparkle(patternDef_t* patParams)
-{
-  static sparkleParams_t* pp;
-  static uint8_t density;
-  static uint8_t selectedPixels[MAX_SPARKLE_DENSITY];
-  static CRGB fgColor;
-  static CRGB bgColor;
-
-  uint8_t i;
-  
-  if (patParams) {
-    pp = (sparkleParams_t*) patParams;
-    
-    density = pp->density <= MAX_SPARKLE_DENSITY ? pp->density : MAX_SPARKLE_DENSITY;
-    for (i = 0; i < density; ++i) {
-      selectedPixels[i] = 0;
-    }
-
-    if (pp->fgColorCode != CRGB::Black || pp->bgColorCode != CRGB::Black) {
-      fgColor = pp->fgColorCode;
-      bgColor = pp->bgColorCode;
-    }
-    else {
-      selectRandomRgb(&fgColor, &bgColor);
-    }
-    bgColor.nscale8_video(BG_INTENSITY_SCALE_FACTOR);
-    
-    // Fill with background color.
-    fill_solid(pixels, NUM_PIXELS + NUM_NONSYMMETRICAL_PIXELS, bgColor);
-    FastLED.show();
-    return;
-  }
-
-  nextPatternUpdateMs = millis() + SPARKLE_DELAY;
-
-  for (i = 0; i < density; ++i) {
-    // Turn off the last sparkle pixel.
-    pixels[selectedPixels[i]] = bgColor;
-  
-    // Turn on a random sparkle pixel.
-    selectedPixels[i] = random8(NUM_PIXELS + NUM_NONSYMMETRICAL_PIXELS);
-    pixels[selectedPixels[i]] = fgColor;
-  }
-
-  FastLED.show();
-}
-
-
-
-void splitRotation(patternDef_t* patParams)
-{
-  static splitRotationParams_t* pp;
-  
-  uint8_t i;
-  HSVHue fgHue;
-  HSVHue bgHue;
-  CHSV fgHsv;
-  CHSV bgHsv;
-  CRGB rgbColor;
-  
-
-  if (patParams) {
-    pp = (splitRotationParams_t*) patParams;
-
-    if (pp->randomHue) {
-      selectRandomHue(&fgHue, &bgHue);
-    }
-    else {
-      fgHue = pp->fgHue;
-      bgHue = pp->bgHue;
-    }
-    fgHsv.h = fgHue;
-    fgHsv.s = 255;
-    fgHsv.v = 255;
-    bgHsv.h = bgHue;
-    bgHsv.s = 255;
-    bgHsv.v = 255;
-
-    // Fill with background color.
-    hsv2rgb_rainbow(bgHsv, rgbColor);
-    rgbColor.nscale8_video(BG_INTENSITY_SCALE_FACTOR);
-    fill_solid(pixels, PANEL_NUM_PIXELS, rgbColor);
-
-    // Set every nth pixel to the foreground color.
-    hsv2rgb_rainbow(fgHsv, rgbColor);
-    rgbColor.nscale8_video(BG_INTENSITY_SCALE_FACTOR);
-    for (i = 0; i < PANEL_NUM_PIXELS; i += pp->fgInterval) {
-        pixels[i] = rgbColor;
-    }
-
-    replicatePixelPanels();
-
-    FastLED.show();
-
-    return;
-  }
-
-
-  nextPatternUpdateMs = millis() + pp->delay;
-
-  i = PANEL_NUM_PIXELS / 4;
-  if (pp->directionDown) {
-    rotateCrgbLeft(pixels, i);
-    rotateCrgbRight(pixels + i, i);
-    rotateCrgbRight(pixels + i * 3, i);
-    rotateCrgbLeft(pixels + i * 2, i);
-  }
-  else {
-    rotateCrgbRight(pixels, i);
-    rotateCrgbLeft(pixels + i, i);
-    rotateCrgbLeft(pixels + i * 3, i);
-    rotateCrgbRight(pixels + i * 2, i);
-  }
-
-  replicatePixelPanels();
-
-  FastLED.show();
-}
+static LegacyPatternSequence patternSequence(
+    patternsDefs,
+    NUM_PATTERNS,
+    legacyPatternTypes,
+    sizeof(legacyPatternTypes) / sizeof(LegacyPatternType),
+    &patternSelector);
 
 
 
@@ -1017,116 +461,6 @@ void splitRotation(patternDef_t* patParams)
  ***********/
 
 
-void selectRandomRgb(CRGB* rgbColor, CRGB* rgbColorInverse)
-{
-  CHSV hsvColor;
-
-  // Choose a fully saturated random color.
-  hsvColor.h = random(256);
-  hsvColor.s = 255;
-  hsvColor.v = 255;
-  hsv2rgb_rainbow(hsvColor, *rgbColor);
-  
-  if (NULL != rgbColorInverse) {
-    switch (random(6)) {
-      case 0:
-        hsvColor.h += 64;    // 1/4 the way around the color wheel
-        break;
-      case 1:
-        hsvColor.h += 85;    // 1/3 the way around the color wheel
-        break;
-      case 2:
-        hsvColor.h -= 64;    // 1/4 the other way around the color wheel
-        break;
-      case 3:
-        hsvColor.h -= 85;    // 1/3 the other way around the color wheel
-        break;
-      default:
-        hsvColor.h += 128;   // complementary color
-        break;
-    }
-    hsv2rgb_rainbow(hsvColor, *rgbColorInverse);
-  }
-}
-
-
-void selectRandomHue(HSVHue* hue, HSVHue* hueInverse)
-{
-  uint8_t hueValue;
-
-  // Choose a fully saturated random color.
-  hueValue = random(256);
-  *hue = (HSVHue) hueValue;
-  
-  if (NULL != hueInverse) {
-    switch (random(6)) {
-      case 0:
-        hueValue += 64;    // 1/4 the way around the color wheel
-        break;
-      case 1:
-        hueValue += 85;    // 1/3 the way around the color wheel
-        break;
-      case 2:
-        hueValue -= 64;    // 1/4 the other way around the color wheel
-        break;
-      case 3:
-        hueValue -= 85;    // 1/3 the other way around the color wheel
-        break;
-      default:
-        hueValue += 128;   // complementary color
-        break;
-    }
-    *hueInverse = (HSVHue) hueValue;
-  }
-}
-
-
-void rotateCrgbRight(CRGB* a, uint8_t length)
-{
-  uint8_t i;
-  CRGB temp;
-
-  temp = a[length - 1];
-
-  for (i = length - 1; i > 0; --i) {
-    a[i] = a[i - 1];
-  }
-
-  a[0] = temp;
-}
-
-
-void rotateCrgbLeft(CRGB* a, uint8_t length)
-{
-  uint8_t i;
-  CRGB temp;
-
-  temp = a[0];
-
-  for (i = 0; i < length - 1; ++i) {
-    a[i] = a[i + 1];
-  }
-
-  a[length - 1] = temp;
-}
-
-
-void replicatePixelPanels()
-{
-  if (NUM_PANELS <= 1)
-    return;
-  
-  uint8_t i;
-  uint8_t j;
-  
-  for (i = 0; i < PANEL_NUM_PIXELS; ++i) {
-    for (j = 1; j < NUM_PANELS; ++j) {
-      pixels[i + PANEL_NUM_PIXELS * j] = pixels[i];
-    }
-  }
-}
-
-
 uint16_t freeRam() 
 {
   // Based on code retrieved on 1 April 2015 from
@@ -1163,125 +497,54 @@ void setup()
 
 //  Serial.begin(9600);
 //  Serial.println("Starting");
+
+  pinMode(ONBOARD_LED_PIN, OUTPUT);
+
+  patternController.addPatternSequence(&patternSequence, &pixelSet);
+  patternController.enableStatusLed(ONBOARD_LED_PIN);
+  patternController.init();
 }
 
 
 void loop()
 {
   static uint8_t patternSelection = 255;
-  static uint8_t patternNum = 255;
-  static unsigned long nextPatternChangeMs = 0;
-  static void (*loopFun)(patternDef_t*);
-  static byte patParamBuf[PAT_PARAMS_BUF_SIZE];  // used by pattern fn; must remain intact between calls to same fn
-  static bool loopedWithoutPatternUpdate;
   static unsigned long lastPushbuttonEventMs = 0;
   static bool lastPushbuttonState = HIGH;
   static bool pushbuttonDebouncedState = HIGH;
 
-  const patternDef_t* patDef;
-  uint8_t patternType;
-  unsigned long durationSec;
-  patternDef_t* patParams;
-  uint8_t paramStructSize;
   unsigned long now = millis();
 
 
-//  digitalWrite(ONBOARD_LED_PIN, pushbuttonDebouncedState);
+  // ----- pushbutton support -----
+
   bool pushbuttonState = digitalRead(MODE_PUSHBUTTON_PIN);
   if (pushbuttonState != lastPushbuttonState) {
     lastPushbuttonState = pushbuttonState;
     lastPushbuttonEventMs = now;
   }
+
   if (pushbuttonState != pushbuttonDebouncedState
         && now - lastPushbuttonEventMs > PUSHBUTTON_DEBOUNCE_INTERVAL_MS) {
       pushbuttonDebouncedState = pushbuttonState;
 
       if (pushbuttonDebouncedState == LOW) {
+        // The pushbutton has been pressed.  Select the next pattern,
+        // starting with the first one when in auto mode.
         if (++patternSelection >= NUM_PATTERNS) {
           patternSelection = 255;
           // Flash the entire string white so that the buttonpusher knows we're back on the show.
           CRGB rgbColor = CRGB::White;
           rgbColor.nscale8_video(BG_INTENSITY_SCALE_FACTOR);
-          fill_solid(pixels, NUM_PIXELS, rgbColor);
+          fill_solid(pixelSet.pixels, NUM_PIXELS, rgbColor);
           FastLED.show();
           delay(150);
         }
-        nextPatternChangeMs = now;
+        patternSelector.setPatternNum(patternSelection);
       }
   }
-  
 
-  if (now < nextPatternChangeMs) {
-    
-    if (now >= nextPatternUpdateMs && loopFun != 0) {
-
-      // If loop has been called at least once without having to call loopFun
-      // then we are probably keeping up with the update frequency that the
-      // pattern wants.  However, if we are calling loopFun every time loop
-      // is called, we probably can't satisfy the pattern's timing.  In that
-      // case, turn on the onboard LED to indicate that there is a problem.
-      digitalWrite(ONBOARD_LED_PIN, !loopedWithoutPatternUpdate);
-      loopedWithoutPatternUpdate = false;
-      
-      (*loopFun)(NULL);
-    }
-    else {
-      loopedWithoutPatternUpdate = true;
-    }
-  }
-  
-  else {
 
-    if (patternSelection == 255) {
-      if (++patternNum >= NUM_PATTERNS) {
-        patternNum = 0;
-      }
-    }
-    else {
-      patternNum = patternSelection;
-    }
-
-    patDef = patternsDefs + patternNum;
-
-    // Get the pattern definition from flash.
-    patternType = (uint8_t) pgm_read_byte(&patDef->patternType);
-    durationSec = (unsigned long) pgm_read_dword(&patDef->durationSec);
-    patParams = (patternDef_t*) pgm_read_word(&patDef->patParams);
-
-    // Get the pattern metadata.
-    paramStructSize = patternMetadataTable[patternType].paramStructSize;
-    loopFun = patternMetadataTable[patternType].loopFun;
-
-    // If the pattern params buffer isn't large enough, turn all
-    // pixels red for one second then go on to the next pattern.
-    if (paramStructSize > PAT_PARAMS_BUF_SIZE) {
-      CRGB rgbColor = CRGB::Red;
-      rgbColor.nscale8_video(BG_INTENSITY_SCALE_FACTOR);
-      fill_solid(pixels, NUM_PIXELS, rgbColor);
-      FastLED.show();
-      loopFun = 0;
-      nextPatternChangeMs = millis() + 1000;
-      return;
-    }
-
-    // Get the pattern parameters from flash.    
-    memcpy_P(patParamBuf, patParams, paramStructSize);
-
-    // When a pattern is explicitly selected, it should run forever.
-    nextPatternChangeMs = (patternSelection != 255) ? -1 : millis() + durationSec * 1000;
-    
-    // Turn off all the pixels, including skipped and non-pattern pixels.
-    fill_solid(pixelArray, NUM_PHYSICAL_PIXELS, CRGB::Black);
-    FastLED.show();
-
-    // Let the pattern initialize itself.
-    (*loopFun)((patternDef_t*) patParamBuf);
-    
-    // Give the pattern a chance to draw itself right away.
-    nextPatternUpdateMs = millis() - 1;
-    
-    // Blip the can't-keep-up light.
-    loopedWithoutPatternUpdate = false;
-  }  
+  patternController.update();
 }
 
@@ -9,14 +9,17 @@
 // /Users/ross/Library/Arduino15/packages/esp8266/tools/xtensa-lx106-elf-gcc/1.20.0-26-gb404fb9-2/bin/xtensa-lx106-elf-objdump  -d -S /var/folders/pr/80vsgp_575lbbzk8x5wbbd7m0000gn/T/arduino_build_722264/ESP8266PixelPatternFrameworkTest.ino.elf > xxx
 
 #include "Esp8266WebPage.h"
+#include "Esp8266WebSocket.h"
 #include <ESPDMX.h>
 #include <ESP8266WiFi.h>
 #include "FastLED.h"
 #include "PixelPatternController.h"
 #include "PatternSequence.h"
+#include "PixelStreamReceiver.h"
 #include "pixelPatternFrameworkTypes.h"
 #include "sequenceDefinition.h"
 #include "ExternalControlSelector.h"
+#include "StreamSelector.h"
 #include <vector>
 #include <Wire.h>
 
@@ -201,11 +204,14 @@ std::vector<Esp8266WebPage::Preset> presets = {
 };
 
 ExternalControlSelector sectionPatternSelector[NUM_SECTIONS];
+PixelStreamReceiver pixelStreamReceiver;
+StreamSelector section0StreamSelector(&pixelStreamReceiver, &sectionPixelSets[0], section0StreamPatternNum, &sectionPatternSelector[0]);
 PatternSequence* sectionPatternSequences[NUM_SECTIONS];
 uint8_t sectionPatternSequenceIdxs[NUM_SECTIONS];
 
 DMXESPSerial dmx;
 Esp8266WebPage esp8266WebPage;
+Esp8266WebSocket esp8266WebSocket;
 PixelPatternController patternController;
 
 
@@ -326,7 +332,8 @@ void initPatterns()
 
   dmx.init();
 
-  sectionPatternSequences[0] = new PatternSequence(section0PatternDefs, sizeof(section0PatternDefs) / sizeof(PatternDef), &sectionPatternSelector[0]);
+  // Section 0 shows E1.31 pixel data from the network when there is any.
+  sectionPatternSequences[0] = new PatternSequence(section0PatternDefs, sizeof(section0PatternDefs) / sizeof(PatternDef), &section0StreamSelector);
   sectionPatternSequences[1] = new PatternSequence(section1PatternDefs, sizeof(section1PatternDefs) / sizeof(PatternDef), &sectionPatternSelector[1]);
   sectionPatternSequences[2] = new PatternSequence(section2PatternDefs, sizeof(section2PatternDefs) / sizeof(PatternDef), &sectionPatternSelector[2]);
   sectionPatternSequences[3] = new PatternSequence(section3PatternDefs, sizeof(section3PatternDefs) / sizeof(PatternDef), &sectionPatternSelector[3]);
@@ -365,7 +372,13 @@ void initWebPage()
 
   esp8266WebPage.addPreset(presets);
 
+  esp8266WebPage.setPatternController(&patternController);
+
   esp8266WebPage.init();
+  esp8266WebSocket.init(&esp8266WebPage);
+
+  pixelStreamReceiver.addUniverse(1, &sectionPixelSets[0]);
+  pixelStreamReceiver.init(PixelStreamReceiver::Protocol::e131);
 
   //Serial.println("wifi init done");
 }
@@ -385,6 +398,7 @@ void updateStatusText()
 //  Serial.println(vBat);
   String statusText = "<h3>Battery: " + String(vBat, 1) + " V</h3>";
   esp8266WebPage.setStatusText(statusText);
+  esp8266WebSocket.setBatteryMillivolts(vBat * 1000);
 }
 
 
@@ -493,6 +507,8 @@ void loop()
         updateStatusText();
       }
       esp8266WebPage.doWiFi();
+      esp8266WebSocket.doWebSocket();
+      pixelStreamReceiver.poll();
       patternController.update();
       if (patternController.getUpdateLeds(sectionPatternSequenceIdxs[4])) {
         writeToDmxLeds();
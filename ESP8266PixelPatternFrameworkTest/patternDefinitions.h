@@ -12,8 +12,18 @@
 
 #include "FastLED.h"
 #include "stockPatternConfigurations.h"
+#include "StreamedPixels.h"
 
 //using namespace pixelPattern;
 
 
+namespace pixelPattern {
+class PixelStreamReceiver;
+}
+
+extern pixelPattern::PixelStreamReceiver pixelStreamReceiver;
+
+const pixelPattern::StreamedPixels::PatternConfig streamedPixels PROGMEM = {&pixelStreamReceiver};
+
+
 
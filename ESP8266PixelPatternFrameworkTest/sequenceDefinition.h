@@ -37,8 +37,13 @@ const PatternDef section0PatternDefs[] PROGMEM = {
   {SolidColor::id,        0L, &solidBSUOrange                   , "BSU Orange"},
   {SolidColor::id,        0L, &solidRed                         , "Red"},
   {SolidColor::id,        0L, &solidWhite                       , "White"},
+  {StreamedPixels::id,    0L, &streamedPixels                   , "Streamed"},
 };
 
+// Pattern number of the Streamed pattern, used while a laptop is sending
+// E1.31 pixel data.  It has zero duration so the automatic show skips it.
+constexpr uint8_t section0StreamPatternNum = 22;
+
 const PatternDef section1PatternDefs[] PROGMEM = {
   {MovingDot::id,         0L, &allOff                           , "Off"},
   {SplitRotation::id, 12000L, &splitRotationOrigRandom6RMedium  , "SplitRotOrig6RMedium"},
@@ -18,6 +18,13 @@
 
 #define ENABLE_WATCHDOG
 //#define ENABLE_DEBUG_PRINT
+// Dump radio link stats to the serial port whenever a character is received.
+//#define ENABLE_LINK_STATS
+// Write each received packet to the serial port as a trace line.
+//#define ENABLE_PACKET_TRACE
+// Instead of listening to the radio, replay trace lines received on the
+// serial port, reporting the processing time and DMX values for each packet.
+//#define ENABLE_PACKET_REPLAY
 //#define ENABLE_SIMULATED_MEASUREMENTS
 #define USE_ROSE_GARDEN_2019_MAPPING
 
@@ -38,6 +45,13 @@
 #else
 #include "printf.h"
 #endif
+#include "DmxUniverse.h"
+#include "LampCrossfade.h"
+#include "MotionInterpolator.h"
+#include "WidgetPayloadRouter.h"
+#if defined(ENABLE_PACKET_REPLAY)
+#include "WidgetPacketTrace.h"
+#endif
 
 
 /*********************************************
@@ -59,6 +73,13 @@
 
 #define LAMP_MIN_INTENSITY 64
 #define LAMP_MAX_INTENSITY 255
+
+// The rotation angle is extrapolated between packets and slewed at no
+// more than ROTATION_MAX_SLEW_TENTHS_PER_SEC.  If the widget stops sending
+// for ROTATION_TIMEOUT_MS, it is treated as inactive.
+#define ROTATION_MAX_SLEW_TENTHS_PER_SEC 7200
+#define ROTATION_MAX_PREDICTION_MS 150
+#define ROTATION_TIMEOUT_MS 2000
 //#define ENABLE_GAMMA_CORRECTION
 
 #define SIMULATED_MEASUREMENT_UPDATE_INTERVAL_MS 15
@@ -101,46 +122,6 @@ constexpr int numReadPipes = sizeof(readPipeAddresses) / (sizeof(uint8_t) * 6);
 #define TX_MAX_RETRIES 15
 
 
-/**********************************************************
- * Widget Packet Header and Payload Structure Definitions *
- **********************************************************/
-
-union WidgetHeader {
-  struct {
-    uint8_t id       : 5;
-    uint8_t channel  : 2;
-    bool    isActive : 1;
-  };
-  uint8_t raw;
-};
-
-// pipe 0
-struct StressTestPayload {
-  WidgetHeader widgetHeader;
-  uint32_t     payloadNum;
-  uint32_t     numTxFailures;
-};
-
-// pipe 1
-struct PositionVelocityPayload {
-  WidgetHeader widgetHeader;
-  int16_t      position;
-  int16_t      velocity;
-};
-
-// pipe 2
-struct MeasurementVectorPayload {
-  WidgetHeader widgetHeader;
-  int16_t      measurements[15];
-};
-
-// pipe 5
-struct CustomPayload {
-  WidgetHeader widgetHeader;
-  uint8_t      buf[31];
-};
-
-
 /***********************
  * Types and Constants *
  ***********************/
@@ -178,10 +159,31 @@ uint8_t g_gamma[] = {
  ***********/
 
 static bool widgetIsActive;
-static float currentRotationAngle;
+using pixelPattern::MotionInterpolator;
+static MotionInterpolator rotationAngle(        // tenths of a degree
+  0, ROTATION_MAX_SLEW_TENTHS_PER_SEC, ROTATION_MAX_PREDICTION_MS, ROTATION_TIMEOUT_MS, 3600);
 
 static uint8_t lampIntensities[NUM_LAMPS + 1];      // +1 because the last element is a virtual lamp that facilitates wraparound
 
+using pixelPattern::DmxUniverse;
+static DmxUniverse dmxUniverse(DMX_NUM_CHANNELS);
+
+// The fade goes across NUM_LAMPS + 1 lamps to include the virtual lamp, in
+// whole-degree steps around the circle.
+typedef pixelPattern::LampCrossfade<NUM_LAMPS + 1, LAMP_MIN_INTENSITY, LAMP_MAX_INTENSITY, 360> LampFade;
+
+using pixelPattern::MeasurementVectorPayload;
+using pixelPattern::WidgetHeaderFormat;
+using pixelPattern::WidgetPacket;
+using pixelPattern::WidgetPayloadRouter;
+using pixelPattern::WidgetRoute;
+#ifdef ENABLE_PACKET_REPLAY
+using pixelPattern::WidgetTraceReader;
+#endif
+using pixelPattern::anyChannel;
+using pixelPattern::measurementVectorPayloadSize;
+using pixelPattern::routeMask;
+
 static RF24 radio(9, 10);    // CE on pin 9, CSN on pin 10, also uses SPI bus (SCK on 13, MISO on 12, MOSI on 11)
 
 
@@ -220,21 +222,53 @@ void initRadio()
 void initDmx()
 {
 #ifndef ENABLE_DEBUG_PRINT
-  DmxSimple.usePin(DMX_OUTPUT_PIN);
-  DmxSimple.maxChannel(DMX_NUM_CHANNELS);
+  dmxUniverse.init(DMX_OUTPUT_PIN);
 #endif
 }
 
 
+bool handleFlowerYaw(const WidgetRoute& route, const WidgetPacket& packet)
+{
+  // Ignore payloads with all-zero data because the packet is probably
+  // just a heartbeat while the widget is in standby mode.
+  if (!packet.isActive || pixelPattern::measurementsAreAllZero(packet)) {
+    widgetIsActive = false;
+    return false;
+  }
+
+  widgetIsActive = true;
+  // yaw (0-3599 tenths of a degree) represents the rotation angle.
+  // If the widget sent crap data, we will just pretend the angle is 0.
+  int16_t yaw = packet.as<MeasurementVectorPayload>()->measurements[0];
+  ((MotionInterpolator*) route.target)->addSample(yaw >= 0 && yaw < 3600 ? yaw : 0, packet.rxMs);
+  return true;
+}
+
+
+// Flower widgets (ids 11-18) send ypr, gyro xyz, and temperature on pipe 2.
+const WidgetRoute widgetRoutes[] PROGMEM = {
+  {2, routeMask(11, 12, 13, 14, 15, 16, 17, 18), anyChannel, measurementVectorPayloadSize(7),
+   handleFlowerYaw, &rotationAngle, 0},
+};
+
+static WidgetPayloadRouter widgetRouter(
+  radio, WidgetHeaderFormat::fiveBitId, widgetRoutes, sizeof(widgetRoutes) / sizeof(WidgetRoute));
+
+
 void setup()
 {
 #ifdef ENABLE_DEBUG_PRINT
   Serial.begin(115200);
   printf_begin();
   Serial.println(F("Debug print enabled."));    
+#elif defined(ENABLE_LINK_STATS) || defined(ENABLE_PACKET_TRACE) || defined(ENABLE_PACKET_REPLAY)
+  Serial.begin(115200);
 #endif
 
   initRadio();
+#ifdef ENABLE_PACKET_TRACE
+  widgetRouter.setTraceOutput(&Serial);
+#endif
   initDmx();
 
 #ifdef LAMP_TEST_PIN
@@ -251,184 +285,72 @@ void setup()
 }
 
 
-bool handleMeasurementVectorPayload(const MeasurementVectorPayload* payload, uint8_t payloadSize)
-{
-  if (payload->widgetHeader.id < 11 || payload->widgetHeader.id > 18) {
-#ifdef ENABLE_DEBUG_PRINT
-    Serial.print(F("got MeasurementVectorPayload payload from widget "));
-    Serial.print(payload->widgetHeader.id);
-    Serial.println(F(" but expected one from a flower widget (ids 11-18)."));
-#endif
-    return false;
-  }
-
-  uint8_t numExpectedValues = 7;          // flower widgets send ypr, gyro xyz, and temperature
-  uint16_t expectedPayloadSize = sizeof(WidgetHeader) + sizeof(int16_t) * numExpectedValues;
-  if (payloadSize != expectedPayloadSize) {
-#ifdef ENABLE_DEBUG_PRINT
-    Serial.print(F("got MeasurementVectorPayload from widget "));
-    Serial.print(payload->widgetHeader.id);
-    Serial.print(F(" with "));
-    Serial.print(payloadSize);
-    Serial.print(F(" bytes but expected "));
-    Serial.print(expectedPayloadSize);
-    Serial.println(F(" bytes."));    
-#endif
-    return false;
-  }
-
-  // Ignore payloads with all-zero data because the packet is probably
-  // just a heartbeat while the widget is in standby mode.
-  bool gotAllZeroData = true;
-  for (uint8_t i = 0; gotAllZeroData && i < numExpectedValues; ++i) {
-    gotAllZeroData = payload->measurements[0] == 0;
-  }
-  if (gotAllZeroData) {
-    widgetIsActive = false;
-    return false;
-  }
-  
-  switch (payload->widgetHeader.id) {
-
-    case 11:
-    case 12:
-    case 13:
-    case 14:
-    case 15:
-    case 16:
-    case 17:
-    case 18:
-      if (payload->widgetHeader.isActive) {
-        widgetIsActive = true;
-        // yaw (0-3599 tenths of a degree) represents the rotation angle
-        currentRotationAngle = ((float) payload->measurements[0]) / 10.0;
-#ifdef ENABLE_DEBUG_PRINT
-        Serial.print(F("got yaw "));
-        Serial.print(currentRotationAngle);
-        Serial.println(F(" for rotation angle from widget 1"));
-#endif
-      }
-      else {
-        widgetIsActive = false;
-      }
-      break;
-  }
-  
-  return true;
-}
-
-
 void pollRadio()
 {
-  uint8_t pipeNum;
-  if (!radio.available(&pipeNum)) {
-    return;
-  }
-
-  constexpr uint8_t maxPayloadSize = 32 + sizeof(WidgetHeader);
-  uint8_t payload[maxPayloadSize];
-  uint8_t payloadSize = radio.getDynamicPayloadSize();
-  if (payloadSize > maxPayloadSize) {
-#ifdef ENABLE_DEBUG_PRINT
-    Serial.print(F("got message on pipe "));
-    Serial.print(pipeNum);
-    Serial.print(F(" with payload size "));
-    Serial.print(payloadSize);
-    Serial.print(F(" but maximum payload size is "));
-    Serial.println(maxPayloadSize);
-#endif
+  if (0 == widgetRouter.poll()) {
     return;
   }
-#ifdef ENABLE_DEBUG_PRINT
-  Serial.print(F("got message on pipe "));
-  Serial.println(pipeNum);
-#endif
-
-  radio.read(payload, payloadSize);
 
-  bool gotMeasurements = false;
-  switch(pipeNum) {
-    case 2:
-        gotMeasurements = handleMeasurementVectorPayload((MeasurementVectorPayload*) payload, payloadSize);
-        break;
-    default:
 #ifdef ENABLE_DEBUG_PRINT
-      Serial.print(F("got message on unsupported pipe "));
-      Serial.println(pipeNum);
-#endif
-      break;
-  }
-
-#ifdef ENABLE_DEBUG_PRINT
-  if (gotMeasurements) {
-    Serial.print(F(" currentRotationAngle="));
-    Serial.print(currentRotationAngle);
-  }
+  const WidgetPacket& packet = widgetRouter.getLastPacket();
+  Serial.print(F("got yaw "));
+  Serial.print(rotationAngle.getLastSample());
+  Serial.print(F(" for rotation angle from widget "));
+  Serial.println(packet.widgetId);
 #endif
 }
 
 
 void sendDmx()
 {
-  // Allocate the array one larger than the number of channels
-  // to facilitate 1-based indexing.  Element zero is not used.
-  uint8_t dmxChannelValues[DMX_NUM_CHANNELS + 1];
-
-  for (uint8_t i = 1; i <= DMX_NUM_CHANNELS; dmxChannelValues[i++] = 0);
+  // The unmapped channels stay at zero, and only the channels
+  // that changed since the last time get transmitted.
 
 #ifdef USE_ROSE_GARDEN_2019_MAPPING
 
   // yellow, outer ring (1, 18, 17, 2)
-  dmxChannelValues[ 1] = GAMMA(lampIntensities[0] + lampIntensities[4]);    // add virtual lamp for wraparound
-  dmxChannelValues[18] = GAMMA(lampIntensities[1]);
-  dmxChannelValues[17] = GAMMA(lampIntensities[2]);
-  dmxChannelValues[ 2] = GAMMA(lampIntensities[3]);
+  dmxUniverse.setChannel( 1, GAMMA(lampIntensities[0] + lampIntensities[4]));    // add virtual lamp for wraparound
+  dmxUniverse.setChannel(18, GAMMA(lampIntensities[1]));
+  dmxUniverse.setChannel(17, GAMMA(lampIntensities[2]));
+  dmxUniverse.setChannel( 2, GAMMA(lampIntensities[3]));
 
   // pink, inside ring (6, 14, 13, 5)
-  dmxChannelValues[13] = GAMMA(lampIntensities[0] + lampIntensities[4]);    // add virtual lamp for wraparound
-  dmxChannelValues[ 5] = GAMMA(lampIntensities[1]);
-  dmxChannelValues[ 6] = GAMMA(lampIntensities[2]);
-  dmxChannelValues[14] = GAMMA(lampIntensities[3]);
+  dmxUniverse.setChannel(13, GAMMA(lampIntensities[0] + lampIntensities[4]));    // add virtual lamp for wraparound
+  dmxUniverse.setChannel( 5, GAMMA(lampIntensities[1]));
+  dmxUniverse.setChannel( 6, GAMMA(lampIntensities[2]));
+  dmxUniverse.setChannel(14, GAMMA(lampIntensities[3]));
 
   // white, pink, yellow center tree
-  dmxChannelValues[ 9] = GAMMA(lampIntensities[0] + lampIntensities[4]);    // add virtual lamp for wraparound
-  dmxChannelValues[10] = GAMMA(lampIntensities[1]);
-  dmxChannelValues[12] = GAMMA(lampIntensities[2]);
+  dmxUniverse.setChannel( 9, GAMMA(lampIntensities[0] + lampIntensities[4]));    // add virtual lamp for wraparound
+  dmxUniverse.setChannel(10, GAMMA(lampIntensities[1]));
+  dmxUniverse.setChannel(12, GAMMA(lampIntensities[2]));
 
 #else
 
-  dmxChannelValues[ 1] = GAMMA(lampIntensities[0] + lampIntensities[4]);    // add virtual lamp for wraparound
-  dmxChannelValues[ 4] = GAMMA(lampIntensities[1]);
-  dmxChannelValues[ 7] = GAMMA(lampIntensities[2]);
-  dmxChannelValues[10] = GAMMA(lampIntensities[3]);
+  dmxUniverse.setChannel( 1, GAMMA(lampIntensities[0] + lampIntensities[4]));    // add virtual lamp for wraparound
+  dmxUniverse.setChannel( 4, GAMMA(lampIntensities[1]));
+  dmxUniverse.setChannel( 7, GAMMA(lampIntensities[2]));
+  dmxUniverse.setChannel(10, GAMMA(lampIntensities[3]));
 
-  dmxChannelValues[26] = GAMMA(lampIntensities[0] + lampIntensities[4]);    // add virtual lamp for wraparound
-  dmxChannelValues[23] = GAMMA(lampIntensities[1]);
-  dmxChannelValues[20] = GAMMA(lampIntensities[2]);
-  dmxChannelValues[17] = GAMMA(lampIntensities[3]);
+  dmxUniverse.setChannel(26, GAMMA(lampIntensities[0] + lampIntensities[4]));    // add virtual lamp for wraparound
+  dmxUniverse.setChannel(23, GAMMA(lampIntensities[1]));
+  dmxUniverse.setChannel(20, GAMMA(lampIntensities[2]));
+  dmxUniverse.setChannel(17, GAMMA(lampIntensities[3]));
 
-  dmxChannelValues[13] = GAMMA(lampIntensities[0] + lampIntensities[4]);    // add virtual lamp for wraparound
-  dmxChannelValues[14] = GAMMA(lampIntensities[1]);
-  dmxChannelValues[15] = GAMMA(lampIntensities[2]);
+  dmxUniverse.setChannel(13, GAMMA(lampIntensities[0] + lampIntensities[4]));    // add virtual lamp for wraparound
+  dmxUniverse.setChannel(14, GAMMA(lampIntensities[1]));
+  dmxUniverse.setChannel(15, GAMMA(lampIntensities[2]));
 
 #endif
 
   // Transmit the DMX channel values.
 #ifndef ENABLE_DEBUG_PRINT
-  for (uint8_t dmxChannelNum = 1; dmxChannelNum <= DMX_NUM_CHANNELS; ++dmxChannelNum) {
-    DmxSimple.write(dmxChannelNum, dmxChannelValues[dmxChannelNum]);
-//#ifdef ENABLE_DEBUG_PRINT
-//    Serial.print(F("sent DMX ch "));
-//    Serial.print(dmxChannelNum);
-//    Serial.print(F(": "));
-//    Serial.println(dmxChannelValues[dmxChannelNum]);    
-//#endif
-  }
+  dmxUniverse.commit();
 #endif
 }
 
 
-void updateLamps()
+void updateLamps(uint32_t now)
 {
 #ifdef LAMP_TEST_PIN
   if (digitalRead(LAMP_TEST_PIN) == LAMP_TEST_ACTIVE) {
@@ -441,7 +363,7 @@ void updateLamps()
   }
 #endif
 
-  if (!widgetIsActive) {
+  if (!widgetIsActive || rotationAngle.isTimedOut(now)) {
     uint8_t lampIdx;
     for (lampIdx = 0; lampIdx < NUM_LAMPS; ++lampIdx) {
       lampIntensities[lampIdx] = LAMP_MAX_INTENSITY;
@@ -451,63 +373,107 @@ void updateLamps()
     return;
   }
 
-  constexpr float lampRotationStepAngle = 360.0 / (float) NUM_LAMPS;
-
-  for (uint8_t lampIdx = 0; lampIdx <= NUM_LAMPS - 1; ++lampIdx) {
-    lampIntensities[lampIdx] = LAMP_MIN_INTENSITY;
-  }
-  // The first lamp already has the minimum intensity, so the virtual lamp doesn't need it.
-  lampIntensities[NUM_LAMPS] = 0;
-
   // Fade across the lamps based on lamp selection angle.  The trick here is
   // that there are no more than two lamps illuminated at a time.  Fading across
-  // pairs of lamps in succession gives the illusion of movement.  currentRotationAngle is
-  // supposed to be 0 to 359.9 degrees.  If the widget sent crap data, we will
-  // just pretend the angle is 0.
-  int fadeDownLamp = currentRotationAngle >= 0 && currentRotationAngle < 360 ? currentRotationAngle / lampRotationStepAngle : 0;
-  int fadeUpLamp = fadeDownLamp + 1;
-  lampIntensities[fadeDownLamp] =
-    map(currentRotationAngle,
-        lampRotationStepAngle * fadeDownLamp, lampRotationStepAngle * (fadeUpLamp),
-        LAMP_MAX_INTENSITY, LAMP_MIN_INTENSITY);
-  lampIntensities[fadeUpLamp] =
-    map(currentRotationAngle,
-        lampRotationStepAngle * fadeDownLamp, lampRotationStepAngle * (fadeUpLamp),
-        LAMP_MIN_INTENSITY, LAMP_MAX_INTENSITY);
+  // pairs of lamps in succession gives the illusion of movement.  The rotation
+  // angle is advanced to now here, at the DMX rate, rather than when packets
+  // arrive, and it is always 0 to 3599 tenths of a degree.
+  uint16_t position = LampFade::positionFromRange(rotationAngle.update(now), 0, 3600);
+  uint8_t fadeDownLamp = LampFade::fill(position, lampIntensities);
+  uint8_t fadeUpLamp = fadeDownLamp + 1;
   // When the virtual lamp is fading up, we're actually wrapping around to
   // the first lamp, so prevent the minimum intensity from affecting it.
+  // Otherwise, the first lamp already has the minimum intensity, so the
+  // virtual lamp doesn't need it.
   if (fadeUpLamp == NUM_LAMPS) {
     lampIntensities[0] = 0;
   }
+  else {
+    lampIntensities[NUM_LAMPS] = 0;
+  }
 
   sendDmx();
 }
 
 
+#ifdef ENABLE_PACKET_REPLAY
+void replayPacketTrace()
+{
+  // Each replayed packet is reported with a line showing the microseconds
+  // spent dispatching it and updating the lamps, followed by a line with
+  // the resulting DMX channel values.  The lamps are updated as of the
+  // time the packet was originally received.
+
+  static WidgetTraceReader traceReader;
+  static WidgetPacket packet;
+  if (!traceReader.read(Serial, &packet)) {
+    return;
+  }
+
+  uint32_t startUs = micros();
+  widgetRouter.dispatch(packet);
+  uint32_t dispatchUs = micros() - startUs;
+
+  startUs = micros();
+  updateLamps(packet.rxMs);
+  uint32_t updateLampsUs = micros() - startUs;
+
+  Serial.print(F("P "));
+  Serial.print(packet.rxMs);
+  Serial.print(F(" dispatchUs="));
+  Serial.print(dispatchUs);
+  Serial.print(F(" updateLampsUs="));
+  Serial.println(updateLampsUs);
+
+  Serial.print('D');
+  for (uint16_t channelNum = 1; channelNum <= dmxUniverse.numChannels; ++channelNum) {
+    Serial.print(' ');
+    Serial.print(dmxUniverse.getChannel(channelNum));
+  }
+  Serial.println();
+}
+#endif
+
+
 void loop()
 {
+#ifdef ENABLE_PACKET_REPLAY
+  replayPacketTrace();
+#else
   static int32_t lastDmxTxMs;
 
   uint32_t now = millis();
 
 #ifdef ENABLE_SIMULATED_MEASUREMENTS
   static int32_t lastMeasmtIncMs;
+  static int16_t simulatedRotationAngle;
   if (now - lastMeasmtIncMs >= SIMULATED_MEASUREMENT_UPDATE_INTERVAL_MS) {
     lastMeasmtIncMs = now;
-    currentRotationAngle += SIMULATED_MEASUREMENT_STEP;
-    if (currentRotationAngle >= 360.0) {
-      currentRotationAngle -= 360.0;
+    simulatedRotationAngle += SIMULATED_MEASUREMENT_STEP * 10;
+    if (simulatedRotationAngle >= 3600) {
+      simulatedRotationAngle -= 3600;
     }
+    rotationAngle.addSample(simulatedRotationAngle, now);
     widgetIsActive = true;
   }
 #endif
 
   pollRadio();
 
+#ifdef ENABLE_LINK_STATS
+  if (Serial.available()) {
+    while (Serial.available()) {
+      Serial.read();
+    }
+    widgetRouter.printLinkStats(Serial, now);
+  }
+#endif
+
   if (now - lastDmxTxMs >= DMX_TX_INTERVAL_MS) {
     lastDmxTxMs = now;
-    updateLamps();
+    updateLamps(now);
   }
+#endif
 
 #ifdef ENABLE_WATCHDOG
   wdt_reset();
@@ -1,10 +1,12 @@
 // ---------------------------------------------------------------------------
-// Example NewPing library sketch that does a ping about 20 times per second.
+// Pings two HC-SR04s in turn, about 15 times per second each, and shows
+// their distances.  The pings are timed by pin change interrupts, so the
+// loop never waits for an echo.
 // ---------------------------------------------------------------------------
 
-#include <NewPing.h>
 #include <LiquidCrystal.h>
 #include "FastLED.h"
+#include "SonarScheduler.h"
 
 #define NUM_SENSORS 2
 #define TRIGGER_PIN_0  7  // Arduino pin tied to trigger pin on the ultrasonic sensor.
@@ -14,11 +16,17 @@
 #define ECHO_PIN_1     A3 // Arduino pin tied to echo pin on the ultrasonic sensor.
 #define MAX_DISTANCE_1 200 // Maximum distance we want to ping for (in centimeters). Maximum sensor distance is rated at 400-500cm.
 
+// Pings alternate between the sensors, so each one pings every
+// NUM_SENSORS * PING_INTERVAL_MS ms.  29 ms should be the shortest
+// interval that lets one sensor's echoes die out before the next pings.
+#define PING_INTERVAL_MS 33
+#define DISPLAY_INTERVAL_MS 200L
+
 #define PRINT_TO_SERIAL
 
-NewPing sonar[NUM_SENSORS] = {
-  NewPing(TRIGGER_PIN_0, ECHO_PIN_0, MAX_DISTANCE_0),
-  NewPing(TRIGGER_PIN_1, ECHO_PIN_1, MAX_DISTANCE_1)
+const pixelPattern::SonarConfig sonarConfigs[NUM_SENSORS] = {
+  {TRIGGER_PIN_0, ECHO_PIN_0, MAX_DISTANCE_0},
+  {TRIGGER_PIN_1, ECHO_PIN_1, MAX_DISTANCE_1}
 };
 
 // RS, E, D4, D5, D6, D7
@@ -28,9 +36,20 @@ LiquidCrystal lcd(A1, A0, 3, 4, 5, 6);
 #define LED_DATA_PIN 2
 CRGB leds[NUM_LEDS];
 
+// A sensor's last good distance is shown for this long after it misses.
 #define GOOD_MEASUREMENT_SUSTAIN_MS 500L
-int lastGoodMeasurement[NUM_SENSORS] = {0, 0};
-unsigned long lastGoodMeasurementMs[NUM_SENSORS];
+
+using pixelPattern::SonarScheduler;
+SonarScheduler sonars(sonarConfigs, NUM_SENSORS, PING_INTERVAL_MS, GOOD_MEASUREMENT_SUSTAIN_MS);
+
+// Pin 8 is on PCINT0, and A3 is on PCINT1.
+ISR(PCINT0_vect) {
+  sonars.handleEchoChange();
+}
+
+ISR(PCINT1_vect) {
+  sonars.handleEchoChange();
+}
 
 void setup() {
 
@@ -48,37 +67,35 @@ void setup() {
   lcd.print("== W I D G E T S ==");
 
   FastLED.addLeds<WS2812B, LED_DATA_PIN, GRB>(leds, NUM_LEDS); // 60 pixels/m 4m 5 V white strips (devel. strip, lampshade hat); Joule strips
+
+  sonars.begin();
 }
 
 void loop() {
 
-  delay(500);                     // Wait 50ms between pings (about 20 pings/sec). 29ms should be the shortest delay between pings.
-
-#ifdef PRINT_TO_SERIAL
-  Serial.print("Ping: ");
-#endif
+  static unsigned long lastDisplayMs;
 
   unsigned long now = millis();
 
+  sonars.update(now);
+
+  if (now - lastDisplayMs < DISPLAY_INTERVAL_MS) {
+    return;
+  }
+  lastDisplayMs = now;
+
   int distance[NUM_SENSORS];
   for (int i = 0; i < NUM_SENSORS; ++i) {
-    distance[i] = sonar[i].ping_cm();
-    if (distance[i] != 0) {
-      lastGoodMeasurement[i] = distance[i];
-      lastGoodMeasurementMs[i] = now;
-    }
-    else {
-      if (now - lastGoodMeasurementMs[i] <= GOOD_MEASUREMENT_SUSTAIN_MS) {
-        distance[i] = lastGoodMeasurement[i];
-      }
-    }
+    distance[i] = sonars.getDistanceCm(i, now);
   }
 
 #ifdef PRINT_TO_SERIAL  
+  Serial.print("Ping: ");
   Serial.print(distance[0]);
   Serial.print(", ");
   Serial.print(distance[1]);
-  Serial.println("cm");
+  Serial.print("cm  ");
+  sonars.printStats(Serial);
 #endif
 
   lcd.setCursor(0, 3);  // zero-based col, line
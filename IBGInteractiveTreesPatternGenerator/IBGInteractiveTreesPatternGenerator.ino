@@ -26,6 +26,11 @@
 
 #include "I2Cdev.h"
 #include "MPU6050_6Axis_MotionApps20.h"
+#include "DmpMotion.h"
+#include "FixedPointFormat.h"
+#include "MpuFifoReader.h"
+#include "MpuMotionActivity.h"
+#include "SensorFilters.h"
 // Arduino Wire library is required if I2Cdev I2CDEV_ARDUINO_WIRE implementation
 // is used in I2Cdev.h
 #if I2CDEV_IMPLEMENTATION == I2CDEV_ARDUINO_WIRE
@@ -33,6 +38,7 @@
 #endif
 
 #include "DmxSimple.h"
+#include "DmxUniverse.h"
 
 
 /*****************
@@ -43,17 +49,30 @@
 #define TEMPERATURE_SAMPLE_INTERVAL_MS 500L
 #define DMX_TX_INTERVAL_MS 33L
 
+// When nobody has moved the controller for MOTION_TIMEOUT_MS ms, the MPU
+// goes into standby and the trees hold their colors.  It wakes up when it
+// sees MOTION_WAKE_THRESHOLD (unit is 2mg) for MOTION_WAKE_DURATION_MS ms,
+// and goes back into standby unless there is more than
+// YPR_MOTION_CHANGE_THRESHOLD tenths of a degree motion in yaw, pitch, or
+// roll within MOTION_CONFIRM_TIMEOUT_MS ms.
+#define MOTION_WAKE_THRESHOLD 2
+#define MOTION_WAKE_DURATION_MS 1
+#define MOTION_WAKE_FREQUENCY 2     // 0 = 1.25 Hz, 1 = 2.5 Hz, 2 = 5 Hz, 3 = 10 Hz
+#define MOTION_CONFIRM_TIMEOUT_MS 1000L
+#define MOTION_TIMEOUT_MS 10000L
+#define YPR_MOTION_CHANGE_THRESHOLD 2
+
 #define IMU_INTERRUPT_PIN 2
 
 #define NUM_MA_SETS 9
-#define MA_LENGTH 8
+#define MA_LENGTH_SHIFT 3   // moving averages are over 2^MA_LENGTH_SHIFT values
 
-// When we haven't retrieved packets from the MPU6050's DMP's FIFO fast enough,
-// data corruption becomes likely even before the FIFO overflows.  We'll clear
-// the FIFO when more than maxPacketsInFifoBeforeReset packets are in it.
-constexpr uint8_t maxPacketsInFifoBeforeReset = 2;
+// Whole packets waiting in the MPU6050's DMP's FIFO are read in one burst of
+// up to maxMpuPacketsPerRead packets.  Older packets than that are dropped.
+constexpr uint8_t maxMpuPacketsPerRead = 4;
 
 constexpr double countsPerG = 8192.0;
+constexpr int32_t countsPerGInt = 8192;
 
 #define DMX_OUTPUT_PIN 3
 #define DMX_NUM_CHANNELS 8
@@ -77,29 +96,35 @@ typedef uint8_t fract8;   ///< ANSI: unsigned short _Fract
  ***********/
 
 // moving average variables
-static int16_t maValues[NUM_MA_SETS][MA_LENGTH];
-static int32_t maSums[NUM_MA_SETS];
-static uint8_t nextSlotIdx[NUM_MA_SETS];
-static bool maSetFull[NUM_MA_SETS];
+using pixelPattern::BoxcarFilterBank;
+static BoxcarFilterBank<NUM_MA_SETS, MA_LENGTH_SHIFT> movingAverages;
 
 static MPU6050 mpu;               // using default I2C address 0x68
 
 // MPU control/status vars
 static bool dmpReady = false;     // set true if DMP init was successful
 static uint8_t devStatus;         // return status after each device operation (0 = success, !0 = error)
-static uint16_t packetSize;       // expected DMP packet size (default is 42 bytes)
-static uint8_t packetBuffer[42];  // must be at least as large as packet size returned by dmpGetFIFOPacketSize
+
+using pixelPattern::MpuFifoReader;
+static MpuFifoReader mpuFifoReader(mpu, maxMpuPacketsPerRead);
+
+// standby/active control
+using pixelPattern::MpuMotionActivity;
+static MpuMotionActivity motionActivity(mpu, mpuFifoReader, {
+  MOTION_WAKE_THRESHOLD,
+  MOTION_WAKE_DURATION_MS,
+  MOTION_WAKE_FREQUENCY,
+  YPR_MOTION_CHANGE_THRESHOLD,
+  MOTION_CONFIRM_TIMEOUT_MS,
+  MOTION_TIMEOUT_MS});
 
 // orientation/motion vars
-static Quaternion quat;           // [w, x, y, z] quaternion container
-static VectorFloat gravity;       // [x, y, z] gravity vector
-static float ypr[3];              // [yaw, pitch, roll] yaw/pitch/roll container
-static VectorInt16 aa;            // [x, y, z] accel sensor measurements
-static VectorInt16 aaReal;        // [x, y, z] gravity-free accel sensor measurements
-static int16_t rawAccel[3];
-static int16_t gyro[3];
-static float mpuTemperatureC;
-static float mpuTemperatureF;
+using pixelPattern::DmpMotion;
+using pixelPattern::getDmpMotion;
+using pixelPattern::printFixedPoint;
+static DmpMotion dmpMotion;       // quaternion, gravity, ypr, accel, and gyro from the latest packet
+static int16_t mpuTemperatureTenthsC;
+static int16_t mpuTemperatureTenthsF;
 
 static volatile bool mpuInterrupt = false;     // indicates whether MPU interrupt pin has gone high
 
@@ -113,6 +138,9 @@ static double avgGyroX;
 static double avgGyroY;
 static double avgGyroZ;
 
+using pixelPattern::DmxUniverse;
+static DmxUniverse dmxUniverse(DMX_NUM_CHANNELS);
+
 
 
 /******************
@@ -165,30 +193,22 @@ void initMpu()
       //mpu.setZGyroOffset(-85);
       //mpu.setZAccelOffset(1788); // 1688 factory default for my test chip
   
-      // turn on the DMP, now that it's ready
-#ifdef ENABLE_DEBUG_PRINT
-      Serial.println(F("Enabling DMP..."));
-#endif
-      mpu.setDMPEnabled(true);
-
 #ifdef ENABLE_DEBUG_PRINT
       Serial.println(F("Enabling interrupt..."));
 #endif
       attachInterrupt(digitalPinToInterrupt(IMU_INTERRUPT_PIN), dmpDataReady, RISING);
 
-      // Get expected DMP packet size, and make sure packetBuffer is large enough.
-      packetSize = mpu.dmpGetFIFOPacketSize();
-      if (sizeof(packetBuffer) >= packetSize) {
+      if (mpuFifoReader.begin(mpu.dmpGetFIFOPacketSize())) {
 #ifdef ENABLE_DEBUG_PRINT
         Serial.println(F("DMP ready."));
 #endif
         dmpReady = true;
+
+        // The DMP gets turned on when there's motion.
+        motionActivity.begin(millis());
       }
       else {
-        Serial.print(F("*** FIFO packet size "));
-        Serial.print(packetSize);
-        Serial.print(F(" is larger than packetBuffer size "));
-        Serial.println(sizeof(packetBuffer));
+        Serial.println(F("*** Couldn't allocate the FIFO packet buffer."));
       }
     }
     else {
@@ -211,8 +231,7 @@ void initMpu()
 
 void initDmx()
 {
-  DmxSimple.usePin(DMX_OUTPUT_PIN);
-  DmxSimple.maxChannel(DMX_NUM_CHANNELS);
+  dmxUniverse.init(DMX_OUTPUT_PIN);
 }
 
 
@@ -296,71 +315,6 @@ LIB8STATIC_ALWAYS_INLINE uint8_t scale8(uint8_t i, fract8 scale)
 }
 
 
-void updateMovingAverage(uint8_t setIdx, int16_t newValue)
-{
-  maSums[setIdx] -= maValues[setIdx][nextSlotIdx[setIdx]];
-  maSums[setIdx] += newValue;
-  maValues[setIdx][nextSlotIdx[setIdx]] = newValue;
-
-  ++nextSlotIdx[setIdx];
-  if (nextSlotIdx[setIdx] >= MA_LENGTH) {
-     maSetFull[setIdx] = true;
-     nextSlotIdx[setIdx] = 0;
-  }
-}
-
-
-int16_t getMovingAverage(uint8_t setIdx)
-{
-  int32_t avg;
-  if (maSetFull[setIdx]) {
-    avg = maSums[setIdx] / (int32_t) MA_LENGTH;
-  }
-  else {
-    avg = nextSlotIdx[setIdx] > 0 ? (int32_t) maSums[setIdx] / (int32_t) nextSlotIdx[setIdx] : 0;
-  }
-
-//#ifdef ENABLE_DEBUG_PRINT
-//  Serial.print("getMovingAverage(");
-//  Serial.print(setIdx);
-//  Serial.print("):  ");
-//  for (uint8_t i = 0; i < (maSetFull[setIdx] ? MA_LENGTH : nextSlotIdx[setIdx]); ++i) {
-//    Serial.print(i);
-//    Serial.print(":");
-//    Serial.print(maValues[setIdx][i]);
-//    Serial.print("  ");
-//  }
-//  Serial.print(maSums[setIdx]);
-//  Serial.print("  ");
-//  Serial.println(avg);
-//#endif
-
-  return avg;
-}
-
-
-void resetDmpFifo()
-{
-#ifdef ENABLE_DEBUG_PRINT
-    Serial.println(F("Resetting DMP FIFO..."));
-#endif
-    mpu.resetFIFO();
-    while (true) {
-      if (mpuInterrupt) {
-        mpuInterrupt = false;
-        uint8_t mpuIntStatus = mpu.getIntStatus();
-        if (mpuIntStatus & 0x01) {
-          mpu.resetFIFO();
-          break;
-        }
-      }
-    }
-#ifdef ENABLE_DEBUG_PRINT
-    Serial.println(F("Cleared FIFO and re-sync'd."));
-#endif
-}
-
-
 void gatherMotionMeasurements()
 {
 //#ifdef ENABLE_DEBUG_PRINT
@@ -369,94 +323,38 @@ void gatherMotionMeasurements()
 
   mpuInterrupt = false;
   uint8_t mpuIntStatus = mpu.getIntStatus();
-  uint16_t fifoCount = mpu.getFIFOCount();
-
-  // Check if FIFO overflowed.  If it did, clear it, then wait for another
-  // data-ready interrupt and clear the FIFO again so that we are back in
-  // sync (i.e., any partial packets have been cleared out).  Based on some
-  // brief testing, it appears that bits 0 and 1 always appear set together.
-  if (mpuIntStatus & 0x10) {
-#ifdef ENABLE_DEBUG_PRINT
-    Serial.print(F("*** FIFO overflow!  fifoCount is "));
-    Serial.println(fifoCount);
-#endif
-    resetDmpFifo();
-    return;
-  }
-
-  // The MPU6050 register map document says that bit 0 indicates data ready and bit 1
-  // is reserved.  However, the I2C data analyzer dump from Jeff Rowberg found at
-  // https://www.i2cdevlib.com/tools/analyzer/1 shows that bit 0 indicates raw data
-  // ready and bit 1 indicates DMP data ready.
-  if (!(mpuIntStatus & 0x02)) {
-#ifdef ENABLE_DEBUG_PRINT
-    Serial.print(F("Got interrupt but not for data ready.  mpuIntStatus="));
-    Serial.print((int) mpuIntStatus);
-    Serial.print(F(", fifoCount="));
-    Serial.println(fifoCount);
-#endif
-    return;
-  }
-
-  // If we've missed retrieving more than a few packets in time, the FIFO has
-  // probably already overflowed (even though we haven't gotten that interrupt)
-  // or otherwise become corrupted.  We need to reset it to avoid getting bad data.
-  if (fifoCount > packetSize * maxPacketsInFifoBeforeReset) {
-#ifdef ENABLE_DEBUG_PRINT
-    Serial.print(F("*** Missed too many packets.  fifoCount="));
-    Serial.println(fifoCount);
-#endif
-    resetDmpFifo();
-    return;
-  }
+  uint32_t now = millis();
 
-  // If the FIFO length is not a multiple of the packet size, there is a partial
-  // packet in the FIFO, either due to the FIFO being filled right now or due to
-  // some sort of FIFO corruption.  We need to reset it to avoid getting bad data.
-  if (fifoCount % packetSize != 0) {
-#ifdef ENABLE_DEBUG_PRINT
-    Serial.print(F("////////// *** Partial packet in FIFO.  fifoCount="));
-    Serial.println(fifoCount);
-#endif
-    resetDmpFifo();
-    return;
+  // MpuMotionActivity wakes the DMP up on motion, and MpuFifoReader takes
+  // care of FIFO overflows and partial packets without waiting on the MPU.
+  uint8_t numPackets = motionActivity.processInterrupt(mpuIntStatus, now);
+  if (motionActivity.checkModeChange() && motionActivity.getIsActive()) {
+    movingAverages.clear();
   }
-
-  while (fifoCount >= packetSize) {
-    fifoCount -= packetSize;
-    mpu.getFIFOBytes(packetBuffer, packetSize);
-//#ifdef ENABLE_DEBUG_PRINT
-//    // Careful:  We might not be able to keep up if this debug print is enabled.
-//    Serial.print(F("Got packet from fifo.  fifoCount now "));
-//    Serial.println(fifoCount);
-//#endif
-
-    mpu.dmpGetGyro(gyro, packetBuffer);
-    mpu.dmpGetQuaternion(&quat, packetBuffer);
-    mpu.dmpGetGravity(&gravity, &quat);
-    mpu.dmpGetYawPitchRoll(ypr, &quat, &gravity);
-    mpu.dmpGetAccel(&aa, packetBuffer);
-    mpu.dmpGetLinearAccel(&aaReal, &aa, &gravity);
-
-    updateMovingAverage(0, ypr[0] * (float) 1800 / M_PI);
-    updateMovingAverage(1, ypr[1] * (float) 1800 / M_PI);
-    updateMovingAverage(2, ypr[2] * (float) 1800 / M_PI);
-    updateMovingAverage(3, aaReal.x);
-    updateMovingAverage(4, aaReal.y);
-    updateMovingAverage(5, aaReal.z);
-//    updateMovingAverage(3, aa.x);
-//    updateMovingAverage(4, aa.y);
-//    updateMovingAverage(5, aa.z);
-    updateMovingAverage(6, gyro[0]);
-    updateMovingAverage(7, gyro[1]);
-    updateMovingAverage(8, gyro[2]);
+  for (uint8_t packetIdx = 0; packetIdx < numPackets; ++packetIdx) {
+    const uint8_t* packetBuffer = mpuFifoReader.getPacket(packetIdx);
+
+    getDmpMotion(packetBuffer, &dmpMotion);
+
+    movingAverages.update(0, dmpMotion.yprTenths[0]);
+    movingAverages.update(1, dmpMotion.yprTenths[1]);
+    movingAverages.update(2, dmpMotion.yprTenths[2]);
+    movingAverages.update(3, dmpMotion.linearAccel[0]);
+    movingAverages.update(4, dmpMotion.linearAccel[1]);
+    movingAverages.update(5, dmpMotion.linearAccel[2]);
+//    movingAverages.update(3, dmpMotion.accel[0]);
+//    movingAverages.update(4, dmpMotion.accel[1]);
+//    movingAverages.update(5, dmpMotion.accel[2]);
+    movingAverages.update(6, dmpMotion.gyro[0]);
+    movingAverages.update(7, dmpMotion.gyro[1]);
+    movingAverages.update(8, dmpMotion.gyro[2]);
 
 #ifdef ENABLE_WATCHDOG
     // If we're here and we got non-zero data, communication
     // with the MPU6050 is probably working, so kick the dog.
     bool gotNonzeroData = false;
     for (uint8_t i = 0; i < 3; ++i) {
-      if (ypr[i] > 0.001 || gyro[i] != 0) {
+      if (dmpMotion.yprTenths[i] != 0 || dmpMotion.gyro[i] != 0) {
         gotNonzeroData = true;
         break;
       }
@@ -466,26 +364,36 @@ void gatherMotionMeasurements()
     }
 #endif
 
+    // If there was sufficient motion, keep us out of standby mode for now.
+    uint16_t maxYprChange = 0;
+    for (uint8_t i = 0; i <= 2; ++i) {
+      uint16_t change = abs(movingAverages.getChange(i));
+      if (change > maxYprChange) {
+        maxYprChange = change;
+      }
+    }
+    motionActivity.reportActivity(maxYprChange, now);
+
 #ifdef ENABLE_DEBUG_PRINT
       // Careful:  We might not be able to keep up if this debug print is enabled.
-    Serial.print("ypr:  ");
-    Serial.print(ypr[0]);
+    Serial.print("yprTenths:  ");
+    Serial.print(dmpMotion.yprTenths[0]);
     Serial.print(", ");
-    Serial.print(ypr[1]);
+    Serial.print(dmpMotion.yprTenths[1]);
     Serial.print(", ");
-    Serial.print(ypr[2]);
-    Serial.print("    aaReal:  ");
-    Serial.print(aaReal.x);
+    Serial.print(dmpMotion.yprTenths[2]);
+    Serial.print("    linearAccel:  ");
+    Serial.print(dmpMotion.linearAccel[0]);
     Serial.print(", ");
-    Serial.print(aaReal.y);
+    Serial.print(dmpMotion.linearAccel[1]);
     Serial.print(", ");
-    Serial.print(aaReal.z);
+    Serial.print(dmpMotion.linearAccel[2]);
     Serial.print("    gyro:  ");
-    Serial.print(gyro[0]);
+    Serial.print(dmpMotion.gyro[0]);
     Serial.print(", ");
-    Serial.print(gyro[1]);
+    Serial.print(dmpMotion.gyro[1]);
     Serial.print(", ");
-    Serial.println(gyro[2]);
+    Serial.println(dmpMotion.gyro[2]);
 #endif
   }
 }
@@ -494,42 +402,51 @@ void gatherMotionMeasurements()
 void gatherTemperatureMeasurement()
 {
   int16_t rawTemperature = mpu.getTemperature();
-  mpuTemperatureC = (float) rawTemperature / 340.0 + 36.53;
-  mpuTemperatureF = mpuTemperatureC * 9.0/5.0 + 32.0;
+  // degrees C = raw / 340 + 36.53, and degrees F = raw * 9 / 1700 + 97.754,
+  // both rounded to tenths
+  mpuTemperatureTenthsC = ((int32_t) rawTemperature * 10 + 124202 + 170) / 340;
+  mpuTemperatureTenthsF = ((int32_t) rawTemperature * 90 + 1661818 + 850) / 1700;
 }
 
 
 void getAverageMeasurements()
 {
-  avgYaw = getMovingAverage(0) / 10.0;
-  avgPitch = getMovingAverage(1) / 10.0;
-  avgRoll = getMovingAverage(2) / 10.0;
-  avgRealAccelX = getMovingAverage(3) / countsPerG;
-  avgRealAccelY = getMovingAverage(4) / countsPerG;
-  avgRealAccelZ = getMovingAverage(5) / countsPerG;
-  avgGyroX = getMovingAverage(6);
-  avgGyroY = getMovingAverage(7);
-  avgGyroZ = getMovingAverage(8);
+  avgYaw = movingAverages.get(0) / 10.0;
+  avgPitch = movingAverages.get(1) / 10.0;
+  avgRoll = movingAverages.get(2) / 10.0;
+  avgRealAccelX = movingAverages.get(3) / countsPerG;
+  avgRealAccelY = movingAverages.get(4) / countsPerG;
+  avgRealAccelZ = movingAverages.get(5) / countsPerG;
+  avgGyroX = movingAverages.get(6);
+  avgGyroY = movingAverages.get(7);
+  avgGyroZ = movingAverages.get(8);
 
 #ifdef ENABLE_DEBUG_PRINT
+  // Print from the integer averages, which are in tenths of a degree and
+  // in counts, to keep the float printing code out of the loop.
   Serial.print(F("avgYaw="));
-  Serial.print(avgYaw);
+  printFixedPoint(Serial, movingAverages.get(0), 1);
   Serial.print(F(" avgPitch="));
-  Serial.print(avgPitch);
+  printFixedPoint(Serial, movingAverages.get(1), 1);
   Serial.print(F(" avgRoll="));
-  Serial.print(avgRoll);
+  printFixedPoint(Serial, movingAverages.get(2), 1);
   Serial.print(F(" avgRealAccelX="));
-  Serial.print(avgRealAccelX);
+  printFixedPoint(Serial, (int32_t) movingAverages.get(3) * 100 / countsPerGInt, 2);
   Serial.print(F(" avgRealAccelY="));
-  Serial.print(avgRealAccelY);
+  printFixedPoint(Serial, (int32_t) movingAverages.get(4) * 100 / countsPerGInt, 2);
   Serial.print(F(" avgRealAccelZ="));
-  Serial.print(avgRealAccelZ);
+  printFixedPoint(Serial, (int32_t) movingAverages.get(5) * 100 / countsPerGInt, 2);
   Serial.print(F(" avgGyroX="));
-  Serial.print(avgGyroX);
+  Serial.print(movingAverages.get(6));
   Serial.print(F(" avgGyroY="));
-  Serial.print(avgGyroY);
+  Serial.print(movingAverages.get(7));
   Serial.print(F(" avgGyroZ="));
-  Serial.println(avgGyroZ);
+  Serial.print(movingAverages.get(8));
+  Serial.print(F(" tempC="));
+  printFixedPoint(Serial, mpuTemperatureTenthsC, 1);
+  Serial.println();
+  mpuFifoReader.printStats(Serial);
+  motionActivity.printStats(Serial, millis());
 #endif
 }
 
@@ -550,11 +467,6 @@ void sendDmx()
     treeIntensities[i] = TREE_MIN_INTENSITY;
   }
 
-  int channelIntensities[NUM_TREES];
-  for (uint8_t i = 0; i < NUM_TREES; ++i) {
-    channelIntensities[i] = 0;
-  }
-
   getAverageMeasurements();
 
   // Normalize and restrict pitch and roll to [0, maxTiltDegrees*2] degrees.
@@ -601,27 +513,19 @@ void sendDmx()
   treeIntensities[treeSection + 1] =
     map(normalizedRoll, treeAngleStep * treeSection, treeAngleStep * (treeSection + 1), TREE_MIN_INTENSITY, 255);
 
-  // For each tree, scale the intensity of each channel assigned
-  // to that tree by the corresponding color intensity.
+  // For each tree, scale the intensity of each channel assigned to that
+  // tree by the corresponding color intensity.  Only the channels that
+  // changed since the last time get transmitted.
   for (uint8_t treeIdx = 0; treeIdx < NUM_TREES; ++treeIdx) {
     for (uint8_t colorIdx = 0; colorIdx < NUM_COLORS_PER_TREE; ++colorIdx) {
       uint8_t channelIdx = treeIdx * NUM_COLORS_PER_TREE + colorIdx;
       if (channelIdx < DMX_NUM_CHANNELS) {
-        channelIntensities[channelIdx] = scale8(treeIntensities[treeIdx], colorIntensities[colorIdx]);
+        dmxUniverse.setChannel(channelIdx + 1, scale8(treeIntensities[treeIdx], colorIntensities[colorIdx]));
       }
     }
   }
 
-  // Transmit the intensities via DMX.
-  for (uint8_t i = 0; i < DMX_NUM_CHANNELS; ++i) {
-    DmxSimple.write(i+1, channelIntensities[i]);
-//#ifdef ENABLE_DEBUG_PRINT
-//    Serial.print(F("sent DMX ch "));
-//    Serial.print(i+1);
-//    Serial.print(F(": "));
-//    Serial.println(channelIntensities[i]);    
-//#endif
-  }
+  dmxUniverse.commit();
 }
 
 
@@ -637,6 +541,16 @@ void loop()
     gatherMotionMeasurements();
   }
 
+#ifdef ENABLE_WATCHDOG
+  // We don't get data periodically from the MPU when it
+  // is in standby, so we need to kick the dog here.
+  if (motionActivity.getIsIdle()) {
+    wdt_reset();
+  }
+#endif
+
+  motionActivity.update(now);
+
   if (now - lastTemperatureSampleMs >= TEMPERATURE_SAMPLE_INTERVAL_MS) {
     lastTemperatureSampleMs = now;
     gatherTemperatureMeasurement();
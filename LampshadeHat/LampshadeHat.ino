@@ -11,6 +11,12 @@
 #include <avr/pgmspace.h>
 
 #include "FastLED.h"
+#include "LegacyPatternSequence.h"
+#include "PixelPatternController.h"
+#include "PixelSet.h"
+#include "SensorFilters.h"
+
+using namespace pixelPattern;
 
 
 
@@ -30,8 +36,7 @@
 
 // power management
 #define VBATT_READ_INTERVAL_MS 250
-#define VBATT_FILTER_LENGTH 16          // must be a power of 2
-#define VBATT_FILTER_DIV_SHIFT 4        // log2(VBATT_FILTER_LENGTH)
+#define VBATT_FILTER_LENGTH_SHIFT 4     // filter length is 2^VBATT_FILTER_LENGTH_SHIFT (16)
 #define VBATT_LOW_ADC_READING 574       // 9.0 V:  1023 * (9.0 / 16.0) = 575
 #define VBATT_SHUTDOWN_ADC_READING 536  // 8.4 V:  1023 * (8.4 / 16.0) = 537
 
@@ -55,6 +60,9 @@
 #define HUE_BSU_BLUE       (HSVHue) 160
 #define HUE_BSU_ORANGE     (HSVHue) 22
 
+// FG_INTENSITY_SCALE_FACTOR sets the brightness of sparkles.
+#define FG_INTENSITY_SCALE_FACTOR 255
+
 // BG_INTENSITY_SCALE_FACTOR sets the maximum brightness for backgrounds.  It also
 // sets the brightness of the foreground of patterns that aren't doing some sort
 // of flashing or sparkle effect.  Although the range is 0 to 255, practical
@@ -183,25 +191,7 @@ struct patternDef {
 };
 
 
-// This structure contains pattern parameter metadata
-// and a pointer to the pattern function.
-typedef struct patternMetadata patternMetadata_t;
-struct patternMetadata {
-  uint8_t paramStructSize;
-  void    (*loopFun)(patternDef_t*);
-};
-
-
-// The pattern functions are declared here so that we
-// can use them to build the pattern metadata table.
-void rainbow(patternDef_t* patParams);
-void multiWave(patternDef_t* patParams);
-void movingDot(patternDef_t* patParams);
-void sparkle(patternDef_t* patParams);
-void splitRotation(patternDef_t* patParams);
-
-
-// These are the pattern types.  The values are indexes into the pattern metadata table.
+// These are the pattern types.  The values are indexes into the legacy pattern type table.
 #define MOVING_DOT     0
 #define MULTI_WAVE     1
 #define RAINBOW        2
@@ -209,31 +199,20 @@ void splitRotation(patternDef_t* patParams);
 #define SPLIT_ROTATION 4
 
 
-// Each pattern metadata entry must be in the element
-// position corresponding to its pattern type constant.
-patternMetadata_t patternMetadataTable[] = {
-  {sizeof(movingDotParams_t)    , movingDot},
-  {sizeof(multiWaveParams_t)    , multiWave},
-  {sizeof(rainbowParams_t)      , rainbow},
-  {sizeof(sparkleParams_t)      , sparkle},
-  {sizeof(splitRotationParams_t), splitRotation}
-};
-
-
-// the size of the buffer used when copying pattern parameters from flash to RAM
-#define PAT_PARAMS_BUF_SIZE 32
-
-
+// These are the ways that this sketch's original pattern functions
+// differed from the other sketches' copies.
+#define LEGACY_STYLE (LegacyStyle::unscaledDot | LegacyStyle::random8Sparkle | LegacyStyle::loopTimed)
 
-/********************************
- * Helper Function Declarations *
- ********************************/
-
-void selectRandomRgb(CRGB* rgbColor, CRGB* rgbColorInverse);
-void selectRandomHue(HSVHue* hue, HSVHue* hueInverse);
-void rotateCrgbRight(CRGB* a, uint8_t length);
-void rotateCrgbLeft(CRGB* a, uint8_t length);
-void replicatePixelPanels();
+// Each legacy pattern type entry must be in the element position
+// corresponding to its pattern type constant.  The patterns are drawn
+// by the framework patterns that replaced the original pattern functions.
+const LegacyPatternType legacyPatternTypes[] = {
+  legacyMovingDot<movingDotParams_t, LEGACY_STYLE>(),
+  legacyMultiWave<multiWaveParams_t, LEGACY_STYLE>(),
+  legacyRainbow<rainbowParams_t, LEGACY_STYLE>(),
+  legacySparkle<sparkleParams_t, SPARKLE_DELAY, MAX_SPARKLE_DENSITY, LEGACY_STYLE>(),
+  legacySplitRotation<splitRotationParams_t>(),
+};
 
 
 
@@ -244,8 +223,19 @@ void replicatePixelPanels();
 CRGB pixelArray[NUM_PHYSICAL_PIXELS];
 CRGB* pixels = pixelArray + NUM_SKIP_PIXELS;
 
+PixelSet pixelSet(
+    pixelArray,
+    NUM_PHYSICAL_PIXELS,
+    NUM_SKIP_PIXELS,
+    0,
+    NUM_PANELS,
+    PANEL_NUM_PIXELS,
+    FG_INTENSITY_SCALE_FACTOR,
+    BG_INTENSITY_SCALE_FACTOR);
+
+PixelPatternController patternController;
+
 bool lowBatteryShutdown;
-byte bgIntensityScaleFactor;
 
 
 
@@ -494,422 +484,11 @@ const patternDef_t patternsDefs[] PROGMEM = {
 // Calculate the number of patterns that make up the entire show.
 #define NUM_PATTERNS (sizeof(patternsDefs) / sizeof(patternDef_t))
 
-
-
-/*****************************
- * Pattern Drawing Functions *
- *****************************/
-
-
-void rainbow(patternDef_t* patParams)
-{
-  static rainbowParams_t* pp;
-  static uint8_t stepNum;
-
-  uint8_t i;
-
-  if (patParams) {
-    pp = (rainbowParams_t*) patParams;
-    stepNum = 0;
-    return;
-  }
-
-  fill_rainbow(pixels, PANEL_NUM_PIXELS, stepNum, 255 / PANEL_NUM_PIXELS);
-  replicatePixelPanels();
-
-  for (i = 0; i < NUM_PIXELS; pixels[i++].nscale8_video(bgIntensityScaleFactor));
-
-  FastLED.show();
-
-  if (pp->directionDown) {
-    ++stepNum;
-  }
-  else {
-    --stepNum;
-  }
-  delay(pp->delay);
-
-}
-
-
-
-void multiWave(patternDef_t* patParams)
-{
-  static multiWaveParams_t* pp;
-  static uint8_t numWaveforms;
-  static HSVHue posHue[MAX_WAVEFORMS];
-  static HSVHue negHue[MAX_WAVEFORMS];
-  static uint16_t angleInterval[MAX_WAVEFORMS];
-  static uint16_t i0[MAX_WAVEFORMS];
-  static uint8_t delayCount[MAX_WAVEFORMS];
-
-  uint8_t w;
-  colorWaveParams_t* waveParam;
-  uint8_t i;
-  uint8_t j;
-  uint16_t t;
-  uint8_t y;
-  CHSV hsvColor;
-  CHSV hsvBlended;
-  uint8_t amountOfOverlay;
-  uint8_t valueSum;
-  CRGB rgbColor;
-  uint8_t scaleFactor;
-  bool needToDisplay;
-
-
-  if (patParams) {
-    pp = (multiWaveParams_t*) patParams;
-
-    numWaveforms = 0;
-    
-    // Calculate and save the LED values for each wave at t = 0.    
-    for (w = 0; w < MAX_WAVEFORMS; ++w)
-    {
-      waveParam = pp->waveParams + w;
-
-      if (0 == waveParam->numWaves) {
-        break;
-      }
-      ++numWaveforms;
-
-      if (waveParam->randomHue) {
-        selectRandomHue(&posHue[w], &negHue[w]);
-      }
-      else {
-        posHue[w] = waveParam->posHue;
-        negHue[w] = waveParam->negHue;
-      }
-  
-      // We use 16 bits for the angle interval and "time" so that we have sufficient
-      // resultion to fit a complete set of the requested number of waves.
-      angleInterval[w] = 65535 / (pp->boundedByPanel ? PANEL_NUM_PIXELS : NUM_PIXELS) * abs(waveParam->numWaves);
-
-      i0[w] = 0;
-      
-      delayCount[w] = waveParam->delay;
-    }
-    
-    return;
-  }
-
-
-  needToDisplay = false;
-  for (w = 0; w < numWaveforms; ++w) {
-    if (0 == --delayCount[w]) {
-      delayCount[w] = pp->waveParams[w].delay;
-      needToDisplay = true;
-      if (pp->waveParams[w].directionDown) {
-        if (++i0[w] >= (pp->boundedByPanel ? PANEL_NUM_PIXELS : NUM_PIXELS)) {
-          i0[w] = 0;
-        }
-      }
-      else {
-        if (0 == i0[w]--) {
-          i0[w] = pp->boundedByPanel ? PANEL_NUM_PIXELS - 1 : NUM_PIXELS - 1;
-        }
-      }
-    }
-  }
-  if (!needToDisplay) {
-    delay(1);
-    return;
-  }
-
-    
-  for (i = 0; i < (pp->boundedByPanel ? PANEL_NUM_PIXELS : NUM_PIXELS); ++i) {
-
-    for (w = 0; w < numWaveforms; ++w) {
-
-      t = ((uint16_t) i + i0[w]) * angleInterval[w] / 256;
-      switch (pp->waveParams[w].waveformType) {
-        case SQUARE_WAVE:
-          y = triwave8(t) >= 128 ? 255 : 0;
-          break;
-        case TRIANGLE_WAVE:
-          y = triwave8(t);
-          break;
-        case QUADRATIC_EASING:
-          y = quadwave8(t);
-          break;
-        case CUBIC_EASING:
-          y = cubicwave8(t);
-          break;
-        case SINE_WAVE:
-        default:
-          y = sin8(t);
-          break;
-      }
-      if (y >= 128) {
-        hsvColor.h = posHue[w];
-        hsvColor.v = (y - 128) * 2;
-      }
-      else {
-        hsvColor.h = negHue[w];
-        // A negative number of waves means make a half wave.
-        hsvColor.v = (pp->waveParams[w].numWaves >= 0) ? (127 - y) * 2 : 0;
-      }
-      hsvColor.s = 255;
-      
-      if (0 == w) {
-        hsvBlended = hsvColor;
-      }
-      else {
-        amountOfOverlay = 255 * (uint16_t) hsvBlended.v / ((uint16_t) hsvColor.v + (uint16_t) hsvBlended.v);
-        valueSum = qadd8(hsvBlended.v, hsvColor.v);
-        nblend(hsvBlended, hsvColor, amountOfOverlay);
-        hsvBlended.v = valueSum;
-      }
-    }
-    
-    hsv2rgb_rainbow(hsvBlended, pixels[i]);
-    pixels[i].nscale8_video(bgIntensityScaleFactor);
-  }
-
-  if (pp->boundedByPanel) {
-    replicatePixelPanels();
-  }
-  
-  FastLED.show();
-}
-
-
-
-void movingDot(patternDef_t* patParams)
-{
-  static movingDotParams_t* pp;
-  static uint8_t stepNum;
-  static uint8_t stepDir;    // 0 = away from pixel 0, 1 = toward pixel 0, 2 = hold at far end, 3 = hold at near end
-  static unsigned long holdEndMs = 0;
-  static CRGB fgColor;
-  static CRGB bgColor;
-
-  CRGB rgbColor;
-  uint8_t prevStepNum;
-  uint8_t prevStepDir;
-  uint8_t j;
-
-  if (patParams) {
-    pp = (movingDotParams_t*) patParams;
-    
-    stepNum = 0;
-    stepDir = 0;
-
-    selectRandomRgb(&fgColor, &bgColor);
-    if (!pp->randomFgColor) {
-        fgColor = pp->fgColorCode;
-    }
-    if (!pp->randomBgColor) {
-        bgColor = pp->bgColorCode;
-    }
-    bgColor.nscale8_video(bgIntensityScaleFactor);
-
-    if (!pp->zipperBg) {
-      fill_solid(pixelArray, NUM_PIXELS, bgColor);
-    }
-
-    return;
-  }
-
-  prevStepNum = stepNum;
-  prevStepDir = stepDir;
-  
-  switch (stepDir) {
-
-    // moving away from pixel 0
-    case 0:
-      if (++stepNum >= PANEL_NUM_PIXELS) {
-        stepDir = 2;
-        stepNum = PANEL_NUM_PIXELS - 1;
-        holdEndMs = pp->holdTimeFarMs;
-        if (holdEndMs != 0) {
-          holdEndMs += millis();
-        }
-      }
-      break;
-
-    // moving toward pixel 0
-    case 1:
-      if (--stepNum == 0) {
-        stepDir = 3;
-        holdEndMs = pp->holdTimeNearMs;
-        if (holdEndMs != 0) {
-           holdEndMs += millis();
-        }
-      }
-      break;
-
-    // hold at far end
-    case 2:
-      if (0 == holdEndMs || millis() >= holdEndMs) {
-        if (pp->bidirectional) {
-          stepDir = 1;
-          stepNum = PANEL_NUM_PIXELS - 2;
-        }
-        else {
-          stepDir = 0;
-          stepNum = 0;
-        }
-      }
-      break;
-
-    // hold at near end
-    case 3:
-      if (0 == holdEndMs || millis() >= holdEndMs) {
-        stepDir = 0;
-      }
-      break;
-  }
-
-  if (0 == stepDir && 0 != prevStepDir && pp->changeFgColor) {
-    if (pp->zipperBg) {
-      // When doing the zipper effect, change the background color, too.
-      selectRandomRgb(&fgColor, &bgColor);
-      bgColor.nscale8_video(bgIntensityScaleFactor);
-    }
-    else {
-      selectRandomRgb(&fgColor, NULL);
-    }
-  }
-
-  if (stepNum != prevStepNum) {
-
-    rgbColor = ((stepDir == 1 || prevStepDir == 1) && pp->zipperBg) ? CRGB::Black : bgColor;
-    pixels[prevStepNum] = rgbColor;
-    for (j = 1; j < NUM_PANELS; ++j) {
-      pixels[prevStepNum + PANEL_NUM_PIXELS * j] = rgbColor;
-    }
-
-    pixels[stepNum] = fgColor;
-    for (j = 1; j < NUM_PANELS; ++j) {
-      pixels[stepNum + PANEL_NUM_PIXELS * j] = fgColor;
-    }
-    
-    FastLED.show();
-    delay(stepDir ? pp->delay1 : pp->delay0);
-  }
-  
-}
-
-
-
-void sparkle(patternDef_t* patParams)
-{
-  static sparkleParams_t* pp;
-  static uint8_t density;
-  static uint8_t selectedPixels[MAX_SPARKLE_DENSITY];
-  static CRGB fgColor;
-  static CRGB bgColor;
-
-  uint8_t i;
-  
-  if (patParams) {
-    pp = (sparkleParams_t*) patParams;
-    
-    density = pp->density <= MAX_SPARKLE_DENSITY ? pp->density : MAX_SPARKLE_DENSITY;
-    for (i = 0; i < density; ++i) {
-      selectedPixels[i] = 0;
-    }
-
-    if (pp->fgColorCode != CRGB::Black || pp->bgColorCode != CRGB::Black) {
-      fgColor = pp->fgColorCode;
-      bgColor = pp->bgColorCode;
-    }
-    else {
-      selectRandomRgb(&fgColor, &bgColor);
-    }
-    bgColor.nscale8_video(bgIntensityScaleFactor);
-    
-    // Fill with background color.
-    fill_solid(pixels, NUM_PIXELS, bgColor);
-    FastLED.show();
-    return;
-  }
-
-  for (i = 0; i < density; ++i) {
-    // Turn off the last sparkle pixel.
-    pixels[selectedPixels[i]] = bgColor;
-  
-    // Turn on a random sparkle pixel.
-    selectedPixels[i] = random8(NUM_PIXELS);
-    pixels[selectedPixels[i]] = fgColor;
-  }
-
-  FastLED.show();
-  delay(SPARKLE_DELAY);
-}
-
-
-
-void splitRotation(patternDef_t* patParams)
-{
-  static splitRotationParams_t* pp;
-  
-  uint8_t i;
-  HSVHue fgHue;
-  HSVHue bgHue;
-  CHSV fgHsv;
-  CHSV bgHsv;
-  CRGB rgbColor;
-  
-
-  if (patParams) {
-    pp = (splitRotationParams_t*) patParams;
-
-    if (pp->randomHue) {
-      selectRandomHue(&fgHue, &bgHue);
-    }
-    else {
-      fgHue = pp->fgHue;
-      bgHue = pp->bgHue;
-    }
-    fgHsv.h = fgHue;
-    fgHsv.s = 255;
-    fgHsv.v = 255;
-    bgHsv.h = bgHue;
-    bgHsv.s = 255;
-    bgHsv.v = 255;
-
-    // Fill with background color.
-    hsv2rgb_rainbow(bgHsv, rgbColor);
-    rgbColor.nscale8_video(bgIntensityScaleFactor);
-    fill_solid(pixels, PANEL_NUM_PIXELS, rgbColor);
-
-    // Set every nth pixel to the foreground color.
-    hsv2rgb_rainbow(fgHsv, rgbColor);
-    rgbColor.nscale8_video(bgIntensityScaleFactor);
-    for (i = 0; i < PANEL_NUM_PIXELS; i += pp->fgInterval) {
-        pixels[i] = rgbColor;
-    }
-
-    replicatePixelPanels();
-
-    FastLED.show();
-
-    return;
-  }
-
-
-  i = PANEL_NUM_PIXELS / 4;
-  if (pp->directionDown) {
-    rotateCrgbLeft(pixels, i);
-    rotateCrgbRight(pixels + i, i);
-    rotateCrgbRight(pixels + i * 3, i);
-    rotateCrgbLeft(pixels + i * 2, i);
-  }
-  else {
-    rotateCrgbRight(pixels, i);
-    rotateCrgbLeft(pixels + i, i);
-    rotateCrgbLeft(pixels + i * 3, i);
-    rotateCrgbRight(pixels + i * 2, i);
-  }
-
-  replicatePixelPanels();
-
-  FastLED.show();
-
-  delay(pp->delay);
-}
+LegacyPatternSequence patternSequence(
+    patternsDefs,
+    NUM_PATTERNS,
+    legacyPatternTypes,
+    sizeof(legacyPatternTypes) / sizeof(LegacyPatternType));
 
 
 
@@ -918,116 +497,6 @@ void splitRotation(patternDef_t* patParams)
  ***********/
 
 
-void selectRandomRgb(CRGB* rgbColor, CRGB* rgbColorInverse)
-{
-  CHSV hsvColor;
-
-  // Choose a fully saturated random color.
-  hsvColor.h = random(256);
-  hsvColor.s = 255;
-  hsvColor.v = 255;
-  hsv2rgb_rainbow(hsvColor, *rgbColor);
-  
-  if (NULL != rgbColorInverse) {
-    switch (random(6)) {
-      case 0:
-        hsvColor.h += 64;    // 1/4 the way around the color wheel
-        break;
-      case 1:
-        hsvColor.h += 85;    // 1/3 the way around the color wheel
-        break;
-      case 2:
-        hsvColor.h -= 64;    // 1/4 the other way around the color wheel
-        break;
-      case 3:
-        hsvColor.h -= 85;    // 1/3 the other way around the color wheel
-        break;
-      default:
-        hsvColor.h += 128;   // complementary color
-        break;
-    }
-    hsv2rgb_rainbow(hsvColor, *rgbColorInverse);
-  }
-}
-
-
-void selectRandomHue(HSVHue* hue, HSVHue* hueInverse)
-{
-  uint8_t hueValue;
-
-  // Choose a fully saturated random color.
-  hueValue = random(256);
-  *hue = (HSVHue) hueValue;
-  
-  if (NULL != hueInverse) {
-    switch (random(6)) {
-      case 0:
-        hueValue += 64;    // 1/4 the way around the color wheel
-        break;
-      case 1:
-        hueValue += 85;    // 1/3 the way around the color wheel
-        break;
-      case 2:
-        hueValue -= 64;    // 1/4 the other way around the color wheel
-        break;
-      case 3:
-        hueValue -= 85;    // 1/3 the other way around the color wheel
-        break;
-      default:
-        hueValue += 128;   // complementary color
-        break;
-    }
-    *hueInverse = (HSVHue) hueValue;
-  }
-}
-
-
-void rotateCrgbRight(CRGB* a, uint8_t length)
-{
-  uint8_t i;
-  CRGB temp;
-
-  temp = a[length - 1];
-
-  for (i = length - 1; i > 0; --i) {
-    a[i] = a[i - 1];
-  }
-
-  a[0] = temp;
-}
-
-
-void rotateCrgbLeft(CRGB* a, uint8_t length)
-{
-  uint8_t i;
-  CRGB temp;
-
-  temp = a[0];
-
-  for (i = 0; i < length - 1; ++i) {
-    a[i] = a[i + 1];
-  }
-
-  a[length - 1] = temp;
-}
-
-
-void replicatePixelPanels()
-{
-  if (NUM_PANELS <= 1)
-    return;
-  
-  uint8_t i;
-  uint8_t j;
-  
-  for (i = 0; i < PANEL_NUM_PIXELS; ++i) {
-    for (j = 1; j < NUM_PANELS; ++j) {
-      pixels[i + PANEL_NUM_PIXELS * j] = pixels[i];
-    }
-  }
-}
-
-
 uint16_t freeRam() 
 {
   // Based on code retrieved on 1 April 2015 from
@@ -1041,10 +510,7 @@ uint16_t freeRam()
 
 void checkVBatt()
 {
-  static bool filterIsFull = false;
-  static unsigned int vBattAdcReadings[VBATT_FILTER_LENGTH];
-  static unsigned int vBattSum;
-  static byte oldestReadingIdx;
+  static BoxcarFilterBank<1, VBATT_FILTER_LENGTH_SHIFT, unsigned int, unsigned int> vBattFilter;
   
 //#define VBATT_READ_INTERVAL_MS 250
 //#define VBATT_FILTER_LENGTH 8  // must be a power of 2
@@ -1059,18 +525,12 @@ void checkVBatt()
 #endif
 
   // Initialize the filter by filling it with the first reading.
-  if (!filterIsFull) {
-    filterIsFull = true;
-    for (byte i = 0; i < VBATT_FILTER_LENGTH; vBattAdcReadings[i++] = vBattAdcReading);
-    vBattSum = vBattAdcReading * VBATT_FILTER_LENGTH;
-    oldestReadingIdx = 0;
+  if (!vBattFilter.getIsFull(0)) {
+    vBattFilter.fill(0, vBattAdcReading);
   }
-  
-  vBattSum = vBattSum - vBattAdcReadings[oldestReadingIdx] + vBattAdcReading;
-  vBattAdcReadings[oldestReadingIdx] = vBattAdcReading;
-  if (++oldestReadingIdx == VBATT_FILTER_LENGTH)
-    oldestReadingIdx = 0;
-  unsigned int vBattFilteredAdcReading = vBattSum >> VBATT_FILTER_DIV_SHIFT;
+
+  vBattFilter.update(0, vBattAdcReading);
+  unsigned int vBattFilteredAdcReading = vBattFilter.get(0);
 
 #ifdef DEBUG_SERIAL_PRINT
   Serial.println(vBattFilteredAdcReading);
@@ -1080,7 +540,7 @@ void checkVBatt()
     lowBatteryShutdown = true;
   }
   if (vBattFilteredAdcReading <= VBATT_LOW_ADC_READING) {
-    bgIntensityScaleFactor = BG_INTENSITY_SCALE_FACTOR_LOW;
+    pixelSet.backgroundIntensityScaleFactor = BG_INTENSITY_SCALE_FACTOR_LOW;
   }
 
 }
@@ -1121,7 +581,6 @@ void setup()
 
   // Initialize power management.
   lowBatteryShutdown = false;
-  bgIntensityScaleFactor = BG_INTENSITY_SCALE_FACTOR;
 
   // Let things settle down a bit then turn on the pixel strip power.
   delay(250);
@@ -1130,15 +589,15 @@ void setup()
 
   // Do an R, G, B self test.
   fill_solid(pixels, NUM_PIXELS, CRGB::Red);
-  for (uint8_t i = 0; i < NUM_PIXELS; pixels[i++].nscale8_video(bgIntensityScaleFactor));
+  for (uint8_t i = 0; i < NUM_PIXELS; pixels[i++].nscale8_video(pixelSet.backgroundIntensityScaleFactor));
   FastLED.show();
   delay(500);
   fill_solid(pixels, NUM_PIXELS, CRGB::Green);
-  for (uint8_t i = 0; i < NUM_PIXELS; pixels[i++].nscale8_video(bgIntensityScaleFactor));
+  for (uint8_t i = 0; i < NUM_PIXELS; pixels[i++].nscale8_video(pixelSet.backgroundIntensityScaleFactor));
   FastLED.show();
   delay(500);
   fill_solid(pixels, NUM_PIXELS, CRGB::Blue);
-  for (uint8_t i = 0; i < NUM_PIXELS; pixels[i++].nscale8_video(bgIntensityScaleFactor));
+  for (uint8_t i = 0; i < NUM_PIXELS; pixels[i++].nscale8_video(pixelSet.backgroundIntensityScaleFactor));
   FastLED.show();
   delay(500);
   fill_solid(pixels, NUM_PIXELS, CRGB::Black);
@@ -1152,11 +611,14 @@ void setup()
 #endif
   uint32_t memDisplayNumPixelsOn = numFreeBytes * NUM_PIXELS / 2048;
   fill_solid(pixels, memDisplayNumPixelsOn, CRGB::Cyan);
-  for (uint8_t i = 0; i < memDisplayNumPixelsOn; pixels[i++].nscale8_video(bgIntensityScaleFactor));
+  for (uint8_t i = 0; i < memDisplayNumPixelsOn; pixels[i++].nscale8_video(pixelSet.backgroundIntensityScaleFactor));
   FastLED.show();
   delay(2000);
   fill_solid(pixels, NUM_PIXELS, CRGB::Black);
   FastLED.show();
+
+  patternController.addPatternSequence(&patternSequence, &pixelSet);
+  patternController.init();
 }
 
 
@@ -1164,17 +626,6 @@ void loop()
 {
   // power control
   static unsigned long nextVBattCheckMs = 0;
-  
-  // pattern control
-  static uint8_t patternNum = -1;
-  static unsigned long nextPatternChangeMs = 0;
-  static void (*loopFun)(patternDef_t*);
-  static byte patParamBuf[PAT_PARAMS_BUF_SIZE];  // used by pattern fn; must remain intact between calls to same fn
-  const patternDef_t* patDef;
-  uint8_t patternType;
-  unsigned long durationSec;
-  patternDef_t* patParams;
-  uint8_t paramStructSize;
 
   // Do power management.
   if (lowBatteryShutdown) {
@@ -1193,48 +644,5 @@ void loop()
     }
   }
 
-///  bool hsvMode = !digitalRead(MODE_PIN);
-
-  if (millis() < nextPatternChangeMs) {
-    (*loopFun)(NULL);
-  }
-  else {
-    if (++patternNum >= NUM_PATTERNS) {
-      patternNum = 0;
-    }
-
-    patDef = patternsDefs + patternNum;
-
-    // Get the pattern definition from flash.
-    patternType = (uint8_t) pgm_read_byte(&patDef->patternType);
-    durationSec = (unsigned long) pgm_read_dword(&patDef->durationSec);
-    patParams = (patternDef_t*) pgm_read_word(&patDef->patParams);
-
-    // Get the pattern metadata.
-    paramStructSize = patternMetadataTable[patternType].paramStructSize;
-    loopFun = patternMetadataTable[patternType].loopFun;
-
-    // If the pattern params buffer isn't large enough, turn all
-    // pixels red for one second then go on to the next pattern.
-    if (paramStructSize > PAT_PARAMS_BUF_SIZE) {
-      fill_solid(pixels, NUM_PIXELS, CRGB::Red);
-      FastLED.show();
-      delay(1000);
-      fill_solid(pixels, NUM_PIXELS, CRGB::Black);
-      FastLED.show();
-      nextPatternChangeMs = millis() - 1;
-      return;
-    }
-
-    // Get the pattern parameters from flash.    
-    memcpy_P(patParamBuf, patParams, paramStructSize);
-
-    nextPatternChangeMs = millis() + durationSec * 1000;
-    
-    fill_solid(pixels, NUM_PIXELS, CRGB::Black);
-    FastLED.show();
-
-    (*loopFun)((patternDef_t*) patParamBuf);
-  }  
+  patternController.update();
 }
-
@@ -1,5 +1,6 @@
 // ---------------------------------------------------------------------------
-// Example NewPing library sketch that does a ping about 20 times per second.
+// Samples a microphone continuously and reports its sound level about five
+// times per second.
 // ---------------------------------------------------------------------------
 
 #define PRINT_TO_SERIAL
@@ -7,17 +8,39 @@
 
 #ifdef ENABLE_LCD
 #include <LiquidCrystal.h>
+#include "FixedPointFormat.h"
+#include "LcdFrame.h"
 #endif
 
 //#include "FastLED.h"
 
+#include "AudioSampler.h"
+
 #define MIC_PIN A3
 
+// The mic is sampled at 9615 Hz no matter what the loop is doing.  Levels
+// are measured over windows of 2^AUDIO_WINDOW_SHIFT samples (26.6 ms),
+// and the loudest window in each SAMPLE_PERIOD_MS is reported.
+#define AUDIO_WINDOW_SHIFT 8
 #define SAMPLE_PERIOD_MS 200L
 
+using pixelPattern::AudioSampler;
+AudioSampler audioSampler(AUDIO_WINDOW_SHIFT, 0);
+
+ISR(ADC_vect) {
+  audioSampler.addSample(ADC);
+}
+
 #ifdef ENABLE_LCD
 // RS, E, D4, D5, D6, D7
 LiquidCrystal lcd(A1, A0, 3, 4, 5, 6);
+using pixelPattern::LcdFrame;
+LcdFrame lcdFrame(lcd, 20, 4);
+using pixelPattern::printFixedPoint;
+
+// Only changed characters are sent to the LCD, a few at a time, so that
+// the display doesn't hold up the loop.
+#define LCD_REFRESH_BUDGET_US 200
 #endif
 
 //#define NUM_LEDS 8
@@ -35,40 +58,48 @@ void setup() {
 
 #ifdef ENABLE_LCD
   // set up the LCD's number of columns and rows: 
-  lcd.begin(20, 4);
-  lcd.setCursor(3, 0);
-  lcd.print("Mic Test For");
-  lcd.setCursor(1, 1);
-  lcd.print("Bells and Plunger");
-//  lcd.setCursor(0, 2);
-//  lcd.print("== W I D G E T S ==");
+  lcdFrame.begin();
+  lcdFrame.setCursor(3, 0);
+  lcdFrame.print("Mic Test For");
+  lcdFrame.setCursor(1, 1);
+  lcdFrame.print("Bells and Plunger");
+//  lcdFrame.setCursor(0, 2);
+//  lcdFrame.print("== W I D G E T S ==");
 #endif
 
 //  FastLED.addLeds<WS2812B, LED_DATA_PIN, GRB>(leds, NUM_LEDS); // 60 pixels/m 4m 5 V white strips (devel. strip, lampshade hat); Joule strips
+
+  audioSampler.begin(MIC_PIN);
 }
 
 
 void loop() {
 
-  static uint16_t minSoundSample = UINT16_MAX;
-  static uint16_t maxSoundSample;
-  static uint16_t numSamples;
+  static uint16_t maxPp;
+  static uint16_t numWindows;
   static unsigned long samplePeriodStartMs;
 
   unsigned long now = millis();
 
+  if (audioSampler.update()) {
+    ++numWindows;
+    if (audioSampler.getPeakToPeak() > maxPp) {
+      maxPp = audioSampler.getPeakToPeak();
+    }
+  }
+
   if (now - samplePeriodStartMs > SAMPLE_PERIOD_MS) {
 
-    uint16_t pp = maxSoundSample - minSoundSample;
+    uint16_t pp = maxPp;
 
 #ifdef PRINT_TO_SERIAL
-    Serial.print(numSamples);
+    Serial.print(numWindows);
     Serial.print(" ");
-    Serial.print(maxSoundSample);
+    Serial.print(pp);
     Serial.print(" ");
-    Serial.print(minSoundSample);
+    Serial.print(audioSampler.getRms());
     Serial.print(" ");
-    Serial.println(pp);
+    Serial.println(audioSampler.getEnvelope());
 #endif
 
 #ifdef ENABLE_LCD
@@ -78,37 +109,25 @@ void loop() {
     memset(bars, ' ', 20);
     memset(bars, '*', numBars);
     bars[numBars] = 0;
-    lcd.setCursor(0, 2);  // zero-based col, line
-    lcd.print("                    ");
-    lcd.setCursor(0, 2);  // zero-based col, line
-    lcd.print(bars);
-
-    lcd.setCursor(0, 3);  // zero-based col, line
-    lcd.print("                    ");
-    lcd.setCursor(0, 3);  // zero-based col, line
-    lcd.print(numSamples);
-    lcd.print(" ");
-    lcd.print(maxSoundSample);
-    lcd.print(" ");
-    lcd.print(minSoundSample);
-    lcd.print(" ");
-    lcd.print(pp);
+    lcdFrame.writeLine(2, bars);
+
+    // Right-aligned 5-character columns fill the line, so the numbers
+    // stay put and there's nothing left over to clear.
+    lcdFrame.setCursor(0, 3);  // zero-based col, line
+    printFixedPoint(lcdFrame, numWindows, 0, 5);
+    printFixedPoint(lcdFrame, pp, 0, 5);
+    printFixedPoint(lcdFrame, audioSampler.getRms(), 0, 5);
+    printFixedPoint(lcdFrame, audioSampler.getEnvelope(), 0, 5);
 #endif
     
-    minSoundSample = UINT16_MAX;
-    maxSoundSample = 0;
-    numSamples = 0;
+    maxPp = 0;
+    numWindows = 0;
     samplePeriodStartMs = now;
   }
 
-  ++numSamples;
-  unsigned int soundSample = analogRead(MIC_PIN);
-  if (soundSample < minSoundSample) {
-    minSoundSample = soundSample;
-  }
-  if (soundSample > maxSoundSample) {
-    maxSoundSample = soundSample;
-  }
+#ifdef ENABLE_LCD
+  lcdFrame.refresh(LCD_REFRESH_BUDGET_US);
+#endif
 
 /*
   if (distance[0] == 0) {
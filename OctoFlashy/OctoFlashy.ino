@@ -13,6 +13,13 @@
 
 #define ENABLE_WATCHDOG
 //#define ENABLE_DEBUG_PRINT
+// Dump radio link stats to the serial port whenever a character is received.
+//#define ENABLE_LINK_STATS
+// Write each received packet to the serial port as a trace line.
+//#define ENABLE_PACKET_TRACE
+// Instead of listening to the radio, replay trace lines received on the
+// serial port, reporting the processing time and DMX values for each packet.
+//#define ENABLE_PACKET_REPLAY
 
 
 /************
@@ -31,6 +38,13 @@
 #else
 #include "DmxSimple.h"
 #endif
+#include "DmxUniverse.h"
+#include "LampCrossfade.h"
+#include "MotionInterpolator.h"
+#include "WidgetPayloadRouter.h"
+#if defined(ENABLE_PACKET_REPLAY)
+#include "WidgetPacketTrace.h"
+#endif
 
 
 /*********************************************
@@ -47,8 +61,15 @@
 #define DMX_TX_INTERVAL_MS 33L
 
 // Restrict color and lamp selection angles to avoid gimbal lock.
-constexpr float maxColorAngleDegrees = 45;
-constexpr float maxLampAngleDegrees = 45;
+constexpr int16_t maxColorAngleTenths = 450;
+constexpr int16_t maxLampAngleTenths = 450;
+
+// Widget angles are extrapolated between packets and slewed at no more
+// than maxAngleSlewTenthsPerSec.  If a widget stops sending, its angles
+// drift back to center after angleTimeoutMs.
+constexpr uint16_t maxAngleSlewTenthsPerSec = 1800;
+constexpr uint16_t maxAnglePredictionMs = 150;
+constexpr uint16_t angleTimeoutMs = 5000;
 
 constexpr int16_t minPpSoundForStrobe = 300;
 constexpr int16_t maxPpSoundForStrobe = 500;
@@ -122,6 +143,14 @@ constexpr int numReadPipes = sizeof(readPipeAddresses) / (sizeof(uint8_t) * 6);
 #endif
 #define DMX_NUM_CHANNELS (NUM_LAMPS * DMX_NUM_CHANNELS_PER_LAMP)
 
+#if defined(LAMP_HAS_CONTROL_CHANNEL)
+#define DMX_LAMP_FIXTURE_TYPE DmxUniverse::FixtureType::dimmerRgb
+#elif defined(SKIP_DIMMER_FOURTH_CHANNEL)
+#define DMX_LAMP_FIXTURE_TYPE DmxUniverse::FixtureType::rgbSkipFourth
+#else
+#define DMX_LAMP_FIXTURE_TYPE DmxUniverse::FixtureType::rgb
+#endif
+
 // Let the scale8 function stolen from the FastLED library use assembly code if we're on an AVR chip.
 #if defined(__AVR__)
 #define SCALE8_AVRASM 1
@@ -132,56 +161,37 @@ typedef uint8_t fract8;   ///< ANSI: unsigned short _Fract
 #define LIB8STATIC_ALWAYS_INLINE __attribute__ ((always_inline)) static inline
 
 
-/**********************************************************
- * Widget Packet Header and Payload Structure Definitions *
- **********************************************************/
-
-union WidgetHeader {
-  struct {
-    uint8_t id       : 4;
-    bool    isActive : 1;
-    uint8_t channel  : 3;
-  };
-  uint8_t raw;
-};
-
-// pipe 0
-struct StressTestPayload {
-  WidgetHeader widgetHeader;
-  uint32_t     payloadNum;
-  uint32_t     numTxFailures;
-};
-
-// pipe 1
-struct PositionVelocityPayload {
-  WidgetHeader widgetHeader;
-  int16_t      position;
-  int16_t      velocity;
-};
-
-// pipe 2
-struct MeasurementVectorPayload {
-  WidgetHeader widgetHeader;
-  int16_t      measurements[15];
-};
-
-// pipe 5
-struct CustomPayload {
-  WidgetHeader widgetHeader;
-  uint8_t      buf[31];
-};
-
-
 /***********
  * Globals *
  ***********/
 
-static double currentColorAngle;
-static double currentLampAngle;
+using pixelPattern::MotionInterpolator;
+static MotionInterpolator colorAngle(0, maxAngleSlewTenthsPerSec, maxAnglePredictionMs, angleTimeoutMs);   // tenths of a degree
+static MotionInterpolator lampAngle(0, maxAngleSlewTenthsPerSec, maxAnglePredictionMs, angleTimeoutMs);    // tenths of a degree
 static int16_t currentPpSound;
 
 static int colorChannelIntensities[NUM_LAMPS][NUM_COLORS_PER_LAMP];
 
+using pixelPattern::DmxUniverse;
+static DmxUniverse dmxUniverse(DMX_NUM_CHANNELS);
+
+typedef pixelPattern::LampCrossfade<NUM_COLORS_PER_LAMP, 0, 255, maxColorAngleTenths * 2 / 10> ColorFade;
+typedef pixelPattern::LampCrossfade<NUM_LAMPS, LAMP_MIN_INTENSITY, 255, maxLampAngleTenths * 2 / 10> LampFade;
+
+using pixelPattern::WidgetHeaderFormat;
+using pixelPattern::WidgetPacket;
+using pixelPattern::WidgetPayloadRouter;
+using pixelPattern::WidgetRoute;
+#ifdef ENABLE_PACKET_REPLAY
+using pixelPattern::WidgetTraceReader;
+#endif
+using pixelPattern::PositionVelocityPayload;
+using pixelPattern::anyChannel;
+using pixelPattern::measurementVectorPayloadSize;
+using pixelPattern::routeMask;
+using pixelPattern::routeMeasurementToInt16;
+using pixelPattern::routeMeasurementToInterpolator;
+
 static RF24 radio(9, 10);    // CE on pin 9, CSN on pin 10, also uses SPI bus (SCK on 13, MISO on 12, MOSI on 11)
 
 
@@ -222,22 +232,109 @@ void initRadio()
 
 void initDmx()
 {
+  for (uint8_t lampIdx = 0; lampIdx < NUM_LAMPS; ++lampIdx) {
+    dmxUniverse.addFixture(DMX_LAMP_FIXTURE_TYPE);
+  }
+
 #ifndef ENABLE_DEBUG_PRINT
-  DmxSimple.usePin(DMX_OUTPUT_PIN);
-  DmxSimple.maxChannel(DMX_NUM_CHANNELS);
+  dmxUniverse.init(DMX_OUTPUT_PIN);
 #endif
 }
 
 
+bool handleTriangleAngle(const WidgetRoute& route, const WidgetPacket& packet)
+{
+  // Vary the target angle continuously between -route.arg and route.arg
+  // degrees as the widget's position changes.  The widget's velocity is
+  // in position units per second.  The angle moves with the position on
+  // the rising half of the triangle wave and against it on the falling half.
+
+  const PositionVelocityPayload* payload = packet.as<PositionVelocityPayload>();
+  constexpr int16_t speedupFactor = 4;
+  int16_t pmax = route.arg;
+  int16_t rawP = (payload->position * speedupFactor) % (pmax * 4);
+  int16_t p = abs(rawP);                          // in Arduinolandia, abs is a macro
+  int16_t angleVelocity = constrain((int32_t) payload->velocity * speedupFactor * 10, -32767L, 32767L);
+  ((MotionInterpolator*) route.target)->addSample(((p <= pmax * 2) ? p - pmax : pmax * 3 - p) * 10,
+                                                  (p <= pmax * 2) == (rawP >= 0) ? angleVelocity : -angleVelocity,
+                                                  packet.rxMs);
+  return true;
+}
+
+
+bool handlePpSoundFromVelocity(const WidgetRoute& route, const WidgetPacket& packet)
+{
+  constexpr int16_t speedupFactor = 4;
+  int16_t ppSound = packet.as<PositionVelocityPayload>()->velocity * speedupFactor;
+  *(int16_t*) route.target = abs(ppSound);
+  return true;
+}
+
+
+bool clearInt16(const WidgetRoute& route, const WidgetPacket& packet)
+{
+  *(int16_t*) route.target = 0;
+  return true;
+}
+
+
+// Pipe 1 carries PositionVelocityPayloads and pipe 2 MeasurementVectorPayloads.
+// A packet goes to every route that matches it.
+const WidgetRoute widgetRoutes[] PROGMEM = {
+  // Spinnah (2), TriObelisk (6), and FourPlays (9-11) vary the color
+  // selection angle on channel 1 and the lamp selection angle on channel 2.
+  {1, routeMask(2, 6, 9, 10, 11), routeMask(1), sizeof(PositionVelocityPayload),
+   handleTriangleAngle, &colorAngle, maxColorAngleTenths / 10},
+  {1, routeMask(2, 6, 9, 10, 11), routeMask(2), sizeof(PositionVelocityPayload),
+   handleTriangleAngle, &lampAngle, maxLampAngleTenths / 10},
+  // The FourPlays send p-p sound as the velocity on channel 3.
+  {1, routeMask(9, 10, 11), routeMask(3), sizeof(PositionVelocityPayload),
+   handlePpSoundFromVelocity, &currentPpSound, 0},
+  // Spinnah and TriObelisk can't measure sound.
+  {1, routeMask(2, 6), routeMask(1, 2, 3), sizeof(PositionVelocityPayload),
+   clearInt16, &currentPpSound, 0},
+
+  // Tilt-1's pitch is the lamp selection angle.
+  {2, routeMask(1), anyChannel, measurementVectorPayloadSize(13),
+   routeMeasurementToInterpolator, &lampAngle, 1},
+  // Tilt-2's pitch is the color selection angle.
+  {2, routeMask(2), anyChannel, measurementVectorPayloadSize(13),
+   routeMeasurementToInterpolator, &colorAngle, 1},
+  // Tilt-Test's pitch is the lamp selection angle, and its roll is the
+  // color selection angle.  Baton (12) pretends to be Tilt-Test.
+  {2, routeMask(3, 12), anyChannel, measurementVectorPayloadSize(13),
+   routeMeasurementToInterpolator, &lampAngle, 1},
+  {2, routeMask(3, 12), anyChannel, measurementVectorPayloadSize(13),
+   routeMeasurementToInterpolator, &colorAngle, 2},
+  // Rainstick sends everything the tilt widgets send plus a peak-to-peak
+  // sound value.  Its pitch is the color selection angle, and its roll is
+  // the lamp selection angle.
+  {2, routeMask(4), anyChannel, measurementVectorPayloadSize(14),
+   routeMeasurementToInterpolator, &colorAngle, 1},
+  {2, routeMask(4), anyChannel, measurementVectorPayloadSize(14),
+   routeMeasurementToInterpolator, &lampAngle, 2},
+  {2, routeMask(4), anyChannel, measurementVectorPayloadSize(14),
+   routeMeasurementToInt16, &currentPpSound, 13},
+};
+
+static WidgetPayloadRouter widgetRouter(
+  radio, WidgetHeaderFormat::fourBitId, widgetRoutes, sizeof(widgetRoutes) / sizeof(WidgetRoute));
+
+
 void setup()
 {
 #ifdef ENABLE_DEBUG_PRINT
   Serial.begin(115200);
   printf_begin();
   Serial.println(F("Debug print enabled."));    
+#elif defined(ENABLE_LINK_STATS) || defined(ENABLE_PACKET_TRACE) || defined(ENABLE_PACKET_REPLAY)
+  Serial.begin(115200);
 #endif
 
   initRadio();
+#ifdef ENABLE_PACKET_TRACE
+  widgetRouter.setTraceOutput(&Serial);
+#endif
   initDmx();
 
 #ifdef LAMP_TEST_PIN
@@ -315,253 +412,32 @@ LIB8STATIC_ALWAYS_INLINE uint8_t scale8(uint8_t i, fract8 scale)
 }
 
 
-bool handlePositionVelocityPayload(const PositionVelocityPayload* payload, uint8_t payloadSize)
-{
-  constexpr uint16_t expectedPayloadSize = sizeof(PositionVelocityPayload);
-  if (payloadSize != expectedPayloadSize) {
-#ifdef ENABLE_DEBUG_PRINT
-    Serial.print(F("got PositionVelocityPayload with "));
-    Serial.print(payloadSize);
-    Serial.print(F(" bytes but expected "));
-    Serial.print(expectedPayloadSize);
-    Serial.println(F(" bytes."));    
-#endif
-    return false;
-  }
-
-  if (payload->widgetHeader.id != 2       // Spinnah
-      && payload->widgetHeader.id != 6    // TriObelisk
-      && payload->widgetHeader.id != 9    // FourPlay
-      && payload->widgetHeader.id != 10   // FourPlay-4-2
-      && payload->widgetHeader.id != 11   // FourPlay-4-3
-     )
-  {
-#ifdef ENABLE_DEBUG_PRINT
-    Serial.print(F("got PositionVelocityPayload payload from widget "));
-    Serial.print(payload->widgetHeader.id);
-    Serial.println(F(" but expected one from widget 2, 6, 9, 10, or 11."));
-#endif
-    return false;
-  }
-
-  bool gotMeasurement = false;
-  int16_t p;
-  int16_t pmax;
-  constexpr int16_t speedupFactor = 4;
-  switch (payload->widgetHeader.channel) {
-//    case 0:
-//      // Vary yaw continuously between -180 and 180.
-//      pmax = 180;
-//      p = (payload->position * speedupFactor) % (pmax * 4);
-//      p = abs(p);                                 // in Arduinolandia, abs is a macro
-//      currentSomethingAngle = (p <= pmax * 2) ? p - pmax : pmax * 3 - p;
-//      gotMeasurement = true;
-//      break;
-    case 1:
-      // Vary color selection angle continuously between -maxColorAngleDegrees and maxColorAngleDegrees.
-      pmax = maxColorAngleDegrees;
-      p = (payload->position * speedupFactor) % (pmax * 4);
-      p = abs(p);                                 // in Arduinolandia, abs is a macro
-      currentColorAngle = (p <= pmax * 2) ? p - pmax : pmax * 3 - p;
-      gotMeasurement = true;
-      break;
-    case 2:
-      // Vary lamp selection angle continuously between -maxLampAngleDegrees and maxLampAngleDegrees.
-      pmax = maxLampAngleDegrees;
-      p = (payload->position * speedupFactor) % (pmax * 4);
-      p = abs(p);                                 // in Arduinolandia, abs is a macro
-      currentLampAngle = (p <= pmax * 2) ? p - pmax : pmax * 3 - p;
-      gotMeasurement = true;
-      break;
-    case 3:
-      currentPpSound = payload->velocity * speedupFactor;
-      currentPpSound = abs(currentPpSound);
-      gotMeasurement = true;
-      break;
-    default:
-#ifdef ENABLE_DEBUG_PRINT
-      Serial.print(F("got PositionVelocityPayload payload from widget "));
-      Serial.print(payload->widgetHeader.id);
-      Serial.print(F(" for unsupported channel "));
-      Serial.println(payload->widgetHeader.channel);
-#endif
-      break;
-  }
-
-  // Clear the measurements we cannot get from this widget.
-  if (gotMeasurement) {
-    if (payload->widgetHeader.id == 2       // Spinnah
-        || payload->widgetHeader.id == 6    // TriObelisk
-       )
-    {
-      currentPpSound = 0;
-    }
-  }
-
-  return gotMeasurement;
-}
-
-
-//bool handleMeasurementVectorPayload(const MeasurementVectorPayload* payload, uint8_t payloadSize)
-bool handleMeasurementVectorPayload(MeasurementVectorPayload* payload, uint8_t payloadSize)
-{
-  if (payload->widgetHeader.id == 12) payload->widgetHeader.id = 3;  // Pretend that Baton is Rainstick
-  
-  if (payload->widgetHeader.id < 1 || payload->widgetHeader.id > 4) {
-#ifdef ENABLE_DEBUG_PRINT
-    Serial.print(F("got MeasurementVectorPayload payload from widget "));
-    Serial.print(payload->widgetHeader.id);
-    Serial.println(F(" but expected one from widgets 1 (Tilt-1), 2 (Tilt-2), 3 (Tilt-Test), or 4 (Rainstick)."));
-#endif
-    return false;
-  }
-
-// TODO:  Enable the next two lines and remove the third when Rainstick is running current firmware.
-  // Rainstick sends everything the tilt widgets send plus a peak-to-peak sound value.
-  uint8_t numExpectedValues = payload->widgetHeader.id <= 3 ? 13 : 14;
-//  uint8_t numExpectedValues = 13;
-  uint16_t expectedPayloadSize = sizeof(WidgetHeader) + sizeof(int16_t) * numExpectedValues;
-  if (payloadSize != expectedPayloadSize) {
-#ifdef ENABLE_DEBUG_PRINT
-    Serial.print(F("got MeasurementVectorPayload from widget "));
-    Serial.print(payload->widgetHeader.id);
-    Serial.print(F(" with "));
-    Serial.print(payloadSize);
-    Serial.print(F(" bytes but expected "));
-    Serial.print(expectedPayloadSize);
-    Serial.println(F(" bytes."));    
-#endif
-    return false;
-  }
-
-  // Ignore payloads with all-zero data because the packet is probably
-  // just a heartbeat while the widget is in standby mode.
-  bool gotAllZeroData = true;
-  for (uint8_t i = 0; gotAllZeroData && i < numExpectedValues; ++i) {
-    gotAllZeroData = payload->measurements[0] == 0;
-  }
-  if (gotAllZeroData) {
-    return false;
-  }
-  
-  switch (payload->widgetHeader.id) {
-
-    case 1:
-      // Tilt-1's pitch is the lamp selection angle.
-      currentLampAngle = payload->measurements[1] / 10.0;
-#ifdef ENABLE_DEBUG_PRINT
-      Serial.print(F("got pitch "));
-      Serial.print(currentLampAngle);
-      Serial.println(F(" for lamp angle from widget 1"));
-#endif
-      break;
-
-    case 2:
-      // Tilt-2's pitch is the color selection angle.
-      currentColorAngle = payload->measurements[1] / 10.0;
-#ifdef ENABLE_DEBUG_PRINT
-      Serial.print(F("got pitch "));
-      Serial.print(currentColorAngle);
-      Serial.println(F(" for color angle from widget 2"));
-#endif
-      break;
-
-    case 3:
-      // Tilt-Test's pitch is the lamp selection angle, and its roll is the color selection angle.
-      currentLampAngle = payload->measurements[1] / 10.0;
-      currentColorAngle = payload->measurements[2] / 10.0;
-#ifdef ENABLE_DEBUG_PRINT
-      Serial.print(F("got pitch "));
-      Serial.print(currentLampAngle);
-      Serial.print(F(" for lamp angle and roll "));
-      Serial.print(currentColorAngle);
-      Serial.println(F(" for color angle from widget 2"));
-#endif
-      break;
-
-    case 4:
-    // TODO:  fix the damn comment below
-      // Rainstick's pitch is the color selection angle, and its pitch is the color selection angle.
-      currentColorAngle = payload->measurements[1] / 10.0;
-      currentLampAngle = payload->measurements[2] / 10.0;
-      currentPpSound = payload->measurements[13];
-#ifdef ENABLE_DEBUG_PRINT
-      Serial.print(F("got pitch "));
-      Serial.print(currentColorAngle);
-      Serial.print(F(" for color angle, roll "));
-      Serial.print(currentLampAngle);
-      Serial.print(F(" for lamp angle, and p-p sound "));
-      Serial.println(currentPpSound);
-#endif
-    break;
-  }
-  
-  return true;
-}
-
-
 void pollRadio()
 {
-  uint8_t pipeNum;
-  if (!radio.available(&pipeNum)) {
+  if (0 == widgetRouter.poll()) {
     return;
   }
 
-  constexpr uint8_t maxPayloadSize = 32 + sizeof(WidgetHeader);
-  uint8_t payload[maxPayloadSize];
-  uint8_t payloadSize = radio.getDynamicPayloadSize();
-  if (payloadSize > maxPayloadSize) {
-#ifdef ENABLE_DEBUG_PRINT
-    Serial.print(F("got message on pipe "));
-    Serial.print(pipeNum);
-    Serial.print(F(" with payload size "));
-    Serial.print(payloadSize);
-    Serial.print(F(" but maximum payload size is "));
-    Serial.println(maxPayloadSize);
-#endif
-    return;
-  }
 #ifdef ENABLE_DEBUG_PRINT
+  const WidgetPacket& packet = widgetRouter.getLastPacket();
   Serial.print(F("got message on pipe "));
-  Serial.println(pipeNum);
-#endif
-
-  radio.read(payload, payloadSize);
-
-  bool gotMeasurements = false;
-  switch(pipeNum) {
-    case 1:
-        gotMeasurements = handlePositionVelocityPayload((PositionVelocityPayload*) payload, payloadSize);
-        break;
-    case 2:
-        gotMeasurements = handleMeasurementVectorPayload((MeasurementVectorPayload*) payload, payloadSize);
-        break;
-    default:
-#ifdef ENABLE_DEBUG_PRINT
-      Serial.print(F("got message on unsupported pipe "));
-      Serial.println(pipeNum);
-#endif
-      break;
-  }
-
-#ifdef ENABLE_DEBUG_PRINT
-  if (gotMeasurements) {
-    Serial.print(F(" currentColorAngle="));
-    Serial.print(currentColorAngle);
-    Serial.print(F(" currentLampAngle="));
-    Serial.print(currentLampAngle);
-    Serial.print(F(" currentPpSound="));
-    Serial.println(currentPpSound);
-  }
+  Serial.print(packet.pipeNum);
+  Serial.print(F(" from widget "));
+  Serial.print(packet.widgetId);
+  Serial.print(F(" colorAngle="));
+  Serial.print(colorAngle.getLastSample());
+  Serial.print(F(" lampAngle="));
+  Serial.print(lampAngle.getLastSample());
+  Serial.print(F(" currentPpSound="));
+  Serial.println(currentPpSound);
 #endif
 }
 
 
 void sendDmx()
 {
-  uint8_t dmxChannelValues[DMX_NUM_CHANNELS + 1];
+  // Only the channels that changed since the last time get transmitted.
 
-  uint16_t dmxChannelNum = 1;
   for (uint8_t lampIdx = 0; lampIdx < NUM_LAMPS; ++lampIdx) {
 
 #if defined(LAMP_HAS_CONTROL_CHANNEL)
@@ -569,7 +445,7 @@ void sendDmx()
     if (currentPpSound >= minPpSoundForStrobe) {
       uint8_t strobeValue = map(constrain(currentPpSound, minPpSoundForStrobe, minPpSoundForStrobe),
                                 minPpSoundForStrobe, maxPpSoundForStrobe, minStrobeValue, maxStrobeValue);
-      dmxChannelValues[dmxChannelNum++] = strobeValue;
+      dmxUniverse.setFixtureDimmer(lampIdx, strobeValue);
 #ifdef ENABLE_DEBUG_PRINT
       Serial.print(F("strobeValue="));
       Serial.print(strobeValue);
@@ -588,44 +464,26 @@ void sendDmx()
     else {
       // Set the lamp to full brightness because we control its
       // overall brightness by way of the individual colors.
-      dmxChannelValues[dmxChannelNum++] = 127;
+      dmxUniverse.setFixtureDimmer(lampIdx, 127);
     }
 #endif
 
 #if (NUM_COLORS_PER_LAMP == 4)
-    dmxChannelValues[dmxChannelNum++] = colorChannelIntensities[lampIdx][0] + colorChannelIntensities[lampIdx][3];
+    uint8_t red = colorChannelIntensities[lampIdx][0] + colorChannelIntensities[lampIdx][3];
 #else
-    dmxChannelValues[dmxChannelNum++] = colorChannelIntensities[lampIdx][0];
-#endif
-    dmxChannelValues[dmxChannelNum++] = colorChannelIntensities[lampIdx][1];
-    dmxChannelValues[dmxChannelNum++] = colorChannelIntensities[lampIdx][2];      
-
-#ifdef SKIP_DIMMER_FOURTH_CHANNEL
-    dmxChannelValues[dmxChannelNum++] = 0;
+    uint8_t red = colorChannelIntensities[lampIdx][0];
 #endif
-  }
-
-  // Send zeros to any unused channels.
-  while (dmxChannelNum <= DMX_NUM_CHANNELS) {
-    dmxChannelValues[dmxChannelNum++] = 0;
+    dmxUniverse.setFixtureRgb(lampIdx, red, colorChannelIntensities[lampIdx][1], colorChannelIntensities[lampIdx][2]);
   }
 
   // Transmit the DMX channel values.
 #ifndef ENABLE_DEBUG_PRINT
-  for (dmxChannelNum = 1; dmxChannelNum <= DMX_NUM_CHANNELS; ++dmxChannelNum) {
-    DmxSimple.write(dmxChannelNum, dmxChannelValues[dmxChannelNum]);
-//#ifdef ENABLE_DEBUG_PRINT
-//    Serial.print(F("sent DMX ch "));
-//    Serial.print(dmxChannelNum);
-//    Serial.print(F(": "));
-//    Serial.println(dmxChannelValues[dmxChannelNum]);    
-//#endif
-  }
+  dmxUniverse.commit();
 #endif
 }
 
 
-void updateLamps()
+void updateLamps(uint32_t now)
 {
 #ifdef LAMP_TEST_PIN
   if (digitalRead(LAMP_TEST_PIN) == LAMP_TEST_ACTIVE) {
@@ -641,62 +499,19 @@ void updateLamps()
   }
 #endif
 
-  constexpr float colorAngleStep = maxColorAngleDegrees * 2 / (NUM_COLORS_PER_LAMP - 1);
-  constexpr float lampAngleStep = maxLampAngleDegrees * 2 / (NUM_LAMPS - 1);
-
-  int colorIntensities[NUM_COLORS_PER_LAMP];
-  for (uint8_t i = 0; i < NUM_COLORS_PER_LAMP; ++i) {
-    colorIntensities[i] = 0;
-  }
-
-  int lampIntensities[NUM_LAMPS];
-  for (uint8_t i = 0; i < NUM_LAMPS; ++i) {
-    lampIntensities[i] = LAMP_MIN_INTENSITY;
-  }
-
-  // Normalize and restrict color and lamp selection angles to [0, max___Degrees*2] degrees.
-  float normalizedColorAngle;
-  if (currentColorAngle <= - maxColorAngleDegrees) {
-    normalizedColorAngle = 0;
-  }
-  else if (currentColorAngle >= maxColorAngleDegrees) {
-    normalizedColorAngle = maxColorAngleDegrees * 2.0;
-  }
-  else {
-    normalizedColorAngle = currentColorAngle + maxColorAngleDegrees;
-  }
-  float normalizedLampAngle;
-  if (currentLampAngle <= - maxLampAngleDegrees) {
-    normalizedLampAngle = 0;
-  }
-  else if (currentLampAngle >= maxLampAngleDegrees) {
-    normalizedLampAngle = maxLampAngleDegrees * 2.0;
-  }
-  else {
-    normalizedLampAngle = currentLampAngle + maxLampAngleDegrees;
-  }
+  // Fade across the colors based on color selection angle and across the
+  // lamps based on lamp selection angle.  The angles are advanced to now
+  // here, at the DMX rate, rather than when packets arrive.  Angles beyond
+  // the maximums are treated as the maximums.
+  uint8_t colorIntensities[NUM_COLORS_PER_LAMP];
+  ColorFade::fill(
+    ColorFade::positionFromRange(colorAngle.update(now), -maxColorAngleTenths, maxColorAngleTenths),
+    colorIntensities);
 
-  // Fade across the colors based on color selection angle.
-  int colorSection = floor(normalizedColorAngle / colorAngleStep);
-  // Fix up colorSection if measurement is maxColorAngleDegrees degrees or more.
-  if (colorSection >= NUM_COLORS_PER_LAMP - 1) {
-      colorSection = NUM_COLORS_PER_LAMP - 2;
-  }
-  colorIntensities[colorSection] =
-    map(normalizedColorAngle, colorAngleStep * colorSection, colorAngleStep * (colorSection + 1), 255, 0);
-  colorIntensities[colorSection + 1] =
-    map(normalizedColorAngle, colorAngleStep * colorSection, colorAngleStep * (colorSection + 1), 0, 255);
-
-  // Fade across the lamps based on lamp selection angle.
-  int lampSection = floor(normalizedLampAngle / lampAngleStep);
-  // Fix up lampSection if measurement is maxLampAngleDegrees degrees or more.
-  if (lampSection >= NUM_LAMPS - 1) {
-      lampSection = NUM_LAMPS - 2;
-  }
-  lampIntensities[lampSection] =
-    map(normalizedLampAngle, lampAngleStep * lampSection, lampAngleStep * (lampSection + 1), 255, LAMP_MIN_INTENSITY);
-  lampIntensities[lampSection + 1] =
-    map(normalizedLampAngle, lampAngleStep * lampSection, lampAngleStep * (lampSection + 1), LAMP_MIN_INTENSITY, 255);
+  uint8_t lampIntensities[NUM_LAMPS];
+  LampFade::fill(
+    LampFade::positionFromRange(lampAngle.update(now), -maxLampAngleTenths, maxLampAngleTenths),
+    lampIntensities);
 
   // For each lamp, scale the intensity of its colors by the corresponding color intensity.
   for (uint8_t lampIdx = 0; lampIdx < NUM_LAMPS; ++lampIdx) {
@@ -709,18 +524,70 @@ void updateLamps()
 }
 
 
+#ifdef ENABLE_PACKET_REPLAY
+void replayPacketTrace()
+{
+  // Each replayed packet is reported with a line showing the microseconds
+  // spent dispatching it and updating the lamps, followed by a line with
+  // the resulting DMX channel values.  The lamps are updated as of the
+  // time the packet was originally received.
+
+  static WidgetTraceReader traceReader;
+  static WidgetPacket packet;
+  if (!traceReader.read(Serial, &packet)) {
+    return;
+  }
+
+  uint32_t startUs = micros();
+  widgetRouter.dispatch(packet);
+  uint32_t dispatchUs = micros() - startUs;
+
+  startUs = micros();
+  updateLamps(packet.rxMs);
+  uint32_t updateLampsUs = micros() - startUs;
+
+  Serial.print(F("P "));
+  Serial.print(packet.rxMs);
+  Serial.print(F(" dispatchUs="));
+  Serial.print(dispatchUs);
+  Serial.print(F(" updateLampsUs="));
+  Serial.println(updateLampsUs);
+
+  Serial.print('D');
+  for (uint16_t channelNum = 1; channelNum <= dmxUniverse.numChannels; ++channelNum) {
+    Serial.print(' ');
+    Serial.print(dmxUniverse.getChannel(channelNum));
+  }
+  Serial.println();
+}
+#endif
+
+
 void loop()
 {
+#ifdef ENABLE_PACKET_REPLAY
+  replayPacketTrace();
+#else
   static int32_t lastDmxTxMs;
 
   uint32_t now = millis();
 
   pollRadio();
 
+#ifdef ENABLE_LINK_STATS
+  if (Serial.available()) {
+    while (Serial.available()) {
+      Serial.read();
+    }
+    widgetRouter.printLinkStats(Serial, now);
+  }
+#endif
+
   if (now - lastDmxTxMs >= DMX_TX_INTERVAL_MS) {
     lastDmxTxMs = now;
-    updateLamps();
+    updateLamps(now);
   }
+#endif
 
 #ifdef ENABLE_WATCHDOG
   wdt_reset();
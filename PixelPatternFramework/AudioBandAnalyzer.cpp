@@ -0,0 +1,210 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Audio Band Analyzer Class                                       *
+ *                                                                 *
+ * by Ross Butler   Dec. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include "AudioBandAnalyzer.h"
+#include "AudioSampler.h"
+
+using namespace pixelPattern;
+
+
+// the first half of a 128-point Hann window, 255 sin^2(pi i / 128)
+static const uint8_t hannWindowTable[65] PROGMEM = {
+      0,   0,   1,   1,   2,   4,   5,   7,  10,  12,  15,  18,  21,
+     25,  29,  33,  37,  42,  47,  52,  57,  62,  67,  73,  79,  85,
+     90,  97, 103, 109, 115, 121, 127, 134, 140, 146, 152, 158, 165,
+    170, 176, 182, 188, 193, 198, 203, 208, 213, 218, 222, 226, 230,
+    234, 237, 240, 243, 245, 248, 250, 251, 253, 254, 254, 255, 255,
+};
+
+
+AudioBandAnalyzer::AudioBandAnalyzer(
+    AudioSampler& sampler,
+    const uint16_t* bandFrequenciesHz,
+    uint8_t numBands,
+    uint8_t blockShift,
+    uint16_t blockIntervalMs)
+    : numBlocks(0)
+    , lastBlockUs(0)
+    , maxBlockUs(0)
+    , sampler(sampler)
+    , bandFrequenciesHz(bandFrequenciesHz)
+    , numBands(numBands)
+    , blockShift(blockShift)
+    , blockIntervalMs(blockIntervalMs)
+    , blockIsStarted(false)
+    , blockStartMs(0)
+    , numBlockSamples(0)
+    , blockUs(0)
+{
+    for (uint8_t i = 0; i < maxBands; ++i) {
+        coeffs[i] = 0;
+        bandLevels[i] = 0;
+    }
+}
+
+
+bool AudioBandAnalyzer::begin()
+{
+    uint16_t sampleRateHz = sampler.getSampleRateHz();
+    if (0 == sampleRateHz || 0 == numBands || numBands > maxBands || blockShift < 4 || blockShift > maxBlockShift) {
+        return false;
+    }
+
+    // The coefficient for a band is 2 cos(2 pi f / sampleRate).
+    for (uint8_t i = 0; i < numBands; ++i) {
+        if (bandFrequenciesHz[i] >= sampleRateHz / 2) {
+            return false;
+        }
+        float w = 2.0 * PI * bandFrequenciesHz[i] / sampleRateHz;
+        coeffs[i] = lround(2.0 * cos(w) * (1 << coeffShift));
+        bandLevels[i] = 0;
+    }
+
+    blockIsStarted = false;
+    blockStartMs = millis() - blockIntervalMs;
+
+    return true;
+}
+
+
+void AudioBandAnalyzer::startBlock(uint32_t nowMs)
+{
+    // Start with fresh samples rather than ones left from between blocks.
+    sampler.discardSamples();
+
+    for (uint8_t i = 0; i < numBands; ++i) {
+        s1[i] = 0;
+        s2[i] = 0;
+    }
+    numBlockSamples = 0;
+    blockUs = 0;
+    blockStartMs = nowMs;
+    blockIsStarted = true;
+}
+
+
+bool AudioBandAnalyzer::update(uint32_t nowMs)
+{
+    if (!blockIsStarted) {
+        if (nowMs - blockStartMs < blockIntervalMs) {
+            // Keep the ring buffer from overrunning while we aren't
+            // listening.
+            sampler.discardSamples();
+            return false;
+        }
+        startBlock(nowMs);
+    }
+
+    uint32_t startUs = micros();
+    uint16_t blockSize = 1 << blockShift;
+
+    // The samples are filtered a few at a time, band by band, so that
+    // each band's states stay in registers.  They are windowed first so
+    // that a loud tone doesn't leak into bands far from it.  Both
+    // multiplies are rounded, because truncating them adds a small
+    // negative offset to every sample that shows up in the low bands.
+    constexpr uint8_t maxSamplesPerRead = 16;
+    int16_t samples[maxSamplesPerRead];
+    while (numBlockSamples < blockSize) {
+        uint16_t numWanted = blockSize - numBlockSamples;
+        uint8_t n = sampler.readSamples(samples, numWanted < maxSamplesPerRead ? numWanted : maxSamplesPerRead);
+        if (0 == n) {
+            break;
+        }
+
+        for (uint8_t i = 0; i < n; ++i) {
+            uint8_t windowIdx = (numBlockSamples + i) << (maxBlockShift - blockShift);
+            uint8_t weight = pgm_read_byte(&hannWindowTable[windowIdx <= 64 ? windowIdx : 128 - windowIdx]);
+            samples[i] = ((int32_t) samples[i] * weight + (1 << (7 + inputShift))) >> (8 + inputShift);
+        }
+
+        for (uint8_t b = 0; b < numBands; ++b) {
+            int32_t coeff = coeffs[b];
+            int32_t q1 = s1[b];
+            int32_t q2 = s2[b];
+            for (uint8_t i = 0; i < n; ++i) {
+                int32_t q0 = samples[i] + ((coeff * q1 + (1 << (coeffShift - 1))) >> coeffShift) - q2;
+                q2 = q1;
+                q1 = q0;
+            }
+            s1[b] = q1;
+            s2[b] = q2;
+        }
+
+        numBlockSamples += n;
+    }
+
+    blockUs += micros() - startUs;
+
+    if (numBlockSamples < blockSize) {
+        return false;
+    }
+
+    finishBlock();
+    return true;
+}
+
+
+void AudioBandAnalyzer::finishBlock()
+{
+    // The squared magnitude of a band's DFT term is s1^2 + s2^2 - coeff
+    // s1 s2.  Its amplitude in ADC counts is 4 / blockSize times the
+    // magnitude (the window halves it), undoing the input scaling.
+    uint8_t amplitudeShift = 2 * (blockShift - 2 - inputShift);
+    for (uint8_t b = 0; b < numBands; ++b) {
+        int64_t power = (int64_t) s1[b] * s1[b] + (int64_t) s2[b] * s2[b]
+                      - ((int64_t) coeffs[b] * s1[b] * s2[b] >> coeffShift);
+        int64_t amplitudeSquared = power > 0 ? power >> amplitudeShift : 0;
+        bandLevels[b] = levelFromAmplitudeSquared(amplitudeSquared < UINT32_MAX ? amplitudeSquared : UINT32_MAX);
+    }
+
+    lastBlockUs = blockUs < UINT16_MAX ? blockUs : UINT16_MAX;
+    if (lastBlockUs > maxBlockUs) {
+        maxBlockUs = lastBlockUs;
+    }
+    ++numBlocks;
+    blockIsStarted = false;
+}
+
+
+uint8_t AudioBandAnalyzer::levelFromAmplitudeSquared(uint32_t amplitudeSquared)
+{
+    // 32 log2(amplitude) is 16 log2(amplitude^2), which is 16 times the
+    // index of the top bit plus the next four bits as the fraction.
+    if (amplitudeSquared < 2) {
+        return 0;
+    }
+
+    uint8_t topBit = 0;
+    for (uint32_t v = amplitudeSquared; v > 1; v >>= 1) {
+        ++topBit;
+    }
+    uint8_t fraction = (topBit >= 4 ? amplitudeSquared >> (topBit - 4) : amplitudeSquared << (4 - topBit)) & 0x0f;
+
+    uint16_t level = topBit * 16 + fraction;
+    return level < 255 ? level : 255;
+}
+
+
+void AudioBandAnalyzer::printStats(Print& out) const
+{
+    out.print(F("blocks="));
+    out.print(numBlocks);
+    out.print(F(" lastBlockUs="));
+    out.print(lastBlockUs);
+    out.print(F(" maxBlockUs="));
+    out.print(maxBlockUs);
+    out.print(F(" levels="));
+    for (uint8_t b = 0; b < numBands; ++b) {
+        out.print(bandLevels[b]);
+        out.print(b + 1 < numBands ? ',' : '\n');
+    }
+}
@@ -0,0 +1,112 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Audio Band Analyzer Class                                       *
+ *                                                                 *
+ * by Ross Butler   Dec. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __AUDIO_BAND_ANALYZER_H
+#define __AUDIO_BAND_ANALYZER_H
+
+#include <stdint.h>
+
+class Print;
+
+
+namespace pixelPattern {
+
+class AudioSampler;
+
+// Measures the sound level in a few frequency bands with one fixed-point
+// Goertzel filter per band, which is much cheaper than an FFT when there
+// are only a handful of bands.  The samples come from an AudioSampler's
+// ring buffer and are Hann windowed.
+//
+// A block of 2^blockShift samples is analyzed every blockIntervalMs, and
+// the samples between blocks are skipped so that the analysis only takes
+// a fraction of the CPU.  update() filters whatever samples have arrived,
+// so the work is spread across the loops while a block comes in.  Call it
+// every time through loop, and call it more often than the sampler's
+// ring buffer fills.
+//
+// Each band's level is 32 * log2 of its amplitude in ADC counts, so 32
+// steps is 6 dB, and it tops out at 255 (an amplitude of about 250
+// counts).  Each band is about 2 sampleRate / 2^blockShift wide (300 Hz
+// for 64 samples at 9615 samples per second), so band frequencies should
+// be about that far apart and from zero.  Goertzel states grow fastest
+// for low frequencies, so blockShift can be at most 7 and the lowest band
+// should be at least 75 Hz at 9615 samples per second.
+class AudioBandAnalyzer {
+
+public:
+
+    static constexpr uint8_t maxBands = 16;
+    static constexpr uint8_t maxBlockShift = 7;
+
+    AudioBandAnalyzer(
+        AudioSampler& sampler,
+        const uint16_t* bandFrequenciesHz,
+        uint8_t numBands,
+        uint8_t blockShift,
+        uint16_t blockIntervalMs);
+
+    ~AudioBandAnalyzer() {}
+
+    AudioBandAnalyzer(const AudioBandAnalyzer&) = delete;
+    AudioBandAnalyzer& operator =(const AudioBandAnalyzer&) = delete;
+
+    // Works out the filter coefficients.  Call it after the sampler's
+    // begin().  Returns false if the sampler isn't running or the
+    // parameters are out of range.
+    bool begin();
+
+    uint8_t getBandLevel(uint8_t band) const { return bandLevels[band]; }
+    uint8_t getNumBands() const { return numBands; }
+
+    // Writes the number of blocks analyzed and how long the last and
+    // slowest blocks took, summed across their update() calls.
+    void printStats(Print& out) const;
+
+    // Filters the samples that have arrived.  Returns true if a block was
+    // finished and the band levels were updated.
+    bool update(uint32_t nowMs);
+
+    uint32_t numBlocks;
+    uint16_t lastBlockUs;
+    uint16_t maxBlockUs;
+
+private:
+
+    // Input samples are scaled down by 2^inputShift, and the coefficients
+    // are Q12, so that the states can't overflow.
+    static constexpr uint8_t inputShift = 2;
+    static constexpr uint8_t coeffShift = 12;
+
+    static uint8_t levelFromAmplitudeSquared(uint32_t amplitudeSquared);
+
+    void finishBlock();
+    void startBlock(uint32_t nowMs);
+
+    AudioSampler& sampler;
+    const uint16_t* bandFrequenciesHz;
+    uint8_t numBands;
+    uint8_t blockShift;
+    uint16_t blockIntervalMs;
+
+    bool blockIsStarted;
+    uint32_t blockStartMs;
+    uint16_t numBlockSamples;
+    uint32_t blockUs;
+
+    int16_t coeffs[maxBands];
+    int32_t s1[maxBands];
+    int32_t s2[maxBands];
+    uint8_t bandLevels[maxBands];
+};
+
+}
+
+#endif  // #ifndef __AUDIO_BAND_ANALYZER_H
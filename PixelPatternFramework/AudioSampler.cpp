@@ -0,0 +1,206 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Free-Running ADC Audio Sampler Class                            *
+ *                                                                 *
+ * by Ross Butler   Dec. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include "AudioSampler.h"
+#include "mathHelpers.h"
+
+using namespace pixelPattern;
+
+
+AudioSampler::AudioSampler(uint8_t windowShift, uint8_t bufferSize)
+    : numWindows(0)
+    , numMissedWindows(0)
+    , numOverruns(0)
+    , windowShift(windowShift < maxWindowShift ? windowShift : maxWindowShift)
+    , bufferSize(bufferSize)
+    , buffer(nullptr)
+    , sampleRateHz(0)
+    , peakToPeak(0)
+    , rms(0)
+    , envelope(0)
+    , writeIdx(0)
+    , numUnread(0)
+    , isDcPrimed(false)
+    , dcScaled(0)
+    , windowMin(UINT16_MAX)
+    , windowMax(0)
+    , windowSumSquares(0)
+    , windowNumSamples(0)
+    , windowIsReady(false)
+    , readyPeakToPeak(0)
+    , readySumSquares(0)
+{
+}
+
+
+AudioSampler::~AudioSampler()
+{
+    end();
+    delete[] buffer;
+}
+
+
+bool AudioSampler::begin(uint8_t pin)
+{
+    if (bufferSize > 0) {
+        delete[] buffer;
+        buffer = new int16_t[bufferSize];
+        if (0 == buffer) {
+            return false;
+        }
+    }
+
+#ifdef ADCSRA
+    // Analog pins can be given as A0 or as 0.
+    uint8_t channel = pin >= A0 ? pin - A0 : pin;
+
+    // The ADC clock is the CPU clock / 128, and a conversion takes 13 ADC
+    // clocks.  AVcc is the reference, as with analogRead().  The pin's
+    // digital input buffer is turned off to keep it from adding noise.
+    ADCSRA = 0;
+    ADMUX = bit(REFS0) | (channel & 0x07);
+    ADCSRB = 0;
+#ifdef DIDR0
+    if (channel < 6) {
+        DIDR0 |= bit(channel);
+    }
+#endif
+    ADCSRA = bit(ADEN) | bit(ADSC) | bit(ADATE) | bit(ADIE) | bit(ADPS2) | bit(ADPS1) | bit(ADPS0);
+    sampleRateHz = F_CPU / 128 / 13;
+    return true;
+#else
+    (void) pin;
+    return false;
+#endif
+}
+
+
+void AudioSampler::discardSamples()
+{
+    numUnread = 0;
+}
+
+
+void AudioSampler::end()
+{
+#ifdef ADCSRA
+    ADCSRA &= ~(bit(ADATE) | bit(ADIE));
+#endif
+}
+
+
+void AudioSampler::addSample(uint16_t sample)
+{
+    if (!isDcPrimed) {
+        isDcPrimed = true;
+        dcScaled = (int32_t) sample << dcShift;
+    }
+    dcScaled += (int32_t) sample - (dcScaled >> dcShift);
+    int16_t ac = (int16_t) sample - (int16_t) (dcScaled >> dcShift);
+
+    if (0 != buffer) {
+        buffer[writeIdx & (bufferSize - 1)] = ac;
+        writeIdx = writeIdx + 1;
+        if (numUnread < bufferSize) {
+            numUnread = numUnread + 1;
+        }
+        else {
+            numOverruns = numOverruns + 1;
+        }
+    }
+
+    if (sample < windowMin) {
+        windowMin = sample;
+    }
+    if (sample > windowMax) {
+        windowMax = sample;
+    }
+    windowSumSquares += (int32_t) ac * ac;
+
+    if (++windowNumSamples >> windowShift) {
+        if (windowIsReady) {
+            ++numMissedWindows;
+        }
+        readyPeakToPeak = windowMax - windowMin;
+        readySumSquares = windowSumSquares;
+        windowIsReady = true;
+
+        windowMin = UINT16_MAX;
+        windowMax = 0;
+        windowSumSquares = 0;
+        windowNumSamples = 0;
+    }
+}
+
+
+bool AudioSampler::update()
+{
+    if (!windowIsReady) {
+        return false;
+    }
+
+    noInterrupts();
+    uint16_t pp = readyPeakToPeak;
+    uint32_t sumSquares = readySumSquares;
+    windowIsReady = false;
+    interrupts();
+
+    peakToPeak = pp;
+    rms = isqrt32(sumSquares >> windowShift);
+    if (pp >= envelope) {
+        envelope = pp;
+    }
+    else {
+        envelope -= (envelope - pp + (1 << envelopeReleaseShift) - 1) >> envelopeReleaseShift;
+    }
+    ++numWindows;
+
+    return true;
+}
+
+
+uint8_t AudioSampler::readSamples(int16_t* dest, uint8_t maxSamples)
+{
+    if (0 == buffer) {
+        return 0;
+    }
+
+    // The samples are claimed with interrupts off and copied with them
+    // on.  When the buffer is full, the oldest of them might be
+    // overwritten during the copy.
+    noInterrupts();
+    uint8_t n = numUnread < maxSamples ? numUnread : maxSamples;
+    uint8_t idx = writeIdx - numUnread;
+    numUnread = numUnread - n;
+    interrupts();
+
+    for (uint8_t i = 0; i < n; ++i) {
+        dest[i] = buffer[idx++ & (bufferSize - 1)];
+    }
+    return n;
+}
+
+
+void AudioSampler::printStats(Print& out) const
+{
+    out.print(F("windows="));
+    out.print(numWindows);
+    out.print(F(" missedWindows="));
+    out.print(numMissedWindows);
+    out.print(F(" overruns="));
+    out.print(numOverruns);
+    out.print(F(" pp="));
+    out.print(peakToPeak);
+    out.print(F(" rms="));
+    out.print(rms);
+    out.print(F(" envelope="));
+    out.println(envelope);
+}
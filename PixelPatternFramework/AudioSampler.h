@@ -0,0 +1,127 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Free-Running ADC Audio Sampler Class                            *
+ *                                                                 *
+ * by Ross Butler   Dec. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __AUDIO_SAMPLER_H
+#define __AUDIO_SAMPLER_H
+
+#include <stdint.h>
+
+class Print;
+
+
+namespace pixelPattern {
+
+// Samples a microphone at a fixed rate with the ADC free-running, so the
+// sound level doesn't depend on what else the loop is doing.  The sketch
+// routes the ADC interrupt to the sampler:
+//
+//   ISR(ADC_vect) { audioSampler.addSample(ADC); }
+//
+// Samples are grouped into windows of 2^windowShift samples, where
+// windowShift is at most maxWindowShift (4096 samples, 426 ms).  Each
+// sample's min, max, and square are accumulated as it arrives, so the
+// work at the end of a window is small.  update() picks up each finished
+// window's peak-to-peak and RMS levels and follows the peak-to-peak level
+// with an envelope that rises at once and falls over a few windows.  The
+// RMS level is taken after removing the microphone's DC bias.
+//
+// With a ring buffer (bufferSize > 0), each sample, less the DC bias, is
+// also kept for readSamples(), which returns the ones that arrived since
+// its last call.  bufferSize must be a power of two no bigger than 128.
+// If readSamples() isn't called often enough, the oldest samples are
+// overwritten and counted as overruns.
+//
+// Only AVR ADCs are supported.  analogRead() can't be used while the
+// sampler is running.
+class AudioSampler {
+
+public:
+
+    // The DC bias is tracked with an exponential moving average over about
+    // 2^dcShift samples.  The envelope falls 1/2^envelopeReleaseShift of
+    // the way to the current level each window.
+    static constexpr uint8_t dcShift = 10;
+    static constexpr uint8_t envelopeReleaseShift = 3;
+
+    // A window's sum of squares has to fit in 32 bits even when every
+    // sample is 1023 away from the DC bias.  A larger windowShift is
+    // treated as maxWindowShift.
+    static constexpr uint8_t maxWindowShift = 12;
+
+    AudioSampler(uint8_t windowShift, uint8_t bufferSize);
+
+    ~AudioSampler();
+
+    AudioSampler(const AudioSampler&) = delete;
+    AudioSampler& operator =(const AudioSampler&) = delete;
+
+    // Call it from the ADC interrupt with each conversion result.
+    void addSample(uint16_t sample);
+
+    // Allocates the ring buffer and starts the ADC converting pin
+    // continuously, at 9615 Hz with a 16 MHz clock.  Returns false if the
+    // buffer couldn't be allocated or the board isn't supported.
+    bool begin(uint8_t pin);
+
+    // Drops the samples waiting in the ring buffer, such as when a reader
+    // only wants some of them.
+    void discardSamples();
+
+    // Stops sampling so that analogRead() works again.
+    void end();
+
+    uint16_t getEnvelope() const { return envelope; }
+    uint16_t getPeakToPeak() const { return peakToPeak; }
+    uint16_t getRms() const { return rms; }
+    uint16_t getSampleRateHz() const { return sampleRateHz; }
+
+    void printStats(Print& out) const;
+
+    // Copies up to maxSamples of the samples that arrived since the last
+    // call to dest, oldest first.  Returns the number copied.
+    uint8_t readSamples(int16_t* dest, uint8_t maxSamples);
+
+    // Updates the levels if a window has finished since the last call.
+    // Returns true if they were updated.  Call this every time through
+    // loop.
+    bool update();
+
+    uint32_t numWindows;
+    volatile uint16_t numMissedWindows;     // finished before update() got the previous one
+    volatile uint16_t numOverruns;          // ring buffer samples overwritten before being read
+
+private:
+
+    uint8_t windowShift;
+    uint8_t bufferSize;
+    int16_t* buffer;
+    uint16_t sampleRateHz;
+
+    uint16_t peakToPeak;
+    uint16_t rms;
+    uint16_t envelope;
+
+    // written by the interrupt
+    volatile uint8_t writeIdx;
+    volatile uint8_t numUnread;
+    bool isDcPrimed;
+    int32_t dcScaled;
+    uint16_t windowMin;
+    uint16_t windowMax;
+    uint32_t windowSumSquares;
+    uint16_t windowNumSamples;
+    volatile bool windowIsReady;
+    volatile uint16_t readyPeakToPeak;
+    volatile uint32_t readySumSquares;
+};
+
+}
+
+#endif  // #ifndef __AUDIO_SAMPLER_H
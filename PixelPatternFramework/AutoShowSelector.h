@@ -37,7 +37,6 @@ protected:
 private:
 
     unsigned long nextPatternChangeMs;
-    uint8_t patternNum;
 };
 
 }
@@ -55,7 +55,8 @@ bool Blocks::initPattern(bool configIsInFlash, void* patternConfig)
          i < pixelSet->numSymmetricalPixels;
          pixelSet->pixels[i++].nscale8_video(pixelSet->backgroundIntensityScaleFactor));
 
-    nextUpdateMs = millis() + (config.delayMs > 0 ? config.delayMs : nonRotationalRefreshIntervalMs);
+    // We need update() to be called as soon as possible.
+    nextUpdateMs = millis() - 1;
 
     return true;
 }
@@ -0,0 +1,118 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Fixed-Point MPU6050 DMP Motion Calculations                     *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include "DmpMotion.h"
+#include "mathHelpers.h"
+
+using namespace pixelPattern;
+
+
+namespace pixelPattern {
+
+// atan(i / 32) in hundredths of a degree, for i = 0 to 32
+static const uint16_t atanHundredthsTable[33] PROGMEM = {
+       0,  179,  358,  536,  713,  888, 1062, 1234,
+    1404, 1571, 1735, 1897, 2056, 2211, 2363, 2511,
+    2657, 2798, 2936, 3070, 3201, 3327, 3451, 3571,
+    3687, 3800, 3909, 4016, 4119, 4218, 4315, 4409,
+    4500
+};
+
+static int16_t getBigEndianInt16(const uint8_t* p)
+{
+    return (int16_t) ((uint16_t) p[0] << 8 | p[1]);
+}
+
+
+int16_t atan2Tenths(int32_t y, int32_t x)
+{
+    uint32_t absY = y < 0 ? 0 - (uint32_t) y : y;
+    uint32_t absX = x < 0 ? 0 - (uint32_t) x : x;
+    if (0 == absX && 0 == absY) {
+        return 0;
+    }
+
+    // Work out the angle in the first octant from the ratio of the smaller
+    // to the larger magnitude, then unfold it into the right octant.
+    bool isSteep = absY > absX;
+    uint32_t minMag = isSteep ? absX : absY;
+    uint32_t maxMag = isSteep ? absY : absX;
+    while (maxMag > 0xffff) {
+        maxMag >>= 1;
+        minMag >>= 1;
+    }
+
+    // ratio is Q15 so that 32768 = 1.0, and each table step is 1024.
+    uint16_t ratio = (minMag << 15) / maxMag;
+    uint8_t i = ratio >> 10;
+    uint16_t frac = ratio & 0x3ff;
+    int32_t angle = pgm_read_word(&atanHundredthsTable[i]);
+    if (frac != 0) {
+        int32_t next = pgm_read_word(&atanHundredthsTable[i + 1]);
+        angle += ((next - angle) * frac + 512) >> 10;
+    }
+
+    if (isSteep) {
+        angle = 9000 - angle;
+    }
+    if (x < 0) {
+        angle = 18000 - angle;
+    }
+    if (y < 0) {
+        angle = -angle;
+    }
+
+    return angle >= 0 ? (angle + 5) / 10 : (angle - 5) / 10;
+}
+
+
+void getDmpMotion(const uint8_t* packet, DmpMotion* motion)
+{
+    // The quaternion components are Q30, but the high halves are plenty.
+    for (uint8_t i = 0; i < 4; ++i) {
+        motion->quat[i] = getBigEndianInt16(packet + i * 4);
+    }
+    for (uint8_t i = 0; i < 3; ++i) {
+        motion->gyro[i] = getBigEndianInt16(packet + 16 + i * 4);
+        motion->accel[i] = getBigEndianInt16(packet + 28 + i * 4);
+    }
+
+    int32_t w = motion->quat[0];
+    int32_t x = motion->quat[1];
+    int32_t y = motion->quat[2];
+    int32_t z = motion->quat[3];
+
+    // Products of Q14 values are Q28.
+    int32_t gx = 2 * (x * z - w * y);
+    int32_t gy = 2 * (w * x + y * z);
+    int32_t gz = w * w - x * x - y * y + z * z;
+    motion->gravity[0] = gx >> 14;
+    motion->gravity[1] = gy >> 14;
+    motion->gravity[2] = gz >> 14;
+
+    motion->yprTenths[0] = atan2Tenths(2 * (x * y - w * z), 2 * (w * w + x * x) - (1L << 28));
+
+    // atan(a / sqrt(b^2 + c^2)) is atan2(a, sqrt(b^2 + c^2)) because the
+    // square root is never negative.  The Q14 gravity components keep the
+    // sum of squares within 32 bits.
+    int32_t gx14 = motion->gravity[0];
+    int32_t gy14 = motion->gravity[1];
+    int32_t gz14 = motion->gravity[2];
+    motion->yprTenths[1] = atan2Tenths(gx14, isqrt32(gy14 * gy14 + gz14 * gz14));
+    motion->yprTenths[2] = atan2Tenths(gy14, isqrt32(gx14 * gx14 + gz14 * gz14));
+
+    // +1 g is 8192 counts, and 1.0 is 16384 in Q14.
+    for (uint8_t i = 0; i < 3; ++i) {
+        motion->linearAccel[i] = motion->accel[i] - (motion->gravity[i] >> 1);
+    }
+}
+
+}
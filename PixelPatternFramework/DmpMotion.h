@@ -0,0 +1,42 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Fixed-Point MPU6050 DMP Motion Calculations                     *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __DMP_MOTION_H
+#define __DMP_MOTION_H
+
+#include <stdint.h>
+
+
+namespace pixelPattern {
+
+// Orientation and motion from one MotionApps 2.0 DMP FIFO packet.  These
+// are the same values that dmpGetQuaternion, dmpGetGravity,
+// dmpGetYawPitchRoll, dmpGetAccel, dmpGetLinearAccel, and dmpGetGyro
+// produce, but calculated with integer math so that keeping up with the
+// DMP doesn't take most of an ATmega328's time.
+struct DmpMotion {
+    int16_t quat[4];            // w, x, y, z, Q14 (16384 = 1.0)
+    int16_t gravity[3];         // x, y, z, Q14
+    int16_t yprTenths[3];       // yaw, pitch, roll in tenths of a degree
+    int16_t accel[3];           // x, y, z, 8192 counts per g
+    int16_t linearAccel[3];     // accel without gravity
+    int16_t gyro[3];            // x, y, z
+};
+
+// Fills in motion from a DMP packet.  Yaw, pitch, and roll are within
+// 0.1 degree of the float library's results.
+void getDmpMotion(const uint8_t* packet, DmpMotion* motion);
+
+// Returns atan2(y, x) in tenths of a degree, -1800 to 1800.
+int16_t atan2Tenths(int32_t y, int32_t x);
+
+}
+
+#endif  // #ifndef __DMP_MOTION_H
@@ -0,0 +1,176 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * DMX Universe Class                                              *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include "DmxUniverse.h"
+#ifndef ESP8266
+#include "DmxSimple.h"
+#endif
+
+using namespace pixelPattern;
+
+
+DmxUniverse::DmxUniverse(uint16_t numChannels)
+    : numChannels(numChannels)
+    , numFixtures(0)
+    , isDirty(false)
+    , nextFixtureChannel(1)
+{
+    channelValues = new uint8_t[numChannels];
+    dirtyBits = new uint8_t[(numChannels + 7) / 8];
+    memset(channelValues, 0, numChannels);
+    memset(dirtyBits, 0, (numChannels + 7) / 8);
+}
+
+
+DmxUniverse::~DmxUniverse()
+{
+    delete[] channelValues;
+    delete[] dirtyBits;
+}
+
+
+void DmxUniverse::init(uint8_t outputPin)
+{
+    // Every channel gets written by the first commit so that
+    // DmxSimple and the fixtures start out with our values.
+
+#ifndef ESP8266
+    DmxSimple.usePin(outputPin);
+    DmxSimple.maxChannel(numChannels);
+#endif
+
+    memset(dirtyBits, 0xff, (numChannels + 7) / 8);
+    isDirty = true;
+}
+
+
+uint8_t DmxUniverse::getFixtureNumChannels(FixtureType fixtureType)
+{
+    return FixtureType::rgb == fixtureType ? 3 : 4;
+}
+
+
+uint8_t DmxUniverse::addFixture(FixtureType fixtureType, uint16_t startChannel)
+{
+    // Adds a fixture starting at startChannel, or just after the previously
+    // added fixture if startChannel is 0.  Returns the fixture index, or
+    // 255 if there are too many fixtures or the fixture doesn't fit.
+
+    if (0 == startChannel) {
+        startChannel = nextFixtureChannel;
+    }
+
+    uint8_t fixtureNumChannels = getFixtureNumChannels(fixtureType);
+    if (numFixtures >= maxFixtures || startChannel + fixtureNumChannels - 1 > numChannels) {
+        return 255;
+    }
+
+    Fixture& fixture = fixtures[numFixtures];
+    fixture.type = fixtureType;
+    fixture.startChannel = startChannel;
+    nextFixtureChannel = startChannel + fixtureNumChannels;
+
+    return numFixtures++;
+}
+
+
+uint8_t DmxUniverse::getChannel(uint16_t channelNum)
+{
+    return channelNum >= 1 && channelNum <= numChannels ? channelValues[channelNum - 1] : 0;
+}
+
+
+void DmxUniverse::setChannel(uint16_t channelNum, uint8_t value)
+{
+    if (channelNum < 1 || channelNum > numChannels) {
+        return;
+    }
+
+    uint16_t i = channelNum - 1;
+    if (channelValues[i] != value) {
+        channelValues[i] = value;
+        dirtyBits[i / 8] |= 1 << (i % 8);
+        isDirty = true;
+    }
+}
+
+
+void DmxUniverse::setFixtureDimmer(uint8_t fixtureIdx, uint8_t level)
+{
+    // Only dimmer+RGB fixtures have a dimmer channel.
+
+    if (fixtureIdx < numFixtures && FixtureType::dimmerRgb == fixtures[fixtureIdx].type) {
+        setChannel(fixtures[fixtureIdx].startChannel, level);
+    }
+}
+
+
+void DmxUniverse::setFixtureRgb(uint8_t fixtureIdx, uint8_t r, uint8_t g, uint8_t b)
+{
+    if (fixtureIdx >= numFixtures) {
+        return;
+    }
+
+    const Fixture& fixture = fixtures[fixtureIdx];
+    uint16_t ch = fixture.startChannel;
+    if (FixtureType::dimmerRgb == fixture.type) {
+        ++ch;
+    }
+    setChannel(ch, r);
+    setChannel(ch + 1, g);
+    setChannel(ch + 2, b);
+
+    // The unused channel of an rgbSkipFourth fixture is left at zero.
+}
+
+
+void DmxUniverse::setFixtureRgbw(uint8_t fixtureIdx, uint8_t r, uint8_t g, uint8_t b, uint8_t w)
+{
+    setFixtureRgb(fixtureIdx, r, g, b);
+    if (fixtureIdx < numFixtures && FixtureType::rgbw == fixtures[fixtureIdx].type) {
+        setChannel(fixtures[fixtureIdx].startChannel + 3, w);
+    }
+}
+
+
+uint16_t DmxUniverse::commit()
+{
+    // Writes the channels that have changed since the last commit to
+    // DmxSimple, skipping eight clean channels at a time.  Returns the
+    // number of channels written.
+
+    if (!isDirty) {
+        return 0;
+    }
+
+    uint16_t numWritten = 0;
+    for (uint16_t byteIdx = 0; byteIdx < (numChannels + 7) / 8; ++byteIdx) {
+        uint8_t bits = dirtyBits[byteIdx];
+        if (0 == bits) {
+            continue;
+        }
+        dirtyBits[byteIdx] = 0;
+        for (uint8_t bit = 0; bit < 8; ++bit) {
+            if (bits & (1 << bit)) {
+                uint16_t i = byteIdx * 8 + bit;
+                if (i < numChannels) {
+#ifndef ESP8266
+                    DmxSimple.write(i + 1, channelValues[i]);
+#endif
+                    ++numWritten;
+                }
+            }
+        }
+    }
+
+    isDirty = false;
+    return numWritten;
+}
@@ -0,0 +1,78 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * DMX Universe Class                                              *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __DMX_UNIVERSE_H
+#define __DMX_UNIVERSE_H
+
+#include <stdint.h>
+
+
+namespace pixelPattern {
+
+// Holds the channel values for a DMX universe sent with DmxSimple.  The
+// channel values are set directly or by way of fixtures that map colors
+// to consecutive channels.  Only the channels whose values have changed
+// since the last commit() are written to DmxSimple, which keeps sending
+// the values it already has.
+//
+// Channel numbers are 1-based, the same as DmxSimple's.
+class DmxUniverse {
+
+public:
+
+    enum class FixtureType {
+        rgb,                // red, green, blue
+        rgbw,               // red, green, blue, white
+        dimmerRgb,          // dimmer (or strobe/control), red, green, blue
+        rgbSkipFourth       // red, green, blue, unused (one RGB lamp per four-channel dimmer)
+    };
+
+    static constexpr uint8_t maxFixtures = 16;
+
+    DmxUniverse(uint16_t numChannels);
+
+    virtual ~DmxUniverse();
+
+    DmxUniverse(const DmxUniverse&) = delete;
+    DmxUniverse& operator =(const DmxUniverse&) = delete;
+
+    uint8_t addFixture(FixtureType fixtureType, uint16_t startChannel = 0);
+    uint16_t commit();
+    uint8_t getChannel(uint16_t channelNum);
+    void init(uint8_t outputPin);
+    void setChannel(uint16_t channelNum, uint8_t value);
+    void setFixtureDimmer(uint8_t fixtureIdx, uint8_t level);
+    void setFixtureRgb(uint8_t fixtureIdx, uint8_t r, uint8_t g, uint8_t b);
+    void setFixtureRgbw(uint8_t fixtureIdx, uint8_t r, uint8_t g, uint8_t b, uint8_t w);
+
+    uint16_t numChannels;
+    uint8_t numFixtures;
+
+protected:
+
+private:
+
+    struct Fixture {
+        FixtureType type;
+        uint16_t startChannel;
+    };
+
+    static uint8_t getFixtureNumChannels(FixtureType fixtureType);
+
+    uint8_t* channelValues;
+    uint8_t* dirtyBits;
+    bool isDirty;
+    uint16_t nextFixtureChannel;
+    Fixture fixtures[maxFixtures];
+};
+
+}
+
+#endif  // #ifndef __DMX_UNIVERSE_H
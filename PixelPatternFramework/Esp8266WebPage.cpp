@@ -13,15 +13,28 @@
 #include <Arduino.h>
 #include "Esp8266WebPage.h"
 #include <ESP8266WiFi.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdarg.h>
+#include "Esp8266WebUiAssets.h"
 #include "ExternalControlSelector.h"
 #include "PatternSequence.h"
+#include "PixelPatternController.h"
 
 using namespace pixelPattern;
 
 
 Esp8266WebPage::Esp8266WebPage()
+    : apiBufLen(0)
+    , nextConnectionIdx(0)
+    , patternController(nullptr)
+    , timeBudgetUs(defaultTimeBudgetMs * 1000)
 {
   wiFiServer = new WiFiServer(80);
+
+  for (uint8_t i = 0; i < maxConnections; ++i) {
+    connections[i].state = ConnectionState::unused;
+  }
 }
 
 
@@ -33,7 +46,11 @@ Esp8266WebPage::~Esp8266WebPage()
 
 void Esp8266WebPage::addPatternSequence(PatternSequence* patternSequence)
 {
-    patternSequences.emplace_back(patternSequence);
+    // The controller can't run more sequences than this, and it bounds
+    // the per-request selection array in selectPatterns().
+    if (patternSequences.size() < maxPatternSequences) {
+        patternSequences.emplace_back(patternSequence);
+    }
 }
 
 
@@ -68,25 +85,512 @@ bool Esp8266WebPage::doWiFi()
 
   checkWiFiStaConnected();
 
-  // Check if a client has connected
-  WiFiClient client = wiFiServer->available();
-  if (client) {
-    patternSelectionChanged = handleClientRequest(client);
+  acceptConnections();
+
+  // Service the connections round-robin, starting after the one serviced
+  // last time, until each has had a turn or the time budget is used up.
+  // Whatever doesn't get a turn now will be first in line next time.
+  uint32_t startUs = micros();
+  for (uint8_t n = 0; n < maxConnections; ++n) {
+    Connection& conn = connections[nextConnectionIdx];
+    nextConnectionIdx = (nextConnectionIdx + 1) % maxConnections;
+    if (ConnectionState::unused != conn.state) {
+      patternSelectionChanged |= serviceConnection(conn);
+      if (micros() - startUs >= timeBudgetUs) {
+        break;
+      }
+    }
   }
 
   return patternSelectionChanged;
 }
 
 
-bool Esp8266WebPage::handleClientRequest(WiFiClient& client)
+void Esp8266WebPage::acceptConnections()
+{
+  // Take as many new clients as we have room for.  Any others
+  // stay queued in the TCP stack until a connection is free.
+
+  for (uint8_t i = 0; i < maxConnections; ++i) {
+    Connection& conn = connections[i];
+    if (ConnectionState::unused != conn.state) {
+      continue;
+    }
+    conn.client = wiFiServer->available();
+    if (!conn.client) {
+      return;
+    }
+    conn.state = ConnectionState::readingRequestLine;
+    conn.startMs = millis();
+    conn.reqLineLength = 0;
+    conn.headerLineLength = 0;
+    conn.etagMatches = false;
+  }
+}
+
+
+void Esp8266WebPage::closeConnection(Connection& conn)
+{
+  conn.client.stop();
+  conn.state = ConnectionState::unused;
+}
+
+
+bool Esp8266WebPage::serviceConnection(Connection& conn)
+{
+  // Parses whatever part of the request has arrived, without waiting
+  // for more, and sends the response once the headers are complete.
+  // Returns true if the request changed the pattern selection.
+
+  char buf[64];
+
+  while (conn.client.available() > 0) {
+    int n = conn.client.read((uint8_t*) buf, sizeof(buf));
+    if (n <= 0) {
+      break;
+    }
+
+    for (int i = 0; i < n; ++i) {
+      char c = buf[i];
+
+      if (ConnectionState::readingRequestLine == conn.state) {
+        if (c == '\n') {
+          if (conn.reqLineLength > 0 && conn.reqLine[conn.reqLineLength - 1] == '\r') {
+            --conn.reqLineLength;
+          }
+          conn.reqLine[conn.reqLineLength] = 0;
+          conn.state = ConnectionState::readingHeaders;
+        }
+        else if (conn.reqLineLength < maxRequestLineLength) {
+          conn.reqLine[conn.reqLineLength++] = c;
+        }
+        continue;
+      }
+
+      // We're reading the headers.  We only care about If-None-Match, which
+      // tells us if the browser's cached copy of the UI page can be reused.
+      if (c != '\n') {
+        if (conn.headerLineLength < maxHeaderLineLength) {
+          conn.headerLine[conn.headerLineLength++] = c;
+        }
+        continue;
+      }
+      if (conn.headerLineLength > 0 && conn.headerLine[conn.headerLineLength - 1] == '\r') {
+        --conn.headerLineLength;
+      }
+      conn.headerLine[conn.headerLineLength] = 0;
+      if (conn.headerLineLength == 0) {
+        // A blank line ends the headers.  Any body is ignored.
+        bool patternSelectionChanged = handleRequest(conn.client, conn.reqLine, conn.etagMatches);
+        closeConnection(conn);
+        return patternSelectionChanged;
+      }
+      if (strncasecmp(conn.headerLine, "If-None-Match:", 14) == 0
+          && strstr(conn.headerLine + 14, webUiIndexHtmlGzEtag) != nullptr)
+      {
+        conn.etagMatches = true;
+      }
+      conn.headerLineLength = 0;
+    }
+  }
+
+  if (!conn.client.connected() || millis() - conn.startMs >= requestTimeoutMs) {
+    closeConnection(conn);
+  }
+
+  return false;
+}
+
+
+bool Esp8266WebPage::handleRequest(WiFiClient& client, char* reqLine, bool etagMatches)
 {
   bool patternSelectionChanged = false;
 
-  String req = client.readStringUntil('\r');
-  Serial.println(req);
+  Serial.println(reqLine);
+
+  if (strncmp(reqLine, "GET /api/", 9) == 0) {
+    patternSelectionChanged = handleApiRequest(client, reqLine);
+  }
+  else if (strncmp(reqLine, "GET / ", 6) == 0 || strncmp(reqLine, "GET /index.html ", 16) == 0) {
+    // Requests with a query string are for the classic page.
+    sendWebUi(client, etagMatches);
+  }
+  else {
+    patternSelectionChanged = handleClientRequest(client, String(reqLine));
+  }
+
+  return patternSelectionChanged;
+}
+
 
-  client.flush();
-  // TODO:  need to do this second flush?  client.flush();
+bool Esp8266WebPage::handleApiRequest(WiFiClient& client, char* reqLine)
+{
+  // The request line looks like "GET /api/select?section0=3&section1=7 HTTP/1.1".
+  // The path and query are split out in place by replacing the separators
+  // with null terminators.
+
+  char* path = reqLine + 4;
+  char* p = strchr(path, ' ');
+  if (p) {
+    *p = 0;
+  }
+  char* query = strchr(path, '?');
+  if (query) {
+    *query++ = 0;
+  }
+  else {
+    query = path + strlen(path);
+  }
+
+  bool patternSelectionChanged = false;
+
+  if (strcmp(path, "/api/sequences") == 0) {
+    handleApiSequences(client);
+  }
+  else if (strcmp(path, "/api/patterns") == 0) {
+    handleApiPatterns(client, query);
+  }
+  else if (strcmp(path, "/api/presets") == 0) {
+    handleApiPresets(client);
+  }
+  else if (strcmp(path, "/api/select") == 0) {
+    patternSelectionChanged = handleApiSelect(client, query);
+  }
+  else if (strcmp(path, "/api/stats") == 0) {
+    handleApiStats(client);
+  }
+  else if (strcmp(path, "/api/status") == 0) {
+    handleApiStatus(client);
+  }
+  else {
+    apiBeginResponse(client, "404 Not Found");
+    apiAppend(client, "{\"error\":\"unknown endpoint\"}");
+  }
+
+  apiFlush(client);
+
+  return patternSelectionChanged;
+}
+
+
+void Esp8266WebPage::handleApiSequences(WiFiClient& client)
+{
+  // GET /api/sequences
+  // Lists each section's pattern count, selected pattern number
+  // (255 for automatic mode), and the pattern currently running.
+
+  apiBeginResponse(client, "200 OK");
+  apiAppend(client, "[");
+  for (unsigned int sectionIdx = 0; sectionIdx < patternSequences.size(); ++sectionIdx) {
+    PatternSequence* ps = patternSequences[sectionIdx];
+    apiAppend(client, "%s{\"section\":%u,\"numPatterns\":%u,\"patternNum\":%u,\"currentPatternNum\":%u}",
+              sectionIdx > 0 ? "," : "",
+              sectionIdx,
+              ps->numPatterns,
+              ps->patternSelector->getPatternNum(),
+              ps->currentPatternNum);
+  }
+  apiAppend(client, "]");
+}
+
+
+void Esp8266WebPage::handleApiPatterns(WiFiClient& client, const char* query)
+{
+  // GET /api/patterns?section=<n>
+  // Lists the names of the patterns in a section.  Patterns
+  // without a name are listed as null.
+
+  int sectionIdx;
+  if (!getQueryInt(query, "section", &sectionIdx) || sectionIdx < 0 || sectionIdx >= (int) patternSequences.size()) {
+    apiBeginResponse(client, "400 Bad Request");
+    apiAppend(client, "{\"error\":\"bad section\"}");
+    return;
+  }
+
+  PatternSequence* ps = patternSequences[sectionIdx];
+
+  apiBeginResponse(client, "200 OK");
+  apiAppend(client, "{\"section\":%d,\"patterns\":[", sectionIdx);
+  for (uint8_t patternIdx = 0; patternIdx < ps->numPatterns; ++patternIdx) {
+    if (patternIdx > 0) {
+      apiAppend(client, ",");
+    }
+    apiAppendJsonString(client, ps->getPatternName(patternIdx));
+  }
+  apiAppend(client, "]}");
+}
+
+
+void Esp8266WebPage::handleApiPresets(WiFiClient& client)
+{
+  // GET /api/presets
+  // Lists the presets and the pattern number each one selects for each section.
+
+  apiBeginResponse(client, "200 OK");
+  apiAppend(client, "[");
+  for (unsigned int presetIdx = 0; presetIdx < presets.size(); ++presetIdx) {
+    apiAppend(client, "%s{\"preset\":%u,\"name\":", presetIdx > 0 ? "," : "", presetIdx);
+    apiAppendJsonString(client, presets[presetIdx].name.c_str());
+    apiAppend(client, ",\"patternNums\":[");
+    for (unsigned int i = 0; i < presets[presetIdx].patternNums.size(); ++i) {
+      apiAppend(client, "%s%u", i > 0 ? "," : "", presets[presetIdx].patternNums[i]);
+    }
+    apiAppend(client, "]}");
+  }
+  apiAppend(client, "]");
+}
+
+
+bool Esp8266WebPage::handleApiSelect(WiFiClient& client, const char* query)
+{
+  // GET /api/select?preset=<n>&section<i>=<patternNum>&...
+
+  bool patternSelectionChanged = false;
+
+  if (!selectPatterns(query, &patternSelectionChanged)) {
+    apiBeginResponse(client, "400 Bad Request");
+    apiAppend(client, "{\"error\":\"bad preset or pattern number\"}");
+    return false;
+  }
+
+  // Report the resulting selections the same way /api/sequences does.
+  handleApiSequences(client);
+
+  return patternSelectionChanged;
+}
+
+
+bool Esp8266WebPage::selectPatterns(const char* query, bool* pPatternSelectionChanged)
+{
+  // Selects patterns for any number of sections at once using a query string
+  // of the form preset=<n>&section<i>=<patternNum>&...  A preset, if given,
+  // is applied first, then any individual section values override it.
+  // Pattern number 255 selects automatic mode.  Every value is validated
+  // before any selection is changed, so either all of the sections change
+  // or none of them do.  Returns false if any value is invalid.
+
+  // UINT16_MAX marks a section whose selection isn't being changed, so
+  // larger pattern numbers are rejected rather than truncated into it.
+  constexpr uint16_t notGiven = UINT16_MAX;
+  constexpr unsigned int maxPatternNum = UINT16_MAX - 2;
+
+  unsigned int numSections = patternSequences.size();
+  uint16_t newPatternNums[maxPatternSequences];
+  bool bad = false;
+  int val;
+
+  *pPatternSelectionChanged = false;
+
+  for (unsigned int sectionIdx = 0; sectionIdx < numSections; ++sectionIdx) {
+    newPatternNums[sectionIdx] = notGiven;
+  }
+
+  if (getQueryInt(query, "preset", &val)) {
+    if (val >= 0 && val < (int) presets.size()) {
+      for (unsigned int sectionIdx = 0;
+           sectionIdx < numSections && sectionIdx < presets[val].patternNums.size();
+           ++sectionIdx)
+      {
+        if (presets[val].patternNums[sectionIdx] <= maxPatternNum) {
+          newPatternNums[sectionIdx] = presets[val].patternNums[sectionIdx];
+        }
+        else {
+          bad = true;
+        }
+      }
+    }
+    else {
+      bad = true;
+    }
+  }
+
+  for (unsigned int sectionIdx = 0; sectionIdx < numSections; ++sectionIdx) {
+    char key[12];
+    snprintf(key, sizeof(key), "section%u", sectionIdx);
+    if (getQueryInt(query, key, &val)) {
+      if (val >= 0 && (unsigned int) val <= maxPatternNum) {
+        newPatternNums[sectionIdx] = val;
+      }
+      else {
+        bad = true;
+      }
+    }
+    if (newPatternNums[sectionIdx] != notGiven
+        && newPatternNums[sectionIdx] != 255
+        && newPatternNums[sectionIdx] >= patternSequences[sectionIdx]->numPatterns)
+    {
+      bad = true;
+    }
+  }
+
+  if (bad) {
+    return false;
+  }
+
+  for (unsigned int sectionIdx = 0; sectionIdx < numSections; ++sectionIdx) {
+    if (newPatternNums[sectionIdx] != notGiven) {
+      patternSequences[sectionIdx]->patternSelector->setPatternNum(newPatternNums[sectionIdx]);
+      *pPatternSelectionChanged = true;
+    }
+  }
+
+  return true;
+}
+
+
+void Esp8266WebPage::handleApiStats(WiFiClient& client)
+{
+  // GET /api/stats
+
+  apiBeginResponse(client, "200 OK");
+  apiAppend(client, "{\"uptimeMs\":%lu,\"freeHeap\":%u", (unsigned long) millis(), ESP.getFreeHeap());
+  if (patternController != nullptr) {
+    const PixelPatternController::Stats& stats = patternController->getStats();
+    apiAppend(client, ",\"updateCalls\":%lu,\"ledWrites\":%lu,\"timingMisses\":%lu,\"lastLedWriteMs\":%lu",
+              (unsigned long) stats.numUpdateCalls,
+              (unsigned long) stats.numLedWrites,
+              (unsigned long) stats.numTimingMisses,
+              (unsigned long) stats.lastLedWriteMs);
+  }
+  apiAppend(client, ",\"stationIp\":");
+  apiAppendJsonString(client, staIpAddress.c_str());
+  apiAppend(client, "}");
+}
+
+
+void Esp8266WebPage::handleApiStatus(WiFiClient& client)
+{
+  // GET /api/status
+  // Returns the title and status text (which may contain HTML) for the UI page.
+
+  apiBeginResponse(client, "200 OK");
+  apiAppend(client, "{\"title\":");
+  apiAppendJsonString(client, titleText.c_str());
+  apiAppend(client, ",\"status\":");
+  apiAppendJsonString(client, statusText.c_str());
+  apiAppend(client, "}");
+}
+
+
+void Esp8266WebPage::sendWebUi(WiFiClient& client, bool etagMatches)
+{
+  // The UI page is gzipped at build time and sent straight from flash.
+  // It gets everything else from the API and the WebSocket channel,
+  // so it never changes and the browser can always use its cached copy
+  // as long as the ETag still matches.
+
+  apiBufLen = 0;
+
+  if (etagMatches) {
+    apiAppend(client,
+              "HTTP/1.1 304 Not Modified\r\n"
+              "ETag: %s\r\n"
+              "Connection: close\r\n\r\n",
+              webUiIndexHtmlGzEtag);
+    apiFlush(client);
+    return;
+  }
+
+  apiAppend(client,
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Type: text/html\r\n"
+            "Content-Encoding: gzip\r\n"
+            "Content-Length: %lu\r\n"
+            "ETag: %s\r\n"
+            "Cache-Control: no-cache\r\n"
+            "Connection: close\r\n\r\n",
+            (unsigned long) webUiIndexHtmlGzLength,
+            webUiIndexHtmlGzEtag);
+  apiFlush(client);
+
+  client.write_P((PGM_P) webUiIndexHtmlGz, webUiIndexHtmlGzLength);
+}
+
+
+void Esp8266WebPage::apiBeginResponse(WiFiClient& client, const char* httpStatus)
+{
+  apiBufLen = 0;
+  apiAppend(client,
+            "HTTP/1.1 %s\r\n"
+            "Content-Type: application/json\r\n"
+            "Cache-Control: no-cache\r\n"
+            "Connection: close\r\n\r\n",
+            httpStatus);
+}
+
+
+void Esp8266WebPage::apiAppend(WiFiClient& client, const char* format, ...)
+{
+  // Formats into the fixed response buffer, sending the buffer's
+  // contents to the client first if there isn't enough room left.
+
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(apiBuf + apiBufLen, apiBufSize - apiBufLen, format, args);
+  va_end(args);
+
+  if (len < 0) {
+    return;
+  }
+
+  if ((size_t) len >= apiBufSize - apiBufLen) {
+    apiBuf[apiBufLen] = 0;
+    apiFlush(client);
+    va_start(args, format);
+    len = vsnprintf(apiBuf, apiBufSize, format, args);
+    va_end(args);
+    // Anything that doesn't fit in an empty buffer gets truncated.
+    if (len < 0) {
+      len = 0;
+    }
+    else if ((size_t) len >= apiBufSize) {
+      len = apiBufSize - 1;
+    }
+  }
+
+  apiBufLen += len;
+}
+
+
+void Esp8266WebPage::apiAppendJsonString(WiFiClient& client, const char* str)
+{
+  if (str == nullptr) {
+    apiAppend(client, "null");
+    return;
+  }
+
+  apiAppend(client, "\"");
+  for (const char* p = str; *p; ++p) {
+    if (apiBufLen + 7 >= apiBufSize) {
+      apiFlush(client);
+    }
+    if (*p == '"' || *p == '\\') {
+      apiBuf[apiBufLen++] = '\\';
+      apiBuf[apiBufLen++] = *p;
+    }
+    else if ((uint8_t) *p < 0x20) {
+      apiBufLen += snprintf(apiBuf + apiBufLen, apiBufSize - apiBufLen, "\\u%04x", (uint8_t) *p);
+    }
+    else {
+      apiBuf[apiBufLen++] = *p;
+    }
+  }
+  apiAppend(client, "\"");
+}
+
+
+void Esp8266WebPage::apiFlush(WiFiClient& client)
+{
+  if (apiBufLen > 0) {
+    client.write((const uint8_t*) apiBuf, apiBufLen);
+    apiBufLen = 0;
+  }
+}
+
+
+bool Esp8266WebPage::handleClientRequest(WiFiClient& client, const String& req)
+{
+  bool patternSelectionChanged = false;
 
   String s = "HTTP/1.1 200 OK\r\n";
   s += "Content-Type: text/html\r\n\r\n";
@@ -106,7 +610,6 @@ bool Esp8266WebPage::handleClientRequest(WiFiClient& client)
   s += statusText;
 
   int8_t selectedPresetIdx = -1;
-  bool autoMode = false;
 
   if (req.indexOf("GET") != -1) {
     String val;
@@ -126,10 +629,6 @@ bool Esp8266WebPage::handleClientRequest(WiFiClient& client)
         patternSelectionChanged = true;
       }
     }
-    val = getRequestValue(req, "auto");
-    if (val.length() != 0) {
-      autoMode = true;
-    }
   }
 
   for (uint8_t presetIdx = 0; presetIdx < presets.size(); ++presetIdx) {
@@ -382,6 +881,42 @@ String Esp8266WebPage::ipAddressToString(const IPAddress& ipAddr)
 //}
 
 
+bool Esp8266WebPage::getQueryInt(const char* query, const char* key, int* pValue)
+{
+  // Finds key=value in a URL query string and converts the value to an
+  // integer.  Returns false if the key isn't present, or if its value
+  // isn't a decimal integer that fits in an int and ends at the next
+  // parameter.
+
+  size_t keyLength = strlen(key);
+  const char* p = query;
+  while (p != nullptr && *p != 0) {
+    if (strncmp(p, key, keyLength) == 0 && p[keyLength] == '=') {
+      const char* v = p + keyLength + 1;
+      if (*v < '0' || *v > '9') {
+        if (*v != '-' || v[1] < '0' || v[1] > '9') {
+          return false;
+        }
+      }
+      char* end;
+      errno = 0;
+      long value = strtol(v, &end, 10);
+      if (errno == ERANGE || value < INT_MIN || value > INT_MAX || (*end != 0 && *end != '&')) {
+        return false;
+      }
+      *pValue = value;
+      return true;
+    }
+    p = strchr(p, '&');
+    if (p != nullptr) {
+      ++p;
+    }
+  }
+
+  return false;
+}
+
+
 String Esp8266WebPage::getRequestValue(const String& req, const String& key)
 {
   String val;
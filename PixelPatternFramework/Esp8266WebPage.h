@@ -13,17 +13,14 @@
 #ifdef ESP8266
 
 #include <Arduino.h>
+#include <ESP8266WiFi.h>
 #include <vector>
 
 
-class IPAddress;
-class WiFiServer;
-class WiFiClient;
-
-
 namespace pixelPattern {
 
 class PatternSequence;
+class PixelPatternController;
 
 
 class Esp8266WebPage {
@@ -52,11 +49,18 @@ public:
 
     void init();
 
+    PixelPatternController* getPatternController() { return patternController; }
+    static bool getQueryInt(const char* query, const char* key, int* pValue);
+    const std::vector<PatternSequence*>& getPatternSequences() { return patternSequences; }
+
     String ipAddressToString(const IPAddress& ipAddr);
 //    IPAddress stringToIpAddress(const String& s);
 
+    bool selectPatterns(const char* query, bool* pPatternSelectionChanged);
+
     void setAp(const String& ssid, const String& password);
     void setHostname(const String& name) { hostname = name; }
+    void setPatternController(PixelPatternController* pc) { patternController = pc; }
     void setSta(const String& ssid, const String& passkey);
     void setStaticIpAddress(const String& ip,
                             const String& gateway,
@@ -64,32 +68,82 @@ public:
                             const String& dns1 = "0.0.0.0",
                             const String& dns2 = "0.0.0.0");
     void setStatusText(const String& text) { statusText = text; }
+    void setTimeBudgetMs(uint16_t ms) { timeBudgetUs = (uint32_t) ms * 1000; }
     void setTitleText(const String& text) { titleText = text; }
 
 protected:
 
 private:
 
+    static constexpr size_t maxRequestLineLength = 255;
+    static constexpr size_t apiBufSize = 512;
+    static constexpr uint8_t maxConnections = 4;
+    static constexpr uint8_t maxHeaderLineLength = 80;
+    static constexpr uint16_t defaultTimeBudgetMs = 20;
+    static constexpr uint32_t requestTimeoutMs = 3000;
+
+    enum class ConnectionState {
+        unused,
+        readingRequestLine,
+        readingHeaders
+    };
+
+    // Per-connection request parsing state.  Requests arrive a piece
+    // at a time, so each connection keeps its place between doWiFi calls.
+    struct Connection {
+        WiFiClient client;
+        ConnectionState state;
+        uint32_t startMs;
+        char reqLine[maxRequestLineLength + 1];
+        uint16_t reqLineLength;
+        char headerLine[maxHeaderLineLength + 1];
+        uint8_t headerLineLength;
+        bool etagMatches;
+    };
+
+    void acceptConnections();
+
+    void apiAppend(WiFiClient& client, const char* format, ...);
+    void apiAppendJsonString(WiFiClient& client, const char* str);
+    void apiBeginResponse(WiFiClient& client, const char* httpStatus);
+    void apiFlush(WiFiClient& client);
     void checkWiFiStaConnected();
+    void closeConnection(Connection& conn);
     String getRequestValue(const String& req, const String& key);
-    bool handleClientRequest(WiFiClient& client);
-
+    bool handleApiRequest(WiFiClient& client, char* reqLine);
+    void handleApiPatterns(WiFiClient& client, const char* query);
+    void handleApiPresets(WiFiClient& client);
+    bool handleApiSelect(WiFiClient& client, const char* query);
+    void handleApiSequences(WiFiClient& client);
+    void handleApiStats(WiFiClient& client);
+    void handleApiStatus(WiFiClient& client);
+    bool handleClientRequest(WiFiClient& client, const String& req);
+    bool handleRequest(WiFiClient& client, char* reqLine, bool etagMatches);
+    void sendWebUi(WiFiClient& client, bool etagMatches);
+    bool serviceConnection(Connection& conn);
+
+    char apiBuf[apiBufSize];
+    size_t apiBufLen;
     String apIpAddress;
     String apPassword;
+    Connection connections[maxConnections];
     String apSsid;
     String dns1Address;
     String dns2Address;
     bool enableSoftAp;
     bool enableStationMode;
+    uint8_t nextConnectionIdx;
     String gatewayAddress;
     String hostname;
     String staticIpAddress;
+    PixelPatternController* patternController;
     std::vector<PatternSequence*> patternSequences;
     std::vector<Preset> presets;
     String staIpAddress;
     String staSsid;
     String staPasskey;
     String statusText;
+    uint32_t timeBudgetUs;
     String titleText;
     WiFiServer* wiFiServer;
     String subnetMask;
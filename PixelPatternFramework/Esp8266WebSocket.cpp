@@ -0,0 +1,511 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * ESP8266 WebSocket Live Status Channel                           *
+ *                                                                 *
+ * by Ross Butler   Oct. 2016                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifdef ESP8266
+
+#include <Arduino.h>
+#include "Esp8266WebSocket.h"
+#include <ESP8266WiFi.h>
+#include <Hash.h>
+#include "Esp8266WebPage.h"
+#include "PatternSelector.h"
+#include "PatternSequence.h"
+#include "PixelPatternController.h"
+
+using namespace pixelPattern;
+
+
+static constexpr uint8_t opcodeText = 0x1;
+static constexpr uint8_t opcodeClose = 0x8;
+static constexpr uint8_t opcodePing = 0x9;
+static constexpr uint8_t opcodePong = 0xA;
+
+static const char webSocketGuid[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+static const char base64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+
+static void base64Encode(const uint8_t* data, uint8_t length, char* out)
+{
+    // out must have room for 4 * ((length + 2) / 3) + 1 chars.
+
+    uint8_t i = 0;
+    while (i + 2 < length) {
+        *out++ = base64Chars[data[i] >> 2];
+        *out++ = base64Chars[((data[i] & 0x03) << 4) | (data[i + 1] >> 4)];
+        *out++ = base64Chars[((data[i + 1] & 0x0f) << 2) | (data[i + 2] >> 6)];
+        *out++ = base64Chars[data[i + 2] & 0x3f];
+        i += 3;
+    }
+    if (i < length) {
+        *out++ = base64Chars[data[i] >> 2];
+        if (i + 1 < length) {
+            *out++ = base64Chars[((data[i] & 0x03) << 4) | (data[i + 1] >> 4)];
+            *out++ = base64Chars[(data[i + 1] & 0x0f) << 2];
+        }
+        else {
+            *out++ = base64Chars[(data[i] & 0x03) << 4];
+            *out++ = '=';
+        }
+        *out++ = '=';
+    }
+    *out = 0;
+}
+
+
+Esp8266WebSocket::Esp8266WebSocket(uint16_t port)
+    : batteryMillivolts(0)
+    , lastStatsLedWrites(0)
+    , lastStatsMs(0)
+    , statsIntervalMs(1000)
+    , webPage(nullptr)
+{
+    wiFiServer = new WiFiServer(port);
+
+    for (uint8_t i = 0; i < maxClients; ++i) {
+        connections[i].state = ConnectionState::unused;
+    }
+    for (uint8_t i = 0; i < maxPatternSequences; ++i) {
+        lastCurrentPatternNums[i] = 255;
+        lastSelectedPatternNums[i] = 255;
+    }
+}
+
+
+Esp8266WebSocket::~Esp8266WebSocket()
+{
+    delete wiFiServer;
+}
+
+
+void Esp8266WebSocket::init(Esp8266WebPage* webPage)
+{
+    this->webPage = webPage;
+    wiFiServer->begin();
+    lastStatsMs = millis();
+}
+
+
+bool Esp8266WebSocket::doWebSocket()
+{
+    // Returns true if a client changed the pattern selection.
+
+    bool patternSelectionChanged = false;
+
+    if (webPage == nullptr) {
+        return false;
+    }
+
+    acceptClients();
+
+    for (uint8_t i = 0; i < maxClients; ++i) {
+        Connection& conn = connections[i];
+        if (ConnectionState::unused == conn.state) {
+            continue;
+        }
+        if (!conn.client.connected()) {
+            closeConnection(conn);
+            continue;
+        }
+        if (ConnectionState::handshake == conn.state) {
+            receiveHandshake(conn);
+        }
+        else {
+            patternSelectionChanged |= receiveFrames(conn);
+        }
+    }
+
+    // Tell everyone about any pattern changes, whether they were
+    // made by us, the web page, or an automatic show.
+    char buf[maxPayloadLength + 1];
+    const std::vector<PatternSequence*>& patternSequences = webPage->getPatternSequences();
+    for (uint8_t sectionIdx = 0; sectionIdx < patternSequences.size() && sectionIdx < maxPatternSequences; ++sectionIdx) {
+        PatternSequence* ps = patternSequences[sectionIdx];
+        if (ps->currentPatternNum != lastCurrentPatternNums[sectionIdx]
+            || ps->patternSelector->getPatternNum() != lastSelectedPatternNums[sectionIdx])
+        {
+            lastCurrentPatternNums[sectionIdx] = ps->currentPatternNum;
+            lastSelectedPatternNums[sectionIdx] = ps->patternSelector->getPatternNum();
+            broadcast(buf, formatPatternEvent(buf, sectionIdx));
+        }
+    }
+
+    uint32_t now = millis();
+    if (now - lastStatsMs >= statsIntervalMs) {
+        broadcast(buf, formatStats(buf));
+        lastStatsMs = now;
+        if (webPage->getPatternController() != nullptr) {
+            lastStatsLedWrites = webPage->getPatternController()->getStats().numLedWrites;
+        }
+    }
+
+    for (uint8_t i = 0; i < maxClients; ++i) {
+        if (ConnectionState::unused != connections[i].state) {
+            sendQueuedMessages(connections[i]);
+        }
+    }
+
+    return patternSelectionChanged;
+}
+
+
+void Esp8266WebSocket::acceptClients()
+{
+    WiFiClient newClient = wiFiServer->available();
+    if (!newClient) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < maxClients; ++i) {
+        Connection& conn = connections[i];
+        if (ConnectionState::unused == conn.state) {
+            conn.client = newClient;
+            conn.client.setNoDelay(true);
+            conn.state = ConnectionState::handshake;
+            conn.lastProgressMs = millis();
+            conn.lineLength = 0;
+            conn.key[0] = 0;
+            conn.rxLength = 0;
+            conn.txHead = 0;
+            conn.txCount = 0;
+            conn.numDroppedMessages = 0;
+            return;
+        }
+    }
+
+    // No room for another client.
+    newClient.stop();
+}
+
+
+void Esp8266WebSocket::closeConnection(Connection& conn)
+{
+    conn.client.stop();
+    conn.state = ConnectionState::unused;
+}
+
+
+void Esp8266WebSocket::receiveHandshake(Connection& conn)
+{
+    // Collect the HTTP upgrade request one line at a time, keeping only
+    // the Sec-WebSocket-Key value.  The blank line ends the request.
+
+    while (conn.client.available()) {
+        char c = conn.client.read();
+        if (c == '\r') {
+            continue;
+        }
+        if (c != '\n') {
+            if (conn.lineLength < maxHeaderLineLength) {
+                conn.lineBuf[conn.lineLength++] = c;
+            }
+            continue;
+        }
+
+        conn.lineBuf[conn.lineLength] = 0;
+
+        if (conn.lineLength == 0) {
+            completeHandshake(conn);
+            return;
+        }
+
+        static const char keyHeader[] = "sec-websocket-key:";
+        if (strncasecmp(conn.lineBuf, keyHeader, sizeof(keyHeader) - 1) == 0) {
+            const char* p = conn.lineBuf + sizeof(keyHeader) - 1;
+            while (*p == ' ') {
+                ++p;
+            }
+            strncpy(conn.key, p, maxKeyLength);
+            conn.key[maxKeyLength] = 0;
+        }
+
+        conn.lineLength = 0;
+    }
+
+    if (millis() - conn.lastProgressMs >= handshakeTimeoutMs) {
+        closeConnection(conn);
+    }
+}
+
+
+void Esp8266WebSocket::completeHandshake(Connection& conn)
+{
+    if (conn.key[0] == 0) {
+        conn.client.print("HTTP/1.1 400 Bad Request\r\nConnection: close\r\n\r\n");
+        closeConnection(conn);
+        return;
+    }
+
+    char keyAndGuid[maxKeyLength + sizeof(webSocketGuid)];
+    strcpy(keyAndGuid, conn.key);
+    strcat(keyAndGuid, webSocketGuid);
+
+    uint8_t hash[20];
+    sha1((const uint8_t*) keyAndGuid, strlen(keyAndGuid), hash);
+
+    char accept[29];
+    base64Encode(hash, sizeof(hash), accept);
+
+    char response[160];
+    int len = snprintf(response, sizeof(response),
+                       "HTTP/1.1 101 Switching Protocols\r\n"
+                       "Upgrade: websocket\r\n"
+                       "Connection: Upgrade\r\n"
+                       "Sec-WebSocket-Accept: %s\r\n\r\n",
+                       accept);
+    conn.client.write((const uint8_t*) response, len);
+
+    conn.state = ConnectionState::open;
+    conn.lastProgressMs = millis();
+
+    queueState(conn);
+}
+
+
+bool Esp8266WebSocket::receiveFrames(Connection& conn)
+{
+    // Reassembles client frames in rxBuf.  Client frames are always masked.
+    // Since commands are short, frames with extended payload lengths or
+    // fragmentation are treated as protocol errors.  Returns true if a
+    // command changed the pattern selection.
+
+    bool patternSelectionChanged = false;
+
+    for (uint16_t n = 0; n < maxRxBytesPerCall && conn.client.available(); ++n) {
+        conn.rxBuf[conn.rxLength++] = conn.client.read();
+
+        if (conn.rxLength < 2) {
+            continue;
+        }
+
+        bool fin = conn.rxBuf[0] & 0x80;
+        uint8_t opcode = conn.rxBuf[0] & 0x0f;
+        bool masked = conn.rxBuf[1] & 0x80;
+        uint8_t payloadLength = conn.rxBuf[1] & 0x7f;
+
+        if (!fin || !masked || payloadLength > maxPayloadLength) {
+            closeConnection(conn);
+            return patternSelectionChanged;
+        }
+
+        if (conn.rxLength < 6 + payloadLength) {
+            continue;
+        }
+
+        uint8_t* mask = conn.rxBuf + 2;
+        char* payload = (char*) conn.rxBuf + 6;
+        for (uint8_t i = 0; i < payloadLength; ++i) {
+            payload[i] ^= mask[i & 3];
+        }
+
+        conn.rxLength = 0;
+
+        if (!handleMessage(conn, opcode, payload, payloadLength, &patternSelectionChanged)) {
+            return patternSelectionChanged;
+        }
+    }
+
+    return patternSelectionChanged;
+}
+
+
+bool Esp8266WebSocket::handleMessage(
+    Connection& conn,
+    uint8_t opcode,
+    char* payload,
+    uint8_t length,
+    bool* pPatternSelectionChanged)
+{
+    // Returns false if the connection was closed.
+
+    char buf[maxPayloadLength + 1];
+
+    switch (opcode) {
+
+        case opcodeText:
+            // The payload is at the end of rxBuf, so there is
+            // no room for a terminator.  Copy it out first.
+            memcpy(buf, payload, length);
+            buf[length] = 0;
+            if (strncmp(buf, "select ", 7) == 0) {
+                bool changed;
+                const char* reply = webPage->selectPatterns(buf + 7, &changed)
+                    ? "{\"event\":\"select\",\"ok\":true}"
+                    : "{\"event\":\"select\",\"ok\":false}";
+                queueMessage(conn, opcodeText, reply, strlen(reply));
+                *pPatternSelectionChanged |= changed;
+            }
+            else if (strcmp(buf, "stats") == 0) {
+                queueMessage(conn, opcodeText, buf, formatStats(buf));
+            }
+            break;
+
+        case opcodePing:
+            queueMessage(conn, opcodePong, payload, length);
+            break;
+
+        case opcodeClose:
+            {
+                uint8_t closeFrame[2] = {0x80 | opcodeClose, 0};
+                conn.client.write(closeFrame, sizeof(closeFrame));
+                closeConnection(conn);
+            }
+            return false;
+
+        default:
+            break;
+    }
+
+    return true;
+}
+
+
+void Esp8266WebSocket::queueMessage(Connection& conn, uint8_t opcode, const char* payload, uint8_t length)
+{
+    if (length > maxPayloadLength) {
+        length = maxPayloadLength;
+    }
+
+    // When the queue is full, the oldest message is dropped to make room.
+    if (conn.txCount >= txQueueLength) {
+        conn.txHead = (conn.txHead + 1) % txQueueLength;
+        --conn.txCount;
+        ++conn.numDroppedMessages;
+    }
+
+    uint8_t slot = (conn.txHead + conn.txCount) % txQueueLength;
+    conn.txOpcode[slot] = opcode;
+    conn.txLength[slot] = length;
+    memcpy(conn.txPayload[slot], payload, length);
+    ++conn.txCount;
+}
+
+
+void Esp8266WebSocket::queueState(Connection& conn)
+{
+    // Give a newly connected client the complete current state.
+
+    char buf[maxPayloadLength + 1];
+
+    const std::vector<PatternSequence*>& patternSequences = webPage->getPatternSequences();
+    for (uint8_t sectionIdx = 0; sectionIdx < patternSequences.size() && sectionIdx < maxPatternSequences; ++sectionIdx) {
+        queueMessage(conn, opcodeText, buf, formatPatternEvent(buf, sectionIdx));
+    }
+    queueMessage(conn, opcodeText, buf, formatStats(buf));
+}
+
+
+void Esp8266WebSocket::broadcast(const char* payload, uint8_t length)
+{
+    for (uint8_t i = 0; i < maxClients; ++i) {
+        if (ConnectionState::open == connections[i].state) {
+            queueMessage(connections[i], opcodeText, payload, length);
+        }
+    }
+}
+
+
+void Esp8266WebSocket::sendQueuedMessages(Connection& conn)
+{
+    if (ConnectionState::open != conn.state) {
+        return;
+    }
+
+    uint32_t now = millis();
+
+    while (conn.txCount > 0) {
+        uint8_t slot = conn.txHead;
+        uint8_t length = conn.txLength[slot];
+
+        // Only write what the TCP send buffer can take right now
+        // so that write() never has to wait for the client.
+        if (conn.client.availableForWrite() < (size_t) length + 2) {
+            break;
+        }
+
+        uint8_t frame[2 + maxPayloadLength];
+        frame[0] = 0x80 | conn.txOpcode[slot];
+        frame[1] = length;
+        memcpy(frame + 2, conn.txPayload[slot], length);
+        conn.client.write(frame, length + 2);
+
+        conn.txHead = (conn.txHead + 1) % txQueueLength;
+        --conn.txCount;
+        conn.lastProgressMs = now;
+    }
+
+    if (0 == conn.txCount) {
+        conn.lastProgressMs = now;
+    }
+    else if (now - conn.lastProgressMs >= slowClientTimeoutMs) {
+        // The client hasn't taken any data for a long time.  It's gone.
+        closeConnection(conn);
+    }
+}
+
+
+uint8_t Esp8266WebSocket::formatPatternEvent(char* buf, uint8_t sectionIdx)
+{
+    // buf must have room for maxPayloadLength + 1 chars.  Returns the
+    // message length.  Long names are truncated to fit the frame.
+
+    PatternSequence* ps = webPage->getPatternSequences()[sectionIdx];
+    const char* name = ps->getPatternName(ps->currentPatternNum);
+
+    int len = snprintf(buf, maxPayloadLength + 1,
+                       "{\"event\":\"pattern\",\"section\":%u,\"patternNum\":%u,\"currentPatternNum\":%u,\"name\":\"",
+                       sectionIdx,
+                       ps->patternSelector->getPatternNum(),
+                       ps->currentPatternNum);
+
+    // Leave room for the closing "} and skip characters that would need escaping.
+    for (const char* p = name; p != nullptr && *p != 0 && len < maxPayloadLength - 2; ++p) {
+        if (*p != '"' && *p != '\\' && (uint8_t) *p >= 0x20) {
+            buf[len++] = *p;
+        }
+    }
+    buf[len++] = '"';
+    buf[len++] = '}';
+    buf[len] = 0;
+
+    return len;
+}
+
+
+uint8_t Esp8266WebSocket::formatStats(char* buf)
+{
+    // buf must have room for maxPayloadLength + 1 chars.  Returns the message length.
+
+    uint32_t now = millis();
+    uint32_t fps = 0;
+    uint32_t timingMisses = 0;
+
+    PixelPatternController* patternController = webPage->getPatternController();
+    if (patternController != nullptr) {
+        const PixelPatternController::Stats& stats = patternController->getStats();
+        uint32_t elapsedMs = now - lastStatsMs;
+        if (elapsedMs > 0) {
+            fps = (stats.numLedWrites - lastStatsLedWrites) * 1000 / elapsedMs;
+        }
+        timingMisses = stats.numTimingMisses;
+    }
+
+    int len = snprintf(buf, maxPayloadLength + 1,
+                       "{\"event\":\"stats\",\"uptimeMs\":%lu,\"fps\":%lu,\"freeHeap\":%u,\"batteryMv\":%u,\"timingMisses\":%lu}",
+                       (unsigned long) now,
+                       (unsigned long) fps,
+                       ESP.getFreeHeap(),
+                       batteryMillivolts,
+                       (unsigned long) timingMisses);
+
+    return len <= maxPayloadLength ? len : maxPayloadLength;
+}
+
+
+#endif  // #ifdef ESP8266
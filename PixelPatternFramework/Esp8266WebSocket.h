@@ -0,0 +1,120 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * ESP8266 WebSocket Live Status Channel                           *
+ *                                                                 *
+ * by Ross Butler   Oct. 2016                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#pragma once
+
+#ifdef ESP8266
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include "pixelPatternFrameworkTypes.h"
+
+
+namespace pixelPattern {
+
+class Esp8266WebPage;
+
+
+// Pushes pattern-change events and periodic frame rate, heap, and battery
+// metrics to connected WebSocket clients, and accepts pattern selection
+// commands from them.  Commands are text messages of the form
+//
+//     select preset=<n>&section<i>=<patternNum>&...
+//     stats
+//
+// using the same query syntax as Esp8266WebPage's /api/select.
+//
+// Everything is done without blocking.  Outgoing messages are put in a
+// small fixed-length queue for each client and are only written when the
+// client's TCP send buffer has room, so a slow client loses its oldest
+// messages instead of stalling the pattern updates.
+class Esp8266WebSocket {
+
+public:
+
+    static constexpr uint8_t maxClients = 4;
+    // Room for an event for every section, a stats message, and a reply
+    // to a command, so that neither a new client's state nor a preset that
+    // changes every section pushes out messages that haven't been sent.
+    static constexpr uint8_t txQueueLength = maxPatternSequences + 2;
+    static constexpr uint8_t maxPayloadLength = 125;    // fits in a WebSocket frame with a 2-byte header
+
+    Esp8266WebSocket(uint16_t port = 81);
+
+    virtual ~Esp8266WebSocket();
+
+    Esp8266WebSocket(const Esp8266WebSocket&) = delete;
+    Esp8266WebSocket& operator =(const Esp8266WebSocket&) = delete;
+
+    bool doWebSocket();
+    void init(Esp8266WebPage* webPage);
+    void setBatteryMillivolts(uint16_t mv) { batteryMillivolts = mv; }
+    void setStatsIntervalMs(uint32_t ms) { statsIntervalMs = ms; }
+
+protected:
+
+private:
+
+    static constexpr uint8_t maxHeaderLineLength = 80;
+    static constexpr uint8_t maxKeyLength = 32;
+    static constexpr uint16_t maxRxBytesPerCall = 256;
+    static constexpr uint32_t handshakeTimeoutMs = 2000;
+    static constexpr uint32_t slowClientTimeoutMs = 10000;
+
+    enum class ConnectionState {
+        unused,
+        handshake,
+        open
+    };
+
+    struct Connection {
+        WiFiClient client;
+        ConnectionState state;
+        uint32_t lastProgressMs;
+        char lineBuf[maxHeaderLineLength + 1];
+        uint8_t lineLength;
+        char key[maxKeyLength + 1];
+        uint8_t rxBuf[6 + maxPayloadLength];    // 2-byte header, 4-byte mask, payload
+        uint8_t rxLength;
+        uint8_t txOpcode[txQueueLength];
+        uint8_t txLength[txQueueLength];
+        char txPayload[txQueueLength][maxPayloadLength];
+        uint8_t txHead;
+        uint8_t txCount;
+        uint32_t numDroppedMessages;
+    };
+
+    void acceptClients();
+    void broadcast(const char* payload, uint8_t length);
+    void closeConnection(Connection& conn);
+    void completeHandshake(Connection& conn);
+    uint8_t formatPatternEvent(char* buf, uint8_t sectionIdx);
+    uint8_t formatStats(char* buf);
+    bool handleMessage(Connection& conn, uint8_t opcode, char* payload, uint8_t length, bool* pPatternSelectionChanged);
+    void queueMessage(Connection& conn, uint8_t opcode, const char* payload, uint8_t length);
+    void queueState(Connection& conn);
+    bool receiveFrames(Connection& conn);
+    void receiveHandshake(Connection& conn);
+    void sendQueuedMessages(Connection& conn);
+
+    uint16_t batteryMillivolts;
+    Connection connections[maxClients];
+    uint8_t lastCurrentPatternNums[maxPatternSequences];
+    uint8_t lastSelectedPatternNums[maxPatternSequences];
+    uint32_t lastStatsLedWrites;
+    uint32_t lastStatsMs;
+    uint32_t statsIntervalMs;
+    Esp8266WebPage* webPage;
+    WiFiServer* wiFiServer;
+};
+
+}
+
+#endif  // #ifdef ESP8266
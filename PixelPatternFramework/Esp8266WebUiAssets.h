@@ -0,0 +1,118 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * ESP8266 Web UI Assets                                           *
+ *                                                                 *
+ * Generated by webUi/makeWebUiAssets from webUi/index.html.       *
+ * Do not edit.                                                    *
+ *                                                                 *
+ *******************************************************************/
+
+#pragma once
+
+#ifdef ESP8266
+
+#include <Arduino.h>
+
+
+namespace pixelPattern {
+
+static const char webUiIndexHtmlGzEtag[] = "\"39590bd4188b5cb7\"";
+
+static const uint32_t webUiIndexHtmlGzLength = 1407;
+
+static const uint8_t webUiIndexHtmlGz[] PROGMEM = {
+   0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x85, 0x56, 0x6d, 0x6f, 0xdb, 0x36,
+   0x10, 0xfe, 0xee, 0x5f, 0xa1, 0xb1, 0x5d, 0x20, 0x21, 0xb2, 0x2c, 0x65, 0x69, 0x11, 0x48, 0xa6,
+   0x83, 0x2e, 0xcb, 0xd6, 0x0e, 0x4d, 0x5b, 0x2c, 0xc1, 0x5e, 0x50, 0xe4, 0x03, 0x25, 0x5d, 0x62,
+   0x2e, 0x32, 0xa5, 0x88, 0x54, 0x6c, 0xcf, 0xf5, 0x7f, 0xdf, 0xf1, 0xc5, 0xb2, 0xdc, 0xa5, 0x58,
+   0x80, 0x58, 0xd2, 0xf1, 0x78, 0x77, 0xbc, 0xe7, 0xe1, 0x43, 0x4e, 0xbf, 0xfb, 0xe9, 0xe3, 0xc5,
+   0xcd, 0x5f, 0x9f, 0x2e, 0xbd, 0xb9, 0x5a, 0x54, 0xb3, 0xd1, 0x74, 0xf7, 0x00, 0x56, 0xe2, 0x63,
+   0x01, 0x8a, 0x79, 0xc5, 0x9c, 0xb5, 0x12, 0x14, 0x25, 0x9d, 0xba, 0x1b, 0x9f, 0x91, 0x9d, 0x59,
+   0xb0, 0x05, 0x50, 0xf2, 0xc4, 0x61, 0xd9, 0xd4, 0xad, 0x22, 0x5e, 0x51, 0x0b, 0x05, 0x02, 0xdd,
+   0x96, 0xbc, 0x54, 0x73, 0x5a, 0xc2, 0x13, 0x2f, 0x60, 0x6c, 0x3e, 0x42, 0x8f, 0x0b, 0xae, 0x38,
+   0xab, 0xc6, 0xb2, 0x60, 0x15, 0xd0, 0x44, 0x07, 0x51, 0x5c, 0x55, 0x30, 0xfb, 0xc4, 0x57, 0x50,
+   0x79, 0x9f, 0x98, 0x52, 0xd0, 0x0a, 0x39, 0x9d, 0x58, 0xeb, 0x68, 0x2a, 0xd5, 0x5a, 0x3f, 0xf3,
+   0xba, 0x5c, 0x6f, 0xee, 0x30, 0x72, 0x9a, 0xbc, 0x6e, 0x56, 0xde, 0x9b, 0x16, 0x83, 0x84, 0x92,
+   0x09, 0x39, 0x96, 0xd0, 0xf2, 0xbb, 0x6c, 0xc1, 0xda, 0x7b, 0x2e, 0xd2, 0xb3, 0x66, 0x95, 0xe5,
+   0xac, 0x78, 0xb8, 0x6f, 0xeb, 0x4e, 0x94, 0xe9, 0x8b, 0x24, 0x49, 0xb2, 0xa2, 0xae, 0xea, 0x36,
+   0x7d, 0x01, 0x00, 0xdb, 0xd1, 0x3c, 0x31, 0x41, 0xc6, 0x92, 0xff, 0x03, 0xe9, 0x89, 0xf6, 0xde,
+   0x4f, 0xf4, 0xe2, 0xed, 0x28, 0xef, 0x94, 0xaa, 0xc5, 0xa6, 0xe4, 0xb2, 0xa9, 0xd8, 0x3a, 0xcd,
+   0xab, 0xba, 0x78, 0xc8, 0x4c, 0xe9, 0x69, 0x12, 0xc7, 0xdf, 0xa3, 0xf7, 0xca, 0xae, 0x24, 0x7d,
+   0x1d, 0xc7, 0x38, 0x7b, 0x0e, 0xfc, 0x7e, 0xae, 0xd2, 0x57, 0xaf, 0xf7, 0x91, 0x74, 0x79, 0x71,
+   0x66, 0x4a, 0xcd, 0xeb, 0xaa, 0xf4, 0x4e, 0x4e, 0x9e, 0xab, 0x37, 0xaf, 0xdb, 0x12, 0xda, 0x34,
+   0x76, 0x2f, 0xe3, 0x96, 0x95, 0xbc, 0x93, 0x7a, 0xf2, 0x41, 0xfd, 0xa7, 0xa7, 0xa7, 0x07, 0xf5,
+   0xdb, 0xfa, 0x22, 0x09, 0xd5, 0x66, 0xe8, 0x16, 0x9f, 0xf5, 0xb5, 0x47, 0x4d, 0x0b, 0x08, 0xd2,
+   0x7f, 0x5d, 0xe2, 0xa2, 0x77, 0x61, 0x9d, 0xaa, 0x0f, 0x06, 0x8b, 0x22, 0xde, 0xa5, 0x89, 0x63,
+   0x0c, 0xf5, 0x42, 0x42, 0xa1, 0x78, 0x2d, 0x64, 0xdf, 0x89, 0xbb, 0x0a, 0x56, 0x99, 0xfe, 0x19,
+   0x2f, 0x5b, 0xd6, 0xa4, 0xfa, 0x27, 0xbb, 0xc7, 0x97, 0x04, 0x57, 0x37, 0xf0, 0x9f, 0x95, 0xfc,
+   0x69, 0xa3, 0xdd, 0xd2, 0x24, 0x5b, 0x70, 0xe1, 0x7a, 0x75, 0x72, 0x12, 0x5b, 0x2f, 0xc5, 0x94,
+   0x1c, 0x00, 0x90, 0x9c, 0xe2, 0x72, 0x5d, 0x5e, 0xc6, 0xd8, 0x76, 0x34, 0x9d, 0x38, 0xb8, 0xa7,
+   0x13, 0x47, 0x3c, 0x8d, 0xbb, 0xa6, 0x61, 0xe2, 0xf1, 0x92, 0x12, 0x43, 0x0a, 0x32, 0xc3, 0xd1,
+   0x04, 0x8d, 0x98, 0xcb, 0x58, 0x75, 0xd8, 0x4e, 0x6a, 0x33, 0x5a, 0xbe, 0xb2, 0x3f, 0x63, 0xb6,
+   0x0d, 0x1a, 0x0c, 0xd8, 0xae, 0x78, 0x45, 0xc5, 0xa4, 0xa4, 0x44, 0x37, 0x87, 0x18, 0x47, 0xf3,
+   0x36, 0x7b, 0x83, 0xbf, 0x0b, 0xa6, 0x78, 0xe1, 0x5d, 0xd5, 0x25, 0x4c, 0x27, 0xd6, 0x7b, 0x98,
+   0xc6, 0xad, 0x7d, 0x1f, 0x50, 0x16, 0x2d, 0x6f, 0xd4, 0x6c, 0xf4, 0xc4, 0x5a, 0x0f, 0x47, 0x25,
+   0xfd, 0x7c, 0x1b, 0xda, 0xac, 0xef, 0xca, 0x15, 0x1d, 0x27, 0xe1, 0x52, 0x66, 0xa3, 0xbb, 0x4e,
+   0x98, 0x79, 0xde, 0x4b, 0x9f, 0x97, 0xc1, 0xa6, 0x05, 0xd5, 0xb5, 0xc2, 0x2b, 0xeb, 0xa2, 0x5b,
+   0xe0, 0xee, 0x89, 0xee, 0x41, 0x5d, 0x56, 0xa0, 0x5f, 0x7f, 0x5c, 0xbf, 0x2b, 0xb5, 0xcb, 0x76,
+   0x3f, 0x05, 0x07, 0xfd, 0xae, 0xad, 0xc2, 0x22, 0x0f, 0x36, 0x3a, 0xc9, 0x8a, 0x0a, 0x58, 0x7a,
+   0x7f, 0x5e, 0xbd, 0x7f, 0xab, 0x54, 0xf3, 0x1b, 0x3c, 0x76, 0x20, 0x95, 0x1f, 0x64, 0xab, 0xa8,
+   0x16, 0x55, 0xcd, 0x4a, 0xba, 0x9b, 0xe8, 0x07, 0x1b, 0x7e, 0xe7, 0xaf, 0x22, 0xdb, 0x31, 0x4a,
+   0x4f, 0xe2, 0xf8, 0xe8, 0x08, 0x83, 0x14, 0xb9, 0xff, 0xeb, 0xf5, 0xc7, 0x0f, 0x51, 0xa3, 0x37,
+   0x38, 0x8e, 0x63, 0xad, 0x0d, 0xae, 0x08, 0x6e, 0x60, 0xa5, 0x82, 0x60, 0xab, 0x03, 0x35, 0x20,
+   0x7c, 0xf2, 0xcb, 0xe5, 0x0d, 0x09, 0x31, 0xb1, 0x0e, 0x2d, 0x41, 0x94, 0xfe, 0xb0, 0x28, 0xe4,
+   0xff, 0x03, 0x26, 0x18, 0x79, 0x66, 0xcd, 0xd1, 0x5d, 0xdd, 0x5e, 0xb2, 0x62, 0xee, 0xf7, 0xb9,
+   0x65, 0xb0, 0x91, 0x51, 0xae, 0xc4, 0x33, 0x43, 0x79, 0xc8, 0x83, 0x4d, 0x1e, 0x19, 0x04, 0x3e,
+   0x68, 0x39, 0xe1, 0x94, 0x4a, 0xac, 0xc6, 0x88, 0xc1, 0x87, 0x6e, 0x71, 0x8e, 0x4d, 0xae, 0x48,
+   0x4a, 0xc8, 0x36, 0xd8, 0x06, 0x19, 0x66, 0x78, 0xd3, 0xb6, 0x6c, 0x8d, 0x54, 0xaf, 0x55, 0xad,
+   0xd6, 0x0d, 0xec, 0x22, 0x46, 0xa8, 0x2a, 0x95, 0xff, 0xd2, 0xef, 0x31, 0x0e, 0xa2, 0x62, 0xce,
+   0xab, 0xb2, 0x05, 0x11, 0x7e, 0x3b, 0x99, 0xf3, 0x26, 0xc7, 0x3e, 0xa6, 0xed, 0x71, 0x3a, 0x27,
+   0x9e, 0x4b, 0x6a, 0x72, 0x0e, 0x16, 0x8a, 0x66, 0x84, 0xdc, 0x7f, 0x34, 0x6b, 0xc5, 0x7e, 0x2e,
+   0xe5, 0xd1, 0xd1, 0x52, 0x62, 0xd3, 0x58, 0xb9, 0xbe, 0xc6, 0xce, 0x02, 0xa5, 0x49, 0xb0, 0x41,
+   0x8b, 0x69, 0x11, 0xb1, 0xee, 0x1e, 0x39, 0x7e, 0xc4, 0x6e, 0x79, 0x1e, 0x54, 0x12, 0x36, 0x1a,
+   0x40, 0x32, 0x61, 0x0d, 0x9f, 0xd8, 0xd1, 0x73, 0x1c, 0xdd, 0x57, 0xd8, 0x22, 0x1d, 0xfa, 0x26,
+   0x75, 0x4d, 0x89, 0x21, 0x11, 0x85, 0x61, 0x09, 0xd6, 0xe8, 0x83, 0x85, 0x5f, 0x52, 0xdd, 0xf1,
+   0xcf, 0x10, 0x39, 0x2a, 0xde, 0x66, 0x58, 0x95, 0x69, 0xf7, 0xbe, 0x85, 0x14, 0x06, 0x1f, 0x99,
+   0xc5, 0x6a, 0x3b, 0x88, 0x68, 0x69, 0xed, 0x23, 0x03, 0x90, 0x72, 0xa1, 0x42, 0xe0, 0xc3, 0x5a,
+   0x14, 0x15, 0x2f, 0x1e, 0x6c, 0x8e, 0x9c, 0xf6, 0xd4, 0x2c, 0x70, 0xa5, 0x0a, 0x1c, 0x3b, 0x7d,
+   0x62, 0x67, 0x92, 0x20, 0xcb, 0x23, 0x3d, 0xed, 0xc2, 0xc9, 0xbf, 0x7e, 0x47, 0x93, 0x0b, 0x42,
+   0xdd, 0x33, 0xb3, 0x09, 0x22, 0xd6, 0x20, 0xa1, 0xca, 0x0b, 0x0d, 0x8e, 0x9f, 0x07, 0x99, 0x63,
+   0x7f, 0xbe, 0x1d, 0x0d, 0x3a, 0x63, 0xb7, 0xf5, 0x41, 0x5b, 0x10, 0x5a, 0xab, 0x01, 0xc1, 0x41,
+   0xae, 0x36, 0x32, 0xd6, 0xac, 0x2f, 0xd1, 0x7c, 0xee, 0xcc, 0x5f, 0xbe, 0x1c, 0xda, 0x33, 0x8c,
+   0xe2, 0x82, 0x07, 0x11, 0x17, 0x02, 0xda, 0xb7, 0x37, 0x57, 0xef, 0xd1, 0xdb, 0x1a, 0x35, 0xda,
+   0xfb, 0x2a, 0x76, 0x4c, 0xfa, 0x06, 0x3a, 0xbd, 0xb5, 0x41, 0x4e, 0xd9, 0x16, 0x0e, 0xe9, 0x17,
+   0x36, 0x91, 0x3e, 0x1e, 0xc3, 0xc1, 0x06, 0xdc, 0x0b, 0x41, 0xe3, 0xb4, 0x3a, 0x73, 0x84, 0x72,
+   0xd3, 0x28, 0x39, 0xde, 0x8d, 0x04, 0x86, 0xef, 0x0e, 0xac, 0x83, 0xb2, 0xa4, 0xde, 0xe4, 0xa2,
+   0x80, 0xaf, 0x0a, 0x43, 0x7e, 0x3d, 0x53, 0x9b, 0x65, 0xaa, 0xe7, 0x69, 0x1c, 0xcb, 0x6f, 0xe2,
+   0x88, 0xda, 0x85, 0x05, 0x4b, 0xba, 0xd9, 0xf3, 0x24, 0x7d, 0x1c, 0x90, 0x26, 0xd4, 0x7b, 0x37,
+   0xfd, 0x7c, 0xbb, 0xcd, 0x4c, 0xb0, 0x72, 0xd0, 0x3a, 0x82, 0x02, 0x3d, 0xbb, 0xb6, 0xe4, 0xd3,
+   0x44, 0xdf, 0x11, 0xf1, 0x98, 0x18, 0xa9, 0x26, 0xa6, 0xe3, 0x3b, 0x99, 0x0c, 0x0e, 0xc0, 0x2f,
+   0x83, 0xcc, 0x90, 0xb7, 0x9f, 0x73, 0x4b, 0xa5, 0x4d, 0x30, 0xc0, 0xc0, 0xdd, 0x0a, 0xce, 0x9d,
+   0x0b, 0x1d, 0xa4, 0x08, 0x87, 0x08, 0x98, 0x79, 0x9e, 0xd7, 0xec, 0xaa, 0x7e, 0x46, 0x6a, 0x84,
+   0xde, 0xfd, 0x96, 0xd0, 0x0e, 0xaf, 0x32, 0x14, 0x94, 0x8a, 0xae, 0xaa, 0xce, 0x89, 0xbb, 0x7e,
+   0xe0, 0x12, 0x78, 0x2a, 0x9e, 0x07, 0x6d, 0x9c, 0xf4, 0x70, 0xb9, 0x0a, 0x0e, 0xd6, 0x8b, 0xa5,
+   0x71, 0x0d, 0x15, 0x6e, 0x40, 0x8c, 0x4a, 0x51, 0x3c, 0xf2, 0xc8, 0x9c, 0x69, 0x91, 0x3b, 0x49,
+   0x29, 0x11, 0xb5, 0x00, 0x92, 0x39, 0x29, 0x6c, 0x3a, 0x39, 0xc7, 0x0d, 0x60, 0x55, 0x4d, 0xff,
+   0x59, 0xb0, 0xed, 0x97, 0xb5, 0x1a, 0xf5, 0xc1, 0x7f, 0xec, 0xa1, 0x39, 0x91, 0x82, 0x7e, 0x4f,
+   0xfd, 0x4f, 0x81, 0x46, 0x86, 0x17, 0xac, 0x19, 0x48, 0xb0, 0x5e, 0xbc, 0xdb, 0x6b, 0xfb, 0xf2,
+   0x39, 0x96, 0x7d, 0xf2, 0xea, 0x15, 0x8a, 0x6b, 0xf4, 0x77, 0xcd, 0x51, 0xe6, 0x8f, 0x88, 0x16,
+   0xfd, 0xbd, 0x36, 0xe0, 0x8d, 0x4e, 0xe8, 0x80, 0xa6, 0xc1, 0x4b, 0x69, 0x0e, 0x9b, 0x3f, 0x20,
+   0xbf, 0xc6, 0xcb, 0x91, 0xc6, 0x68, 0x29, 0xd3, 0xc9, 0x84, 0x1c, 0xe3, 0x5d, 0x89, 0x69, 0xf7,
+   0x68, 0x5e, 0x4b, 0xa5, 0x59, 0x7f, 0x4c, 0xd2, 0xb3, 0x64, 0x42, 0xcc, 0x22, 0x50, 0x0d, 0x6b,
+   0xb1, 0x00, 0x29, 0xd9, 0x3d, 0xec, 0xeb, 0x5e, 0x58, 0x28, 0x80, 0x0e, 0x4e, 0x9f, 0x45, 0x84,
+   0xd2, 0xc6, 0x5c, 0x07, 0xb0, 0x8d, 0x10, 0xc1, 0x93, 0xde, 0xe3, 0x28, 0xd3, 0x16, 0x1d, 0x12,
+   0xf4, 0xea, 0x67, 0x9d, 0xb4, 0xa2, 0x1e, 0x7a, 0xda, 0x93, 0x3f, 0x70, 0xfb, 0x5c, 0x7e, 0xa5,
+   0x16, 0x78, 0x5c, 0x34, 0xf2, 0x98, 0x78, 0xf8, 0x1b, 0x22, 0xd4, 0xf8, 0xd9, 0x02, 0xbc, 0x05,
+   0xd6, 0xa0, 0x2d, 0x5f, 0x2b, 0x90, 0x9e, 0x36, 0xe0, 0x71, 0x00, 0x51, 0x6e, 0x52, 0xae, 0xaf,
+   0x9e, 0xce, 0x49, 0xe8, 0xb9, 0x0f, 0xef, 0x70, 0x64, 0x82, 0x17, 0xc3, 0x18, 0x13, 0xd4, 0x3f,
+   0xe3, 0x0d, 0xb6, 0xf4, 0x93, 0x00, 0xa3, 0xfc, 0x6e, 0x8e, 0x0d, 0x03, 0x5e, 0xbf, 0xf8, 0xa2,
+   0xaa, 0x25, 0x0c, 0x21, 0x43, 0xbc, 0x6e, 0xf8, 0x02, 0xea, 0x4e, 0xf9, 0xae, 0xc1, 0xe1, 0x0f,
+   0x3a, 0xd4, 0x56, 0x1f, 0x36, 0x7d, 0xcb, 0x33, 0x7d, 0x29, 0x72, 0xf7, 0x09, 0xbc, 0x7c, 0xd8,
+   0xeb, 0xd0, 0xc4, 0xde, 0xce, 0xff, 0x05, 0x25, 0xe5, 0xed, 0x79, 0xb5, 0x0b, 0x00, 0x00,
+};
+
+}
+
+#endif  // #ifdef ESP8266
@@ -0,0 +1,79 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Fixed-Point Number Formatting                                   *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include "FixedPointFormat.h"
+
+using namespace pixelPattern;
+
+
+namespace pixelPattern {
+
+char* formatFixedPoint(char* buf, int32_t value, uint8_t numDecimals, uint8_t width)
+{
+    if (numDecimals > maxFixedPointDecimals) {
+        numDecimals = maxFixedPointDecimals;
+    }
+
+    // The digits are generated from the right into digits, which is
+    // filled from the end.
+    char digits[maxFixedPointLength];
+    uint8_t i = maxFixedPointLength;
+
+    bool isNegative = value < 0;
+    uint32_t magnitude = isNegative ? -(uint32_t) value : (uint32_t) value;
+    uint8_t numDigits = 0;
+
+    // Use 32-bit division only until the rest fits in 16 bits.
+    while (magnitude > UINT16_MAX) {
+        digits[--i] = '0' + magnitude % 10;
+        magnitude /= 10;
+        if (++numDigits == numDecimals) {
+            digits[--i] = '.';
+        }
+    }
+    uint16_t magnitude16 = magnitude;
+    // Keep going through the ones digit even if the value runs out.
+    while (magnitude16 != 0 || numDigits <= numDecimals) {
+        digits[--i] = '0' + magnitude16 % 10;
+        magnitude16 /= 10;
+        if (++numDigits == numDecimals) {
+            digits[--i] = '.';
+        }
+    }
+
+    if (isNegative) {
+        digits[--i] = '-';
+    }
+
+    uint8_t length = maxFixedPointLength - i;
+    char* p = buf;
+    while (width > length) {
+        *p++ = ' ';
+        --width;
+    }
+    memcpy(p, digits + i, length);
+    p[length] = '\0';
+
+    return buf;
+}
+
+
+size_t printFixedPoint(Print& out, int32_t value, uint8_t numDecimals, uint8_t width)
+{
+    char buf[maxFixedPointPrintWidth + 1];
+    if (width > maxFixedPointPrintWidth) {
+        width = maxFixedPointPrintWidth;
+    }
+    formatFixedPoint(buf, value, numDecimals, width);
+    return out.write((const uint8_t*) buf, strlen(buf));
+}
+
+}
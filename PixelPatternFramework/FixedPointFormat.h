@@ -0,0 +1,49 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Fixed-Point Number Formatting                                   *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __FIXED_POINT_FORMAT_H
+#define __FIXED_POINT_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+class Print;
+
+
+namespace pixelPattern {
+
+// Formats scaled integers, such as angles in tenths of a degree, the way
+// dtostrf formats floats, but with integer math and no printf code.  The
+// value shown is value / 10^numDecimals, right-aligned in a field of width
+// characters.  A number wider than the field widens it, as with dtostrf.
+//
+// Values that fit in 16 bits are converted with 16-bit division, so the
+// usual tenths and hundredths cost a few tens of microseconds on an AVR.
+
+// The longest formatted number, not counting padding:  "-2.147483648".
+constexpr uint8_t maxFixedPointLength = 12;
+
+// The most decimal places that can be shown.
+constexpr uint8_t maxFixedPointDecimals = 9;
+
+// Formats value into buf, which must have room for the larger of width
+// and maxFixedPointLength, plus the terminating null.  Returns buf so that
+// the result can be passed straight to print().  numDecimals greater than
+// maxFixedPointDecimals is treated as maxFixedPointDecimals.
+char* formatFixedPoint(char* buf, int32_t value, uint8_t numDecimals, uint8_t width = 0);
+
+// Formats value and writes it to out.  width is limited to
+// maxFixedPointPrintWidth.  Returns the number of characters written.
+constexpr uint8_t maxFixedPointPrintWidth = 20;
+size_t printFixedPoint(Print& out, int32_t value, uint8_t numDecimals, uint8_t width = 0);
+
+}
+
+#endif  // #ifndef __FIXED_POINT_FORMAT_H
@@ -30,6 +30,12 @@ bool Glint::initPattern(bool configIsInFlash, void* patternConfig)
     w = (pixelSet->numSymmetricalPixels <= 30) ? 6 : pixelSet->numSymmetricalPixels / 5;
     ns = 255.0 / (float) w;
 
+    if (config.width > 0) {
+        sHundredths = config.stepIncrement * 100;
+        wHundredths = config.width * 100;
+        nsHundredths = 25500 / wHundredths;
+    }
+
     // We need update() to be called as soon as possible.
     nextUpdateMs = millis() - 1;
 
@@ -45,6 +51,7 @@ bool Glint::update()
 
     if (!doingGlint && now >= nextGlintMs) {
         n0 = - w;
+        n0Hundredths = - wHundredths;
         doingGlint = true;
 //        Serial.println("starting glint");
 //        Serial.print("s=");
@@ -63,7 +70,17 @@ bool Glint::update()
     hsvColor.v = pixelSet->backgroundIntensityScaleFactor;
     for (uint16_t i = 0; i < pixelSet->numSymmetricalPixels; ++i) {
 
-        if (doingGlint) {
+        if (doingGlint && config.width > 0) {
+            int32_t i100 = (int32_t) i * 100;
+            if (i100 < n0Hundredths || i100 > n0Hundredths + wHundredths) {
+                hsvColor.s = 255;
+            }
+            else {
+                int32_t n = (i100 - n0Hundredths) * nsHundredths;
+                hsvColor.s = 255 - quadwave8(n / 100);
+            }
+        }
+        else if (doingGlint) {
             if (i < n0 || i > n0 + w) {
                 hsvColor.s = 255;
             }
@@ -101,7 +118,11 @@ bool Glint::update()
 
     if (doingGlint) {
         n0 += s;
-        if (n0 >= (float) pixelSet->numSymmetricalPixels) {
+        n0Hundredths += sHundredths;
+        bool glintIsDone = config.width > 0
+            ? n0Hundredths >= (int32_t) pixelSet->numSymmetricalPixels * 100
+            : n0 >= (float) pixelSet->numSymmetricalPixels;
+        if (glintIsDone) {
             doingGlint = false;
             nextGlintMs = now + config.glintIntervalMs;
 //            Serial.println("glint done");
@@ -28,6 +28,8 @@ public:
         uint32_t glintIntervalMs;   // interval between glints
         // TODO:  express delay as the period of a complete glint
         uint32_t delayMs;           // ms delay between glint steps
+        uint8_t width;              // width (in pixels) of the glint; 0 to size it from the number of pixels
+        float   stepIncrement;      // pixels or fractions of a pixel to move the glint at each step (if width isn't 0)
     };
 
     Glint() {};
@@ -49,6 +51,13 @@ private:
     float s;
     float w;
     float ns;
+
+    // When the width is configured, the glint is positioned in hundredths
+    // of a pixel with integer math, like Permanence's original glint.
+    int32_t n0Hundredths;
+    int32_t sHundredths;
+    int32_t wHundredths;
+    int32_t nsHundredths;
 };
 
 }
@@ -0,0 +1,149 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Lamp Crossfade Lookup Tables                                    *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __LAMP_CROSSFADE_H
+#define __LAMP_CROSSFADE_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+
+namespace pixelPattern {
+
+// Fades across a row of outputs (lamps or the colors of a lamp) as a
+// position goes from 0 to numSteps.  At most two adjacent outputs are
+// above the minimum intensity:  one fading down and the next one fading
+// up.  At position 0, the first output is at maxIntensity, and at position
+// numSteps, the last one is.
+//
+// The fade is the same one that the lamp sketches used to calculate with
+// floating point angles and map(), where numSteps is the number of whole
+// degrees that the angle spans.  map() only saw whole degrees, so the
+// section and fade-down intensity for every whole degree are calculated
+// at compile time, the same way, and kept in flash.  A lookup doesn't need
+// floating point math, map(), or any division.  hostTests/lampCrossfadeTest
+// checks that the tables match the floating point fade.
+//
+// Usage:
+//   using ColorCrossfade = pixelPattern::LampCrossfade<3, 0, 255, 90>;
+//   uint16_t pos = ColorCrossfade::positionFromRange(angleTenths, -450, 450);
+//   ColorCrossfade::fill(pos, colorIntensities);
+
+namespace lampCrossfadeDetail {
+
+struct Entry {
+    uint8_t section;            // index of the output that is fading down
+    uint8_t fadeDownIntensity;  // its intensity; the next one's is max + min - this
+};
+
+template <uint16_t... i> struct IndexList {};
+
+template <uint16_t n, uint16_t... i>
+struct MakeIndexList : MakeIndexList<n - 1, n - 1, i...> {};
+
+template <uint16_t... i>
+struct MakeIndexList<0, i...> {
+    typedef IndexList<i...> type;
+};
+
+// The sections evenly divide the steps, and the fade is linear within each
+// section.  The last position belongs to the last section so that the
+// last output reaches maxIntensity.  The float math and the truncation of
+// the section bounds are the same as the sketches' floor() and map() calls.
+constexpr float sectionSteps(uint16_t numSteps, uint8_t numOutputs)
+{
+    return (float) numSteps / (numOutputs - 1);
+}
+
+constexpr uint8_t section(uint16_t position, uint16_t numSteps, uint8_t numOutputs)
+{
+    return (long) (position / sectionSteps(numSteps, numOutputs)) < numOutputs - 2
+           ? (long) (position / sectionSteps(numSteps, numOutputs))
+           : numOutputs - 2;
+}
+
+constexpr long sectionStart(uint8_t section, uint16_t numSteps, uint8_t numOutputs)
+{
+    return (long) (sectionSteps(numSteps, numOutputs) * section);
+}
+
+constexpr uint8_t fadeDownIntensity(uint16_t position, uint8_t fadeDownSection, uint16_t numSteps, uint8_t numOutputs,
+                                    uint8_t minIntensity, uint8_t maxIntensity)
+{
+    return (position - sectionStart(fadeDownSection, numSteps, numOutputs)) * ((long) minIntensity - maxIntensity)
+           / (sectionStart(fadeDownSection + 1, numSteps, numOutputs) - sectionStart(fadeDownSection, numSteps, numOutputs))
+           + maxIntensity;
+}
+
+template <uint8_t numOutputs, uint8_t minIntensity, uint8_t maxIntensity, uint16_t numSteps, typename Indices>
+struct Table;
+
+template <uint8_t numOutputs, uint8_t minIntensity, uint8_t maxIntensity, uint16_t numSteps, uint16_t... i>
+struct Table<numOutputs, minIntensity, maxIntensity, numSteps, IndexList<i...>> {
+    static const Entry entries[sizeof...(i)];
+};
+
+template <uint8_t numOutputs, uint8_t minIntensity, uint8_t maxIntensity, uint16_t numSteps, uint16_t... i>
+const Entry Table<numOutputs, minIntensity, maxIntensity, numSteps, IndexList<i...>>::entries[sizeof...(i)] PROGMEM = {
+    {section(i, numSteps, numOutputs),
+     fadeDownIntensity(i, section(i, numSteps, numOutputs), numSteps, numOutputs, minIntensity, maxIntensity)}...
+};
+
+}
+
+
+template <uint8_t numOutputs, uint8_t minIntensity, uint8_t maxIntensity, uint16_t numSteps>
+class LampCrossfade {
+
+public:
+
+    static_assert(numOutputs >= 2, "LampCrossfade needs at least two outputs.");
+    static_assert(minIntensity <= maxIntensity, "LampCrossfade minIntensity can't be more than maxIntensity.");
+    static_assert(numSteps >= numOutputs - 1, "LampCrossfade needs at least one step per section.");
+
+    // Scales value from [minValue, maxValue] to a position, truncating
+    // it to a whole step and clamping values that are outside the range.
+    static uint16_t positionFromRange(int16_t value, int16_t minValue, int16_t maxValue)
+    {
+        if (value <= minValue) {
+            return 0;
+        }
+        if (value >= maxValue) {
+            return numSteps;
+        }
+        return (uint32_t) (value - minValue) * numSteps / (uint16_t) (maxValue - minValue);
+    }
+
+    // Sets the intensities of all numOutputs outputs for position.
+    // Returns the index of the output that is fading down.
+    static uint8_t fill(uint16_t position, uint8_t* intensities)
+    {
+        const lampCrossfadeDetail::Entry* entry = Entries::entries + position;
+        uint8_t section = pgm_read_byte(&entry->section);
+        uint8_t fadeDownIntensity = pgm_read_byte(&entry->fadeDownIntensity);
+
+        for (uint8_t i = 0; i < numOutputs; ++i) {
+            intensities[i] = minIntensity;
+        }
+        intensities[section] = fadeDownIntensity;
+        intensities[section + 1] = maxIntensity + minIntensity - fadeDownIntensity;
+
+        return section;
+    }
+
+private:
+
+    typedef lampCrossfadeDetail::Table<numOutputs, minIntensity, maxIntensity, numSteps,
+                                       typename lampCrossfadeDetail::MakeIndexList<numSteps + 1>::type> Entries;
+};
+
+}
+
+#endif  // #ifndef __LAMP_CROSSFADE_H
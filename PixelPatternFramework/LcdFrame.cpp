@@ -0,0 +1,176 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Shadow-Buffered Character LCD Frame Class                       *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include <LiquidCrystal.h>
+#include "LcdFrame.h"
+
+using namespace pixelPattern;
+
+
+// The LCD's cursor position isn't known until we set it.
+static constexpr uint8_t unknownPosition = 0xff;
+
+
+LcdFrame::LcdFrame(LiquidCrystal& lcd, uint8_t numCols, uint8_t numRows)
+    : lcd(lcd)
+    , numCols(numCols <= maxCols ? numCols : maxCols)
+    , numRows(numRows <= maxRows ? numRows : maxRows)
+    , cursorCol(0)
+    , cursorRow(0)
+    , numDirtyCells(0)
+    , nextRefreshIdx(0)
+    , lcdCol(unknownPosition)
+    , lcdRow(unknownPosition)
+{
+    memset(cells, ' ', sizeof(cells));
+    memset(shownCells, ' ', sizeof(shownCells));
+}
+
+
+void LcdFrame::begin()
+{
+    lcd.begin(numCols, numRows);
+
+    // The LCD is blank now, so only what's been printed needs sending.
+    memset(shownCells, ' ', sizeof(shownCells));
+    numDirtyCells = 0;
+    for (uint8_t row = 0; row < numRows; ++row) {
+        for (uint8_t col = 0; col < numCols; ++col) {
+            if (cells[row][col] != ' ') {
+                ++numDirtyCells;
+            }
+        }
+    }
+    lcdCol = unknownPosition;
+    lcdRow = unknownPosition;
+}
+
+
+void LcdFrame::setCell(uint8_t col, uint8_t row, uint8_t c)
+{
+    uint8_t old = cells[row][col];
+    if (old == c) {
+        return;
+    }
+    cells[row][col] = c;
+
+    bool wasDirty = old != shownCells[row][col];
+    bool isDirty = c != shownCells[row][col];
+    if (isDirty && !wasDirty) {
+        ++numDirtyCells;
+    }
+    else if (wasDirty && !isDirty) {
+        --numDirtyCells;
+    }
+}
+
+
+void LcdFrame::clear()
+{
+    for (uint8_t row = 0; row < numRows; ++row) {
+        clearLine(row);
+    }
+    cursorCol = 0;
+    cursorRow = 0;
+}
+
+
+void LcdFrame::clearLine(uint8_t row)
+{
+    if (row >= numRows) {
+        return;
+    }
+    for (uint8_t col = 0; col < numCols; ++col) {
+        setCell(col, row, ' ');
+    }
+}
+
+
+void LcdFrame::invalidate()
+{
+    // Make each shown cell differ from what we want.
+    for (uint8_t row = 0; row < numRows; ++row) {
+        for (uint8_t col = 0; col < numCols; ++col) {
+            shownCells[row][col] = ~cells[row][col];
+        }
+    }
+    numDirtyCells = numRows * numCols;
+    lcdCol = unknownPosition;
+    lcdRow = unknownPosition;
+}
+
+
+void LcdFrame::setCursor(uint8_t col, uint8_t row)
+{
+    cursorCol = col;
+    cursorRow = row;
+}
+
+
+size_t LcdFrame::write(uint8_t c)
+{
+    if (cursorRow >= numRows || cursorCol >= numCols) {
+        return 0;
+    }
+    setCell(cursorCol++, cursorRow, c);
+    return 1;
+}
+
+
+void LcdFrame::writeLine(uint8_t row, const char* text)
+{
+    if (row >= numRows) {
+        return;
+    }
+    uint8_t col = 0;
+    for (; col < numCols && '\0' != text[col]; ++col) {
+        setCell(col, row, text[col]);
+    }
+    for (; col < numCols; ++col) {
+        setCell(col, row, ' ');
+    }
+}
+
+
+bool LcdFrame::refresh(uint16_t budgetUs)
+{
+    uint32_t startUs = micros();
+    uint8_t numCells = numRows * numCols;
+
+    for (uint8_t n = 0; n < numCells && numDirtyCells > 0; ++n) {
+        uint8_t row = nextRefreshIdx / numCols;
+        uint8_t col = nextRefreshIdx - row * numCols;
+        if (++nextRefreshIdx >= numCells) {
+            nextRefreshIdx = 0;
+        }
+
+        uint8_t c = cells[row][col];
+        if (c == shownCells[row][col]) {
+            continue;
+        }
+
+        // Consecutive changed cells in a row need only one setCursor.
+        if (col != lcdCol || row != lcdRow) {
+            lcd.setCursor(col, row);
+        }
+        lcd.write(c);
+        shownCells[row][col] = c;
+        --numDirtyCells;
+        lcdCol = col + 1;
+        lcdRow = row;
+
+        if (micros() - startUs >= budgetUs) {
+            break;
+        }
+    }
+
+    return 0 == numDirtyCells;
+}
@@ -0,0 +1,93 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Shadow-Buffered Character LCD Frame Class                       *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __LCD_FRAME_H
+#define __LCD_FRAME_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+class LiquidCrystal;
+
+
+namespace pixelPattern {
+
+// Holds the frame we want on an HD44780 character LCD, along with a copy
+// of what is actually on it.  Printing to the frame doesn't touch the
+// LCD.  refresh() sends only the cells that differ, and it stops once
+// its time budget is used up so that a full redraw can be spread across
+// several calls instead of blocking for a few milliseconds.
+//
+// Text printed past the end of a row is dropped rather than wrapped.
+class LcdFrame : public Print {
+
+public:
+
+    static constexpr uint8_t maxCols = 20;
+    static constexpr uint8_t maxRows = 4;
+
+    LcdFrame(LiquidCrystal& lcd, uint8_t numCols, uint8_t numRows);
+
+    virtual ~LcdFrame() {}
+
+    LcdFrame(const LcdFrame&) = delete;
+    LcdFrame& operator =(const LcdFrame&) = delete;
+
+    // Initializes the LCD, which clears it.
+    void begin();
+
+    // Fills the frame with spaces.
+    void clear();
+
+    // Fills row with spaces.
+    void clearLine(uint8_t row);
+
+    // Marks every cell as needing to be sent, such as after writing to
+    // the LCD directly.
+    void invalidate();
+
+    bool isDirty() const { return numDirtyCells > 0; }
+
+    // Sends changed cells to the LCD until it matches the frame or about
+    // budgetUs microseconds have gone by.  Returns true if it matches.
+    bool refresh(uint16_t budgetUs);
+
+    void setCursor(uint8_t col, uint8_t row);
+
+    virtual size_t write(uint8_t c);
+    using Print::write;
+
+    // Replaces row with text, padded with spaces.
+    void writeLine(uint8_t row, const char* text);
+
+private:
+
+    void setCell(uint8_t col, uint8_t row, uint8_t c);
+
+    LiquidCrystal& lcd;
+    uint8_t numCols;
+    uint8_t numRows;
+    uint8_t cursorCol;
+    uint8_t cursorRow;
+
+    uint8_t cells[maxRows][maxCols];
+    uint8_t shownCells[maxRows][maxCols];
+    uint8_t numDirtyCells;
+
+    // where refresh() picks up, and where the LCD's cursor is (its
+    // address counter steps to the next column after each write)
+    uint8_t nextRefreshIdx;
+    uint8_t lcdCol;
+    uint8_t lcdRow;
+};
+
+}
+
+#endif  // #ifndef __LCD_FRAME_H
@@ -0,0 +1,79 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Legacy Pattern Sequence Adapter                                 *
+ *                                                                 *
+ * by Ross Butler   Nov. 2016                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include "LegacyPatternSequence.h"
+
+using namespace pixelPattern;
+
+
+LegacyPatternSequence::LegacyPatternSequence(
+    const LegacyPatternDef* legacyPatternDefs,
+    uint8_t numPatterns,
+    const LegacyPatternType* patternTypes,
+    uint8_t numPatternTypes,
+    PatternSelector* patternSelector)
+    : PatternSequence(nullptr, numPatterns, patternSelector)
+    , legacyPatternDefs(legacyPatternDefs)
+    , patternTypes(patternTypes)
+    , numPatternTypes(numPatternTypes)
+{
+}
+
+
+void LegacyPatternSequence::readPatternDefinitionFromFlash(
+    uint8_t patternNum,
+    uint8_t* pPatternId,
+    uint32_t* pDurationMs,
+    void** pPatternConfig,
+    String* pPatternName)
+{
+    const LegacyPatternDef* patDef = legacyPatternDefs + patternNum;
+
+    uint8_t patternType = (uint8_t) pgm_read_byte(&patDef->patternType);
+    const LegacyPatternType* lpt = patternType < numPatternTypes ? patternTypes + patternType : nullptr;
+    bool canRun = lpt != nullptr && lpt->paramStructSize <= maxLegacyParamsSize;
+
+    if (pPatternId) {
+        *pPatternId = canRun ? lpt->patternId : SolidColor::id;
+    }
+
+    if (pDurationMs) {
+        // Like the legacy sketches, show red for a second when a pattern can't run.
+        uint32_t durationSec = canRun ? (uint32_t) pgm_read_dword(&patDef->durationSec) : 1;
+        *pDurationMs = durationSec * 1000;
+    }
+
+    if (pPatternConfig) {
+        if (canRun) {
+            const void* patParams;
+            if (sizeof(patDef->patParams) == 4) {
+                patParams = (const void*) pgm_read_dword(&patDef->patParams);
+            }
+            else {
+                patParams = (const void*) pgm_read_word(&patDef->patParams);
+            }
+
+            // The legacy parameters are converted from a RAM copy so that
+            // the converters don't have to read each member from flash.
+            uint32_t legacyParamsBuf[maxLegacyParamsSize / sizeof(uint32_t)];
+            memcpy_P(legacyParamsBuf, patParams, lpt->paramStructSize);
+            (*lpt->convertParams)(legacyParamsBuf, &patternConfigBuf);
+        }
+        else {
+            patternConfigBuf.solidColor = {HUE_RED, HUE_RED, 255, 1000, false};
+        }
+        *pPatternConfig = &patternConfigBuf;
+    }
+
+    if (pPatternName) {
+        *pPatternName = "Pattern " + String(patternNum);
+    }
+}
@@ -0,0 +1,456 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Legacy Pattern Sequence Adapter                                 *
+ *                                                                 *
+ * by Ross Butler   Nov. 2016                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __LEGACY_PATTERN_SEQUENCE_H
+#define __LEGACY_PATTERN_SEQUENCE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "PatternSequence.h"
+#include "Blocks.h"
+#include "Glint.h"
+#include "MovingDot.h"
+#include "MultiWave.h"
+#include "Rainbow.h"
+#include "SolidColor.h"
+#include "Sparkle.h"
+#include "SplitRotation.h"
+
+
+namespace pixelPattern {
+
+class PatternSelector;
+
+
+// Converts a legacy pattern parameters struct in RAM to a framework PatternConfig.
+typedef void (*LegacyParamsConverter)(const void* legacyParams, void* patternConfig);
+
+// This is the framework counterpart of a legacy sketch's patternMetadata
+// entry.  It associates a legacy pattern type with the framework pattern
+// that draws it and the function that converts its parameters.
+struct LegacyPatternType {
+    uint8_t patternId;
+    uint8_t paramStructSize;
+    LegacyParamsConverter convertParams;
+};
+
+
+// Runs a pre-framework sketch's patternDef table, unchanged, on a
+// PixelPatternController.  Those sketches (Permanence, LampshadeHat,
+// TripperStickII, etc.) define
+//
+//     struct patternDef {
+//       uint8_t       patternType;
+//       unsigned long durationSec;
+//       const void*   patParams;
+//     };
+//
+// and a pattern metadata table indexed by the patternType constants.
+// The sketch replaces its metadata table with a table of LegacyPatternType
+// entries, in the same order, built with the legacyXxx helpers below:
+//
+//     #define LEGACY_STYLE (LegacyStyle::random8Sparkle)
+//
+//     const LegacyPatternType legacyPatternTypes[] = {
+//       legacyMovingDot<movingDotParams_t, LEGACY_STYLE>(),    // MOVING_DOT
+//       legacyMultiWave<multiWaveParams_t, LEGACY_STYLE>(),    // MULTI_WAVE
+//       legacyRainbow<rainbowParams_t, LEGACY_STYLE>(),        // RAINBOW
+//       legacySparkle<sparkleParams_t, SPARKLE_DELAY, MAX_SPARKLE_DENSITY, LEGACY_STYLE>(),  // SPARKLE
+//       legacySplitRotation<splitRotationParams_t>(),          // SPLIT_ROTATION
+//     };
+//
+//     LegacyPatternSequence patternSequence(
+//         patternsDefs, NUM_PATTERNS,
+//         legacyPatternTypes, sizeof(legacyPatternTypes) / sizeof(LegacyPatternType));
+//
+// The LegacyStyle flags (below) pick the ways that the sketch's copies of
+// the pattern functions differed from the other sketches' copies, and
+// hostTests/runHostTests checks that each converted sketch still shows the
+// same frames that its original pattern functions did.
+//
+// When a pattern starts, its parameters are read from flash and converted
+// to the framework pattern's config in RAM.  The framework patterns use the
+// pixel set's intensity scale factors instead of BG_INTENSITY_SCALE_FACTOR.
+// A pattern type that isn't in the table, or whose parameters are larger
+// than maxLegacyParamsSize, is shown as dim solid red for one second.
+class LegacyPatternSequence : public PatternSequence {
+
+public:
+
+    static constexpr uint8_t maxLegacyParamsSize = 32;      // the legacy sketches' PAT_PARAMS_BUF_SIZE
+
+    // The layout shared by the legacy sketches' patternDef structs.
+    struct LegacyPatternDef {
+        uint8_t       patternType;
+        unsigned long durationSec;
+        const void*   patParams;
+    };
+
+    template <typename PatternDefT>
+    LegacyPatternSequence(
+        const PatternDefT* legacyPatternDefs,
+        uint8_t numPatterns,
+        const LegacyPatternType* patternTypes,
+        uint8_t numPatternTypes,
+        PatternSelector* patternSelector = nullptr)
+        : LegacyPatternSequence(
+            (const LegacyPatternDef*) legacyPatternDefs,
+            numPatterns,
+            patternTypes,
+            numPatternTypes,
+            patternSelector)
+    {
+        static_assert(sizeof(PatternDefT) == sizeof(LegacyPatternDef)
+                      && offsetof(PatternDefT, durationSec) == offsetof(LegacyPatternDef, durationSec)
+                      && offsetof(PatternDefT, patParams) == offsetof(LegacyPatternDef, patParams),
+                      "legacy patternDef layout doesn't match LegacyPatternDef");
+    }
+
+    LegacyPatternSequence(
+        const LegacyPatternDef* legacyPatternDefs,
+        uint8_t numPatterns,
+        const LegacyPatternType* patternTypes,
+        uint8_t numPatternTypes,
+        PatternSelector* patternSelector = nullptr);
+
+    ~LegacyPatternSequence() {}
+
+    LegacyPatternSequence(const LegacyPatternSequence&) = delete;
+    LegacyPatternSequence& operator =(const LegacyPatternSequence&) = delete;
+
+    const char* getPatternName(uint8_t) { return nullptr; }
+    bool patternConfigIsInFlash() { return false; }
+
+    void readPatternDefinitionFromFlash(
+        uint8_t patternNum,
+        uint8_t* pPatternId = nullptr,
+        uint32_t* pDurationMs = nullptr,
+        void** pPatternConfig = nullptr,
+        String* pPatternName = nullptr);
+
+private:
+
+    const LegacyPatternDef* legacyPatternDefs;
+    const LegacyPatternType* patternTypes;
+    uint8_t numPatternTypes;
+
+    // the config of the current pattern, converted from its legacy parameters
+    union {
+        Blocks::PatternConfig blocks;
+        Glint::PatternConfig glint;
+        MovingDot::PatternConfig movingDot;
+        MultiWave::PatternConfig multiWave;
+        Rainbow::PatternConfig rainbow;
+        SolidColor::PatternConfig solidColor;
+        Sparkle::PatternConfig sparkle;
+        SplitRotation::PatternConfig splitRotation;
+    } patternConfigBuf;
+};
+
+
+/*****************************
+ * Legacy Parameter Adapters *
+ *****************************/
+
+// Each sketch had its own copy of the pattern functions, and the copies
+// drifted apart.  A sketch passes the LegacyStyle flags for the
+// differences its copies had to the legacyXxx helpers.
+namespace LegacyStyle {
+    constexpr uint16_t unscaledDot = 0x0001;    // movingDot doesn't dim the dot to BG_INTENSITY_SCALE_FACTOR
+    constexpr uint16_t random8Sparkle = 0x0002; // sparkle picks its pixels with random8
+    constexpr uint16_t loopTimed = 0x0004;      // movingDot and multiWave time their steps by counting loops
+    constexpr uint16_t fullHueRainbow = 0x0008; // rainbow spans all 256 hues across a panel instead of 255
+    constexpr uint16_t valueDimmedSolid = 0x0010; // solidColor dims its color with the HSV value
+}
+
+// The legacy sketches' param structs differ slightly from sketch to sketch
+// (e.g., only some solidColorParams have a saturation), so these pick up
+// the optional members when they exist and supply the old defaults when not.
+
+template <typename P>
+auto legacySaturation(const P& p, int) -> decltype(p.saturation) { return p.saturation; }
+template <typename P>
+uint8_t legacySaturation(const P&, long) { return 255; }
+
+template <typename P>
+auto legacyNumPixelsPerSegment(const P& p, int) -> decltype(p.numPixelsPerSegment) { return p.numPixelsPerSegment; }
+template <typename P>
+uint8_t legacyNumPixelsPerSegment(const P&, long) { return 11; }
+
+
+inline ColorWave::WaveformType legacyWaveformType(uint8_t waveformType)
+{
+    // SQUARE_WAVE, TRIANGLE_WAVE, QUADRATIC_EASING, CUBIC_EASING, SINE_WAVE
+    switch (waveformType) {
+        case 0:
+            return ColorWave::square;
+        case 1:
+            return ColorWave::triangle;
+        case 2:
+            return ColorWave::quadraticEasing;
+        case 3:
+            return ColorWave::cubicEasing;
+        default:
+            return ColorWave::sine;
+    }
+}
+
+
+template <typename P, uint16_t style>
+void convertLegacyMovingDot(const void* legacyParams, void* patternConfig)
+{
+    const P* lp = (const P*) legacyParams;
+    MovingDot::PatternConfig* pc = (MovingDot::PatternConfig*) patternConfig;
+
+    pc->fgColorCode = lp->fgColorCode;
+    pc->bgColorCode = lp->bgColorCode;
+    pc->randomFgColor = lp->randomFgColor;
+    pc->randomBgColor = lp->randomBgColor;
+    pc->changeFgColor = lp->changeFgColor;
+    pc->zipperBg = lp->zipperBg;
+    pc->bidirectional = lp->bidirectional;
+    pc->delay0Ms = lp->delay0;
+    pc->delay1Ms = lp->delay1;
+    pc->holdTimeFarMs = lp->holdTimeFarMs;
+    pc->holdTimeNearMs = lp->holdTimeNearMs;
+    pc->brightFg = style & LegacyStyle::unscaledDot;
+    pc->keepColorWhileHeld = style & LegacyStyle::loopTimed;
+}
+
+
+template <typename P, uint16_t style>
+void convertLegacyMultiWave(const void* legacyParams, void* patternConfig)
+{
+    const P* lp = (const P*) legacyParams;
+    MultiWave::PatternConfig* pc = (MultiWave::PatternConfig*) patternConfig;
+
+    constexpr uint8_t numLegacyWaveforms = sizeof(lp->waveParams) / sizeof(lp->waveParams[0]);
+
+    pc->boundedByPanel = lp->boundedByPanel;
+    pc->addValues = true;
+    pc->delayFirstStep = true;
+    for (uint8_t w = 0; w < MultiWave::maxWaveforms; ++w) {
+        ColorWave& cw = pc->waveParams[w];
+        if (w >= numLegacyWaveforms) {
+            cw.numWaves = 0;
+            cw.waveformType = ColorWave::none;
+            continue;
+        }
+        cw.randomHue = lp->waveParams[w].randomHue;
+        cw.posHue = lp->waveParams[w].posHue;
+        cw.posSaturation = 255;
+        cw.negHue = lp->waveParams[w].negHue;
+        cw.negSaturation = 255;
+        cw.numWaves = lp->waveParams[w].numWaves;
+        cw.waveformType = legacyWaveformType(lp->waveParams[w].waveformType);
+        cw.directionDown = lp->waveParams[w].directionDown;
+        // A loop-timed wave's delay counter wraps, so 0 counts 256 loops.
+        cw.delayMs = (style & LegacyStyle::loopTimed) && 0 == lp->waveParams[w].delay ? 256 : lp->waveParams[w].delay;
+    }
+}
+
+
+template <typename P, uint16_t style>
+void convertLegacyRainbow(const void* legacyParams, void* patternConfig)
+{
+    const P* lp = (const P*) legacyParams;
+    Rainbow::PatternConfig* pc = (Rainbow::PatternConfig*) patternConfig;
+
+    pc->directionDown = lp->directionDown;
+    pc->delayMs = lp->delay;
+    pc->hueSpan = (style & LegacyStyle::fullHueRainbow) ? 256 : 255;
+}
+
+
+template <typename P, uint32_t sparkleDelayMs, uint8_t maxSparkleDensity, uint16_t style>
+void convertLegacySparkle(const void* legacyParams, void* patternConfig)
+{
+    // The legacy sparkle moves each sparkle to a new pixel, in turn, every
+    // SPARKLE_DELAY ms, and limits the density to MAX_SPARKLE_DENSITY.
+
+    const P* lp = (const P*) legacyParams;
+    Sparkle::PatternConfig* pc = (Sparkle::PatternConfig*) patternConfig;
+
+    pc->fgColorCode = lp->fgColorCode;
+    pc->bgColorCode = lp->bgColorCode;
+    pc->density = lp->density <= maxSparkleDensity ? lp->density : maxSparkleDensity;
+    pc->dwellMs = sparkleDelayMs;
+    pc->changeMs = sparkleDelayMs;
+    pc->moveInTurn = true;
+    pc->useRandom8 = style & LegacyStyle::random8Sparkle;
+}
+
+
+template <typename P>
+void convertLegacySplitRotation(const void* legacyParams, void* patternConfig)
+{
+    const P* lp = (const P*) legacyParams;
+    SplitRotation::PatternConfig* pc = (SplitRotation::PatternConfig*) patternConfig;
+
+    pc->mode = SplitRotation::original;
+    pc->randomHue = lp->randomHue;
+    pc->fgHue = lp->fgHue;
+    pc->bgHue = lp->bgHue;
+    pc->fgInterval = lp->fgInterval;
+    pc->directionDown = lp->directionDown;
+    pc->delayMs = lp->delay;
+}
+
+
+template <typename P, uint16_t style>
+void convertLegacySolidColor(const void* legacyParams, void* patternConfig)
+{
+    const P* lp = (const P*) legacyParams;
+    SolidColor::PatternConfig* pc = (SolidColor::PatternConfig*) patternConfig;
+
+    pc->startHue = lp->startHue;
+    pc->endHue = lp->endHue;
+    pc->saturation = legacySaturation(*lp, 0);
+    pc->delay = lp->delay;
+    pc->dimByValue = style & LegacyStyle::valueDimmedSolid;
+}
+
+
+template <typename P>
+void convertLegacyGlint(const void* legacyParams, void* patternConfig)
+{
+    const P* lp = (const P*) legacyParams;
+    Glint::PatternConfig* pc = (Glint::PatternConfig*) patternConfig;
+
+    pc->bgHue = lp->bgHue;
+    pc->glintIntervalMs = lp->glintInterval;
+    pc->delayMs = lp->delay;
+    pc->width = lp->width;
+    pc->stepIncrement = lp->stepIncrement;
+}
+
+
+template <typename P>
+void convertLegacyShine(const void* legacyParams, void* patternConfig)
+{
+    // Shine was renamed Glint when it moved into the framework.
+
+    const P* lp = (const P*) legacyParams;
+    Glint::PatternConfig* pc = (Glint::PatternConfig*) patternConfig;
+
+    pc->bgHue = lp->bgHue;
+    pc->glintIntervalMs = lp->shineInterval;
+    pc->delayMs = lp->delay;
+    pc->width = 0;
+    pc->stepIncrement = 0;
+}
+
+
+template <typename P>
+void convertLegacyRedWhiteAndBlue(const void* legacyParams, void* patternConfig)
+{
+    // Red, white, and blue segments rotating one pixel per step are
+    // three rotating blocks.
+
+    const P* lp = (const P*) legacyParams;
+    Blocks::PatternConfig* pc = (Blocks::PatternConfig*) patternConfig;
+
+    uint8_t numPixelsPerSegment = legacyNumPixelsPerSegment(*lp, 0);
+
+    memset(pc, 0, sizeof(Blocks::PatternConfig));
+    pc->delayMs = lp->delay;
+    pc->blocks[0] = {HUE_RED, 255, numPixelsPerSegment};
+    pc->blocks[1] = {HUE_RED, 0, numPixelsPerSegment};
+    pc->blocks[2] = {HUE_BLUE, 255, numPixelsPerSegment};
+}
+
+
+template <typename P>
+void convertLegacyXmasLights(const void* legacyParams, void* patternConfig)
+{
+    // Each hue is a one-pixel, non-rotating block.
+
+    const P* lp = (const P*) legacyParams;
+    Blocks::PatternConfig* pc = (Blocks::PatternConfig*) patternConfig;
+
+    memset(pc, 0, sizeof(Blocks::PatternConfig));
+    pc->delayMs = 0;
+    uint8_t numHues = lp->numHues <= Blocks::numBlocks ? lp->numHues : Blocks::numBlocks;
+    for (uint8_t i = 0; i < numHues; ++i) {
+        pc->blocks[i] = {lp->hues[i], 255, 1};
+    }
+    if (0 == numHues) {
+        pc->blocks[0] = {HUE_RED, 255, 1};
+    }
+}
+
+
+/*************************************
+ * Legacy Pattern Type Table Entries *
+ *************************************/
+
+template <typename P, uint16_t style = 0>
+constexpr LegacyPatternType legacyMovingDot()
+{
+    return {MovingDot::id, sizeof(P), convertLegacyMovingDot<P, style>};
+}
+
+template <typename P, uint16_t style = 0>
+constexpr LegacyPatternType legacyMultiWave()
+{
+    return {MultiWave::id, sizeof(P), convertLegacyMultiWave<P, style>};
+}
+
+template <typename P, uint16_t style = 0>
+constexpr LegacyPatternType legacyRainbow()
+{
+    return {Rainbow::id, sizeof(P), convertLegacyRainbow<P, style>};
+}
+
+template <typename P, uint32_t sparkleDelayMs, uint8_t maxSparkleDensity, uint16_t style = 0>
+constexpr LegacyPatternType legacySparkle()
+{
+    return {Sparkle::id, sizeof(P), convertLegacySparkle<P, sparkleDelayMs, maxSparkleDensity, style>};
+}
+
+template <typename P>
+constexpr LegacyPatternType legacySplitRotation()
+{
+    return {SplitRotation::id, sizeof(P), convertLegacySplitRotation<P>};
+}
+
+template <typename P, uint16_t style = 0>
+constexpr LegacyPatternType legacySolidColor()
+{
+    return {SolidColor::id, sizeof(P), convertLegacySolidColor<P, style>};
+}
+
+template <typename P>
+constexpr LegacyPatternType legacyGlint()
+{
+    return {Glint::id, sizeof(P), convertLegacyGlint<P>};
+}
+
+template <typename P>
+constexpr LegacyPatternType legacyShine()
+{
+    return {Glint::id, sizeof(P), convertLegacyShine<P>};
+}
+
+template <typename P>
+constexpr LegacyPatternType legacyRedWhiteAndBlue()
+{
+    return {Blocks::id, sizeof(P), convertLegacyRedWhiteAndBlue<P>};
+}
+
+template <typename P>
+constexpr LegacyPatternType legacyXmasLights()
+{
+    return {Blocks::id, sizeof(P), convertLegacyXmasLights<P>};
+}
+
+}
+
+#endif  // #ifndef __LEGACY_PATTERN_SEQUENCE_H
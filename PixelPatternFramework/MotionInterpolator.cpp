@@ -0,0 +1,141 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Motion Interpolator Class                                       *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include "MotionInterpolator.h"
+
+using namespace pixelPattern;
+
+
+MotionInterpolator::MotionInterpolator(
+    int16_t restValue,
+    uint16_t maxSlewPerSec,
+    uint16_t maxPredictionMs,
+    uint16_t timeoutMs,
+    int16_t wrapModulus)
+    : restValue(restValue)
+    , maxSlewPerSec(maxSlewPerSec)
+    , maxPredictionMs(maxPredictionMs)
+    , timeoutMs(timeoutMs)
+    , wrapModulus(wrapModulus)
+{
+    reset(restValue);
+}
+
+
+void MotionInterpolator::reset(int16_t value)
+{
+    haveSample = false;
+    sampleValue = value;
+    sampleVelocityPerSec = 0;
+    sampleMs = 0;
+    outputValue = value;
+    lastUpdateMs = 0;
+}
+
+
+int16_t MotionInterpolator::wrapDelta(int32_t delta) const
+{
+    // Returns delta, or for wrapped values, the equivalent delta with the
+    // smallest magnitude.
+
+    if (0 != wrapModulus) {
+        delta %= wrapModulus;
+        if (delta >= wrapModulus / 2) {
+            delta -= wrapModulus;
+        }
+        else if (delta < -wrapModulus / 2) {
+            delta += wrapModulus;
+        }
+    }
+    return constrain(delta, INT16_MIN, INT16_MAX);
+}
+
+
+int16_t MotionInterpolator::wrapValue(int32_t value) const
+{
+    if (0 != wrapModulus) {
+        value %= wrapModulus;
+        if (value < 0) {
+            value += wrapModulus;
+        }
+    }
+    return constrain(value, INT16_MIN, INT16_MAX);
+}
+
+
+void MotionInterpolator::addSample(int16_t value, uint32_t nowMs)
+{
+    // Estimate the velocity from the previous sample, averaging it with
+    // the previous estimate to take the edge off of measurement noise.
+    // Without a recent previous sample, assume the value isn't moving.
+
+    int16_t velocityPerSec = 0;
+    uint32_t elapsedMs = nowMs - sampleMs;
+    if (haveSample && elapsedMs > 0 && elapsedMs <= timeoutMs) {
+        int32_t newVelocityPerSec = (int32_t) wrapDelta((int32_t) value - sampleValue) * 1000 / (int32_t) elapsedMs;
+        velocityPerSec = constrain((newVelocityPerSec + sampleVelocityPerSec) / 2, INT16_MIN, INT16_MAX);
+    }
+
+    addSample(value, velocityPerSec, nowMs);
+}
+
+
+void MotionInterpolator::addSample(int16_t value, int16_t velocityPerSec, uint32_t nowMs)
+{
+    // If we were at rest, start from the new value instead of slewing to it.
+    if (!haveSample || isTimedOut(nowMs)) {
+        outputValue = value;
+        lastUpdateMs = nowMs;
+    }
+
+    haveSample = true;
+    sampleValue = value;
+    sampleVelocityPerSec = velocityPerSec;
+    sampleMs = nowMs;
+}
+
+
+bool MotionInterpolator::isTimedOut(uint32_t nowMs) const
+{
+    return !haveSample || nowMs - sampleMs > timeoutMs;
+}
+
+
+int16_t MotionInterpolator::update(uint32_t nowMs)
+{
+    uint32_t elapsedMs = nowMs - lastUpdateMs;
+    lastUpdateMs = nowMs;
+
+    int32_t targetValue;
+    if (isTimedOut(nowMs)) {
+        targetValue = restValue;
+    }
+    else {
+        uint32_t predictionMs = nowMs - sampleMs;
+        if (predictionMs > maxPredictionMs) {
+            predictionMs = maxPredictionMs;
+        }
+        targetValue = sampleValue + (int32_t) sampleVelocityPerSec * (int32_t) predictionMs / 1000;
+        if (0 == wrapModulus) {
+            targetValue = constrain(targetValue, INT16_MIN, INT16_MAX);
+        }
+    }
+
+    // Move toward the target, but no farther than the slew rate allows.
+    // Long gaps between updates (like the first one) are capped at a
+    // second so that the product can't overflow.
+    int32_t delta = wrapDelta(targetValue - outputValue);
+    int32_t maxDelta = (int32_t) maxSlewPerSec * (int32_t) min(elapsedMs, (uint32_t) 1000) / 1000;
+    delta = constrain(delta, -maxDelta, maxDelta);
+    outputValue = wrapValue((int32_t) outputValue + delta);
+
+    return outputValue;
+}
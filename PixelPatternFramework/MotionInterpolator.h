@@ -0,0 +1,90 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Motion Interpolator Class                                       *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __MOTION_INTERPOLATOR_H
+#define __MOTION_INTERPOLATOR_H
+
+#include <stdint.h>
+
+
+namespace pixelPattern {
+
+// Smooths a value that arrives in irregular samples (such as a widget
+// angle received by radio) so that it can be read at a steady output
+// rate.  Between samples, the value is extrapolated along the sample's
+// velocity for up to maxPredictionMs.  The output moves toward that
+// prediction no faster than maxSlewPerSec, which hides both the sample
+// rate and the jump after a dropped packet.  If no sample arrives for
+// timeoutMs, the output slews to restValue and stays there.
+//
+// Values and velocities are in the caller's units (e.g., tenths of a
+// degree and tenths of a degree per second).  When wrapModulus isn't 0,
+// values wrap around in [0, wrapModulus), and the output takes the short
+// way around.
+class MotionInterpolator {
+
+public:
+
+    MotionInterpolator(
+        int16_t restValue,
+        uint16_t maxSlewPerSec,
+        uint16_t maxPredictionMs,
+        uint16_t timeoutMs,
+        int16_t wrapModulus = 0);
+
+    ~MotionInterpolator() {}
+
+    MotionInterpolator(const MotionInterpolator&) = delete;
+    MotionInterpolator& operator =(const MotionInterpolator&) = delete;
+
+    // Adds a sample whose velocity is estimated from the previous sample.
+    void addSample(int16_t value, uint32_t nowMs);
+
+    // Adds a sample with a known velocity (units per second).
+    void addSample(int16_t value, int16_t velocityPerSec, uint32_t nowMs);
+
+    // Returns the most recent sample.
+    int16_t getLastSample() const { return sampleValue; }
+
+    // Returns the output value as of the last update.
+    int16_t getValue() const { return outputValue; }
+
+    bool isTimedOut(uint32_t nowMs) const;
+
+    // Jumps the output to value and forgets the samples.
+    void reset(int16_t value);
+
+    // Advances the output to nowMs and returns it.  Call this at the
+    // output rate, not when samples arrive.
+    int16_t update(uint32_t nowMs);
+
+private:
+
+    int16_t wrapDelta(int32_t delta) const;
+    int16_t wrapValue(int32_t value) const;
+
+    const int16_t restValue;
+    const uint16_t maxSlewPerSec;
+    const uint16_t maxPredictionMs;
+    const uint16_t timeoutMs;
+    const int16_t wrapModulus;
+
+    bool haveSample;
+    int16_t sampleValue;
+    int16_t sampleVelocityPerSec;
+    uint32_t sampleMs;
+
+    int16_t outputValue;
+    uint32_t lastUpdateMs;
+};
+
+}
+
+#endif  // #ifndef __MOTION_INTERPOLATOR_H
@@ -38,7 +38,7 @@ bool MovingDot::initPattern(bool configIsInFlash, void* patternConfig)
     if (!config.randomBgColor) {
         bgColor = config.bgColorCode;
     }
-    fgColor.nscale8_video(pixelSet->backgroundIntensityScaleFactor);
+    fgColor.nscale8_video(getFgIntensityScaleFactor());
     bgColor.nscale8_video(pixelSet->backgroundIntensityScaleFactor);
 
     if (!config.zipperBg) {
@@ -75,10 +75,13 @@ bool MovingDot::update()
 
         // moving toward pixel 0
         case 1:
+            nextUpdateMs = now + config.delay1Ms;
             if (--stepNum == 0) {
                 stepDir = 3;
+                if (config.keepColorWhileHeld && config.holdTimeNearMs > config.delay1Ms) {
+                    nextUpdateMs = now + config.holdTimeNearMs;
+                }
             }
-            nextUpdateMs = now + config.delay1Ms;
             break;
 
         // held at far end
@@ -96,7 +99,14 @@ bool MovingDot::update()
         // held at near end
         case 3:
             stepDir = 0;
-            nextUpdateMs = now + config.holdTimeNearMs;
+            if (config.keepColorWhileHeld) {
+                // The hold is over, so take the first step now.
+                ++stepNum;
+                nextUpdateMs = now + config.delay0Ms;
+            }
+            else {
+                nextUpdateMs = now + config.holdTimeNearMs;
+            }
             break;
     }
 
@@ -104,12 +114,12 @@ bool MovingDot::update()
         if (config.zipperBg) {
             // When doing the zipper effect, change the background color, too.
             selectRandomRgb(&fgColor, &bgColor);
-            fgColor.nscale8_video(pixelSet->backgroundIntensityScaleFactor);
+            fgColor.nscale8_video(getFgIntensityScaleFactor());
             bgColor.nscale8_video(pixelSet->backgroundIntensityScaleFactor);
         }
         else {
             selectRandomRgb(&fgColor, NULL);
-            fgColor.nscale8_video(pixelSet->backgroundIntensityScaleFactor);
+            fgColor.nscale8_video(getFgIntensityScaleFactor());
         }
     }
 
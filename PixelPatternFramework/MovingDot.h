@@ -36,6 +36,8 @@ public:
         uint32_t            delay1Ms;       // delay between dot steps when moving toward pixel 0
         uint32_t            holdTimeFarMs;  // how long to hold the dot at the far end before it moves back toward pixel 0
         uint32_t            holdTimeNearMs; // how long to hold the dot at the near end before it moves toward the last pixel
+        bool                brightFg;       // true if the dot should be scaled by the foreground intensity instead of the background's
+        bool                keepColorWhileHeld; // true if a new dot color should first show when the dot leaves the near end
     };
 
     MovingDot() {};
@@ -49,6 +51,8 @@ public:
 
 private:
 
+    uint8_t getFgIntensityScaleFactor() const { return config.brightFg ? pixelSet->foregroundIntensityScaleFactor : pixelSet->backgroundIntensityScaleFactor; }
+
     PatternConfig config;
     uint16_t stepNum;
     uint8_t stepDir;    // 0 = away from pixel 0, 1 = toward pixel 0, 2 = hold at far end, 3 = hold at near end
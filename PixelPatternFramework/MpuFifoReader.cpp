@@ -0,0 +1,172 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * MPU6050 DMP FIFO Reader Class                                   *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include "MPU6050.h"
+#include "MpuFifoReader.h"
+
+using namespace pixelPattern;
+
+
+MpuFifoReader::MpuFifoReader(MPU6050& mpu, uint8_t maxPacketsPerRead)
+    : numPacketsRead(0)
+    , numPacketsDropped(0)
+    , numOverflows(0)
+    , numResyncs(0)
+    , mpu(mpu)
+    , maxPacketsPerRead(maxPacketsPerRead)
+    , packetSize(0)
+    , buffer(nullptr)
+    , isSynced(false)
+{
+}
+
+
+MpuFifoReader::~MpuFifoReader()
+{
+    delete[] buffer;
+}
+
+
+bool MpuFifoReader::begin(uint16_t packetSize)
+{
+    // getFIFOBytes can't read more than 255 bytes at a time.
+    if (0 == packetSize || packetSize > 255 || 0 == maxPacketsPerRead) {
+        return false;
+    }
+
+    delete[] buffer;
+    this->packetSize = packetSize;
+    buffer = new uint8_t[packetSize * maxPacketsPerRead];
+    if (0 == buffer) {
+        return false;
+    }
+
+    restart();
+    return true;
+}
+
+
+void MpuFifoReader::restart()
+{
+    mpu.resetFIFO();
+    isSynced = false;
+}
+
+
+void MpuFifoReader::resync(uint16_t fifoCount)
+{
+    numPacketsDropped += fifoCount / packetSize;
+    ++numResyncs;
+    restart();
+}
+
+
+bool MpuFifoReader::isPacketAligned(const uint8_t* packet)
+{
+    // A DMP packet starts with the orientation quaternion as four
+    // big-endian Q30 values.  The quaternion is normalized, so the squares
+    // of the Q14 high halves add up to about 2^28.  A misaligned packet
+    // is very unlikely to.  Garbage can add up to 4 * 2^30, which doesn't
+    // fit in an int32_t.
+
+    int64_t sumSquares = 0;
+    for (uint8_t i = 0; i < 16; i += 4) {
+        int16_t q = (int16_t) (packet[i] << 8 | packet[i + 1]);
+        sumSquares += (int32_t) q * q;
+    }
+
+    constexpr int64_t unitSumSquares = 1L << 28;
+    constexpr int64_t tolerance = unitSumSquares / 8;
+    return sumSquares > unitSumSquares - tolerance && sumSquares < unitSumSquares + tolerance;
+}
+
+
+void MpuFifoReader::readPackets(uint8_t numPackets)
+{
+    const uint8_t maxPacketsPerBurst = 255 / packetSize;
+
+    uint8_t* p = buffer;
+    while (numPackets > 0) {
+        uint8_t n = numPackets < maxPacketsPerBurst ? numPackets : maxPacketsPerBurst;
+        mpu.getFIFOBytes(p, n * packetSize);
+        p += n * packetSize;
+        numPackets -= n;
+    }
+}
+
+
+uint8_t MpuFifoReader::read(uint8_t intStatus)
+{
+    if (0 == buffer) {
+        return 0;
+    }
+
+    uint16_t fifoCount = mpu.getFIFOCount();
+
+    if (intStatus & fifoOverflowIntBit) {
+        ++numOverflows;
+        resync(fifoCount);
+        return 0;
+    }
+
+    // Right after a reset, the DMP might have been partway through writing
+    // a packet, so we're back in sync only once the FIFO holds a whole
+    // number of packets.
+    if (!isSynced) {
+        if (0 == fifoCount) {
+            return 0;
+        }
+        if (fifoCount % packetSize != 0) {
+            resync(fifoCount);
+            return 0;
+        }
+        isSynced = true;
+    }
+
+    uint16_t numWaiting = fifoCount / packetSize;
+
+    // Get rid of stale packets that don't fit in the buffer so that we
+    // stay in sync without a reset.
+    while (numWaiting > maxPacketsPerRead) {
+        uint16_t numStale = numWaiting - maxPacketsPerRead;
+        uint8_t n = numStale < maxPacketsPerRead ? numStale : maxPacketsPerRead;
+        readPackets(n);
+        numPacketsDropped += n;
+        numWaiting -= n;
+    }
+
+    readPackets(numWaiting);
+
+    for (uint8_t i = 0; i < numWaiting; ++i) {
+        if (!isPacketAligned(getPacket(i))) {
+            numPacketsDropped += numWaiting - i;
+            resync(mpu.getFIFOCount());
+            numPacketsRead += i;
+            return i;
+        }
+    }
+
+    numPacketsRead += numWaiting;
+    return numWaiting;
+}
+
+
+void MpuFifoReader::printStats(Print& out) const
+{
+    out.print(F("mpuFifo read="));
+    out.print(numPacketsRead);
+    out.print(F(" dropped="));
+    out.print(numPacketsDropped);
+    out.print(F(" overflows="));
+    out.print(numOverflows);
+    out.print(F(" resyncs="));
+    out.println(numResyncs);
+}
@@ -0,0 +1,91 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * MPU6050 DMP FIFO Reader Class                                   *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __MPU_FIFO_READER_H
+#define __MPU_FIFO_READER_H
+
+#include <stdint.h>
+
+class MPU6050;
+class Print;
+
+
+namespace pixelPattern {
+
+// Drains whole DMP packets from an MPU6050's FIFO, reading as many as are
+// waiting with one getFIFOBytes call per buffer-full instead of one call
+// per packet.  Call read() with the interrupt status after each MPU
+// interrupt, then process getPacket(0) through getPacket(n - 1), oldest
+// first.
+//
+// Nothing here waits on the MPU.  After an overflow, or when a packet
+// fails the quaternion sanity check (which is what a partial packet looks
+// like once the FIFO is out of sync), the FIFO is reset and the reader
+// resyncs on a later call by waiting for a FIFO count that is a whole
+// number of packets.  A FIFO count with a partial packet at the end while
+// in sync just means the DMP is writing a packet right now, so the whole
+// packets ahead of it are read and the partial one is left for next time.
+class MpuFifoReader {
+
+public:
+
+    // MPU6050 interrupt status bits
+    static constexpr uint8_t fifoOverflowIntBit = 0x10;
+    static constexpr uint8_t dmpDataReadyIntBit = 0x02;
+
+    MpuFifoReader(MPU6050& mpu, uint8_t maxPacketsPerRead);
+
+    ~MpuFifoReader();
+
+    MpuFifoReader(const MpuFifoReader&) = delete;
+    MpuFifoReader& operator =(const MpuFifoReader&) = delete;
+
+    // Allocates the packet buffer and resets the FIFO.  Returns false if
+    // the buffer couldn't be allocated.
+    bool begin(uint16_t packetSize);
+
+    // Returns the ith packet from the last read().
+    const uint8_t* getPacket(uint8_t i) const { return buffer + i * packetSize; }
+
+    void printStats(Print& out) const;
+
+    // Reads the whole packets waiting in the FIFO.  intStatus is the
+    // result of getIntStatus(), which the caller reads because it might
+    // need the other bits too.  Returns the number of packets read.  When
+    // more packets are waiting than fit in the buffer, the oldest are read
+    // and dropped.
+    uint8_t read(uint8_t intStatus);
+
+    // Resets the FIFO and starts resyncing, such as after the DMP is
+    // re-enabled.
+    void restart();
+
+    uint32_t numPacketsRead;
+    uint32_t numPacketsDropped;     // overflowed, stale, or read while resyncing
+    uint16_t numOverflows;
+    uint16_t numResyncs;
+
+private:
+
+    static bool isPacketAligned(const uint8_t* packet);
+
+    void readPackets(uint8_t numPackets);
+    void resync(uint16_t fifoCount);
+
+    MPU6050& mpu;
+    uint8_t maxPacketsPerRead;
+    uint16_t packetSize;
+    uint8_t* buffer;
+    bool isSynced;
+};
+
+}
+
+#endif  // #ifndef __MPU_FIFO_READER_H
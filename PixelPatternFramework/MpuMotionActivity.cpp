@@ -0,0 +1,161 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * MPU6050 Motion Activity Class                                   *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include "MPU6050.h"
+#include "MpuFifoReader.h"
+#include "MpuMotionActivity.h"
+
+using namespace pixelPattern;
+
+
+MpuMotionActivity::MpuMotionActivity(MPU6050& mpu, MpuFifoReader& fifoReader, const MotionActivityConfig& config)
+    : numWakes(0)
+    , numFalseWakes(0)
+    , totalActiveMs(0)
+    , mpu(mpu)
+    , fifoReader(fifoReader)
+    , config(config)
+    , mode(MotionActivityMode::init)
+    , modeChanged(false)
+    , isConfirmed(false)
+    , activeClockSource(0)
+    , activeSinceMs(0)
+    , lastActivityMs(0)
+{
+}
+
+
+void MpuMotionActivity::begin(uint32_t nowMs)
+{
+    // The DMP wants the gyro PLL as its clock, but the gyros are put in
+    // standby while idle, so the clock source has to be switched too.
+    activeClockSource = mpu.getClockSource();
+    goIdle(nowMs);
+}
+
+
+bool MpuMotionActivity::checkModeChange()
+{
+    bool changed = modeChanged;
+    modeChanged = false;
+    return changed;
+}
+
+
+void MpuMotionActivity::goActive(uint32_t nowMs)
+{
+    mpu.setIntMotionEnabled(false);
+    mpu.setWakeCycleEnabled(false);
+    mpu.setStandbyXGyroEnabled(false);
+    mpu.setStandbyYGyroEnabled(false);
+    mpu.setStandbyZGyroEnabled(false);
+    mpu.setClockSource(activeClockSource);
+    mpu.setDMPEnabled(true);
+    fifoReader.restart();
+
+    mode = MotionActivityMode::active;
+    modeChanged = true;
+    isConfirmed = false;
+    activeSinceMs = nowMs;
+    lastActivityMs = nowMs;
+    ++numWakes;
+}
+
+
+void MpuMotionActivity::goIdle(uint32_t nowMs)
+{
+    mpu.setDMPEnabled(false);
+    mpu.setClockSource(MPU6050_CLOCK_INTERNAL);
+    mpu.setStandbyXGyroEnabled(true);
+    mpu.setStandbyYGyroEnabled(true);
+    mpu.setStandbyZGyroEnabled(true);
+    mpu.setMotionDetectionThreshold(config.wakeThreshold);
+    mpu.setMotionDetectionCounterDecrement(1);
+    mpu.setMotionDetectionDuration(config.wakeDurationMs);
+    mpu.setWakeFrequency(config.wakeFrequency);
+    mpu.setWakeCycleEnabled(true);
+    mpu.setIntMotionEnabled(true);
+
+    if (MotionActivityMode::active == mode) {
+        totalActiveMs += nowMs - activeSinceMs;
+    }
+    mode = MotionActivityMode::idle;
+    modeChanged = true;
+}
+
+
+uint8_t MpuMotionActivity::processInterrupt(uint8_t intStatus, uint32_t nowMs)
+{
+    switch (mode) {
+        case MotionActivityMode::init:
+            // The MPU isn't ready yet.
+            break;
+
+        case MotionActivityMode::idle:
+            if (intStatus & motionIntBit) {
+                goActive(nowMs);
+            }
+            break;
+
+        case MotionActivityMode::active:
+            return fifoReader.read(intStatus);
+    }
+
+    return 0;
+}
+
+
+void MpuMotionActivity::reportActivity(uint16_t activity, uint32_t nowMs)
+{
+    if (MotionActivityMode::active == mode && activity > config.activityThreshold) {
+        lastActivityMs = nowMs;
+        isConfirmed = true;
+    }
+}
+
+
+void MpuMotionActivity::update(uint32_t nowMs)
+{
+    if (MotionActivityMode::active != mode) {
+        return;
+    }
+
+    uint32_t timeoutMs = isConfirmed ? config.idleTimeoutMs : config.confirmTimeoutMs;
+    if (nowMs - lastActivityMs >= timeoutMs) {
+        if (!isConfirmed) {
+            ++numFalseWakes;
+        }
+        goIdle(nowMs);
+    }
+}
+
+
+void MpuMotionActivity::printStats(Print& out, uint32_t nowMs) const
+{
+    out.print(F("mode="));
+    switch (mode) {
+        case MotionActivityMode::init:
+            out.print(F("init"));
+            break;
+        case MotionActivityMode::idle:
+            out.print(F("idle"));
+            break;
+        case MotionActivityMode::active:
+            out.print(F("active"));
+            break;
+    }
+    out.print(F(" wakes="));
+    out.print(numWakes);
+    out.print(F(" falseWakes="));
+    out.print(numFalseWakes);
+    out.print(F(" activeMs="));
+    out.println(totalActiveMs + (MotionActivityMode::active == mode ? nowMs - activeSinceMs : 0));
+}
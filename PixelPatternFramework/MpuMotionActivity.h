@@ -0,0 +1,115 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * MPU6050 Motion Activity Class                                   *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __MPU_MOTION_ACTIVITY_H
+#define __MPU_MOTION_ACTIVITY_H
+
+#include <stdint.h>
+
+class MPU6050;
+class Print;
+
+
+namespace pixelPattern {
+
+class MpuFifoReader;
+
+enum class MotionActivityMode : uint8_t {
+    init,
+    idle,           // DMP off, accelerometer cycling, waiting for a motion interrupt
+    active          // DMP streaming packets
+};
+
+struct MotionActivityConfig {
+    uint8_t  wakeThreshold;         // MPU motion detection threshold, 2 mg units
+    uint8_t  wakeDurationMs;        // how long the threshold must be exceeded
+    uint8_t  wakeFrequency;         // 0 = 1.25 Hz, 1 = 2.5 Hz, 2 = 5 Hz, 3 = 10 Hz
+    uint16_t activityThreshold;     // reportActivity values above this are motion
+    uint16_t confirmTimeoutMs;      // how long a wakeup has to produce motion
+    uint32_t idleTimeoutMs;         // how long without motion before going idle
+};
+
+// Keeps an MPU6050 in its low-power cycle mode, with the DMP off and the
+// gyros in standby, until its motion interrupt fires, then runs the DMP
+// until the sketch stops reporting motion.  While idle, there's no I2C
+// traffic at all.
+//
+// The hardware threshold and the sketch's activity threshold give some
+// hysteresis.  A bump that wakes the MPU but doesn't produce activity
+// above activityThreshold within confirmTimeoutMs is a false wakeup and
+// goes right back to idle.  Once confirmed, the DMP keeps running until
+// there has been no activity for idleTimeoutMs.
+//
+//   processInterrupt() after each MPU interrupt, then handle the packets
+//   reportActivity() with, for example, the largest change in yaw, pitch,
+//       or roll for each packet
+//   update() every time through loop
+class MpuMotionActivity {
+
+public:
+
+    // MPU6050 interrupt status bit
+    static constexpr uint8_t motionIntBit = 0x40;
+
+    MpuMotionActivity(MPU6050& mpu, MpuFifoReader& fifoReader, const MotionActivityConfig& config);
+
+    ~MpuMotionActivity() {}
+
+    MpuMotionActivity(const MpuMotionActivity&) = delete;
+    MpuMotionActivity& operator =(const MpuMotionActivity&) = delete;
+
+    // Goes idle.  Call this once the DMP has been initialized and the
+    // FIFO reader has been started.
+    void begin(uint32_t nowMs);
+
+    // Returns true if the mode changed since the last call, such as so
+    // the sketch can reset its filters after waking up.
+    bool checkModeChange();
+
+    bool getIsActive() const { return MotionActivityMode::active == mode; }
+    bool getIsIdle() const { return MotionActivityMode::idle == mode; }
+    uint32_t getLastActivityMs() const { return lastActivityMs; }
+    MotionActivityMode getMode() const { return mode; }
+
+    void printStats(Print& out, uint32_t nowMs) const;
+
+    // Handles the interrupt status from getIntStatus().  Wakes up on a
+    // motion interrupt while idle, and reads the FIFO while active.
+    // Returns the number of packets ready in the FIFO reader.
+    uint8_t processInterrupt(uint8_t intStatus, uint32_t nowMs);
+
+    void reportActivity(uint16_t activity, uint32_t nowMs);
+
+    // Goes idle when the confirm or idle timeout expires.
+    void update(uint32_t nowMs);
+
+    uint16_t numWakes;
+    uint16_t numFalseWakes;
+    uint32_t totalActiveMs;         // not counting the current active period
+
+private:
+
+    void goActive(uint32_t nowMs);
+    void goIdle(uint32_t nowMs);
+
+    MPU6050& mpu;
+    MpuFifoReader& fifoReader;
+    const MotionActivityConfig config;
+    MotionActivityMode mode;
+    bool modeChanged;
+    bool isConfirmed;
+    uint8_t activeClockSource;
+    uint32_t activeSinceMs;
+    uint32_t lastActivityMs;
+};
+
+}
+
+#endif  // #ifndef __MPU_MOTION_ACTIVITY_H
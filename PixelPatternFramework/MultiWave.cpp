@@ -31,7 +31,7 @@ bool MultiWave::initPattern(bool configIsInFlash, void* patternConfig)
     numPixelsForPattern = config.boundedByPanel ? pixelSet->numPanelPixels : pixelSet->numSymmetricalPixels;
 
     numWaveforms = 0;
-    lastDelayMs = UINT16_MAX;
+    lastDelayMs = config.delayFirstStep ? 1 : UINT16_MAX;
     for (uint8_t w = 0; w < maxWaveforms; ++w)
     {
         // The first ColorWave struct with waveform type "none" or
@@ -60,8 +60,13 @@ bool MultiWave::initPattern(bool configIsInFlash, void* patternConfig)
 
         i0[w] = 0;
       
-        // Use an immediate update to initially display the waveform.
-        waveformDelayMs[w] = 1;
+        if (config.delayFirstStep) {
+            waveformDelayMs[w] = config.waveParams[w].delayMs > 0 ? config.waveParams[w].delayMs : 1;
+        }
+        else {
+            // Use an immediate update to initially display the waveform.
+            waveformDelayMs[w] = 1;
+        }
     }
     
     // We need update() to be called as soon as possible.
@@ -159,6 +164,15 @@ bool MultiWave::update()
                 if (0 == w) {
                     hsvBlended = hsvWaveformPixels[w];
                 }
+                else if (config.addValues) {
+                    // The values add up, and the waves blended so far weigh
+                    // on the hue in proportion to their combined value.
+                    uint16_t valuePairSum = hsvBlended.v + hsvWaveformPixels[w].v;
+                    fract8 amountOfOverlay = valuePairSum > 0 ? 255 * hsvBlended.v / valuePairSum : 255;
+                    uint8_t blendedValue = qadd8(hsvBlended.v, hsvWaveformPixels[w].v);
+                    nblend(hsvBlended, hsvWaveformPixels[w], amountOfOverlay);
+                    hsvBlended.v = blendedValue;
+                }
                 else {
                     // We'll try to make each wave have equal influence on the final display.
                     // When there are two waves, split 50%/50%.  When there are three, overlay
@@ -71,6 +71,8 @@ public:
         bool boundedByPanel;  // true if all the waveforms should appear across each panel, false if across the entire strip
         // TODO:  rename waveParams to colorWaves
         ColorWave waveParams[maxWaveforms];
+        bool addValues;       // true to add the waveforms' values instead of dividing the intensity among them
+        bool delayFirstStep;  // true if each waveform should first move after its delay instead of right away
     };
 
     MultiWave() {};
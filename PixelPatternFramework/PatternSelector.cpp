@@ -20,7 +20,7 @@ PatternSelector::PatternSelector()
 }
 
 
-bool PatternSelector::setPatternNum(uint8_t newPatternNum)
+bool PatternSelector::setPatternNum(uint8_t)
 {
     // If the derived class doesn't implement setting the
     // pattern number, ignore the request and indicate failure.
@@ -40,6 +40,24 @@ void PatternSequence::changePattern()
 }
 
 
+const char* PatternSequence::getPatternName(uint8_t patternNum)
+{
+    // Returns the pattern's name without making a String copy, or
+    // nullptr if the pattern doesn't have a name or doesn't exist.
+
+    if (patternNum >= numPatterns) {
+        return nullptr;
+    }
+
+    const PatternDef* patDef = patternDefs + patternNum;
+
+    if (sizeof(patDef->patternName) == 4) {
+        return (const char*) pgm_read_dword(&patDef->patternName);
+    }
+    return (const char*) pgm_read_word(&patDef->patternName);
+}
+
+
 bool PatternSequence::patternChangeRequested()
 {
     return patternSelector->checkIfPatternChangeNeeded();
@@ -32,15 +32,20 @@ public:
         uint8_t numPatterns,
         PatternSelector* patternSelector);
 
-    ~PatternSequence() {}
+    virtual ~PatternSequence() {}
 
     PatternSequence(const PatternSequence&) = delete;
     PatternSequence& operator =(const PatternSequence&) = delete;
 
     void changePattern();
+    virtual const char* getPatternName(uint8_t patternNum);
     bool patternChangeRequested();
 
-    void readPatternDefinitionFromFlash(
+    // Returns true if the pattern config pointers from readPatternDefinitionFromFlash
+    // point to program memory or false if they point to RAM.
+    virtual bool patternConfigIsInFlash() { return true; }
+
+    virtual void readPatternDefinitionFromFlash(
         uint8_t patternNum,
         uint8_t* pPatternId = nullptr,
         uint32_t* pDurationMs = nullptr,
@@ -114,7 +114,8 @@ void PixelPatternController::updatePattern(PatternState& patternState)
         patternState.pixPat = pixelPatternFactory(patternId);
 //Serial.println("created pixPat object");
 
-        if (patternState.pixPat->init(true, patternConfig, patternState.pixelSet)) {
+        bool configIsInFlash = patternState.patternSequence->patternConfigIsInFlash();
+        if (patternState.pixPat->init(configIsInFlash, patternConfig, patternState.pixelSet)) {
 //Serial.println("pixPat->init successful");
             // Blip the can't-keep-up light.
             patternState.timingSatisfied = false;
@@ -161,22 +162,43 @@ void PixelPatternController::updatePattern(PatternState& patternState)
 bool PixelPatternController::update()
 {
     bool writeToLeds = false;
+    bool wroteToDmx = false;
     bool allTimingSatisfied = true;
+
+    ++stats.numUpdateCalls;
+
     for (uint8_t psidx = 0; psidx < numPatternSequences; ++psidx) {
         PatternState* ps = patternStates[psidx];
         updatePattern(*ps);
-        writeToLeds |= ps->updateLeds;
+        if (ps->updateLeds) {
+            // Pixel sets with a DMX output are sent right away.  The
+            // others are all shown together by FastLED below.
+            if (0 != ps->pixelSet->dmxUniverse) {
+                ps->pixelSet->writeDmx();
+                ++stats.numDmxWrites;
+                wroteToDmx = true;
+            }
+            else {
+                writeToLeds = true;
+            }
+        }
         allTimingSatisfied &= ps->timingSatisfied;
     }
 
     if (writeToLeds) {
         FastLED.show();
+        ++stats.numLedWrites;
+        stats.lastLedWriteMs = millis();
+    }
+
+    if (!allTimingSatisfied) {
+        ++stats.numTimingMisses;
     }
 
     if (useStatusLed) {
         digitalWrite(statusLedPin, !allTimingSatisfied);
     }
 
-    return writeToLeds;
+    return writeToLeds || wroteToDmx;
 }
 
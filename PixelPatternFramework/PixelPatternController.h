@@ -26,13 +26,22 @@ class PixelPatternController {
 
 public:
 
+    // Running counters that can be reported by a status page or API.
+    struct Stats {
+        uint32_t numUpdateCalls;        // number of calls to update()
+        uint32_t numLedWrites;          // number of times update() wrote to the LEDs
+        uint32_t numDmxWrites;          // number of times update() wrote a pixel set to its DMX fixtures
+        uint32_t numTimingMisses;       // number of update() calls where a pattern couldn't keep up
+        uint32_t lastLedWriteMs;        // millis() of the most recent LED write
+    };
 
     PixelPatternController()
         :
         numPatternSequences(0),
         useStatusLed(false),
         statusLedPin(-1),
-        initDone(false)
+        initDone(false),
+        stats()
         {};
 
     ~PixelPatternController() {};
@@ -45,6 +54,7 @@ public:
     bool getUpdateLeds(uint8_t patternSequenceIdx);
     void init();
     uint32_t freeRam();
+    const Stats& getStats() const { return stats; }
     void displayRelativeValue(PixelSet* pixelSet, uint8_t value, CRGB rgbColor);
     bool update();
 
@@ -67,6 +77,8 @@ private:
 
     bool initDone;
 
+    Stats stats;
+
     void updatePattern(PatternState& patternState);
 };
 
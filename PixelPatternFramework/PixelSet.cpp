@@ -10,6 +10,7 @@
 
 #include "PixelSet.h"
 #include "FastLED.h"
+#include "DmxUniverse.h"
 
 using namespace pixelPattern;
 
@@ -33,8 +34,35 @@ PixelSet::PixelSet(
     foregroundIntensityScaleFactor(foregroundIntensityScaleFactor),
     backgroundIntensityScaleFactor(backgroundIntensityScaleFactor),
     numPixels(numPhysicalPixels - numSkipPixels),
-    numSymmetricalPixels(numPhysicalPixels - numSkipPixels - numNonsymmetricalPixels)
+    numSymmetricalPixels(numPhysicalPixels - numSkipPixels - numNonsymmetricalPixels),
+    dmxUniverse(0),
+    dmxFirstFixtureIdx(0)
 {
     pixels = allPixels + numSkipPixels;
 }
 
+
+void PixelSet::setDmxOutput(DmxUniverse* dmxUniverse, uint8_t firstFixtureIdx)
+{
+    this->dmxUniverse = dmxUniverse;
+    dmxFirstFixtureIdx = firstFixtureIdx;
+}
+
+
+void PixelSet::writeDmx()
+{
+    // Sets each fixture's color from its pixel then transmits the channels
+    // that changed.  Skipped pixels are black, so their fixtures stay off.
+
+    if (0 == dmxUniverse) {
+        return;
+    }
+
+    for (uint16_t i = 0; i < numPhysicalPixels && dmxFirstFixtureIdx + i < dmxUniverse->numFixtures; ++i) {
+        const CRGB& rgb = allPixels[i];
+        dmxUniverse->setFixtureRgb(dmxFirstFixtureIdx + i, rgb.r, rgb.g, rgb.b);
+    }
+
+    dmxUniverse->commit();
+}
+
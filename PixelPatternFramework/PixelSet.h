@@ -19,6 +19,9 @@ class CRGB;
 
 namespace pixelPattern {
 
+class DmxUniverse;
+
+
 class PixelSet {
 
 public:
@@ -38,6 +41,12 @@ public:
     PixelSet(const PixelSet&) = delete;
     PixelSet& operator =(const PixelSet&) = delete;
 
+    // A pixel set with a DMX output sends its pixels to consecutive RGB
+    // fixtures in a DMX universe, starting with firstFixtureIdx, instead
+    // of being shown by FastLED.  Any extra pixels or fixtures are ignored.
+    void setDmxOutput(DmxUniverse* dmxUniverse, uint8_t firstFixtureIdx = 0);
+    void writeDmx();
+
     CRGB* allPixels;
     uint16_t numPhysicalPixels;
     uint16_t numSkipPixels;
@@ -49,6 +58,8 @@ public:
     CRGB* pixels;
     uint16_t numPixels;
     uint16_t numSymmetricalPixels;
+    DmxUniverse* dmxUniverse;
+    uint8_t dmxFirstFixtureIdx;
 };
 
 }
@@ -0,0 +1,260 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * E1.31 (sACN) / Art-Net Pixel Stream Receiver                    *
+ *                                                                 *
+ * by Ross Butler   Nov. 2016                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifdef ESP8266
+
+#include <Arduino.h>
+#include "PixelStreamReceiver.h"
+#include <WiFiUdp.h>
+#include "FastLED.h"
+#include "PixelSet.h"
+
+using namespace pixelPattern;
+
+
+static const uint8_t e131PacketIdentifier[] = {'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0};
+static const uint8_t artNetId[] = {'A', 'r', 't', '-', 'N', 'e', 't', 0};
+
+
+PixelStreamReceiver::PixelStreamReceiver()
+    : numUniverses(0)
+    , protocol(Protocol::e131)
+    , stats()
+    , timeoutMs(2500)
+{
+    udp = new WiFiUDP;
+}
+
+
+PixelStreamReceiver::~PixelStreamReceiver()
+{
+    delete udp;
+}
+
+
+bool PixelStreamReceiver::addUniverse(uint16_t universe, PixelSet* pixelSet, uint16_t startPixel)
+{
+    if (numUniverses >= maxUniverses || 0 == pixelSet || startPixel >= pixelSet->numPixels) {
+        return false;
+    }
+
+    UniverseMap& um = universeMaps[numUniverses++];
+    um.universe = universe;
+    um.pixelSet = pixelSet;
+    um.startPixel = startPixel;
+    um.lastSequence = 0;
+    um.lastFrameMs = 0;
+    um.receiving = false;
+    um.newFrame = false;
+
+    return true;
+}
+
+
+void PixelStreamReceiver::init(Protocol protocol, uint32_t timeoutMs)
+{
+    // E1.31 multicast isn't joined, so the sender must use unicast.
+
+    this->protocol = protocol;
+    this->timeoutMs = timeoutMs;
+    udp->begin(Protocol::e131 == protocol ? e131Port : artNetPort);
+}
+
+
+bool PixelStreamReceiver::isStreaming(const PixelSet* pixelSet)
+{
+    // A pixel set is streaming if any of its universes has received
+    // a frame recently and the sender hasn't terminated the stream.
+
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < numUniverses; ++i) {
+        UniverseMap& um = universeMaps[i];
+        if (um.pixelSet == pixelSet && um.receiving) {
+            if (now - um.lastFrameMs < timeoutMs) {
+                return true;
+            }
+            um.receiving = false;
+        }
+    }
+
+    return false;
+}
+
+
+bool PixelStreamReceiver::takeNewFrame(const PixelSet* pixelSet)
+{
+    // Returns true if a frame has been written to any part of the pixel
+    // set since the last call, which means the LEDs need to be updated.
+
+    bool newFrame = false;
+    for (uint8_t i = 0; i < numUniverses; ++i) {
+        UniverseMap& um = universeMaps[i];
+        if (um.pixelSet == pixelSet && um.newFrame) {
+            um.newFrame = false;
+            newFrame = true;
+        }
+    }
+
+    return newFrame;
+}
+
+
+void PixelStreamReceiver::poll()
+{
+    // Drain the pending packets, up to a limit so that a flood of packets
+    // can't starve the rest of loop().  Only the newest frame for a
+    // universe will be shown because each one overwrites the last.
+
+    for (uint8_t n = 0; n < maxPacketsPerPoll; ++n) {
+        int packetSize = udp->parsePacket();
+        if (packetSize <= 0) {
+            break;
+        }
+
+        uint16_t universe;
+        uint8_t sequence;
+        uint16_t dataLength;
+        bool terminated = false;
+        bool valid = Protocol::e131 == protocol
+            ? readE131Header(packetSize, &universe, &sequence, &dataLength, &terminated)
+            : readArtNetHeader(packetSize, &universe, &sequence, &dataLength);
+        if (!valid) {
+            ++stats.numBadPackets;
+            continue;
+        }
+
+        UniverseMap* um = nullptr;
+        for (uint8_t i = 0; i < numUniverses; ++i) {
+            if (universeMaps[i].universe == universe) {
+                um = &universeMaps[i];
+                break;
+            }
+        }
+        if (nullptr == um) {
+            ++stats.numIgnoredPackets;
+            continue;
+        }
+
+        uint32_t now = millis();
+
+        if (terminated) {
+            um->receiving = false;
+            continue;
+        }
+
+        // Per E1.31, a frame whose sequence number is 0 to 19 behind the last
+        // one is out of order and must be dropped.  Anything further behind
+        // is taken as the sender having restarted.  Art-Net uses sequence
+        // number 0 to mean that sequencing is disabled.  A stream that has
+        // timed out is always restarted.
+        if (um->receiving && now - um->lastFrameMs < timeoutMs
+            && !(Protocol::artNet == protocol && 0 == sequence))
+        {
+            int8_t seqDiff = (int8_t) (sequence - um->lastSequence);
+            if (seqDiff <= 0 && seqDiff > -20) {
+                ++stats.numStaleFrames;
+                continue;
+            }
+        }
+
+        // Read the channel data straight into the pixels.  CRGB is packed
+        // as three bytes in R, G, B order, so DMX slots map directly to it.
+        uint16_t maxDataLength = (um->pixelSet->numPixels - um->startPixel) * sizeof(CRGB);
+        if (dataLength > maxDataLength) {
+            dataLength = maxDataLength;
+        }
+        udp->read((uint8_t*) (um->pixelSet->pixels + um->startPixel), dataLength);
+
+        um->lastSequence = sequence;
+        um->lastFrameMs = now;
+        um->receiving = true;
+        um->newFrame = true;
+        ++stats.numFrames;
+    }
+}
+
+
+bool PixelStreamReceiver::readE131Header(
+    int packetSize,
+    uint16_t* pUniverse,
+    uint8_t* pSequence,
+    uint16_t* pDataLength,
+    bool* pTerminated)
+{
+    // Reads and validates the root, framing, and DMP layers of an E1.31
+    // data packet, leaving the UDP read position at the first DMX slot.
+
+    if (packetSize < e131HeaderLength) {
+        return false;
+    }
+
+    uint8_t hdr[e131HeaderLength];
+    if (udp->read(hdr, e131HeaderLength) != e131HeaderLength) {
+        return false;
+    }
+
+    if (memcmp(hdr + 4, e131PacketIdentifier, sizeof(e131PacketIdentifier)) != 0
+        || hdr[18] != 0 || hdr[19] != 0 || hdr[20] != 0 || hdr[21] != 0x04     // VECTOR_ROOT_E131_DATA
+        || hdr[40] != 0 || hdr[41] != 0 || hdr[42] != 0 || hdr[43] != 0x02     // VECTOR_E131_DATA_PACKET
+        || hdr[117] != 0x02                                                     // VECTOR_DMP_SET_PROPERTY
+        || hdr[125] != 0)                                                       // DMX start code
+    {
+        return false;
+    }
+
+    uint16_t propertyValueCount = ((uint16_t) hdr[123] << 8) | hdr[124];
+    if (propertyValueCount < 1) {
+        return false;
+    }
+
+    *pSequence = hdr[111];
+    *pTerminated = hdr[112] & 0x40;
+    *pUniverse = ((uint16_t) hdr[113] << 8) | hdr[114];
+    *pDataLength = propertyValueCount - 1;      // less the start code
+    if (*pDataLength > packetSize - e131HeaderLength) {
+        *pDataLength = packetSize - e131HeaderLength;
+    }
+
+    return true;
+}
+
+
+bool PixelStreamReceiver::readArtNetHeader(int packetSize, uint16_t* pUniverse, uint8_t* pSequence, uint16_t* pDataLength)
+{
+    // Reads and validates an ArtDmx header, leaving the
+    // UDP read position at the first DMX channel.
+
+    if (packetSize < artNetHeaderLength) {
+        return false;
+    }
+
+    uint8_t hdr[artNetHeaderLength];
+    if (udp->read(hdr, artNetHeaderLength) != artNetHeaderLength) {
+        return false;
+    }
+
+    if (memcmp(hdr, artNetId, sizeof(artNetId)) != 0
+        || hdr[8] != 0x00 || hdr[9] != 0x50)        // OpDmx, little endian
+    {
+        return false;
+    }
+
+    *pSequence = hdr[12];
+    *pUniverse = (((uint16_t) hdr[15] & 0x7f) << 8) | hdr[14];
+    *pDataLength = ((uint16_t) hdr[16] << 8) | hdr[17];
+    if (*pDataLength > packetSize - artNetHeaderLength) {
+        *pDataLength = packetSize - artNetHeaderLength;
+    }
+
+    return true;
+}
+
+
+#endif  // #ifdef ESP8266
@@ -0,0 +1,101 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * E1.31 (sACN) / Art-Net Pixel Stream Receiver                    *
+ *                                                                 *
+ * by Ross Butler   Nov. 2016                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#pragma once
+
+#ifdef ESP8266
+
+#include <stdint.h>
+
+
+class WiFiUDP;
+
+
+namespace pixelPattern {
+
+class PixelSet;
+
+
+// Receives DMX-style pixel frames over UDP and writes the pixel data
+// directly into the pixel sets' pixel arrays.  Each universe is mapped to
+// a range of pixels in a pixel set (up to 170 RGB pixels per universe).
+// Frames that arrive out of order are dropped using the packet sequence
+// numbers.  poll() should be called every time through loop() before the
+// pattern controller's update().
+//
+// The StreamSelector and StreamedPixels classes use the receiver to show
+// the streamed pixels while a stream is active and to fall back to the
+// local patterns when it stops.
+class PixelStreamReceiver {
+
+public:
+
+    enum class Protocol {
+        e131,
+        artNet
+    };
+
+    struct Stats {
+        uint32_t numFrames;             // frames written to the pixels
+        uint32_t numStaleFrames;        // frames dropped because they were out of order
+        uint32_t numBadPackets;         // packets that weren't valid E1.31 or Art-Net DMX data
+        uint32_t numIgnoredPackets;     // valid packets for universes we don't have
+    };
+
+    static constexpr uint8_t maxUniverses = 8;
+    static constexpr uint16_t e131Port = 5568;
+    static constexpr uint16_t artNetPort = 6454;
+
+    PixelStreamReceiver();
+
+    virtual ~PixelStreamReceiver();
+
+    PixelStreamReceiver(const PixelStreamReceiver&) = delete;
+    PixelStreamReceiver& operator =(const PixelStreamReceiver&) = delete;
+
+    bool addUniverse(uint16_t universe, PixelSet* pixelSet, uint16_t startPixel = 0);
+    const Stats& getStats() const { return stats; }
+    void init(Protocol protocol, uint32_t timeoutMs = 2500);
+    bool isStreaming(const PixelSet* pixelSet);
+    void poll();
+    bool takeNewFrame(const PixelSet* pixelSet);
+
+protected:
+
+private:
+
+    static constexpr uint8_t maxPacketsPerPoll = 8;
+    static constexpr uint8_t e131HeaderLength = 126;
+    static constexpr uint8_t artNetHeaderLength = 18;
+
+    struct UniverseMap {
+        uint16_t universe;
+        PixelSet* pixelSet;
+        uint16_t startPixel;
+        uint8_t lastSequence;
+        uint32_t lastFrameMs;
+        bool receiving;
+        bool newFrame;
+    };
+
+    bool readArtNetHeader(int packetSize, uint16_t* pUniverse, uint8_t* pSequence, uint16_t* pDataLength);
+    bool readE131Header(int packetSize, uint16_t* pUniverse, uint8_t* pSequence, uint16_t* pDataLength, bool* pTerminated);
+
+    uint8_t numUniverses;
+    Protocol protocol;
+    Stats stats;
+    uint32_t timeoutMs;
+    WiFiUDP* udp;
+    UniverseMap universeMaps[maxUniverses];
+};
+
+}
+
+#endif  // #ifdef ESP8266
@@ -28,7 +28,8 @@ bool Rainbow::initPattern(bool configIsInFlash, void* patternConfig)
     }
 
     stepNum = 0;
-    delta = (uint8_t) (pixelSet->numPanelPixels > 256 ? 1 : (uint16_t) 256 / pixelSet->numPanelPixels);
+    uint16_t hueSpan = config.hueSpan > 0 ? config.hueSpan : 256;
+    delta = (uint8_t) (pixelSet->numPanelPixels > hueSpan ? 1 : hueSpan / pixelSet->numPanelPixels);
 
     // We need update() to be called as soon as possible.
     nextUpdateMs = millis() - 1;
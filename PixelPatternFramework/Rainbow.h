@@ -28,6 +28,7 @@ public:
         bool     directionDown;     // true to rotate one way, false to rotate the other way
         // TODO:  Need to change delay to be the period of a full rotation
         uint32_t delayMs;           // delay between rotation steps
+        uint16_t hueSpan;           // hues that the rainbow spans across a panel; 0 for all 256
     };
 
     Rainbow() {};
@@ -0,0 +1,304 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Sensor Filter Bank Templates                                    *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __SENSOR_FILTERS_H
+#define __SENSOR_FILTERS_H
+
+#include <stdint.h>
+
+
+namespace pixelPattern {
+
+// Each filter bank filters numChannels independent channels, such as the
+// axes of a motion sensor, with storage sized at compile time and kept
+// together so that the channels share one copy of the code.  update()
+// takes constant time.  Channels are numbered from 0.
+
+
+// Moving average of the last 2^lengthShift values.  Once a channel has a
+// full window, the average is a shift rather than a division.  Until
+// then, it is the average of the values so far.  SumT must be able to
+// hold the sum of a full window.
+template <uint8_t numChannels, uint8_t lengthShift, typename T = int16_t, typename SumT = int32_t>
+class BoxcarFilterBank {
+
+public:
+
+    static_assert(lengthShift < 8, "BoxcarFilterBank lengthShift must be less than 8 so that length fits in a uint8_t.");
+
+    static constexpr uint8_t length = 1 << lengthShift;
+
+    BoxcarFilterBank() { clear(); }
+
+    void clear()
+    {
+        for (uint8_t c = 0; c < numChannels; ++c) {
+            for (uint8_t i = 0; i < length; ++i) {
+                values[c][i] = 0;
+            }
+            sums[c] = 0;
+            nextSlotIdx[c] = 0;
+            isFull[c] = false;
+        }
+    }
+
+    // Fills channel's window with value, such as to start from the first
+    // reading rather than from zero.
+    void fill(uint8_t channel, T value)
+    {
+        for (uint8_t i = 0; i < length; ++i) {
+            values[channel][i] = value;
+        }
+        sums[channel] = (SumT) value * length;
+        nextSlotIdx[channel] = 0;
+        isFull[channel] = true;
+    }
+
+    void update(uint8_t channel, T value)
+    {
+        uint8_t i = nextSlotIdx[channel];
+        sums[channel] += (SumT) value - values[channel][i];
+        values[channel][i] = value;
+        nextSlotIdx[channel] = (i + 1) & (length - 1);
+        if (0 == nextSlotIdx[channel]) {
+            isFull[channel] = true;
+        }
+    }
+
+    // Returns the average, rounded toward zero.
+    T get(uint8_t channel) const
+    {
+        SumT sum = sums[channel];
+        if (isFull[channel]) {
+            // Negate negative sums around the shift so that they round
+            // the same way as the division.  (sum < 1 rather than sum < 0
+            // keeps the compiler quiet when SumT is unsigned.)
+            return sum < 1 ? -(-sum >> lengthShift) : sum >> lengthShift;
+        }
+        return nextSlotIdx[channel] > 0 ? sum / nextSlotIdx[channel] : 0;
+    }
+
+    // Returns the newest value less the oldest one in the window.
+    T getChange(uint8_t channel) const
+    {
+        uint8_t newestIdx = (nextSlotIdx[channel] - 1) & (length - 1);
+        uint8_t oldestIdx = isFull[channel] ? nextSlotIdx[channel] : 0;
+        return values[channel][newestIdx] - values[channel][oldestIdx];
+    }
+
+    bool getIsFull(uint8_t channel) const { return isFull[channel]; }
+
+private:
+
+    T values[numChannels][length];
+    SumT sums[numChannels];
+    uint8_t nextSlotIdx[numChannels];
+    bool isFull[numChannels];
+};
+
+
+// Exponential moving average with a smoothing factor of 1/2^alphaShift.
+// The state is kept scaled up by 2^alphaShift so that small changes
+// aren't lost.  The first value after clear() primes the channel.
+template <uint8_t numChannels, uint8_t alphaShift, typename T = int16_t>
+class EmaFilterBank {
+
+public:
+
+    EmaFilterBank() { clear(); }
+
+    void clear()
+    {
+        for (uint8_t c = 0; c < numChannels; ++c) {
+            scaledValues[c] = 0;
+            isPrimed[c] = false;
+        }
+    }
+
+    void update(uint8_t channel, T value)
+    {
+        if (!isPrimed[channel]) {
+            isPrimed[channel] = true;
+            scaledValues[channel] = (int32_t) value * (1L << alphaShift);
+            return;
+        }
+        scaledValues[channel] += value - (scaledValues[channel] >> alphaShift);
+    }
+
+    T get(uint8_t channel) const { return scaledValues[channel] >> alphaShift; }
+
+private:
+
+    int32_t scaledValues[numChannels];
+    bool isPrimed[numChannels];
+};
+
+
+// Median of the last length values, which throws out spikes that an
+// average would smear.  Keep length small and odd; get() sorts a copy of
+// the window.
+template <uint8_t numChannels, uint8_t length, typename T = int16_t>
+class MedianFilterBank {
+
+public:
+
+    static_assert(length > 0, "MedianFilterBank length must be at least 1.");
+
+    MedianFilterBank() { clear(); }
+
+    void clear()
+    {
+        for (uint8_t c = 0; c < numChannels; ++c) {
+            clear(c);
+        }
+    }
+
+    void clear(uint8_t channel)
+    {
+        nextSlotIdx[channel] = 0;
+        numValues[channel] = 0;
+    }
+
+    void update(uint8_t channel, T value)
+    {
+        values[channel][nextSlotIdx[channel]] = value;
+        if (++nextSlotIdx[channel] >= length) {
+            nextSlotIdx[channel] = 0;
+        }
+        if (numValues[channel] < length) {
+            ++numValues[channel];
+        }
+    }
+
+    T get(uint8_t channel) const
+    {
+        uint8_t n = numValues[channel];
+        if (0 == n) {
+            return 0;
+        }
+
+        T sorted[length];
+        for (uint8_t i = 0; i < n; ++i) {
+            T v = values[channel][i];
+            uint8_t j = i;
+            for (; j > 0 && sorted[j - 1] > v; --j) {
+                sorted[j] = sorted[j - 1];
+            }
+            sorted[j] = v;
+        }
+        return sorted[n / 2];
+    }
+
+private:
+
+    T values[numChannels][length];
+    uint8_t nextSlotIdx[numChannels];
+    uint8_t numValues[numChannels];
+};
+
+
+// One-euro filter (Casiez, Roussel, and Vogel, 2012):  an exponential
+// moving average whose cutoff frequency rises with the rate of change, so
+// that it smooths jitter when a value is steady but doesn't lag much when
+// it moves.  The cutoff is minCutoffMilliHz plus betaMilliHz for each unit
+// per second of (filtered) rate of change.  The math is fixed point, with
+// values kept in 1/64ths and smoothing factors in 1/256ths.
+template <uint8_t numChannels, typename T = int16_t>
+class OneEuroFilterBank {
+
+public:
+
+    static constexpr uint16_t derivativeCutoffMilliHz = 1000;
+    static constexpr uint32_t maxCutoffMilliHz = 0x100000;
+    static constexpr int32_t maxRatePerSec = 1L << 21;
+
+    OneEuroFilterBank(uint16_t minCutoffMilliHz, uint16_t betaMilliHz)
+        : minCutoffMilliHz(minCutoffMilliHz)
+        , betaMilliHz(betaMilliHz)
+        , maxRateForBeta(maxCutoffMilliHz / ((uint32_t) betaMilliHz + 1))
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        for (uint8_t c = 0; c < numChannels; ++c) {
+            scaledValues[c] = 0;
+            ratesPerSec[c] = 0;
+            lastUpdateMs[c] = 0;
+            isPrimed[c] = false;
+        }
+    }
+
+    void update(uint8_t channel, T value, uint32_t nowMs)
+    {
+        int32_t scaledValue = (int32_t) value * 64;
+
+        if (!isPrimed[channel]) {
+            isPrimed[channel] = true;
+            scaledValues[channel] = scaledValue;
+            ratesPerSec[channel] = 0;
+            lastUpdateMs[channel] = nowMs;
+            return;
+        }
+
+        uint32_t dtMs = nowMs - lastUpdateMs[channel];
+        if (0 == dtMs) {
+            return;
+        }
+        lastUpdateMs[channel] = nowMs;
+
+        int32_t ratePerSec = ((int32_t) value - (scaledValues[channel] >> 6)) * 1000 / (int32_t) dtMs;
+        if (ratePerSec > maxRatePerSec) {
+            ratePerSec = maxRatePerSec;
+        }
+        else if (ratePerSec < -maxRatePerSec) {
+            ratePerSec = -maxRatePerSec;
+        }
+        ratesPerSec[channel] += (ratePerSec - ratesPerSec[channel]) * getAlpha(derivativeCutoffMilliHz, dtMs) >> 8;
+
+        uint32_t absRate = ratesPerSec[channel] < 0 ? -ratesPerSec[channel] : ratesPerSec[channel];
+        uint32_t cutoffMilliHz = absRate < maxRateForBeta ? minCutoffMilliHz + betaMilliHz * absRate : maxCutoffMilliHz;
+        scaledValues[channel] += (scaledValue - scaledValues[channel]) * getAlpha(cutoffMilliHz, dtMs) >> 8;
+    }
+
+    T get(uint8_t channel) const { return scaledValues[channel] >> 6; }
+
+private:
+
+    // Returns the smoothing factor for cutoffMilliHz at a sample interval
+    // of dtMs, r / (r + 1) where r = 2 pi fc dt, in 1/256ths.
+    static int16_t getAlpha(uint32_t cutoffMilliHz, uint32_t dtMs)
+    {
+        if (cutoffMilliHz >= maxCutoffMilliHz || dtMs >= 0x1000) {
+            return 256;
+        }
+
+        // r in 1/65536ths is fc (mHz) * dt (ms) * 0.411775, approximated
+        // as 843 / 2048.  Big products are shifted first so that they
+        // don't overflow.  alpha is 1 - 1 / (r + 1), which can't overflow
+        // however big r is, rounded to the nearest 1/256th.
+        uint32_t fcDt = cutoffMilliHz * dtMs;
+        uint32_t r = fcDt < 0x400000 ? fcDt * 843 >> 11 : (fcDt >> 11) * 843;
+        return 256 - (((1UL << 25) / (r + 65536) + 1) >> 1);
+    }
+
+    uint16_t minCutoffMilliHz;
+    uint16_t betaMilliHz;
+    uint32_t maxRateForBeta;
+    int32_t scaledValues[numChannels];
+    int32_t ratesPerSec[numChannels];
+    uint32_t lastUpdateMs[numChannels];
+    bool isPrimed[numChannels];
+};
+
+}
+
+#endif  // #ifndef __SENSOR_FILTERS_H
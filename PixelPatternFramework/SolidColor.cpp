@@ -41,15 +41,17 @@ bool SolidColor::update()
     CHSV hsvColor;
     hsvColor.h = stepNum;
     hsvColor.s = config.saturation;
-    hsvColor.v = 255;
+    hsvColor.v = config.dimByValue ? pixelSet->backgroundIntensityScaleFactor : 255;
 
     CRGB rgbColor;
     hsv2rgb_rainbow(hsvColor, rgbColor);
 
     fill_solid(pixelSet->pixels, pixelSet->numPixels, rgbColor);
 
-    // TODO:  use a helper for this
-    for (uint16_t i = 0; i < pixelSet->numPixels; pixelSet->pixels[i++].nscale8_video(pixelSet->backgroundIntensityScaleFactor));
+    if (!config.dimByValue) {
+        // TODO:  use a helper for this
+        for (uint16_t i = 0; i < pixelSet->numPixels; pixelSet->pixels[i++].nscale8_video(pixelSet->backgroundIntensityScaleFactor));
+    }
 
     if (config.startHue != config.endHue) {
         if (stepDir) {
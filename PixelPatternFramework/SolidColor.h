@@ -27,6 +27,7 @@ public:
       HSVHue   endHue;        // end hue
       uint8_t  saturation;    // the S in HSV
       uint32_t delay;         // ms delay between rotation steps
+      bool     dimByValue;    // true to dim the color with its HSV value rather than scaling its RGB color
     };
 
     SolidColor() {}
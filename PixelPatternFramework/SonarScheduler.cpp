@@ -0,0 +1,175 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Ultrasonic Sonar Scheduler Class                                *
+ *                                                                 *
+ * by Ross Butler   Dec. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include "SonarScheduler.h"
+
+using namespace pixelPattern;
+
+
+SonarScheduler::SonarScheduler(const SonarConfig* sensors, uint8_t numSensors, uint16_t pingIntervalMs, uint16_t sustainMs)
+    : numPings(0)
+    , numGoodPings(0)
+    , numNoEchoes(0)
+    , numBusy(0)
+    , sensors(sensors)
+    , numSensors(numSensors < maxSensors ? numSensors : maxSensors)
+    , pingIntervalMs(pingIntervalMs)
+    , sustainMs(sustainMs)
+    , currentSensor(0)
+    , lastPingMs(0)
+    , pingStartUs(0)
+    , maxEchoWaitUs(0)
+    , echoPin(0)
+    , echoState(EchoState::idle)
+    , echoStartUs(0)
+    , echoUs(0)
+{
+    for (uint8_t i = 0; i < maxSensors; ++i) {
+        lastGoodPingMs[i] = 0;
+    }
+}
+
+
+void SonarScheduler::begin()
+{
+    for (uint8_t i = 0; i < numSensors; ++i) {
+        pinMode(sensors[i].triggerPin, OUTPUT);
+        digitalWrite(sensors[i].triggerPin, LOW);
+        pinMode(sensors[i].echoPin, INPUT);
+#ifdef PCICR
+        uint8_t pin = sensors[i].echoPin;
+        *digitalPinToPCMSK(pin) |= bit(digitalPinToPCMSKbit(pin));
+        PCIFR |= bit(digitalPinToPCICRbit(pin));
+        PCICR |= bit(digitalPinToPCICRbit(pin));
+#endif
+    }
+
+    // The first update() pings the first sensor.
+    currentSensor = numSensors - 1;
+    lastPingMs = millis() - pingIntervalMs;
+}
+
+
+void SonarScheduler::handleEchoChange()
+{
+    EchoState state = echoState;
+    if (EchoState::waiting == state && HIGH == digitalRead(echoPin)) {
+        echoStartUs = micros();
+        echoState = EchoState::timing;
+    }
+    else if (EchoState::timing == state && LOW == digitalRead(echoPin)) {
+        echoUs = micros() - echoStartUs;
+        echoState = EchoState::done;
+    }
+}
+
+
+int8_t SonarScheduler::update(uint32_t nowMs)
+{
+    int8_t finishedSensor = -1;
+
+    EchoState state = echoState;
+    if (EchoState::done == state) {
+        finishPing(nowMs);
+        finishedSensor = currentSensor;
+    }
+    else if (EchoState::idle != state && micros() - pingStartUs > maxEchoWaitUs) {
+        // The echo could end while we're giving up on it.
+        noInterrupts();
+        bool isDone = EchoState::done == echoState;
+        echoState = EchoState::idle;
+        interrupts();
+        if (isDone) {
+            finishPing(nowMs);
+        }
+        else {
+            ++numNoEchoes;
+        }
+        finishedSensor = currentSensor;
+    }
+
+    if (EchoState::idle == echoState && nowMs - lastPingMs >= pingIntervalMs) {
+        startPing(nowMs);
+    }
+
+    return finishedSensor;
+}
+
+
+void SonarScheduler::startPing(uint32_t nowMs)
+{
+    lastPingMs = nowMs;
+    if (++currentSensor >= numSensors) {
+        currentSensor = 0;
+    }
+    const SonarConfig& sensor = sensors[currentSensor];
+
+    // A sensor that heard nothing holds its echo pin high for tens of
+    // milliseconds, and it won't ping again until the pin drops.
+    if (HIGH == digitalRead(sensor.echoPin)) {
+        ++numBusy;
+        return;
+    }
+
+    // The echo pin is set before the state so that the interrupt never
+    // sees the new state with the old pin.
+    echoPin = sensor.echoPin;
+    maxEchoWaitUs = (uint32_t) sensor.maxDistanceCm * echoUsPerCm + echoSlackUs;
+    echoState = EchoState::waiting;
+
+    digitalWrite(sensor.triggerPin, HIGH);
+    delayMicroseconds(10);
+    digitalWrite(sensor.triggerPin, LOW);
+    pingStartUs = micros();
+    ++numPings;
+}
+
+
+void SonarScheduler::finishPing(uint32_t nowMs)
+{
+    echoState = EchoState::idle;
+
+    uint16_t distanceCm = (echoUs + echoUsPerCm / 2) / echoUsPerCm;
+    if (0 == distanceCm || distanceCm > sensors[currentSensor].maxDistanceCm) {
+        ++numNoEchoes;
+        return;
+    }
+
+    // Start the median over when the old distances have gone stale.
+    if (nowMs - lastGoodPingMs[currentSensor] > sustainMs) {
+        distanceFilters.clear(currentSensor);
+    }
+    distanceFilters.update(currentSensor, distanceCm);
+    lastGoodPingMs[currentSensor] = nowMs;
+    ++numGoodPings;
+}
+
+
+uint16_t SonarScheduler::getDistanceCm(uint8_t sensor, uint32_t nowMs) const
+{
+    if (nowMs - lastGoodPingMs[sensor] > sustainMs) {
+        return 0;
+    }
+    return distanceFilters.get(sensor);
+}
+
+
+void SonarScheduler::printStats(Print& out) const
+{
+    out.print(F("pings="));
+    out.print(numPings);
+    out.print(F(" good="));
+    out.print(numGoodPings);
+    out.print(F(" noEcho="));
+    out.print(numNoEchoes);
+    out.print(F(" busy="));
+    out.println(numBusy);
+}
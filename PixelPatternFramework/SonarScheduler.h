@@ -0,0 +1,117 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Ultrasonic Sonar Scheduler Class                                *
+ *                                                                 *
+ * by Ross Butler   Dec. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __SONAR_SCHEDULER_H
+#define __SONAR_SCHEDULER_H
+
+#include <stdint.h>
+#include "SensorFilters.h"
+
+class Print;
+
+
+namespace pixelPattern {
+
+struct SonarConfig {
+    uint8_t  triggerPin;
+    uint8_t  echoPin;
+    uint16_t maxDistanceCm;     // echoes from farther away are ignored
+};
+
+// Pings HC-SR04 style ultrasonic sensors one at a time, pingIntervalMs
+// apart so that one sensor's echoes die out before the next one pings,
+// without waiting for the echoes.  update() sends each ping and collects
+// the result, and the echo is timed by handleEchoChange(), which must be
+// called from an interrupt whenever an echo pin changes.
+//
+// On AVR boards, begin() enables the echo pins' pin change interrupts,
+// and the sketch routes the vectors to the scheduler:
+//
+//   ISR(PCINT0_vect) { sonarScheduler.handleEchoChange(); }
+//
+// Elsewhere, attach handleEchoChange to each echo pin with CHANGE.  Only
+// the pinging sensor's echo pin is looked at, so a shared vector is fine.
+//
+// Each sensor's distances are the median of its last three good ones.  A
+// distance is held for sustainMs after the last good ping, which rides
+// out the occasional missed echo.  After that, getDistanceCm() returns 0.
+class SonarScheduler {
+
+public:
+
+    static constexpr uint8_t maxSensors = 4;
+
+    // microseconds of echo per centimeter of distance (there and back at
+    // 343 m/s is 58.3 us/cm)
+    static constexpr uint16_t echoUsPerCm = 58;
+
+    // Echoes normally start about half a millisecond after the trigger
+    // pulse.  A ping with no echo by maxDistanceCm plus this long is
+    // given up on.
+    static constexpr uint16_t echoSlackUs = 1000;
+
+    SonarScheduler(const SonarConfig* sensors, uint8_t numSensors, uint16_t pingIntervalMs, uint16_t sustainMs);
+
+    ~SonarScheduler() {}
+
+    SonarScheduler(const SonarScheduler&) = delete;
+    SonarScheduler& operator =(const SonarScheduler&) = delete;
+
+    void begin();
+
+    // Returns the sensor's filtered distance, or 0 if it hasn't had a good
+    // ping in the last sustainMs.
+    uint16_t getDistanceCm(uint8_t sensor, uint32_t nowMs) const;
+
+    // Times the pinging sensor's echo.  Call it from the echo pins'
+    // interrupts.
+    void handleEchoChange();
+
+    void printStats(Print& out) const;
+
+    // Collects a finished ping and sends the next one when it is time.
+    // Returns the number of the sensor whose ping finished, or -1 if none
+    // did.
+    int8_t update(uint32_t nowMs);
+
+    uint32_t numPings;
+    uint32_t numGoodPings;
+    uint16_t numNoEchoes;       // nothing within the sensor's maxDistanceCm
+    uint16_t numBusy;           // echo pin still high from the last ping
+
+private:
+
+    enum class EchoState : uint8_t {idle, waiting, timing, done};
+
+    void finishPing(uint32_t nowMs);
+    void startPing(uint32_t nowMs);
+
+    const SonarConfig* sensors;
+    uint8_t numSensors;
+    uint16_t pingIntervalMs;
+    uint16_t sustainMs;
+
+    uint8_t currentSensor;
+    uint32_t lastPingMs;
+    uint32_t pingStartUs;
+    uint32_t maxEchoWaitUs;
+
+    volatile uint8_t echoPin;
+    volatile EchoState echoState;
+    volatile uint32_t echoStartUs;
+    volatile uint32_t echoUs;
+
+    MedianFilterBank<maxSensors, 3, uint16_t> distanceFilters;
+    uint32_t lastGoodPingMs[maxSensors];
+};
+
+}
+
+#endif  // #ifndef __SONAR_SCHEDULER_H
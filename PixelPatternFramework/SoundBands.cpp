@@ -0,0 +1,80 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Sound Bands Pattern                                             *
+ *                                                                 *
+ * by Ross Butler   Dec. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#include "SoundBands.h"
+#include "patternHelpers.h"
+
+using namespace pixelPattern;
+
+
+bool SoundBands::initPattern(bool configIsInFlash, void* patternConfig)
+{
+    // Returns true if successful, false if failed or pattern cannot run.
+
+    if (configIsInFlash) {
+        memcpy_P(&config, patternConfig, sizeof(PatternConfig));
+    }
+    else {
+        memcpy(&config, patternConfig, sizeof(PatternConfig));
+    }
+
+    if (0 == config.analyzer || 0 == config.analyzer->getNumBands()) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < AudioBandAnalyzer::maxBands; ++i) {
+        bandBrightnesses[i] = 0;
+    }
+
+    fill_solid(pixelSet->pixels, pixelSet->numPixels, CRGB::Black);
+
+    // We need update() to be called as soon as possible.
+    nextUpdateMs = millis() - 1;
+
+    return true;
+}
+
+
+bool SoundBands::update()
+{
+    nextUpdateMs = millis() + config.updateIntervalMs;
+
+    uint8_t numBands = config.analyzer->getNumBands();
+    uint16_t numPanelPixels = pixelSet->numPanelPixels;
+
+    uint16_t segmentStart = 0;
+    for (uint8_t band = 0; band < numBands; ++band) {
+
+        // Levels above the floor are stretched to fill the brightness
+        // range.  A band brightens at once and fades gradually.
+        uint8_t level = config.analyzer->getBandLevel(band);
+        uint8_t brightness = level > config.floorLevel
+            ? (uint16_t) (level - config.floorLevel) * 255 / (255 - config.floorLevel)
+            : 0;
+        uint8_t decayed = qsub8(bandBrightnesses[band], config.decayPerUpdate);
+        if (brightness < decayed) {
+            brightness = decayed;
+        }
+        bandBrightnesses[band] = brightness;
+
+        CRGB color;
+        hsv2rgb_rainbow(CHSV(config.startHue + band * config.hueStep, 255, brightness), color);
+        color.nscale8_video(pixelSet->foregroundIntensityScaleFactor);
+
+        uint16_t segmentEnd = (uint32_t) numPanelPixels * (band + 1) / numBands;
+        fill_solid(pixelSet->pixels + segmentStart, segmentEnd - segmentStart, color);
+        segmentStart = segmentEnd;
+    }
+
+    replicatePixelPanels(pixelSet);
+
+    // Return true to request write to the LEDs.
+    return true;
+}
@@ -0,0 +1,57 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Sound Bands Pattern                                             *
+ *                                                                 *
+ * by Ross Butler   Dec. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __SOUND_BANDS_H
+#define __SOUND_BANDS_H
+
+#include "PixelPattern.h"
+#include "AudioBandAnalyzer.h"
+
+
+namespace pixelPattern {
+
+// Splits each pixel panel into one segment per band of an
+// AudioBandAnalyzer, from the lowest band at pixel 0 up.  Each segment's
+// hue is fixed, and its brightness follows the band's level, jumping up
+// on a loud sound and fading back down.  The sketch keeps the analyzer
+// (and its AudioSampler) updated.
+class SoundBands : public PixelPattern {
+
+public:
+
+    static constexpr uint8_t id = 10;
+
+    struct PatternConfig {
+        AudioBandAnalyzer* analyzer;
+        uint8_t            startHue;            // hue of the lowest band
+        uint8_t            hueStep;             // hue added for each higher band
+        uint8_t            floorLevel;          // band levels at or below this are dark
+        uint8_t            decayPerUpdate;      // most that a band's brightness falls each update
+        uint32_t           updateIntervalMs;
+    };
+
+    SoundBands() {};
+    ~SoundBands() {};
+
+    SoundBands(const SoundBands&) = delete;
+    SoundBands& operator =(const SoundBands&) = delete;
+
+    bool initPattern(bool configIsInFlash, void* patternConfig);
+    bool update();
+
+private:
+
+    PatternConfig config;
+    uint8_t bandBrightnesses[AudioBandAnalyzer::maxBands];
+};
+
+}
+
+#endif  // #ifndef __SOUND_BANDS_H
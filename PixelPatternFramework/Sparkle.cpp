@@ -67,6 +67,19 @@ bool Sparkle::update()
 {
     uint32_t now = millis();
 
+    if (config.moveInTurn) {
+        // Each sparkle goes dark and a new one lights in its place, one
+        // after the other, so a new sparkle that lands on the pixel of a
+        // sparkle that hasn't moved yet goes dark when that one moves.
+        for (uint8_t i = 0; i < config.density; ++i) {
+            pixelSet->pixels[selectedPixels[i]] = bgColor;
+            selectedPixels[i] = pickPixel();
+            pixelSet->pixels[selectedPixels[i]] = fgColor;
+        }
+        nextUpdateMs = now + config.changeMs;
+        return true;
+    }
+
     if (sparklesAreOn) {
         sparklesAreOn = false;
 
@@ -89,7 +102,7 @@ bool Sparkle::update()
 
     // Turn on random sparkle pixels.
     for (uint8_t i = 0; i < config.density; ++i) {
-        selectedPixels[i] = random16(pixelSet->numPixels);
+        selectedPixels[i] = pickPixel();
         pixelSet->pixels[selectedPixels[i]] = fgColor;
     }
 
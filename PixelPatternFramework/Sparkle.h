@@ -30,6 +30,8 @@ public:
         uint8_t             density;        // number of foreground (sparkle) pixels on simultaneously
         uint32_t            dwellMs;        // period that a set of sparkles is on (lit)
         uint32_t            changeMs;       // period between sparkle sets (changes)
+        bool                moveInTurn;     // true to move each sparkle in turn every changeMs, with no dark period (ignores dwellMs)
+        bool                useRandom8;     // true to pick pixels with random8 (for at most 255 pixels), like the legacy sparkle
     };
 
     Sparkle()
@@ -47,6 +49,8 @@ public:
 
 private:
 
+    uint16_t pickPixel() const { return config.useRandom8 ? random8(pixelSet->numPixels) : random16(pixelSet->numPixels); }
+
     PatternConfig config;
     CRGB fgColor;
     CRGB bgColor;
@@ -0,0 +1,88 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Network Stream Pattern Selector Class                           *
+ *                                                                 *
+ * by Ross Butler   Nov. 2016                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifdef ESP8266
+
+#include "StreamSelector.h"
+#include "AutoShowSelector.h"
+#include "PixelStreamReceiver.h"
+
+using namespace pixelPattern;
+
+
+StreamSelector::StreamSelector(
+    PixelStreamReceiver* receiver,
+    PixelSet* pixelSet,
+    uint8_t streamPatternNum,
+    PatternSelector* fallbackSelector)
+    : fallbackSelector(fallbackSelector)
+    , ownFallbackSelector(false)
+    , pixelSet(pixelSet)
+    , receiver(receiver)
+    , streamPatternNum(streamPatternNum)
+    , showingStream(false)
+{
+    if (0 == this->fallbackSelector) {
+        this->fallbackSelector = new AutoShowSelector();
+        ownFallbackSelector = true;
+    }
+}
+
+
+StreamSelector::~StreamSelector()
+{
+    if (ownFallbackSelector) {
+        delete fallbackSelector;
+    }
+}
+
+
+void StreamSelector::setPatternSequence(PatternSequence* ps)
+{
+    patternSequence = ps;
+    fallbackSelector->setPatternSequence(ps);
+}
+
+
+bool StreamSelector::setPatternNum(uint8_t newPatternNum)
+{
+    // Selections made while streaming take effect when the stream stops.
+    bool result = fallbackSelector->setPatternNum(newPatternNum);
+    patternNum = fallbackSelector->getPatternNum();
+    return result;
+}
+
+
+bool StreamSelector::checkIfPatternChangeNeeded()
+{
+    bool streaming = receiver->isStreaming(pixelSet);
+
+    if (streaming != showingStream) {
+        return true;
+    }
+
+    return streaming ? false : fallbackSelector->checkIfPatternChangeNeeded();
+}
+
+
+uint8_t StreamSelector::changePattern()
+{
+    showingStream = receiver->isStreaming(pixelSet);
+
+    if (showingStream) {
+        return streamPatternNum;
+    }
+
+    // The fallback selector resumes with whatever it would have selected next.
+    return fallbackSelector->changePattern();
+}
+
+
+#endif  // #ifdef ESP8266
@@ -0,0 +1,67 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Network Stream Pattern Selector Class                           *
+ *                                                                 *
+ * by Ross Butler   Nov. 2016                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __STREAM_SELECTOR_H
+#define __STREAM_SELECTOR_H
+
+#ifdef ESP8266
+
+#include "PatternSelector.h"
+#include <stdint.h>
+
+
+namespace pixelPattern {
+
+class PixelSet;
+class PixelStreamReceiver;
+
+
+// Selects the StreamedPixels pattern while a network pixel stream is active
+// for the pixel set, and lets another selector (by default, an automatic
+// show) choose the patterns the rest of the time.  The pattern sequence
+// must contain a StreamedPixels pattern with a zero duration so that the
+// automatic show won't select it.
+class StreamSelector : public PatternSelector {
+
+public:
+
+    StreamSelector(
+        PixelStreamReceiver* receiver,
+        PixelSet* pixelSet,
+        uint8_t streamPatternNum,
+        PatternSelector* fallbackSelector = 0);
+
+    ~StreamSelector();
+
+    StreamSelector(const StreamSelector&) = delete;
+    StreamSelector& operator =(const StreamSelector&) = delete;
+
+    bool setPatternNum(uint8_t newPatternNum);
+    void setPatternSequence(PatternSequence* ps);
+    bool checkIfPatternChangeNeeded();
+    uint8_t changePattern();
+
+protected:
+
+private:
+
+    PatternSelector* fallbackSelector;
+    bool ownFallbackSelector;
+    PixelSet* pixelSet;
+    PixelStreamReceiver* receiver;
+    uint8_t streamPatternNum;
+    bool showingStream;
+};
+
+}
+
+#endif  // #ifdef ESP8266
+
+#endif  // #ifndef __STREAM_SELECTOR_H
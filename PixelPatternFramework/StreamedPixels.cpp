@@ -0,0 +1,57 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Streamed Pixels Pattern                                         *
+ *                                                                 *
+ * by Ross Butler   Nov. 2016                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifdef ESP8266
+
+#include "StreamedPixels.h"
+#include "PixelStreamReceiver.h"
+
+using namespace pixelPattern;
+
+
+bool StreamedPixels::initPattern(bool configIsInFlash, void* patternConfig)
+{
+    // Returns true if successful, false if failed or pattern cannot run.
+
+    if (configIsInFlash) {
+        memcpy_P(&config, patternConfig, sizeof(PatternConfig));
+    }
+    else {
+        memcpy(&config, patternConfig, sizeof(PatternConfig));
+    }
+
+    if (0 == config.receiver) {
+        return false;
+    }
+
+    // The controller clears the pixels when it changes patterns, which
+    // wipes out the frame that started the stream.  Rather than show the
+    // cleared pixels, the LEDs keep the last pattern's frame until the
+    // next one arrives.
+    config.receiver->takeNewFrame(pixelSet);
+
+    // We need update() to be called as soon as possible.
+    nextUpdateMs = millis() - 1;
+
+    return true;
+}
+
+
+bool StreamedPixels::update()
+{
+    // Frames can arrive at any time, so check again on the next loop.
+    nextUpdateMs = millis() + 1;
+
+    // Return true to request write to the LEDs.
+    return config.receiver->takeNewFrame(pixelSet);
+}
+
+
+#endif  // #ifdef ESP8266
@@ -0,0 +1,55 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Streamed Pixels Pattern                                         *
+ *                                                                 *
+ * by Ross Butler   Nov. 2016                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __STREAMED_PIXELS_H
+#define __STREAMED_PIXELS_H
+
+#ifdef ESP8266
+
+#include "PixelPattern.h"
+
+
+namespace pixelPattern {
+
+class PixelStreamReceiver;
+
+
+// Displays pixel frames received over the network by a PixelStreamReceiver.
+// The receiver writes the frames directly into the pixel set, so all this
+// pattern has to do is request an LED update when a new frame has arrived.
+class StreamedPixels : public PixelPattern {
+
+public:
+
+    static constexpr uint8_t id = 9;
+
+    struct PatternConfig {
+        PixelStreamReceiver* receiver;
+    };
+
+    StreamedPixels() {};
+    ~StreamedPixels() {};
+
+    StreamedPixels(const StreamedPixels&) = delete;
+    StreamedPixels& operator =(const StreamedPixels&) = delete;
+
+    bool initPattern(bool configIsInFlash, void* patternConfig);
+    bool update();
+
+private:
+
+    PatternConfig config;
+};
+
+}
+
+#endif  // #ifdef ESP8266
+
+#endif  // #ifndef __STREAMED_PIXELS_H
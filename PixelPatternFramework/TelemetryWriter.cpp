@@ -0,0 +1,219 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Binary Telemetry Writer Class                                   *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include "TelemetryWriter.h"
+
+using namespace pixelPattern;
+
+
+static uint16_t crcCcittUpdate(uint16_t crc, uint8_t data)
+{
+    // This is avr-libc's _crc_ccitt_update, which isn't available on
+    // other architectures.
+    data ^= crc & 0xff;
+    data ^= data << 4;
+    return (((uint16_t) data << 8) | (crc >> 8)) ^ (uint8_t) (data >> 4) ^ ((uint16_t) data << 3);
+}
+
+
+TelemetryWriter::TelemetryWriter(Print& out, uint16_t txBufferSize)
+    : numFramesSent(0)
+    , numFramesDropped(0)
+    , out(out)
+    , txBufferSize(txBufferSize)
+    , txBuffer(nullptr)
+    , txHead(0)
+    , txTail(0)
+    , nextSeq(0)
+    , numSchemas(0)
+    , nextSchemaIdx(0)
+    , lastSchemaSentMs(0)
+{
+}
+
+
+TelemetryWriter::~TelemetryWriter()
+{
+    delete[] txBuffer;
+}
+
+
+bool TelemetryWriter::begin()
+{
+    delete[] txBuffer;
+    txBuffer = new uint8_t[txBufferSize];
+    txHead = 0;
+    txTail = 0;
+    if (0 == txBuffer) {
+        return false;
+    }
+
+    // Start with a delimiter so that a receiver that is already listening
+    // syncs on it rather than skipping the first frame.
+    txBuffer[txHead++] = 0;
+    return true;
+}
+
+
+bool TelemetryWriter::addSchema(uint8_t schemaId, const __FlashStringHelper* description)
+{
+    if (schemaDescriptionSchemaId == schemaId || numSchemas >= maxSchemas) {
+        return false;
+    }
+
+    Schema& schema = schemas[numSchemas++];
+    schema.schemaId = schemaId;
+    schema.description = description;
+    sendSchema(schema);
+    return true;
+}
+
+
+bool TelemetryWriter::sendSchema(const Schema& schema)
+{
+    const char* p = (const char*) schema.description;
+    uint8_t length = strnlen_P(p, maxPayloadSize - 1);
+
+    if (!beginFrame(schemaDescriptionSchemaId, length + 1)) {
+        return false;
+    }
+    putFrameByte(schema.schemaId);
+    for (uint8_t i = 0; i < length; ++i) {
+        putFrameByte(pgm_read_byte(p + i));
+    }
+    endFrame();
+
+    lastSchemaSentMs = millis();
+    return true;
+}
+
+
+bool TelemetryWriter::sendRecord(uint8_t schemaId, const int16_t* fields, uint8_t numFields)
+{
+    if (!beginFrame(schemaId, numFields * 2)) {
+        return false;
+    }
+    for (uint8_t i = 0; i < numFields; ++i) {
+        putFrameByte(fields[i] & 0xff);
+        putFrameByte((uint16_t) fields[i] >> 8);
+    }
+    endFrame();
+
+    pump();
+    return true;
+}
+
+
+bool TelemetryWriter::beginFrame(uint8_t schemaId, uint8_t payloadSize)
+{
+    if (0 == txBuffer || payloadSize > maxPayloadSize) {
+        ++numFramesDropped;
+        return false;
+    }
+
+    // header, payload, and CRC, plus the COBS code byte and the delimiter
+    uint16_t maxEncodedSize = headerSize + payloadSize + 2 + 2;
+    uint16_t used = txHead >= txTail ? txHead - txTail : txBufferSize - txTail + txHead;
+    // One slot stays empty so that a full buffer doesn't look empty.
+    if (txBufferSize - used - 1 < maxEncodedSize) {
+        ++numFramesDropped;
+        return false;
+    }
+
+    frameHead = txHead;
+    frameCrc = 0xffff;
+    codeIdx = frameHead;
+    code = 1;
+    putEncodedByte(0);      // placeholder for the first code byte
+
+    uint16_t nowMs = millis();
+    putFrameByte(schemaId);
+    putFrameByte(nextSeq++);
+    putFrameByte(nowMs & 0xff);
+    putFrameByte(nowMs >> 8);
+
+    return true;
+}
+
+
+void TelemetryWriter::putEncodedByte(uint8_t b)
+{
+    txBuffer[frameHead] = b;
+    if (++frameHead >= txBufferSize) {
+        frameHead = 0;
+    }
+}
+
+
+void TelemetryWriter::putFrameByte(uint8_t b)
+{
+    frameCrc = crcCcittUpdate(frameCrc, b);
+
+    // COBS replaces each zero with the distance to the next one.  Frames
+    // are always shorter than 254 bytes, so a block never fills up.
+    if (0 == b) {
+        txBuffer[codeIdx] = code;
+        codeIdx = frameHead;
+        code = 1;
+        putEncodedByte(0);      // placeholder for the next code byte
+    }
+    else {
+        putEncodedByte(b);
+        ++code;
+    }
+}
+
+
+void TelemetryWriter::endFrame()
+{
+    uint16_t crc = frameCrc;
+    putFrameByte(crc & 0xff);
+    putFrameByte(crc >> 8);
+    txBuffer[codeIdx] = code;
+    putEncodedByte(0);
+
+    txHead = frameHead;
+    ++numFramesSent;
+}
+
+
+void TelemetryWriter::pump()
+{
+    if (numSchemas > 0 && millis() - lastSchemaSentMs >= schemaRepeatMs) {
+        if (nextSchemaIdx >= numSchemas) {
+            nextSchemaIdx = 0;
+        }
+        // If there's no room right now, try again after schemaRetryMs
+        // rather than every time through loop while the buffer is full.
+        if (sendSchema(schemas[nextSchemaIdx])) {
+            ++nextSchemaIdx;
+        }
+        else {
+            lastSchemaSentMs = millis() - (schemaRepeatMs - schemaRetryMs);
+        }
+    }
+
+    while (txTail != txHead) {
+        int room = out.availableForWrite();
+        if (room <= 0) {
+            break;
+        }
+        uint16_t length = txHead > txTail ? txHead - txTail : txBufferSize - txTail;
+        if (length > (uint16_t) room) {
+            length = room;
+        }
+        out.write(txBuffer + txTail, length);
+        txTail += length;
+        if (txTail >= txBufferSize) {
+            txTail = 0;
+        }
+    }
+}
@@ -0,0 +1,131 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Binary Telemetry Writer Class                                   *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __TELEMETRY_WRITER_H
+#define __TELEMETRY_WRITER_H
+
+#include <stdint.h>
+
+class Print;
+class __FlashStringHelper;
+
+
+namespace pixelPattern {
+
+// Sends records of int16_t fields as compact binary frames, so that a
+// sketch can stream measurements at the sensor's rate rather than at the
+// rate that a serial port can carry them as text.  Each frame is
+//
+//   schema id, sequence number, millis() & 0xffff (little-endian),
+//   fields (little-endian), CRC-16 (little-endian)
+//
+// COBS-encoded and followed by a 0x00 delimiter, so a receiver can find
+// the start of the next frame no matter what it missed.  The CRC is the
+// reflected CCITT CRC with an initial value of 0xffff (avr-libc's
+// _crc_ccitt_update), over everything before it.  The sequence number
+// counts the frames that are queued, so gaps in it show frames that were
+// lost after they were sent, and numFramesDropped counts the frames that
+// didn't fit.  The first frame is preceded by a delimiter, too.
+//
+// A schema describes a record type in text, a name followed by its field
+// names, each optionally followed by a divisor to scale it by:
+//
+//   "motion:yaw/10,pitch/10,roll/10,accelX/8192,accelY/8192,accelZ/8192"
+//
+// Descriptions are sent as records with schema id 0 whose payload is the
+// described schema's id followed by the text.  They are repeated every
+// schemaRepeatMs so that a receiver that starts listening late still
+// learns them.  A description that doesn't fit is retried every
+// schemaRetryMs.  telemetry/decodeTelemetry decodes the frames into CSV.
+//
+// Frames are queued in a ring buffer and written out by pump() only as
+// fast as out reports room for them with availableForWrite(), so sending
+// never blocks.  If a frame doesn't fit in the ring buffer, it is dropped.
+class TelemetryWriter {
+
+public:
+
+    static constexpr uint8_t schemaDescriptionSchemaId = 0;
+    static constexpr uint8_t maxSchemas = 4;
+    static constexpr uint16_t schemaRepeatMs = 2000;
+    static constexpr uint16_t schemaRetryMs = 100;
+
+    // Frames shorter than 254 bytes grow by just one byte when they are
+    // COBS-encoded.  Schema descriptions longer than maxPayloadSize - 1
+    // characters are cut off.
+    static constexpr uint8_t headerSize = 4;
+    static constexpr uint8_t maxPayloadSize = 200;
+
+    TelemetryWriter(Print& out, uint16_t txBufferSize);
+
+    ~TelemetryWriter();
+
+    TelemetryWriter(const TelemetryWriter&) = delete;
+    TelemetryWriter& operator =(const TelemetryWriter&) = delete;
+
+    // Registers and sends the schema for schemaId.  description must be
+    // in flash, as with F("...").  Returns false if schemaId is 0 or there
+    // are already maxSchemas schemas.
+    bool addSchema(uint8_t schemaId, const __FlashStringHelper* description);
+
+    // Allocates the ring buffer and queues the leading delimiter.  Call
+    // this before addSchema.  Returns false if the buffer couldn't be
+    // allocated.
+    bool begin();
+
+    // Writes as much of the queued data as out has room for, and repeats
+    // a schema description when it is time to.  Call this every time
+    // through loop.
+    void pump();
+
+    // Queues a record and writes what out has room for.  Returns false if
+    // the record was dropped for lack of room.
+    bool sendRecord(uint8_t schemaId, const int16_t* fields, uint8_t numFields);
+
+    uint32_t numFramesSent;
+    uint32_t numFramesDropped;
+
+private:
+
+    struct Schema {
+        uint8_t schemaId;
+        const __FlashStringHelper* description;
+    };
+
+    // Frames are COBS-encoded straight into the ring buffer.  Nothing
+    // between txHead and frameHead is visible to pump() until endFrame().
+    bool beginFrame(uint8_t schemaId, uint8_t payloadSize);
+    void putFrameByte(uint8_t b);
+    void endFrame();
+    void putEncodedByte(uint8_t b);
+
+    bool sendSchema(const Schema& schema);
+
+    Print& out;
+    uint16_t txBufferSize;
+    uint8_t* txBuffer;
+    uint16_t txHead;
+    uint16_t txTail;
+
+    uint16_t frameHead;
+    uint16_t codeIdx;
+    uint8_t code;
+    uint16_t frameCrc;
+    uint8_t nextSeq;
+
+    Schema schemas[maxSchemas];
+    uint8_t numSchemas;
+    uint8_t nextSchemaIdx;
+    uint32_t lastSchemaSentMs;
+};
+
+}
+
+#endif  // #ifndef __TELEMETRY_WRITER_H
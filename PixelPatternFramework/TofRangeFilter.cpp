@@ -0,0 +1,103 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Time-of-Flight Range Filter Class                               *
+ *                                                                 *
+ * by Ross Butler   Dec. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include "TofRangeFilter.h"
+
+using namespace pixelPattern;
+
+
+static uint16_t absDiff(uint16_t a, uint16_t b)
+{
+    return a > b ? a - b : b - a;
+}
+
+
+TofRangeFilter::TofRangeFilter()
+    : numAccepted(0)
+    , numBadStatus(0)
+    , numWeakSignal(0)
+    , numOutliers(0)
+    , config({0, 0, UINT16_MAX, 0})
+{
+    reset();
+}
+
+
+TofRangeFilter::TofRangeFilter(const TofRangeFilterConfig& config)
+    : numAccepted(0)
+    , numBadStatus(0)
+    , numWeakSignal(0)
+    , numOutliers(0)
+    , config(config)
+{
+    reset();
+}
+
+
+void TofRangeFilter::reset()
+{
+    hasRange = false;
+    rangeMm = 0;
+    candidateMm = 0;
+    numCandidateReadings = 0;
+}
+
+
+bool TofRangeFilter::addRange(uint16_t rangeMm, uint8_t rangeStatus, uint16_t signalKcps, uint16_t ambientKcps)
+{
+    if (rangeStatusValid != rangeStatus) {
+        ++numBadStatus;
+        return false;
+    }
+
+    if (signalKcps < config.minSignalKcps
+        || (uint32_t) signalKcps * 100 < (uint32_t) ambientKcps * config.minSignalToAmbientPct)
+    {
+        ++numWeakSignal;
+        return false;
+    }
+
+    if (hasRange && absDiff(rangeMm, this->rangeMm) > config.maxJumpMm) {
+        // Count the readings in a row that agree with the first one that
+        // jumped.  One that doesn't starts the count over.
+        if (numCandidateReadings > 0 && absDiff(rangeMm, candidateMm) <= config.maxJumpMm) {
+            ++numCandidateReadings;
+        }
+        else {
+            numCandidateReadings = 1;
+        }
+        candidateMm = rangeMm;
+
+        if (numCandidateReadings < config.numJumpConfirmations) {
+            ++numOutliers;
+            return false;
+        }
+    }
+
+    hasRange = true;
+    this->rangeMm = rangeMm;
+    numCandidateReadings = 0;
+    ++numAccepted;
+    return true;
+}
+
+
+void TofRangeFilter::printStats(Print& out) const
+{
+    out.print(F("accepted="));
+    out.print(numAccepted);
+    out.print(F(" badStatus="));
+    out.print(numBadStatus);
+    out.print(F(" weakSignal="));
+    out.print(numWeakSignal);
+    out.print(F(" outliers="));
+    out.println(numOutliers);
+}
@@ -0,0 +1,88 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Time-of-Flight Range Filter Class                               *
+ *                                                                 *
+ * by Ross Butler   Dec. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __TOF_RANGE_FILTER_H
+#define __TOF_RANGE_FILTER_H
+
+#include <stdint.h>
+
+class Print;
+
+
+namespace pixelPattern {
+
+struct TofRangeFilterConfig {
+    uint16_t minSignalKcps;             // weaker returns are rejected
+    uint8_t  minSignalToAmbientPct;     // so are returns this close to the ambient light
+    uint16_t maxJumpMm;                 // bigger changes are outliers until confirmed
+    uint8_t  numJumpConfirmations;      // readings that must agree to accept a jump
+};
+
+// Screens VL53L1X ranges before they are used.  A range is rejected if
+// its range status isn't valid (0), if its peak signal rate is too low,
+// or if the signal isn't far enough above the ambient rate, which is how
+// sunlight and out-of-range targets show up.
+//
+// A range more than maxJumpMm from the last accepted one is held back as
+// a possible outlier.  If numJumpConfirmations readings in a row jump and
+// each lands within maxJumpMm of the one before, the target really moved
+// and the newest of them is accepted.  A single bad reading therefore
+// never moves the output, and a real move is followed after a few
+// readings.
+class TofRangeFilter {
+
+public:
+
+    static constexpr uint8_t rangeStatusValid = 0;
+
+    // Without a config, every range with a valid status is accepted until
+    // setConfig() is called.
+    TofRangeFilter();
+    explicit TofRangeFilter(const TofRangeFilterConfig& config);
+
+    ~TofRangeFilter() {}
+
+    TofRangeFilter(const TofRangeFilter&) = delete;
+    TofRangeFilter& operator =(const TofRangeFilter&) = delete;
+
+    // Returns true if the range was accepted, in which case getRangeMm()
+    // returns it.  The rates are in thousands of counts per second.
+    bool addRange(uint16_t rangeMm, uint8_t rangeStatus, uint16_t signalKcps, uint16_t ambientKcps);
+
+    // Returns the last accepted range.
+    uint16_t getRangeMm() const { return rangeMm; }
+
+    bool getHasRange() const { return hasRange; }
+
+    void printStats(Print& out) const;
+
+    void setConfig(const TofRangeFilterConfig& config) { this->config = config; }
+
+    // Forgets the last accepted range, so the next good one is accepted
+    // whatever it is.
+    void reset();
+
+    uint32_t numAccepted;
+    uint16_t numBadStatus;
+    uint16_t numWeakSignal;
+    uint16_t numOutliers;
+
+private:
+
+    TofRangeFilterConfig config;
+    bool hasRange;
+    uint16_t rangeMm;
+    uint16_t candidateMm;
+    uint8_t numCandidateReadings;
+};
+
+}
+
+#endif  // #ifndef __TOF_RANGE_FILTER_H
@@ -0,0 +1,181 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Time-of-Flight Zone Scanner Class                               *
+ *                                                                 *
+ * by Ross Butler   Dec. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include <VL53L1X.h>
+#include "TofZoneScanner.h"
+
+using namespace pixelPattern;
+
+
+TofZoneScanner::TofZoneScanner(
+    VL53L1X& sensor,
+    const TofZone* zones,
+    uint8_t numZones,
+    const TofRangeFilterConfig& filterConfig,
+    uint16_t maxRangeMm,
+    uint16_t zoneTimeoutMs)
+    : numScans(0)
+    , sensor(sensor)
+    , zones(zones)
+    , numZones(numZones < maxZones ? numZones : maxZones)
+    , maxRangeMm(maxRangeMm)
+    , zoneTimeoutMs(zoneTimeoutMs)
+    , currentZone(0)
+    , hasTarget(false)
+    , lateralPosition(0)
+    , nearestRangeMm(0)
+    , hadTargetLastScan(false)
+    , lastScanRangeMm(0)
+    , lastScanMs(0)
+    , approachMmPerSec(0)
+{
+    for (uint8_t i = 0; i < maxZones; ++i) {
+        zoneFilters[i].setConfig(filterConfig);
+        zoneRangesMm[i] = 0;
+        zoneLastRangeMs[i] = 0;
+    }
+}
+
+
+void TofZoneScanner::begin()
+{
+    currentZone = 0;
+    sensor.setROISize(zones[0].roiWidth, zones[0].roiHeight);
+    sensor.setROICenter(zones[0].roiCenterSpad);
+}
+
+
+void TofZoneScanner::selectZone(uint8_t zone)
+{
+    // Writing the ROI takes a few I2C transactions, so unchanged sizes
+    // aren't rewritten.
+    const TofZone& oldZone = zones[currentZone];
+    const TofZone& newZone = zones[zone];
+    if (newZone.roiWidth != oldZone.roiWidth || newZone.roiHeight != oldZone.roiHeight) {
+        sensor.setROISize(newZone.roiWidth, newZone.roiHeight);
+    }
+    sensor.setROICenter(newZone.roiCenterSpad);
+    currentZone = zone;
+}
+
+
+bool TofZoneScanner::getZoneHasTarget(uint8_t zone, uint32_t nowMs) const
+{
+    return zoneFilters[zone].getHasRange()
+        && nowMs - zoneLastRangeMs[zone] <= zoneTimeoutMs
+        && zoneRangesMm[zone] <= maxRangeMm;
+}
+
+
+bool TofZoneScanner::addRange(uint16_t rangeMm, uint8_t rangeStatus, uint16_t signalKcps, uint16_t ambientKcps, uint32_t nowMs)
+{
+    uint8_t zone = currentZone;
+    TofRangeFilter& filter = zoneFilters[zone];
+
+    // A zone that lost its target accepts whatever it sees next rather
+    // than treating it as a jump from the old range.
+    bool isStale = !filter.getHasRange() || nowMs - zoneLastRangeMs[zone] > zoneTimeoutMs;
+    if (isStale) {
+        filter.reset();
+    }
+
+    bool accepted = filter.addRange(rangeMm, rangeStatus, signalKcps, ambientKcps);
+    if (accepted) {
+        // Average with the previous range to take the edge off the
+        // noise without adding much lag at one range per scan.
+        zoneRangesMm[zone] = isStale ? rangeMm : (zoneRangesMm[zone] + rangeMm + 1) / 2;
+        zoneLastRangeMs[zone] = nowMs;
+    }
+
+    selectZone(zone + 1 < numZones ? zone + 1 : 0);
+
+    updateTarget(nowMs);
+    if (0 == currentZone) {
+        ++numScans;
+        updateApproach(nowMs);
+    }
+
+    return accepted;
+}
+
+
+void TofZoneScanner::updateTarget(uint32_t nowMs)
+{
+    // The weights are how much nearer than maxRangeMm each zone's range
+    // is, so a hand close to one zone pulls the position toward that
+    // zone more than the background seen by another does.
+    int32_t weightedPositionSum = 0;
+    uint32_t weightSum = 0;
+    uint16_t nearestMm = UINT16_MAX;
+
+    for (uint8_t i = 0; i < numZones; ++i) {
+        if (!getZoneHasTarget(i, nowMs)) {
+            continue;
+        }
+        uint16_t weight = maxRangeMm - zoneRangesMm[i] + 1;
+        weightedPositionSum += (int32_t) zones[i].lateralPosition * weight;
+        weightSum += weight;
+        if (zoneRangesMm[i] < nearestMm) {
+            nearestMm = zoneRangesMm[i];
+        }
+    }
+
+    hasTarget = weightSum > 0;
+    if (hasTarget) {
+        lateralPosition = weightedPositionSum / (int32_t) weightSum;
+        nearestRangeMm = nearestMm;
+    }
+}
+
+
+void TofZoneScanner::updateApproach(uint32_t nowMs)
+{
+    if (!hasTarget) {
+        hadTargetLastScan = false;
+        approachMmPerSec = 0;
+        return;
+    }
+
+    uint32_t dtMs = nowMs - lastScanMs;
+    if (hadTargetLastScan && dtMs > 0) {
+        int32_t mmPerSec = ((int32_t) nearestRangeMm - lastScanRangeMm) * 1000 / (int32_t) dtMs;
+        mmPerSec = constrain(mmPerSec, -INT16_MAX, INT16_MAX);
+        approachMmPerSec = (approachMmPerSec + mmPerSec) / 2;
+    }
+
+    hadTargetLastScan = true;
+    lastScanRangeMm = nearestRangeMm;
+    lastScanMs = nowMs;
+}
+
+
+void TofZoneScanner::printStats(Print& out) const
+{
+    out.print(F("scans="));
+    out.print(numScans);
+    out.print(F(" hasTarget="));
+    out.print(hasTarget);
+    out.print(F(" lateralPosition="));
+    out.print(lateralPosition);
+    out.print(F(" nearestRangeMm="));
+    out.print(nearestRangeMm);
+    out.print(F(" approachMmPerSec="));
+    out.println(approachMmPerSec);
+
+    for (uint8_t i = 0; i < numZones; ++i) {
+        out.print(F("zone "));
+        out.print(i);
+        out.print(F(" rangeMm="));
+        out.print(zoneRangesMm[i]);
+        out.print(' ');
+        zoneFilters[i].printStats(out);
+    }
+}
@@ -0,0 +1,130 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Time-of-Flight Zone Scanner Class                               *
+ *                                                                 *
+ * by Ross Butler   Dec. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __TOF_ZONE_SCANNER_H
+#define __TOF_ZONE_SCANNER_H
+
+#include <stdint.h>
+#include "TofRangeFilter.h"
+
+class Print;
+class VL53L1X;
+
+
+namespace pixelPattern {
+
+// A region of interest on the VL53L1X's 16x16 SPAD array.  The smallest
+// ROI is 4x4.  lateralPosition says where the zone looks, from -1000 at
+// one side of the scanned area to 1000 at the other.
+struct TofZone {
+    uint8_t roiCenterSpad;
+    uint8_t roiWidth;
+    uint8_t roiHeight;
+    int16_t lateralPosition;
+};
+
+// Turns one VL53L1X into a few coarse range sensors by moving its region
+// of interest from zone to zone, one range per zone.  Each zone's ranges
+// are screened by its own TofRangeFilter and smoothed.  From the zones
+// that see a target, the scanner estimates where the target is across
+// the scanned area and how fast it is approaching.
+//
+// Call addRange() with each range read from the sensor.  The range is
+// credited to the current zone, and the next zone's ROI is written.  A
+// new ROI takes effect with the next measurement that starts, so the
+// inter-measurement period must leave time after the timing budget for
+// the range to be read and the ROI to be written.  Otherwise each range
+// is credited to the zone before the one it came from.
+//
+// Zones that haven't accepted a range for zoneTimeoutMs, or whose range
+// is beyond maxRangeMm, don't see a target.
+class TofZoneScanner {
+
+public:
+
+    static constexpr uint8_t maxZones = 4;
+
+    TofZoneScanner(
+        VL53L1X& sensor,
+        const TofZone* zones,
+        uint8_t numZones,
+        const TofRangeFilterConfig& filterConfig,
+        uint16_t maxRangeMm,
+        uint16_t zoneTimeoutMs);
+
+    ~TofZoneScanner() {}
+
+    TofZoneScanner(const TofZoneScanner&) = delete;
+    TofZoneScanner& operator =(const TofZoneScanner&) = delete;
+
+    // Selects the first zone.  Call it before starting continuous ranging.
+    void begin();
+
+    // Adds the range just read for the current zone and moves on to the
+    // next zone.  The rates are in thousands of counts per second.
+    // Returns true if the range was accepted.
+    bool addRange(uint16_t rangeMm, uint8_t rangeStatus, uint16_t signalKcps, uint16_t ambientKcps, uint32_t nowMs);
+
+    // Returns the target's approach speed, which is negative when it is
+    // getting closer.  It is measured once per scan of all the zones.
+    int16_t getApproachMmPerSec() const { return approachMmPerSec; }
+
+    uint8_t getCurrentZone() const { return currentZone; }
+
+    bool getHasTarget() const { return hasTarget; }
+
+    // Returns the target's position across the scanned area, weighting
+    // each zone that sees the target more the closer its range is.
+    int16_t getLateralPosition() const { return lateralPosition; }
+
+    // Returns the range of the nearest zone that sees the target.
+    uint16_t getNearestRangeMm() const { return nearestRangeMm; }
+
+    const TofRangeFilter& getZoneFilter(uint8_t zone) const { return zoneFilters[zone]; }
+
+    bool getZoneHasTarget(uint8_t zone, uint32_t nowMs) const;
+
+    // Returns the zone's smoothed range.
+    uint16_t getZoneRangeMm(uint8_t zone) const { return zoneRangesMm[zone]; }
+
+    void printStats(Print& out) const;
+
+    uint32_t numScans;
+
+private:
+
+    void selectZone(uint8_t zone);
+    void updateTarget(uint32_t nowMs);
+    void updateApproach(uint32_t nowMs);
+
+    VL53L1X& sensor;
+    const TofZone* zones;
+    uint8_t numZones;
+    uint16_t maxRangeMm;
+    uint16_t zoneTimeoutMs;
+
+    uint8_t currentZone;
+    TofRangeFilter zoneFilters[maxZones];
+    uint16_t zoneRangesMm[maxZones];
+    uint32_t zoneLastRangeMs[maxZones];
+
+    bool hasTarget;
+    int16_t lateralPosition;
+    uint16_t nearestRangeMm;
+
+    bool hadTargetLastScan;
+    uint16_t lastScanRangeMm;
+    uint32_t lastScanMs;
+    int16_t approachMmPerSec;
+};
+
+}
+
+#endif  // #ifndef __TOF_ZONE_SCANNER_H
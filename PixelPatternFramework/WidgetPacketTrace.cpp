@@ -0,0 +1,121 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Widget Packet Trace Writer and Reader                           *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include "WidgetPacketTrace.h"
+
+using namespace pixelPattern;
+
+
+namespace pixelPattern {
+
+static int8_t hexDigitValue(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+
+void writeWidgetPacketTrace(Print& out, const WidgetPacket& packet)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+
+    out.print(F("T "));
+    out.print(packet.rxMs);
+    out.print(' ');
+    out.print(packet.pipeNum);
+    out.print(' ');
+    for (uint8_t i = 0; i < packet.payloadSize; ++i) {
+        out.print(hexDigits[packet.payload[i] >> 4]);
+        out.print(hexDigits[packet.payload[i] & 0x0f]);
+    }
+    out.println();
+}
+
+
+bool parseWidgetPacketTrace(const char* line, WidgetPacket* packet)
+{
+    if (line[0] != 'T' || line[1] != ' ') {
+        return false;
+    }
+
+    char* end;
+    packet->rxMs = strtoul(line + 2, &end, 10);
+    if (end == line + 2 || *end != ' ') {
+        return false;
+    }
+
+    const char* p = end + 1;
+    unsigned long pipeNum = strtoul(p, &end, 10);
+    if (end == p || *end != ' ' || pipeNum > 5) {
+        return false;
+    }
+    packet->pipeNum = pipeNum;
+
+    p = end + 1;
+    uint8_t payloadSize = 0;
+    while (hexDigitValue(p[0]) >= 0 && hexDigitValue(p[1]) >= 0) {
+        if (payloadSize >= maxWidgetPayloadSize) {
+            return false;
+        }
+        packet->payload[payloadSize++] = hexDigitValue(p[0]) << 4 | hexDigitValue(p[1]);
+        p += 2;
+    }
+    if (payloadSize < sizeof(WidgetHeader) || (*p != '\0' && *p != '\r')) {
+        return false;
+    }
+    packet->payloadSize = payloadSize;
+
+    return true;
+}
+
+}
+
+
+WidgetTraceReader::WidgetTraceReader()
+    : lineLength(0)
+    , lineTooLong(false)
+{
+}
+
+
+bool WidgetTraceReader::read(Stream& in, WidgetPacket* packet)
+{
+    while (in.available() > 0) {
+        char c = in.read();
+        if ('\n' != c) {
+            if (lineLength < maxLineLength) {
+                line[lineLength++] = c;
+            }
+            else {
+                lineTooLong = true;
+            }
+            continue;
+        }
+
+        line[lineLength] = '\0';
+        bool gotPacket = !lineTooLong && parseWidgetPacketTrace(line, packet);
+        lineLength = 0;
+        lineTooLong = false;
+        if (gotPacket) {
+            return true;
+        }
+    }
+
+    return false;
+}
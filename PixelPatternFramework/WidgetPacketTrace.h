@@ -0,0 +1,67 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Widget Packet Trace Writer and Reader                           *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __WIDGET_PACKET_TRACE_H
+#define __WIDGET_PACKET_TRACE_H
+
+#include <stdint.h>
+#include "WidgetPayloadRouter.h"
+
+class Print;
+class Stream;
+
+
+namespace pixelPattern {
+
+// A packet trace is text, one packet per line:
+//
+//   T <rxMs> <pipeNum> <payload bytes in hex>
+//
+// for example, "T 104233 2 0b1c0e0000...".  Lines that don't start with
+// "T " are ignored when reading a trace, so traces can be captured from a
+// serial port along with other output and replayed as is.
+
+// Writes packet as a trace line.
+void writeWidgetPacketTrace(Print& out, const WidgetPacket& packet);
+
+// Parses a trace line into packet.  Returns false if line isn't a valid
+// trace line.
+bool parseWidgetPacketTrace(const char* line, WidgetPacket* packet);
+
+
+// Assembles trace lines from a stream without blocking.
+class WidgetTraceReader {
+
+public:
+
+    // Long enough for a 32-byte payload and a 10-digit timestamp.
+    static constexpr uint8_t maxLineLength = 96;
+
+    WidgetTraceReader();
+
+    ~WidgetTraceReader() {}
+
+    WidgetTraceReader(const WidgetTraceReader&) = delete;
+    WidgetTraceReader& operator =(const WidgetTraceReader&) = delete;
+
+    // Consumes available characters until a trace line is complete.
+    // Returns true and fills in packet if one was.
+    bool read(Stream& in, WidgetPacket* packet);
+
+private:
+
+    char line[maxLineLength + 1];
+    uint8_t lineLength;
+    bool lineTooLong;
+};
+
+}
+
+#endif  // #ifndef __WIDGET_PACKET_TRACE_H
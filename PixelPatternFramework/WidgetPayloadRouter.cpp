@@ -0,0 +1,272 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Widget Payload Router Class                                     *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include "RF24.h"
+#include "MotionInterpolator.h"
+#include "WidgetPayloadRouter.h"
+#include "WidgetPacketTrace.h"
+
+using namespace pixelPattern;
+
+
+namespace pixelPattern {
+
+static bool getMeasurement(const WidgetRoute& route, const WidgetPacket& packet, int16_t* pValue)
+{
+    if (packet.payloadSize < measurementVectorPayloadSize(route.arg + 1)) {
+        return false;
+    }
+    *pValue = packet.as<MeasurementVectorPayload>()->measurements[route.arg];
+    return true;
+}
+
+
+bool routeMeasurementToInt16(const WidgetRoute& route, const WidgetPacket& packet)
+{
+    int16_t value;
+    if (measurementsAreAllZero(packet) || !getMeasurement(route, packet, &value)) {
+        return false;
+    }
+    *(int16_t*) route.target = value;
+    return true;
+}
+
+
+bool routeMeasurementToInterpolator(const WidgetRoute& route, const WidgetPacket& packet)
+{
+    int16_t value;
+    if (measurementsAreAllZero(packet) || !getMeasurement(route, packet, &value)) {
+        return false;
+    }
+    ((MotionInterpolator*) route.target)->addSample(value, packet.rxMs);
+    return true;
+}
+
+
+bool measurementsAreAllZero(const WidgetPacket& packet)
+{
+    for (uint8_t i = sizeof(WidgetHeader); i < packet.payloadSize; ++i) {
+        if (0 != packet.payload[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+
+WidgetPayloadRouter::WidgetPayloadRouter(
+    RF24& radio,
+    WidgetHeaderFormat headerFormat,
+    const WidgetRoute* routes,
+    uint8_t numRoutes)
+    : numPacketsReceived(0)
+    , numPacketsUnrouted(0)
+    , numPacketsCorrupt(0)
+    , radio(radio)
+    , headerFormat(headerFormat)
+    , routes(routes)
+    , numRoutes(numRoutes)
+    , traceOutput(nullptr)
+    , gapThresholdMs(defaultGapThresholdMs)
+{
+    resetLinkStats();
+}
+
+
+bool WidgetPayloadRouter::dispatch(WidgetPacket& packet)
+{
+    const WidgetHeader* header = (const WidgetHeader*) packet.payload;
+    packet.widgetId = header->getId(headerFormat);
+    packet.channel = header->getChannel(headerFormat);
+    packet.isActive = header->getIsActive(headerFormat);
+
+    bool matchedRoute = false;
+    bool sizeMismatch = false;
+    bool updatedTarget = false;
+
+    for (uint8_t i = 0; i < numRoutes; ++i) {
+        if (pgm_read_byte(&routes[i].pipeNum) != packet.pipeNum) {
+            continue;
+        }
+
+        WidgetRoute route;
+        memcpy_P(&route, routes + i, sizeof(WidgetRoute));
+        if ((route.widgetIdMask & (1UL << packet.widgetId))
+            && (route.channelMask & (1u << packet.channel)))
+        {
+            if (0 == route.payloadSize || route.payloadSize == packet.payloadSize) {
+                matchedRoute = true;
+                if ((*route.handler)(route, packet)) {
+                    updatedTarget = true;
+                }
+            }
+            else {
+                sizeMismatch = true;
+            }
+        }
+    }
+
+    if (!matchedRoute) {
+        ++numPacketsUnrouted;
+    }
+
+    updateLinkStats(packet, sizeMismatch && !matchedRoute);
+
+    return updatedTarget;
+}
+
+
+uint8_t WidgetPayloadRouter::poll()
+{
+    uint8_t numUpdates = 0;
+
+    // Keep the rates current even when the widgets go quiet.
+    updateRateWindow(millis());
+
+    for (uint8_t n = 0; n < maxPacketsPerPoll && radio.available(&packet.pipeNum); ++n) {
+        packet.rxMs = millis();
+        packet.payloadSize = radio.getDynamicPayloadSize();
+        ++numPacketsReceived;
+
+        // A corrupt payload size means the FIFO can't be trusted.
+        if (packet.payloadSize < sizeof(WidgetHeader) || packet.payloadSize > maxWidgetPayloadSize) {
+            ++numPacketsCorrupt;
+            radio.flush_rx();
+            break;
+        }
+
+        radio.read(packet.payload, packet.payloadSize);
+
+        if (0 != traceOutput) {
+            writeWidgetPacketTrace(*traceOutput, packet);
+        }
+
+        if (dispatch(packet)) {
+            ++numUpdates;
+        }
+    }
+
+    return numUpdates;
+}
+
+
+void WidgetPayloadRouter::resetLinkStats()
+{
+    numTrackedWidgets = 0;
+    rateWindowStartMs = millis();
+    memset(linkStats, 0, sizeof(linkStats));
+}
+
+
+const WidgetLinkStats* WidgetPayloadRouter::getLinkStats(uint8_t widgetId) const
+{
+    for (uint8_t i = 0; i < numTrackedWidgets; ++i) {
+        if (linkStats[i].widgetId == widgetId) {
+            return linkStats + i;
+        }
+    }
+    return nullptr;
+}
+
+
+WidgetLinkStats* WidgetPayloadRouter::findOrAddLinkStats(uint8_t widgetId)
+{
+    WidgetLinkStats* stats = (WidgetLinkStats*) getLinkStats(widgetId);
+    if (0 == stats && numTrackedWidgets < maxTrackedWidgets) {
+        stats = linkStats + numTrackedWidgets++;
+        stats->widgetId = widgetId;
+    }
+    return stats;
+}
+
+
+void WidgetPayloadRouter::updateLinkStats(const WidgetPacket& packet, bool sizeMismatch)
+{
+    updateRateWindow(packet.rxMs);
+
+    WidgetLinkStats* stats = findOrAddLinkStats(packet.widgetId);
+    if (0 == stats) {
+        return;
+    }
+
+    if (stats->numPackets > 0) {
+        uint32_t gapMs = packet.rxMs - stats->lastSeenMs;
+        if (gapMs > gapThresholdMs) {
+            ++stats->numGaps;
+        }
+        if (gapMs > stats->maxGapMs) {
+            stats->maxGapMs = gapMs < UINT16_MAX ? gapMs : UINT16_MAX;
+        }
+    }
+
+    stats->pipeNum = packet.pipeNum;
+    ++stats->numPackets;
+    stats->numBytes += packet.payloadSize;
+    if (sizeMismatch) {
+        ++stats->numSizeMismatches;
+    }
+    stats->lastSeenMs = packet.rxMs;
+    if (stats->numWindowPackets < UINT8_MAX) {
+        ++stats->numWindowPackets;
+    }
+}
+
+
+void WidgetPayloadRouter::updateRateWindow(uint32_t nowMs)
+{
+    // Packet rates are counted over windows of at least a second.
+
+    uint32_t windowMs = nowMs - rateWindowStartMs;
+    if (windowMs < 1000) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < numTrackedWidgets; ++i) {
+        linkStats[i].packetsPerSec = (uint32_t) linkStats[i].numWindowPackets * 1000 / windowMs;
+        linkStats[i].numWindowPackets = 0;
+    }
+    rateWindowStartMs = nowMs;
+}
+
+
+void WidgetPayloadRouter::printLinkStats(Print& out, uint32_t nowMs) const
+{
+    out.print(F("received="));
+    out.print(numPacketsReceived);
+    out.print(F(" unrouted="));
+    out.print(numPacketsUnrouted);
+    out.print(F(" corrupt="));
+    out.println(numPacketsCorrupt);
+
+    for (uint8_t i = 0; i < numTrackedWidgets; ++i) {
+        const WidgetLinkStats& stats = linkStats[i];
+        out.print(F("widget "));
+        out.print(stats.widgetId);
+        out.print(F(" pipe="));
+        out.print(stats.pipeNum);
+        out.print(F(" packets="));
+        out.print(stats.numPackets);
+        out.print(F(" bytes="));
+        out.print(stats.numBytes);
+        out.print(F(" sizeMismatches="));
+        out.print(stats.numSizeMismatches);
+        out.print(F(" gaps="));
+        out.print(stats.numGaps);
+        out.print(F(" maxGapMs="));
+        out.print(stats.maxGapMs);
+        out.print(F(" lastSeenMsAgo="));
+        out.print(nowMs - stats.lastSeenMs);
+        out.print(F(" packetsPerSec="));
+        out.println(stats.packetsPerSec);
+    }
+}
@@ -0,0 +1,185 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Widget Payload Router Class                                     *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __WIDGET_PAYLOAD_ROUTER_H
+#define __WIDGET_PAYLOAD_ROUTER_H
+
+#include <stdint.h>
+#include "WidgetPayloads.h"
+
+class Print;
+class RF24;
+
+
+namespace pixelPattern {
+
+// A payload received from a widget, along with the pipe it arrived on and
+// when it arrived.  Payloads are cast in place to the struct for the pipe.
+// The router decodes the widget header before dispatching the packet.
+struct WidgetPacket {
+    uint32_t rxMs;
+    uint8_t  pipeNum;
+    uint8_t  payloadSize;
+    uint8_t  widgetId;
+    uint8_t  channel;
+    bool     isActive;
+    uint8_t  payload[maxWidgetPayloadSize];
+
+    template <typename P>
+    const P* as() const { return (const P*) payload; }
+};
+
+struct WidgetRoute;
+
+// Handles a packet that matched route.  Returns true if the packet
+// updated route.target.
+typedef bool (*WidgetPayloadHandler)(const WidgetRoute& route, const WidgetPacket& packet);
+
+// Sends packets from the widgets in widgetIdMask, on the channels in
+// channelMask, and with payloadSize bytes (or any size if payloadSize is
+// 0) to handler.  target and arg are for the handler, typically the
+// variable to update and the measurement to update it from.
+struct WidgetRoute {
+    uint8_t              pipeNum;
+    uint32_t             widgetIdMask;
+    uint8_t              channelMask;
+    uint8_t              payloadSize;
+    WidgetPayloadHandler handler;
+    void*                target;
+    uint8_t              arg;
+};
+
+constexpr uint32_t anyWidget = 0xffffffff;
+constexpr uint8_t anyChannel = 0xff;
+
+// Returns the mask for the listed widget ids or channels, as in
+// routeMask(2, 6, 9).
+constexpr uint32_t routeMask()
+{
+    return 0;
+}
+
+template <typename... Bits>
+constexpr uint32_t routeMask(uint8_t bit, Bits... bits)
+{
+    return (1UL << bit) | routeMask(bits...);
+}
+
+// Stock handlers.  arg is the measurement index.
+bool routeMeasurementToInt16(const WidgetRoute& route, const WidgetPacket& packet);
+bool routeMeasurementToInterpolator(const WidgetRoute& route, const WidgetPacket& packet);
+
+// Returns true if every measurement is zero, which is what widgets send
+// as a heartbeat while they are in standby mode.
+bool measurementsAreAllZero(const WidgetPacket& packet);
+
+
+// Link quality counters for one widget.
+struct WidgetLinkStats {
+    uint8_t  widgetId;
+    uint8_t  pipeNum;               // pipe of the most recent packet
+    uint32_t numPackets;
+    uint32_t numBytes;
+    uint16_t numSizeMismatches;     // matched a route except for the payload size
+    uint16_t numGaps;               // arrived more than the gap threshold after the previous one
+    uint16_t maxGapMs;
+    uint32_t lastSeenMs;
+    uint8_t  packetsPerSec;         // during the last full rate window
+    uint8_t  numWindowPackets;
+};
+
+
+// Drains an RF24's receive FIFO and dispatches each payload to every
+// matching route in a table kept in flash:
+//
+//   const WidgetRoute widgetRoutes[] PROGMEM = {
+//       {2, routeMask(1), anyChannel, measurementVectorPayloadSize(13),
+//        routeMeasurementToInterpolator, &lampAngle, 1},
+//       ...
+//   };
+//   WidgetPayloadRouter router(radio, WidgetHeaderFormat::fourBitId,
+//                              widgetRoutes, sizeof(widgetRoutes) / sizeof(WidgetRoute));
+//
+// Each payload is read once into the router's packet buffer and handled
+// there without further copying.
+class WidgetPayloadRouter {
+
+public:
+
+    // Bounds the time spent in poll() if widgets send faster than we can
+    // keep up.  The nRF24L01+ receive FIFO holds three payloads.
+    static constexpr uint8_t maxPacketsPerPoll = 8;
+
+    // Link stats are kept for the first maxTrackedWidgets widgets heard from.
+    static constexpr uint8_t maxTrackedWidgets = 8;
+    static constexpr uint16_t defaultGapThresholdMs = 250;
+
+    WidgetPayloadRouter(
+        RF24& radio,
+        WidgetHeaderFormat headerFormat,
+        const WidgetRoute* routes,
+        uint8_t numRoutes);
+
+    ~WidgetPayloadRouter() {}
+
+    WidgetPayloadRouter(const WidgetPayloadRouter&) = delete;
+    WidgetPayloadRouter& operator =(const WidgetPayloadRouter&) = delete;
+
+    // Decodes packet's widget header and dispatches packet to its routes.
+    // Returns true if any handler updated its target.
+    bool dispatch(WidgetPacket& packet);
+
+    // Returns the most recently received packet.
+    const WidgetPacket& getLastPacket() const { return packet; }
+
+    // Returns the link stats for widgetId, or nullptr if it isn't tracked.
+    const WidgetLinkStats* getLinkStats(uint8_t widgetId) const;
+
+    // Writes one line of link stats per tracked widget, plus the totals.
+    void printLinkStats(Print& out, uint32_t nowMs) const;
+
+    void resetLinkStats();
+
+    void setGapThresholdMs(uint16_t thresholdMs) { gapThresholdMs = thresholdMs; }
+
+    // Writes each received packet to out in the WidgetPacketTrace format,
+    // or stops writing them if out is nullptr.
+    void setTraceOutput(Print* out) { traceOutput = out; }
+
+    // Reads and dispatches payloads until the receive FIFO is empty.
+    // Returns the number of payloads that updated a target.
+    uint8_t poll();
+
+    uint32_t numPacketsReceived;
+    uint32_t numPacketsUnrouted;        // no route matched, including wrong payload sizes
+    uint32_t numPacketsCorrupt;         // corrupt dynamic payload size
+
+private:
+
+    WidgetLinkStats* findOrAddLinkStats(uint8_t widgetId);
+    void updateLinkStats(const WidgetPacket& packet, bool sizeMismatch);
+    void updateRateWindow(uint32_t nowMs);
+
+    RF24& radio;
+    WidgetHeaderFormat headerFormat;
+    const WidgetRoute* routes;
+    uint8_t numRoutes;
+    WidgetPacket packet;
+
+    Print* traceOutput;
+    uint16_t gapThresholdMs;
+    uint32_t rateWindowStartMs;
+    uint8_t numTrackedWidgets;
+    WidgetLinkStats linkStats[maxTrackedWidgets];
+};
+
+}
+
+#endif  // #ifndef __WIDGET_PAYLOAD_ROUTER_H
@@ -0,0 +1,88 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Widget Packet Header and Payload Structure Definitions          *
+ *                                                                 *
+ * by Ross Butler   Nov. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __WIDGET_PAYLOADS_H
+#define __WIDGET_PAYLOADS_H
+
+#include <stdint.h>
+
+
+namespace pixelPattern {
+
+// nRF24L01+ payloads are at most 32 bytes, including the widget header.
+constexpr uint8_t maxWidgetPayloadSize = 32;
+
+// The first byte of every payload is the widget header.  Widgets built
+// through 2018 use a 4-bit widget id, an active flag, and a 3-bit channel
+// (from LSB to MSB).  Later widgets use a 5-bit id, a 2-bit channel, and
+// the active flag.
+enum class WidgetHeaderFormat : uint8_t {
+    fourBitId,
+    fiveBitId
+};
+
+struct WidgetHeader {
+    uint8_t raw;
+
+    uint8_t getId(WidgetHeaderFormat format) const
+    {
+        return WidgetHeaderFormat::fourBitId == format ? raw & 0x0f : raw & 0x1f;
+    }
+
+    uint8_t getChannel(WidgetHeaderFormat format) const
+    {
+        return WidgetHeaderFormat::fourBitId == format ? raw >> 5 : (raw >> 5) & 0x03;
+    }
+
+    bool getIsActive(WidgetHeaderFormat format) const
+    {
+        return WidgetHeaderFormat::fourBitId == format ? raw & 0x10 : raw & 0x80;
+    }
+};
+
+// The payloads are packed, as the AVR widgets send them, so that they
+// decode the same way on receivers with wider alignment, such as the host
+// tests.
+
+// pipe 0
+struct __attribute__((packed)) StressTestPayload {
+    WidgetHeader widgetHeader;
+    uint32_t     payloadNum;
+    uint32_t     numTxFailures;
+};
+
+// pipe 1
+struct __attribute__((packed)) PositionVelocityPayload {
+    WidgetHeader widgetHeader;
+    int16_t      position;
+    int16_t      velocity;
+};
+
+// pipe 2
+struct __attribute__((packed)) MeasurementVectorPayload {
+    WidgetHeader widgetHeader;
+    int16_t      measurements[15];
+};
+
+// pipe 5
+struct __attribute__((packed)) CustomPayload {
+    WidgetHeader widgetHeader;
+    uint8_t      buf[31];
+};
+
+// Returns the payload size of a MeasurementVectorPayload with numMeasurements values.
+constexpr uint8_t measurementVectorPayloadSize(uint8_t numMeasurements)
+{
+    return sizeof(WidgetHeader) + sizeof(int16_t) * numMeasurements;
+}
+
+}
+
+#endif  // #ifndef __WIDGET_PAYLOADS_H
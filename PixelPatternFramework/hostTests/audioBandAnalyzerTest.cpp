@@ -0,0 +1,413 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Audio Band Analyzer WAV Test                                    *
+ *                                                                 *
+ * Plays a WAV file into an AudioSampler, as if it were the        *
+ * microphone, and runs an AudioBandAnalyzer on it.                *
+ *                                                                 *
+ * usage:  audioBandAnalyzerTest [file.wav]                        *
+ *                                                                 *
+ * Without a file, it makes a WAV of silence and of tones at each  *
+ * band's frequency and at a few loudnesses, plays it, and checks  *
+ * that each tone shows up in its own band at the right level, and *
+ * that every level is within two steps of a floating point        *
+ * Goertzel filter's level for the same samples.  Then it times    *
+ * the analyzer against the floating point filter.                 *
+ *                                                                 *
+ * With a file, such as a recording of a microphone, it writes     *
+ * the band levels of each block instead.  The file must be 16-bit *
+ * mono PCM at the sampler's rate (9615 samples per second).       *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include <AudioBandAnalyzer.h>
+#include <AudioSampler.h>
+#include <chrono>
+#include <vector>
+
+using namespace pixelPattern;
+
+static const uint16_t bandFrequenciesHz[] = {150, 450, 750, 1100, 1600, 2300, 3200, 4200};
+static constexpr uint8_t numBands = sizeof(bandFrequenciesHz) / sizeof(bandFrequenciesHz[0]);
+static constexpr uint8_t blockShift = 6;
+static constexpr uint16_t blockSize = 1 << blockShift;
+static constexpr uint16_t blockIntervalMs = 33;
+
+// The sampler's window doesn't matter here, and its ring buffer is as big
+// as it can be.  A sketch's loop calls update() every few samples.
+static constexpr uint8_t samplerWindowShift = 8;
+static constexpr uint8_t samplerBufferSize = 128;
+static constexpr uint8_t samplesPerLoop = 8;
+
+// A WAV sample is scaled down to a 10-bit ADC sample around 512.
+static constexpr uint8_t wavToAdcShift = 6;
+static constexpr uint16_t adcBias = 512;
+
+static constexpr uint32_t testSegmentMs = 400;
+static constexpr uint8_t maxLevelError = 2;
+
+// A tone's level is also checked against its amplitude in the WAV, which
+// the ADC rounds, so a quiet tone can be a few steps off.
+static constexpr uint8_t maxToneLevelError = 4;
+
+// Levels up to this (an amplitude of 2 counts) are rounding, by the ADC
+// and by the analyzer when it scales the input down, so they only have
+// to be that low.
+static constexpr uint8_t noiseFloorLevel = 32;
+
+// The analyzer scales its input down to steps of 4 counts and uses an
+// 8-bit window, so what leaks from a loud tone into the other bands is
+// mostly that rounding once it is 24 dB (128 steps) below the tone.
+// Levels that far below the loudest one only have to stay there.
+static constexpr uint8_t maxLeakageLevels = 128;
+static constexpr uint32_t benchmarkPasses = 20;
+
+static volatile uint8_t benchmarkSink;
+
+
+struct Wav {
+    uint32_t sampleRateHz;
+    std::vector<int16_t> samples;
+};
+
+// A stretch of the test WAV, which is a tone, or silence if its
+// amplitude is 0.
+struct Segment {
+    uint32_t firstSample;
+    uint32_t endSample;
+    uint8_t band;
+    uint16_t amplitude;         // in ADC counts
+};
+
+struct Block {
+    uint32_t endSample;
+    uint8_t levels[numBands];
+};
+
+
+static void putLe(std::vector<uint8_t>& bytes, uint32_t value, uint8_t size)
+{
+    for (uint8_t i = 0; i < size; ++i) {
+        bytes.push_back(value >> (8 * i));
+    }
+}
+
+
+static uint32_t getLe(const uint8_t* p, uint8_t size)
+{
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < size; ++i) {
+        value |= (uint32_t) p[i] << (8 * i);
+    }
+    return value;
+}
+
+
+// Makes a 16-bit mono PCM WAV:  silence, a tone at each band's frequency,
+// a quieter tone, and silence again.
+static std::vector<uint8_t> makeTestWav(uint32_t sampleRateHz, std::vector<Segment>& segments)
+{
+    std::vector<int16_t> samples;
+    uint32_t segmentSamples = sampleRateHz * testSegmentMs / 1000;
+
+    auto addSegment = [&](uint8_t band, uint16_t amplitude) {
+        segments.push_back({(uint32_t) samples.size(), (uint32_t) samples.size() + segmentSamples, band, amplitude});
+        double w = 2 * PI * bandFrequenciesHz[band] / sampleRateHz;
+        for (uint32_t i = 0; i < segmentSamples; ++i) {
+            samples.push_back(lround(amplitude * sin(w * i)) << wavToAdcShift);
+        }
+    };
+
+    addSegment(0, 0);
+    for (uint8_t band = 0; band < numBands; ++band) {
+        addSegment(band, 200);
+    }
+    addSegment(3, 50);
+    addSegment(6, 12);
+    addSegment(0, 0);
+
+    std::vector<uint8_t> bytes;
+    uint32_t dataSize = samples.size() * 2;
+    bytes.insert(bytes.end(), {'R', 'I', 'F', 'F'});
+    putLe(bytes, 36 + dataSize, 4);
+    bytes.insert(bytes.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+    putLe(bytes, 16, 4);
+    putLe(bytes, 1, 2);                 // PCM
+    putLe(bytes, 1, 2);                 // mono
+    putLe(bytes, sampleRateHz, 4);
+    putLe(bytes, sampleRateHz * 2, 4);  // bytes per second
+    putLe(bytes, 2, 2);                 // bytes per sample
+    putLe(bytes, 16, 2);                // bits per sample
+    bytes.insert(bytes.end(), {'d', 'a', 't', 'a'});
+    putLe(bytes, dataSize, 4);
+    for (int16_t sample : samples) {
+        putLe(bytes, (uint16_t) sample, 2);
+    }
+
+    return bytes;
+}
+
+
+static bool parseWav(const std::vector<uint8_t>& bytes, Wav* wav)
+{
+    if (bytes.size() < 12 || 0 != memcmp(&bytes[0], "RIFF", 4) || 0 != memcmp(&bytes[8], "WAVE", 4)) {
+        printf("not a WAV file\n");
+        return false;
+    }
+
+    bool hasFormat = false;
+    for (size_t i = 12; i + 8 <= bytes.size(); ) {
+        const uint8_t* chunk = &bytes[i];
+        uint32_t chunkSize = getLe(chunk + 4, 4);
+        if (i + 8 + chunkSize > bytes.size()) {
+            chunkSize = bytes.size() - i - 8;
+        }
+
+        if (0 == memcmp(chunk, "fmt ", 4) && chunkSize >= 16) {
+            if (1 != getLe(chunk + 8, 2) || 1 != getLe(chunk + 10, 2) || 16 != getLe(chunk + 22, 2)) {
+                printf("the WAV file isn't 16-bit mono PCM\n");
+                return false;
+            }
+            wav->sampleRateHz = getLe(chunk + 12, 4);
+            hasFormat = true;
+        }
+        else if (0 == memcmp(chunk, "data", 4) && hasFormat) {
+            for (uint32_t j = 0; j + 1 < chunkSize; j += 2) {
+                wav->samples.push_back((int16_t) getLe(chunk + 8 + j, 2));
+            }
+            return true;
+        }
+
+        // Chunks are padded to an even size.
+        i += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    printf("the WAV file has no %s\n", hasFormat ? "data" : "format");
+    return false;
+}
+
+
+static uint16_t adcSample(int16_t wavSample)
+{
+    return adcBias + (wavSample >> wavToAdcShift);
+}
+
+
+// Plays wav into the sampler a sample at a time, calling the analyzer's
+// update() every samplesPerLoop samples.  Returns the levels of each
+// block and the total time that update() took.  acSamples gets each
+// sample less the DC bias, tracked the same way that the sampler does,
+// which is what the analyzer sees.
+static std::vector<Block> play(const Wav& wav, AudioSampler& sampler, AudioBandAnalyzer& analyzer,
+                               std::vector<int16_t>& acSamples, double* updateNs)
+{
+    std::vector<Block> blocks;
+    uint64_t elapsedUs = 0;
+    int32_t dcScaled = (int32_t) adcSample(wav.samples.empty() ? 0 : wav.samples[0]) << AudioSampler::dcShift;
+    *updateNs = 0;
+
+    for (uint32_t i = 0; i < wav.samples.size(); ++i) {
+        uint16_t sample = adcSample(wav.samples[i]);
+        sampler.addSample(sample);
+        dcScaled += (int32_t) sample - (dcScaled >> AudioSampler::dcShift);
+        acSamples.push_back((int16_t) sample - (int16_t) (dcScaled >> AudioSampler::dcShift));
+
+        uint64_t sampleUs = (uint64_t) (i + 1) * 1000000 / wav.sampleRateHz;
+        host::advanceUs(sampleUs - elapsedUs);
+        elapsedUs = sampleUs;
+
+        if (0 == (i + 1) % samplesPerLoop) {
+            auto start = std::chrono::steady_clock::now();
+            bool isFinished = analyzer.update(millis());
+            std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            *updateNs += elapsed.count();
+
+            if (isFinished) {
+                Block block;
+                block.endSample = i + 1;
+                for (uint8_t b = 0; b < numBands; ++b) {
+                    block.levels[b] = analyzer.getBandLevel(b);
+                }
+                blocks.push_back(block);
+            }
+        }
+    }
+
+    return blocks;
+}
+
+
+// The analyzer's levels, but with a floating point Goertzel filter and
+// log2() on the block's samples.
+static void floatLevels(const int16_t* acSamples, uint32_t sampleRateHz, uint8_t* levels)
+{
+    for (uint8_t b = 0; b < numBands; ++b) {
+        float coeff = 2 * cosf(2 * PI * bandFrequenciesHz[b] / sampleRateHz);
+        float s1 = 0;
+        float s2 = 0;
+        for (uint16_t i = 0; i < blockSize; ++i) {
+            float hann = sinf(PI * i / blockSize);
+            float s0 = acSamples[i] * hann * hann + coeff * s1 - s2;
+            s2 = s1;
+            s1 = s0;
+        }
+
+        float power = s1 * s1 + s2 * s2 - coeff * s1 * s2;
+        float amplitude = 4 * sqrtf(power > 0 ? power : 0) / blockSize;
+        float level = amplitude * amplitude >= 2 ? 32 * log2f(amplitude) : 0;
+        levels[b] = level < 255 ? level : 255;
+    }
+}
+
+
+static bool checkBlock(const Block& block, const Segment& segment, const std::vector<int16_t>& acSamples,
+                       uint32_t sampleRateHz)
+{
+    uint8_t expected[numBands];
+    floatLevels(&acSamples[block.endSample - blockSize], sampleRateHz, expected);
+
+    // Quieter levels than the floor only have to stay below it.
+    uint8_t floorLevel = noiseFloorLevel;
+    for (uint8_t b = 0; b < numBands; ++b) {
+        if (expected[b] > floorLevel + maxLeakageLevels) {
+            floorLevel = expected[b] - maxLeakageLevels;
+        }
+    }
+
+    bool ok = true;
+    uint8_t loudestBand = 0;
+    for (uint8_t b = 0; b < numBands; ++b) {
+        bool isBelowFloor = block.levels[b] <= floorLevel && expected[b] <= floorLevel;
+        if (!isBelowFloor && abs(block.levels[b] - expected[b]) > maxLevelError) {
+            ok = false;
+        }
+        if (block.levels[b] > block.levels[loudestBand]) {
+            loudestBand = b;
+        }
+        if (0 == segment.amplitude && block.levels[b] > noiseFloorLevel) {
+            ok = false;
+        }
+    }
+
+    if (segment.amplitude > 0) {
+        int16_t toneLevel = lround(32 * log2(segment.amplitude));
+        ok &= loudestBand == segment.band && abs(block.levels[segment.band] - toneLevel) <= maxToneLevelError;
+    }
+
+    if (!ok) {
+        if (0 == segment.amplitude) {
+            printf("silence at sample %lu:  the levels are", (unsigned long) block.endSample);
+        }
+        else {
+            printf("%u Hz at %u counts, sample %lu:  the levels are",
+                   bandFrequenciesHz[segment.band], segment.amplitude, (unsigned long) block.endSample);
+        }
+        for (uint8_t b = 0; b < numBands; ++b) {
+            printf(" %u", block.levels[b]);
+        }
+        printf(", and the float levels are");
+        for (uint8_t b = 0; b < numBands; ++b) {
+            printf(" %u", expected[b]);
+        }
+        printf("\n");
+    }
+    return ok;
+}
+
+
+// Times the floating point filter on every block's samples, to compare
+// with the analyzer's time.
+static double floatNsPerBlock(const std::vector<Block>& blocks, const std::vector<int16_t>& acSamples,
+                              uint32_t sampleRateHz)
+{
+    uint8_t levels[numBands];
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t pass = 0; pass < benchmarkPasses; ++pass) {
+        for (const Block& block : blocks) {
+            floatLevels(&acSamples[block.endSample - blockSize], sampleRateHz, levels);
+            benchmarkSink = levels[0];
+        }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (benchmarkPasses * blocks.size());
+}
+
+
+int main(int argc, char** argv)
+{
+    AudioSampler sampler(samplerWindowShift, samplerBufferSize);
+    AudioBandAnalyzer analyzer(sampler, bandFrequenciesHz, numBands, blockShift, blockIntervalMs);
+    if (!sampler.begin(A0) || !analyzer.begin()) {
+        printf("the sampler or the analyzer didn't start\n");
+        return 1;
+    }
+
+    std::vector<uint8_t> bytes;
+    std::vector<Segment> segments;
+    if (argc > 1) {
+        FILE* f = fopen(argv[1], "rb");
+        if (0 == f) {
+            perror(argv[1]);
+            return 2;
+        }
+        uint8_t buf[4096];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+            bytes.insert(bytes.end(), buf, buf + n);
+        }
+        fclose(f);
+    }
+    else {
+        bytes = makeTestWav(sampler.getSampleRateHz(), segments);
+    }
+
+    Wav wav;
+    if (!parseWav(bytes, &wav)) {
+        return 1;
+    }
+    if (wav.sampleRateHz != sampler.getSampleRateHz()) {
+        printf("the WAV file is %lu samples per second, not %u\n",
+               (unsigned long) wav.sampleRateHz, sampler.getSampleRateHz());
+        return 1;
+    }
+
+    double updateNs;
+    std::vector<int16_t> acSamples;
+    std::vector<Block> blocks = play(wav, sampler, analyzer, acSamples, &updateNs);
+    if (sampler.numOverruns > 0) {
+        printf("the sampler's ring buffer overran %u times\n", sampler.numOverruns);
+        return 1;
+    }
+
+    if (argc > 1) {
+        for (const Block& block : blocks) {
+            printf("%lu", (unsigned long) (block.endSample * 1000ULL / wav.sampleRateHz));
+            for (uint8_t b = 0; b < numBands; ++b) {
+                printf(" %u", block.levels[b]);
+            }
+            printf("\n");
+        }
+        return 0;
+    }
+
+    // Only the blocks that are all within one segment are checked.
+    uint32_t numChecked = 0;
+    for (const Block& block : blocks) {
+        for (const Segment& segment : segments) {
+            if (block.endSample - blockSize >= segment.firstSample && block.endSample <= segment.endSample) {
+                if (!checkBlock(block, segment, acSamples, wav.sampleRateHz)) {
+                    return 1;
+                }
+                ++numChecked;
+            }
+        }
+    }
+
+    printf("test WAV:  %u segments, %lu blocks match; float %.0f ns, analyzer %.0f ns per block\n",
+           (unsigned int) segments.size(), (unsigned long) numChecked,
+           floatNsPerBlock(blocks, acSamples, wav.sampleRateHz), updateNs / blocks.size());
+    return 0;
+}
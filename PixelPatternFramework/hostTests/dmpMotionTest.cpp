@@ -0,0 +1,313 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * DMP Motion Test                                                 *
+ *                                                                 *
+ * Checks atan2Tenths against atan2 in every octant and at its     *
+ * edge values, then feeds DMP packets through getDmpMotion and    *
+ * checks its results against the float calculations from the     *
+ * MotionApps 2.0 library that it replaced, and times both.        *
+ *                                                                 *
+ * usage:  dmpMotionTest packets.txt                               *
+ *                                                                 *
+ * Each line of the packets file is a 42-byte packet in hex.       *
+ * Blank lines and lines that start with # are skipped.            *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include <DmpMotion.h>
+#include <chrono>
+#include <vector>
+
+using namespace pixelPattern;
+
+static constexpr uint8_t packetSize = 42;
+
+// atan2Tenths rounds to the nearest tenth, and the table that it
+// interpolates is good to a little over a hundredth of a degree.
+static constexpr double maxAtan2Error = 0.65;
+
+// DmpMotion.h promises yaw, pitch, and roll within 0.1 degree of the
+// library's.  Gravity is truncated to Q14 before the linear accel is
+// worked out, which can move it a count.
+static constexpr float maxYprError = 1.0;
+static constexpr int16_t maxLinearAccelError = 1;
+
+static constexpr uint32_t benchmarkPasses = 200;
+
+static volatile int32_t benchmarkSink;
+
+
+// The MotionApps 2.0 library's quaternion and vector types and its
+// dmpGetQuaternion, dmpGetGravity, dmpGetYawPitchRoll, and
+// dmpGetLinearAccel, with float for the AVR's double.
+struct Quaternion {
+    float w;
+    float x;
+    float y;
+    float z;
+};
+
+struct VectorFloat {
+    float x;
+    float y;
+    float z;
+};
+
+struct FloatMotion {
+    float ypr[3];
+    int16_t linearAccel[3];
+};
+
+static int16_t getPacketInt16(const uint8_t* p)
+{
+    return (int16_t) ((uint16_t) p[0] << 8 | p[1]);
+}
+
+static void dmpGetQuaternion(Quaternion* q, const uint8_t* packet)
+{
+    q->w = (float) getPacketInt16(packet) / 16384.0f;
+    q->x = (float) getPacketInt16(packet + 4) / 16384.0f;
+    q->y = (float) getPacketInt16(packet + 8) / 16384.0f;
+    q->z = (float) getPacketInt16(packet + 12) / 16384.0f;
+}
+
+static void dmpGetGravity(VectorFloat* v, const Quaternion* q)
+{
+    v->x = 2 * (q->x * q->z - q->w * q->y);
+    v->y = 2 * (q->w * q->x + q->y * q->z);
+    v->z = q->w * q->w - q->x * q->x - q->y * q->y + q->z * q->z;
+}
+
+static void dmpGetYawPitchRoll(float* data, const Quaternion* q, const VectorFloat* gravity)
+{
+    data[0] = atan2f(2 * q->x * q->y - 2 * q->w * q->z, 2 * q->w * q->w + 2 * q->x * q->x - 1);
+    data[1] = atanf(gravity->x / sqrtf(gravity->y * gravity->y + gravity->z * gravity->z));
+    data[2] = atanf(gravity->y / sqrtf(gravity->x * gravity->x + gravity->z * gravity->z));
+}
+
+static void dmpGetLinearAccel(int16_t* v, const int16_t* vRaw, const VectorFloat* gravity)
+{
+    v[0] = vRaw[0] - gravity->x * 8192;
+    v[1] = vRaw[1] - gravity->y * 8192;
+    v[2] = vRaw[2] - gravity->z * 8192;
+}
+
+static void getFloatMotion(const uint8_t* packet, FloatMotion* motion)
+{
+    Quaternion q;
+    VectorFloat gravity;
+    int16_t accel[3];
+
+    dmpGetQuaternion(&q, packet);
+    dmpGetGravity(&gravity, &q);
+    dmpGetYawPitchRoll(motion->ypr, &q, &gravity);
+    for (uint8_t i = 0; i < 3; ++i) {
+        motion->ypr[i] *= 1800 / (float) M_PI;
+        accel[i] = getPacketInt16(packet + 28 + i * 4);
+    }
+    dmpGetLinearAccel(motion->linearAccel, accel, &gravity);
+}
+
+
+static bool checkAtan2(int32_t y, int32_t x, double* worstError)
+{
+    double expected = atan2((double) y, (double) x) * 1800 / M_PI;
+    int16_t actual = atan2Tenths(y, x);
+
+    // +/-180 degrees is the same direction either way.
+    double error = fabs(actual - expected);
+    if (fabs(error - 3600) < error) {
+        error = fabs(error - 3600);
+    }
+    if (error > *worstError) {
+        *worstError = error;
+    }
+    if (error > maxAtan2Error || actual < -1800 || actual > 1800) {
+        printf("atan2Tenths(%ld, %ld) is %d rather than %.2f\n", (long) y, (long) x, actual, expected);
+        return false;
+    }
+    return true;
+}
+
+
+static bool checkAtan2Tenths()
+{
+    static const int32_t edgeValues[] = {
+        0, 1, -1, 2, -2, 32767, -32768, 65535, 65536, -65536,
+        (1L << 28), -(1L << 28), INT32_MAX, -INT32_MAX, INT32_MIN
+    };
+
+    double worstError = 0;
+    uint32_t numChecked = 0;
+
+    // Every pair of edge values, which covers the axes, the diagonals, and
+    // the largest magnitudes in every octant
+    for (int32_t y : edgeValues) {
+        for (int32_t x : edgeValues) {
+            if (0 == x && 0 == y) {
+                if (atan2Tenths(0, 0) != 0) {
+                    printf("atan2Tenths(0, 0) is %d\n", atan2Tenths(0, 0));
+                    return false;
+                }
+            }
+            else if (!checkAtan2(y, x, &worstError)) {
+                return false;
+            }
+            ++numChecked;
+        }
+    }
+
+    // Every small pair, where the ratios are coarse
+    for (int32_t y = -64; y <= 64; ++y) {
+        for (int32_t x = -64; x <= 64; ++x) {
+            if ((0 != x || 0 != y) && !checkAtan2(y, x, &worstError)) {
+                return false;
+            }
+            ++numChecked;
+        }
+    }
+
+    // Every hundredth of a degree around the circle, at magnitudes from
+    // the Q14 gravity components to the Q28 yaw terms
+    static const double magnitudes[] = {1000, 16384, 65535, 1L << 20, 1L << 28, 2147483000.0};
+    for (double magnitude : magnitudes) {
+        for (int32_t hundredths = -18000; hundredths <= 18000; ++hundredths) {
+            double angle = hundredths * M_PI / 18000;
+            if (!checkAtan2(lround(magnitude * sin(angle)), lround(magnitude * cos(angle)), &worstError)) {
+                return false;
+            }
+            ++numChecked;
+        }
+    }
+
+    printf("atan2Tenths:  %lu angles within %.2f tenths of a degree\n", (unsigned long) numChecked, worstError);
+    return true;
+}
+
+
+static bool readPackets(const char* fileName, std::vector<std::vector<uint8_t>>& packets)
+{
+    FILE* file = fopen(fileName, "r");
+    if (0 == file) {
+        perror(fileName);
+        return false;
+    }
+
+    bool ok = true;
+    char line[200];
+    for (int lineNum = 1; ok && fgets(line, sizeof(line), file); ++lineNum) {
+        if ('#' == line[0] || '\0' == line[strspn(line, " \t\r\n")]) {
+            continue;
+        }
+
+        std::vector<uint8_t> packet;
+        unsigned int byte;
+        for (const char* p = line; packet.size() < packetSize && 1 == sscanf(p, "%2x", &byte); p += 2) {
+            packet.push_back(byte);
+        }
+        if (packet.size() != packetSize) {
+            printf("line %d:  the packet has %u bytes\n", lineNum, (unsigned int) packet.size());
+            ok = false;
+        }
+        packets.push_back(packet);
+    }
+    fclose(file);
+
+    return ok;
+}
+
+
+static bool checkPackets(const std::vector<std::vector<uint8_t>>& packets)
+{
+    float worstYprError = 0;
+    int16_t worstLinearAccelError = 0;
+
+    for (uint32_t n = 0; n < packets.size(); ++n) {
+        DmpMotion motion;
+        FloatMotion expected;
+        getDmpMotion(packets[n].data(), &motion);
+        getFloatMotion(packets[n].data(), &expected);
+
+        bool ok = true;
+        for (uint8_t i = 0; i < 3; ++i) {
+            float yprError = fabsf(motion.yprTenths[i] - expected.ypr[i]);
+            int16_t linearAccelError = abs(motion.linearAccel[i] - expected.linearAccel[i]);
+            worstYprError = max(worstYprError, yprError);
+            worstLinearAccelError = max(worstLinearAccelError, linearAccelError);
+            ok &= yprError <= maxYprError && linearAccelError <= maxLinearAccelError;
+        }
+
+        if (!ok) {
+            printf("packet %lu:  getDmpMotion gives ypr %d %d %d and linear accel %d %d %d,\n"
+                   "    and the library gives ypr %.2f %.2f %.2f and linear accel %d %d %d\n",
+                   (unsigned long) n,
+                   motion.yprTenths[0], motion.yprTenths[1], motion.yprTenths[2],
+                   motion.linearAccel[0], motion.linearAccel[1], motion.linearAccel[2],
+                   expected.ypr[0], expected.ypr[1], expected.ypr[2],
+                   expected.linearAccel[0], expected.linearAccel[1], expected.linearAccel[2]);
+            return false;
+        }
+    }
+
+    printf("%lu packets:  ypr within %.2f tenths of a degree, linear accel within %d\n",
+           (unsigned long) packets.size(), worstYprError, worstLinearAccelError);
+    return true;
+}
+
+
+static double nsPer(std::chrono::steady_clock::time_point start, uint32_t n)
+{
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / n;
+}
+
+
+static void benchmark(const std::vector<std::vector<uint8_t>>& packets)
+{
+    uint32_t numPackets = benchmarkPasses * packets.size();
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t pass = 0; pass < benchmarkPasses; ++pass) {
+        for (const std::vector<uint8_t>& packet : packets) {
+            FloatMotion motion;
+            getFloatMotion(packet.data(), &motion);
+            benchmarkSink = motion.ypr[0];
+        }
+    }
+    double floatNs = nsPer(start, numPackets);
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t pass = 0; pass < benchmarkPasses; ++pass) {
+        for (const std::vector<uint8_t>& packet : packets) {
+            DmpMotion motion;
+            getDmpMotion(packet.data(), &motion);
+            benchmarkSink = motion.yprTenths[0];
+        }
+    }
+    double fixedNs = nsPer(start, numPackets);
+
+    printf("packets:  float %.1f ns, getDmpMotion %.1f ns per packet\n", floatNs, fixedNs);
+}
+
+
+int main(int argc, char** argv)
+{
+    if (argc != 2) {
+        fprintf(stderr, "usage:  %s packets.txt\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<std::vector<uint8_t>> packets;
+    if (!readPackets(argv[1], packets)) {
+        return 2;
+    }
+
+    bool ok = checkAtan2Tenths() && checkPackets(packets);
+    if (ok) {
+        benchmark(packets);
+    }
+    return ok ? 0 : 1;
+}
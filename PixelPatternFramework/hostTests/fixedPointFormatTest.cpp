@@ -0,0 +1,172 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Fixed-Point Format Test                                         *
+ *                                                                 *
+ * Checks that formatFixedPoint and printFixedPoint give the same  *
+ * strings that printf gives for the value scaled down to a float, *
+ * the way that dtostrf formats it, and then times                 *
+ * formatFixedPoint against dtostrf.                               *
+ *                                                                 *
+ * usage:  fixedPointFormatTest                                    *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include <FixedPointFormat.h>
+#include <chrono>
+
+using namespace pixelPattern;
+
+static constexpr uint32_t numRandomValues = 100000;
+static constexpr uint32_t benchmarkPasses = 20;
+
+static volatile char benchmarkSink;
+
+
+// Collects what is printed to it.
+class StringPrint : public Print {
+public:
+    size_t write(uint8_t c) override { s += (char) c; return 1; }
+    size_t write(const uint8_t* buf, size_t n) override { s.append((const char*) buf, n); return n; }
+
+    std::string s;
+};
+
+
+static bool check(int32_t value, uint8_t numDecimals, uint8_t width)
+{
+    double scale = 1;
+    for (uint8_t i = 0; i < numDecimals; ++i) {
+        scale *= 10;
+    }
+
+    // A double holds every int32_t exactly, and its quotient is close
+    // enough to the decimal value for printf to round it back.
+    char expected[64];
+    snprintf(expected, sizeof(expected), "%*.*f", width, numDecimals, value / scale);
+
+    char actual[maxFixedPointPrintWidth + 1];
+    formatFixedPoint(actual, value, numDecimals, width);
+    if (0 != strcmp(expected, actual)) {
+        printf("%ld with %u decimals in %u:  printf gives \"%s\", and formatFixedPoint gives \"%s\"\n",
+               (long) value, numDecimals, width, expected, actual);
+        return false;
+    }
+
+    StringPrint out;
+    size_t n = printFixedPoint(out, value, numDecimals, width);
+    if (out.s != expected || n != out.s.size()) {
+        printf("%ld with %u decimals in %u:  printf gives \"%s\", and printFixedPoint gives \"%s\" (%u)\n",
+               (long) value, numDecimals, width, expected, out.s.c_str(), (unsigned int) n);
+        return false;
+    }
+
+    return true;
+}
+
+
+static bool checkEdgeValues()
+{
+    static const int32_t values[] = {
+        0, 1, -1, 5, -5, 9, -9, 10, -10, 99, -99, 100, -100,
+        32767, -32768, 65535, -65535, 65536, -65536, 99999, -99999, 100000, -100000,
+        999999999, -999999999, 1000000000, -1000000000, INT32_MAX, INT32_MIN, INT32_MIN + 1
+    };
+
+    uint32_t numChecked = 0;
+    for (int32_t value : values) {
+        for (uint8_t numDecimals = 0; numDecimals <= maxFixedPointDecimals; ++numDecimals) {
+            for (uint8_t width = 0; width <= maxFixedPointPrintWidth; ++width) {
+                if (!check(value, numDecimals, width)) {
+                    return false;
+                }
+                ++numChecked;
+            }
+        }
+    }
+
+    printf("edge values:  %lu strings match\n", (unsigned long) numChecked);
+    return true;
+}
+
+
+// Every value around the 16-bit boundary, with the decimals that the
+// sketches use.
+static bool checkSmallValues()
+{
+    uint32_t numChecked = 0;
+    for (int32_t value = -70000; value <= 70000; ++value) {
+        for (uint8_t numDecimals = 0; numDecimals <= 3; ++numDecimals) {
+            if (!check(value, numDecimals, 0) || !check(value, numDecimals, 8)) {
+                return false;
+            }
+            numChecked += 2;
+        }
+    }
+
+    printf("values to +/-70000:  %lu strings match\n", (unsigned long) numChecked);
+    return true;
+}
+
+
+static bool checkRandomValues()
+{
+    uint32_t x = 1;
+    for (uint32_t i = 0; i < numRandomValues; ++i) {
+        // xorshift32
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        if (!check((int32_t) x, i % (maxFixedPointDecimals + 1), i % 16)) {
+            return false;
+        }
+    }
+
+    printf("random values:  %lu strings match\n", (unsigned long) numRandomValues);
+    return true;
+}
+
+
+// Times tenths of a degree in a 6-character field, the way the sketches
+// print angles, against the dtostrf call that the sketches used to make.
+static void benchmark()
+{
+    constexpr int16_t firstValue = -3600;
+    constexpr int16_t lastValue = 3600;
+    constexpr uint32_t numFormats = benchmarkPasses * (lastValue - firstValue + 1);
+
+    char buf[maxFixedPointPrintWidth + 1];
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t pass = 0; pass < benchmarkPasses; ++pass) {
+        for (int16_t value = firstValue; value <= lastValue; ++value) {
+            dtostrf(value / 10.0, 6, 1, buf);
+            benchmarkSink = buf[4];
+        }
+    }
+    std::chrono::duration<double, std::nano> dtostrfNs = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t pass = 0; pass < benchmarkPasses; ++pass) {
+        for (int16_t value = firstValue; value <= lastValue; ++value) {
+            formatFixedPoint(buf, value, 1, 6);
+            benchmarkSink = buf[4];
+        }
+    }
+    std::chrono::duration<double, std::nano> fixedPointNs = std::chrono::steady_clock::now() - start;
+
+    printf("tenths:  dtostrf %.1f ns, formatFixedPoint %.1f ns per number\n",
+           dtostrfNs.count() / numFormats, fixedPointNs.count() / numFormats);
+}
+
+
+int main()
+{
+    bool ok = checkEdgeValues() && checkSmallValues() && checkRandomValues();
+    if (ok) {
+        benchmark();
+    }
+    return ok ? 0 : 1;
+}
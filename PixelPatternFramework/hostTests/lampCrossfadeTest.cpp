@@ -0,0 +1,224 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Lamp Crossfade Test                                             *
+ *                                                                 *
+ * Checks that the LampCrossfade tables give the same intensities  *
+ * as the floating point fades that OctoFlashy, TofOctoFlashy, and *
+ * GardenSpinner calculated before the tables were used, for every *
+ * angle in tenths of a degree that a widget can send, and then    *
+ * times both ways of doing it.                                    *
+ *                                                                 *
+ * usage:  lampCrossfadeTest                                       *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include <LampCrossfade.h>
+#include <chrono>
+
+// The floats are float rather than double because that's what double is
+// on the AVR.
+typedef float avrDouble;
+
+static constexpr uint8_t maxOutputs = 10;
+static constexpr uint32_t benchmarkPasses = 200;
+
+static volatile uint8_t benchmarkSink;
+
+
+// The fade from the old OctoFlashy and TofOctoFlashy updateLamps(), for an
+// angle that was converted from tenths of a degree.
+static void floatFade(int16_t angleTenths, avrDouble maxAngleDegrees, uint8_t numOutputs,
+                      uint8_t minIntensity, uint8_t maxIntensity, uint8_t* intensities)
+{
+    const float angleStep = (float) maxAngleDegrees * 2 / (numOutputs - 1);
+
+    for (uint8_t i = 0; i < numOutputs; ++i) {
+        intensities[i] = minIntensity;
+    }
+
+    avrDouble angle = angleTenths / (avrDouble) 10.0;
+    float normalizedAngle;
+    if (angle <= - maxAngleDegrees) {
+        normalizedAngle = 0;
+    }
+    else if (angle >= maxAngleDegrees) {
+        normalizedAngle = maxAngleDegrees * (avrDouble) 2.0;
+    }
+    else {
+        normalizedAngle = angle + maxAngleDegrees;
+    }
+
+    int section = floorf(normalizedAngle / angleStep);
+    if (section >= numOutputs - 1) {
+        section = numOutputs - 2;
+    }
+    intensities[section] =
+        map(normalizedAngle, angleStep * section, angleStep * (section + 1), maxIntensity, minIntensity);
+    intensities[section + 1] =
+        map(normalizedAngle, angleStep * section, angleStep * (section + 1), minIntensity, maxIntensity);
+}
+
+
+// The fade from the old GardenSpinner updateLamps(), for a rotation angle
+// that was converted from tenths of a degree.
+static void floatRotationFade(int16_t angleTenths, uint8_t numLamps,
+                              uint8_t minIntensity, uint8_t maxIntensity, uint8_t* intensities)
+{
+    constexpr float lampRotationStepAngle = 360.0;
+
+    for (uint8_t lampIdx = 0; lampIdx <= numLamps - 1; ++lampIdx) {
+        intensities[lampIdx] = minIntensity;
+    }
+    intensities[numLamps] = 0;
+
+    avrDouble angle = angleTenths / (avrDouble) 10.0;
+    float stepAngle = lampRotationStepAngle / (float) numLamps;
+    int fadeDownLamp = angle >= 0 && angle < 360 ? angle / stepAngle : 0;
+    int fadeUpLamp = fadeDownLamp + 1;
+    intensities[fadeDownLamp] =
+        map(angle, stepAngle * fadeDownLamp, stepAngle * fadeUpLamp, maxIntensity, minIntensity);
+    intensities[fadeUpLamp] =
+        map(angle, stepAngle * fadeDownLamp, stepAngle * fadeUpLamp, minIntensity, maxIntensity);
+    if (fadeUpLamp == numLamps) {
+        intensities[0] = 0;
+    }
+}
+
+
+static bool reportDifference(const char* name, int16_t angleTenths, uint8_t numOutputs,
+                             const uint8_t* expected, const uint8_t* actual)
+{
+    if (0 == memcmp(expected, actual, numOutputs)) {
+        return false;
+    }
+
+    printf("%s:  at %d tenths, the float fade is", name, angleTenths);
+    for (uint8_t i = 0; i < numOutputs; ++i) {
+        printf(" %u", expected[i]);
+    }
+    printf(", and the table fade is");
+    for (uint8_t i = 0; i < numOutputs; ++i) {
+        printf(" %u", actual[i]);
+    }
+    printf("\n");
+    return true;
+}
+
+
+static double nsPerFade(std::chrono::steady_clock::time_point start, uint32_t numFades)
+{
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / numFades;
+}
+
+
+// Checks and times a LampCrossfade for an angle that goes from
+// -maxAngleTenths to maxAngleTenths.
+template <uint8_t numOutputs, uint8_t minIntensity, uint8_t maxIntensity, int16_t maxAngleTenths>
+static bool checkFade(const char* name)
+{
+    typedef pixelPattern::LampCrossfade<numOutputs, minIntensity, maxIntensity, maxAngleTenths * 2 / 10> Fade;
+
+    // Angles beyond the maximums are included to check the clamping.
+    constexpr int16_t firstAngle = -maxAngleTenths - 20;
+    constexpr int16_t lastAngle = maxAngleTenths + 20;
+    constexpr avrDouble maxAngleDegrees = maxAngleTenths / 10;
+
+    uint8_t expected[maxOutputs];
+    uint8_t actual[maxOutputs];
+    for (int16_t angle = firstAngle; angle <= lastAngle; ++angle) {
+        floatFade(angle, maxAngleDegrees, numOutputs, minIntensity, maxIntensity, expected);
+        Fade::fill(Fade::positionFromRange(angle, -maxAngleTenths, maxAngleTenths), actual);
+        if (reportDifference(name, angle, numOutputs, expected, actual)) {
+            return false;
+        }
+    }
+
+    uint32_t numFades = benchmarkPasses * (lastAngle - firstAngle + 1);
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t pass = 0; pass < benchmarkPasses; ++pass) {
+        for (int16_t angle = firstAngle; angle <= lastAngle; ++angle) {
+            floatFade(angle, maxAngleDegrees, numOutputs, minIntensity, maxIntensity, expected);
+            benchmarkSink = expected[numOutputs / 2];
+        }
+    }
+    double floatNs = nsPerFade(start, numFades);
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t pass = 0; pass < benchmarkPasses; ++pass) {
+        for (int16_t angle = firstAngle; angle <= lastAngle; ++angle) {
+            Fade::fill(Fade::positionFromRange(angle, -maxAngleTenths, maxAngleTenths), actual);
+            benchmarkSink = actual[numOutputs / 2];
+        }
+    }
+    double tableNs = nsPerFade(start, numFades);
+
+    printf("%s:  %d angles match; float %.1f ns, table %.1f ns per fade\n",
+           name, lastAngle - firstAngle + 1, floatNs, tableNs);
+    return true;
+}
+
+
+// Checks GardenSpinner's LampCrossfade, with its virtual lamp, for rotation
+// angles from 0 to 3599 tenths of a degree.  numLamps must divide 360
+// degrees evenly.  Otherwise, the float fade can pick the next section
+// partway through the degree where a section starts, and that changes
+// whether the wraparound turns off the first lamp.
+template <uint8_t numLamps, uint8_t minIntensity, uint8_t maxIntensity>
+static bool checkRotationFade(const char* name)
+{
+    static_assert(360 % numLamps == 0, "The lamps must divide 360 degrees evenly.");
+    typedef pixelPattern::LampCrossfade<numLamps + 1, minIntensity, maxIntensity, 360> Fade;
+
+    uint8_t expected[maxOutputs];
+    uint8_t actual[maxOutputs];
+    for (int16_t angle = 0; angle < 3600; ++angle) {
+        floatRotationFade(angle, numLamps, minIntensity, maxIntensity, expected);
+
+        // The fix-up after the fill is the same as GardenSpinner's.
+        uint8_t fadeUpLamp = Fade::fill(Fade::positionFromRange(angle, 0, 3600), actual) + 1;
+        if (fadeUpLamp == numLamps) {
+            actual[0] = 0;
+        }
+        else {
+            actual[numLamps] = 0;
+        }
+
+        if (reportDifference(name, angle, numLamps + 1, expected, actual)) {
+            return false;
+        }
+    }
+
+    printf("%s:  3600 angles match\n", name);
+    return true;
+}
+
+
+int main()
+{
+    bool ok = true;
+
+    // OctoFlashy
+    ok &= checkFade<3, 0, 255, 450>("3 colors over 90 degrees");
+    ok &= checkFade<4, 0, 255, 450>("4 colors over 90 degrees");
+    ok &= checkFade<9, 64, 255, 450>("9 lamps over 90 degrees");
+
+    // TofOctoFlashy
+    ok &= checkFade<3, 0, 255, 1800>("3 colors over 360 degrees");
+    ok &= checkFade<4, 0, 255, 1800>("4 colors over 360 degrees");
+    ok &= checkFade<9, 64, 255, 1800>("9 lamps over 360 degrees");
+
+    // Other sizes that don't divide the angles evenly
+    ok &= checkFade<7, 0, 255, 450>("7 outputs over 90 degrees");
+    ok &= checkFade<8, 10, 200, 1800>("8 outputs over 360 degrees");
+
+    // GardenSpinner
+    ok &= checkRotationFade<4, 64, 255>("4 lamps around");
+    ok &= checkRotationFade<6, 64, 255>("6 lamps around");
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,173 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Legacy Sketch Frame Recorder                                    *
+ *                                                                 *
+ * Runs a pattern sketch's setup() and loop() on the host shim and *
+ * writes a line for each frame that the sketch shows on its pixel *
+ * strip, so that runHostTests can check that a sketch converted   *
+ * to LegacyPatternSequence looks the same as it did before.       *
+ *                                                                 *
+ * usage:  sketch durationSec [pin@sec ...] [aN=value ...] [-v]    *
+ *                                                                 *
+ * Each pin@sec pushes the button on that pin for 200 ms at that   *
+ * time, and each aN=value sets what analog input N reads (e.g., a *
+ * battery voltage).  The frame lines are "ms hash", or the ms and *
+ * the pixel values with -v.  Frames that repeat the one before,   *
+ * and black frames, aren't written.                               *
+ *                                                                 *
+ * Both the legacy sketches and LegacyPatternSequence copy a       *
+ * pattern's parameters out of flash when it starts, so each copy  *
+ * is written as a "pattern hash" line, and the random number      *
+ * generators are reseeded so that every pattern starts from the   *
+ * same random numbers however long the patterns before it ran.    *
+ * Only the first copy in each pass through loop() counts, so the  *
+ * configs of other pattern sequences (e.g., TripperStickII's DMX  *
+ * ambiance lights) don't count as pattern starts.                 *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <vector>
+
+void setup();
+void loop();
+
+// freeRam() in the sketches measures from these.  They're set up so that
+// it returns a little under 1 KB.
+int __heap_start;
+int* __brkval;
+
+
+struct ButtonPress {
+    uint8_t pin;
+    uint32_t ms;
+};
+
+static bool verbose = false;
+static bool isRecording = false;
+static bool patternStartedThisLoop;
+static uint64_t lastFrameHash;
+
+
+static uint64_t fnv1a(uint64_t hash, uint8_t c)
+{
+    return (hash ^ c) * 0x100000001b3ULL;
+}
+
+
+static void recordPatternStart(const void* src, size_t n)
+{
+    if (!isRecording || patternStartedThisLoop) {
+        return;
+    }
+    patternStartedThisLoop = true;
+
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < n; ++i) {
+        hash = fnv1a(hash, ((const uint8_t*) src)[i]);
+    }
+    printf("pattern %016llx\n", (unsigned long long) hash);
+
+    randomSeed(1);
+    random16_set_seed(1337);
+    lastFrameHash = 0;
+}
+
+
+static void recordFrame()
+{
+    if (!isRecording || 0 == FastLED.numStrips) {
+        return;
+    }
+
+    const CRGB* strip = FastLED.strips[0];
+    int numPixels = FastLED.stripLengths[0];
+
+    bool isBlack = true;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (int i = 0; i < numPixels; ++i) {
+        for (uint8_t c = 0; c < 3; ++c) {
+            hash = fnv1a(hash, strip[i].raw[c]);
+            isBlack &= 0 == strip[i].raw[c];
+        }
+    }
+
+    if (isBlack || hash == lastFrameHash) {
+        return;
+    }
+    lastFrameHash = hash;
+
+    printf("%lu", millis());
+    if (verbose) {
+        for (int i = 0; i < numPixels; ++i) {
+            printf(" %02x%02x%02x", strip[i].r, strip[i].g, strip[i].b);
+        }
+    }
+    else {
+        printf(" %016llx", (unsigned long long) hash);
+    }
+    printf("\n");
+}
+
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage:  %s durationSec [pin@sec ...] [aN=value ...] [-v]\n", argv[0]);
+        return 2;
+    }
+
+    uint32_t durationMs = strtoul(argv[1], nullptr, 10) * 1000;
+    std::vector<ButtonPress> presses;
+    for (int i = 2; i < argc; ++i) {
+        unsigned int pin;
+        unsigned int sec;
+        unsigned int channel;
+        int value;
+        if (0 == strcmp(argv[i], "-v")) {
+            verbose = true;
+        }
+        else if (2 == sscanf(argv[i], "%u@%u", &pin, &sec)) {
+            presses.push_back({(uint8_t) pin, sec * 1000});
+        }
+        else if (2 == sscanf(argv[i], "a%u=%d", &channel, &value)) {
+            host::setAnalogInput((uint8_t) channel, value);
+        }
+    }
+
+    int stackMark;
+    __brkval = (int*) ((char*) &stackMark - 1024);
+
+    FastLED.showHook = recordFrame;
+    host::memcpyPHook = recordPatternStart;
+
+    // The start-up display depends on freeRam(), so it isn't recorded.
+    setup();
+    isRecording = true;
+
+    while (millis() < durationMs) {
+        uint32_t now = millis();
+        for (const ButtonPress& press : presses) {
+            host::setPinInput(press.pin, HIGH);
+        }
+        for (const ButtonPress& press : presses) {
+            if (now >= press.ms && now < press.ms + 200) {
+                host::setPinInput(press.pin, LOW);
+            }
+        }
+
+        uint32_t loopStartUs = micros();
+        patternStartedThisLoop = false;
+        loop();
+
+        // Loops that don't delay take a millisecond.
+        if (micros() == loopStartUs) {
+            host::advanceUs(1000);
+        }
+    }
+
+    return 0;
+}
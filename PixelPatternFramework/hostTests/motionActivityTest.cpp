@@ -0,0 +1,328 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * MPU Motion Activity Test                                        *
+ *                                                                 *
+ * Replays a motion trace through MpuMotionActivity the way        *
+ * Tiltarama drives it, one loop per ms:  the MPU6050 stand-in's   *
+ * interrupts go through processInterrupt, the packets' largest    *
+ * yaw, pitch, or roll change over the moving average window goes  *
+ * to reportActivity, and update runs every loop.  It checks the   *
+ * idle and active modes, wake counts, and active time that the    *
+ * trace expects, that the MPU registers match each mode, and that *
+ * there is no I2C traffic while idle.                             *
+ *                                                                 *
+ * usage:  motionActivityTest trace.txt...                         *
+ *                                                                 *
+ * Trace lines:                                                    *
+ *   ms yawTenths pitchTenths rollTenths motionMg                  *
+ *       a keyframe; the pose and the accel that the motion        *
+ *       detector sees are interpolated between keyframes          *
+ *   config wakeThreshold wakeDurationMs wakeFrequency             *
+ *          activityThreshold confirmTimeoutMs idleTimeoutMs       *
+ *       replaces Tiltarama's settings, before the first keyframe  *
+ *   expect idle | active                                          *
+ *   expect wakes n | falseWakes n | activeMs min max              *
+ *       checked at the time of the keyframe before it             *
+ * Blank lines and lines that start with # are skipped.            *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include <MPU6050.h>
+#include <DmpMotion.h>
+#include <MpuFifoReader.h>
+#include <MpuMotionActivity.h>
+#include <SensorFilters.h>
+#include <math.h>
+#include <string.h>
+
+using namespace pixelPattern;
+
+// Tiltarama's settings
+static constexpr MotionActivityConfig tiltaramaConfig = {1, 1, 0, 1, 1000, 5000};
+static constexpr uint8_t maxMpuPacketsPerRead = 4;
+static constexpr uint8_t movingAverageLengthShift = 3;
+
+static constexpr uint16_t countsPerG = 8192;
+
+
+// Writes a DMP packet for the pose, in tenths of a degree, with its
+// gravity plus motionMg straight up as the accel.
+static void setPacket(uint8_t* packet, const float* yprTenths, float motionMg)
+{
+    float half[3];
+    for (uint8_t i = 0; i < 3; ++i) {
+        half[i] = yprTenths[i] * (float) M_PI / 3600;
+    }
+    float cy = cosf(half[0]), sy = sinf(half[0]);
+    float cp = cosf(half[1]), sp = sinf(half[1]);
+    float cr = cosf(half[2]), sr = sinf(half[2]);
+    float q[4] = {
+        cr * cp * cy + sr * sp * sy,
+        sr * cp * cy - cr * sp * sy,
+        cr * sp * cy + sr * cp * sy,
+        cr * cp * sy - sr * sp * cy
+    };
+    float gravity[3] = {
+        2 * (q[1] * q[3] - q[0] * q[2]),
+        2 * (q[0] * q[1] + q[2] * q[3]),
+        q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3]
+    };
+
+    memset(packet, 0, MPU6050::packetSize);
+    for (uint8_t i = 0; i < 4; ++i) {
+        uint32_t v = (uint32_t) (int32_t) lroundf(q[i] * (1L << 30));
+        packet[i * 4] = v >> 24;
+        packet[i * 4 + 1] = v >> 16;
+        packet[i * 4 + 2] = v >> 8;
+        packet[i * 4 + 3] = v;
+    }
+    for (uint8_t i = 0; i < 3; ++i) {
+        float accel = gravity[i] * countsPerG + (2 == i ? motionMg * countsPerG / 1000 : 0);
+        uint16_t v = (int16_t) lroundf(constrain(accel, -32768.0f, 32767.0f));
+        packet[28 + i * 4] = v >> 8;
+        packet[29 + i * 4] = v;
+    }
+}
+
+
+class MotionReplay {
+public:
+    MotionReplay(const char* fileName, const MotionActivityConfig& config)
+        : fileName(fileName)
+        , config(config)
+        , fifoReader(mpu, maxMpuPacketsPerRead)
+        , activity(mpu, fifoReader, config)
+    {
+    }
+
+    bool begin()
+    {
+        if (!fifoReader.begin(MPU6050::packetSize)) {
+            printf("%s:  couldn't allocate the FIFO reader's buffer\n", fileName);
+            return false;
+        }
+        activity.begin(nowMs);
+        lastMode = activity.getMode();
+        return checkRegisters();
+    }
+
+    // Runs one loop per ms up to the keyframe.
+    bool replayTo(uint32_t toMs, const float* toYpr, uint16_t toMotionMg)
+    {
+        uint32_t fromMs = nowMs;
+        float fromYpr[3] = {ypr[0], ypr[1], ypr[2]};
+        uint16_t fromMotionMg = motionMg;
+
+        while (nowMs != toMs) {
+            ++nowMs;
+            float t = (float) (nowMs - fromMs) / (toMs - fromMs);
+            for (uint8_t i = 0; i < 3; ++i) {
+                ypr[i] = fromYpr[i] + (toYpr[i] - fromYpr[i]) * t;
+            }
+            motionMg = lroundf(fromMotionMg + ((float) toMotionMg - fromMotionMg) * t);
+
+            setPacket(mpu.packet, ypr, motionMg);
+            mpu.motionMg = motionMg;
+
+            uint32_t numTransfers = mpu.numTransfers;
+            if (mpu.run(nowMs)) {
+                processMpuInterrupt();
+            }
+            activity.update(nowMs);
+
+            if (activity.getMode() != lastMode) {
+                lastMode = activity.getMode();
+                ++numTransitions;
+                if (!checkRegisters()) {
+                    return false;
+                }
+            }
+            else if (activity.getIsIdle() && mpu.numTransfers != numTransfers) {
+                printf("%s:  %lu ms:  %lu I2C transfers while idle\n", fileName, (unsigned long) nowMs,
+                       (unsigned long) (mpu.numTransfers - numTransfers));
+                return false;
+            }
+        }
+
+        for (uint8_t i = 0; i < 3; ++i) {
+            ypr[i] = toYpr[i];
+        }
+        motionMg = toMotionMg;
+        return true;
+    }
+
+    bool expect(const char* what, uint32_t a, uint32_t b)
+    {
+        bool ok;
+        uint32_t actual;
+        if (0 == strcmp(what, "idle") || 0 == strcmp(what, "active")) {
+            ok = activity.getIsIdle() == (0 == strcmp(what, "idle"));
+            if (!ok) {
+                printf("%s:  %lu ms:  expected %s\n", fileName, (unsigned long) nowMs, what);
+            }
+            return ok;
+        }
+        else if (0 == strcmp(what, "wakes")) {
+            actual = activity.numWakes;
+            ok = actual == a;
+        }
+        else if (0 == strcmp(what, "falseWakes")) {
+            actual = activity.numFalseWakes;
+            ok = actual == a;
+        }
+        else if (0 == strcmp(what, "activeMs")) {
+            actual = activity.totalActiveMs;
+            ok = actual >= a && actual <= b;
+        }
+        else {
+            printf("%s:  can't expect \"%s\"\n", fileName, what);
+            return false;
+        }
+
+        if (!ok) {
+            printf("%s:  %lu ms:  %s is %lu\n", fileName, (unsigned long) nowMs, what, (unsigned long) actual);
+        }
+        return ok;
+    }
+
+    void printSummary() const
+    {
+        printf("%s:  %u transitions, %u wakes, %u false, %lu ms active, %lu mode register writes, "
+               "%lu packets, %u resyncs\n",
+               fileName, numTransitions, activity.numWakes, activity.numFalseWakes,
+               (unsigned long) activity.totalActiveMs, (unsigned long) mpu.numModeWrites,
+               (unsigned long) fifoReader.numPacketsRead, fifoReader.numResyncs);
+    }
+
+private:
+    // Tiltarama's processMpuInterrupt and gatherMotionMeasurements
+    void processMpuInterrupt()
+    {
+        uint8_t intStatus = mpu.getIntStatus();
+        if (0 == intStatus) {
+            return;
+        }
+
+        uint8_t numPackets = activity.processInterrupt(intStatus, nowMs);
+        if (activity.checkModeChange() && activity.getIsActive()) {
+            movingAverages.clear();
+        }
+
+        for (uint8_t i = 0; i < numPackets; ++i) {
+            DmpMotion motion;
+            getDmpMotion(fifoReader.getPacket(i), &motion);
+            uint16_t maxYprChange = 0;
+            for (uint8_t c = 0; c < 3; ++c) {
+                movingAverages.update(c, motion.yprTenths[c]);
+                maxYprChange = max(maxYprChange, (uint16_t) abs(movingAverages.getChange(c)));
+            }
+            activity.reportActivity(maxYprChange, nowMs);
+        }
+    }
+
+    bool checkRegisters()
+    {
+        bool isIdle = activity.getIsIdle();
+        bool ok = mpu.dmpEnabled == !isIdle
+               && mpu.clockSource == (isIdle ? MPU6050_CLOCK_INTERNAL : MPU6050_CLOCK_PLL_XGYRO)
+               && mpu.wakeCycleEnabled == isIdle
+               && mpu.intMotionEnabled == isIdle;
+        for (uint8_t i = 0; i < 3; ++i) {
+            ok &= mpu.gyroStandby[i] == isIdle;
+        }
+        if (isIdle) {
+            ok &= mpu.motionThreshold == config.wakeThreshold
+               && mpu.motionDuration == config.wakeDurationMs
+               && mpu.wakeFrequency == config.wakeFrequency;
+        }
+
+        if (!ok) {
+            printf("%s:  %lu ms:  the MPU registers don't match %s mode\n",
+                   fileName, (unsigned long) nowMs, isIdle ? "idle" : "active");
+        }
+        return ok;
+    }
+
+    const char* fileName;
+    const MotionActivityConfig config;
+    MPU6050 mpu;
+    MpuFifoReader fifoReader;
+    MpuMotionActivity activity;
+    BoxcarFilterBank<3, movingAverageLengthShift> movingAverages;
+
+    MotionActivityMode lastMode = MotionActivityMode::init;
+    uint16_t numTransitions = 0;
+    uint32_t nowMs = 0;
+    float ypr[3] = {0, 0, 0};
+    uint16_t motionMg = 0;
+};
+
+
+static bool replayTrace(const char* fileName)
+{
+    FILE* file = fopen(fileName, "r");
+    if (0 == file) {
+        perror(fileName);
+        return false;
+    }
+
+    MotionActivityConfig config = tiltaramaConfig;
+    MotionReplay* replay = 0;
+    bool ok = true;
+    char line[200];
+    for (int lineNum = 1; ok && fgets(line, sizeof(line), file); ++lineNum) {
+        if ('#' == line[0] || '\0' == line[strspn(line, " \t\r\n")]) {
+            continue;
+        }
+
+        char what[20];
+        unsigned int c[6];
+        unsigned long a = 0, b = 0, ms;
+        float ypr[3];
+        unsigned int motionMg;
+        if (0 == replay && 6 == sscanf(line, "config %u %u %u %u %u %u", &c[0], &c[1], &c[2], &c[3], &c[4], &c[5])) {
+            config = {(uint8_t) c[0], (uint8_t) c[1], (uint8_t) c[2], (uint16_t) c[3], (uint16_t) c[4], c[5]};
+        }
+        else if (0 != replay && 1 <= sscanf(line, "expect %19s %lu %lu", what, &a, &b)) {
+            ok = replay->expect(what, a, b);
+        }
+        else if (5 == sscanf(line, "%lu %f %f %f %u", &ms, &ypr[0], &ypr[1], &ypr[2], &motionMg)) {
+            if (0 == replay) {
+                replay = new MotionReplay(fileName, config);
+                ok = replay->begin();
+            }
+            ok = ok && replay->replayTo(ms, ypr, motionMg);
+        }
+        else {
+            printf("%s:%d:  can't parse \"%.*s\"\n", fileName, lineNum, (int) strcspn(line, "\r\n"), line);
+            ok = false;
+        }
+    }
+    fclose(file);
+
+    if (0 != replay) {
+        if (ok) {
+            replay->printSummary();
+        }
+        delete replay;
+    }
+    return ok;
+}
+
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage:  %s trace.txt...\n", argv[0]);
+        return 2;
+    }
+
+    bool ok = true;
+    for (int i = 1; i < argc; ++i) {
+        ok &= replayTrace(argv[i]);
+    }
+    return ok ? 0 : 1;
+}
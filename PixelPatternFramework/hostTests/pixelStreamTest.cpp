@@ -0,0 +1,482 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Pixel Stream Test                                               *
+ *                                                                 *
+ * Sends E1.31 and Art-Net frames through the WiFiUDP stand-in to  *
+ * a PixelStreamReceiver and checks, for each protocol:            *
+ *   - that frames 0 to 19 sequence numbers behind the last one    *
+ *     are dropped and that everything else, including a frame     *
+ *     after the stream timed out, is shown                        *
+ *   - that a pixel set spread over two universes gets each        *
+ *     universe's part of the frame and nothing past its end       *
+ *   - that a StreamSelector and StreamedPixels show the stream    *
+ *     and that the local PatternSequence comes back when the      *
+ *     stream times out or, with E1.31, is terminated              *
+ *                                                                 *
+ * usage:  pixelStreamTest                                         *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <FastLED.h>
+#include <ExternalControlSelector.h>
+#include <PatternSequence.h>
+#include <PixelPatternController.h>
+#include <PixelSet.h>
+#include <PixelStreamReceiver.h>
+#include <SolidColor.h>
+#include <StreamSelector.h>
+#include <StreamedPixels.h>
+#include <pixelPatternFrameworkTypes.h>
+#include <vector>
+
+using namespace pixelPattern;
+
+typedef PixelStreamReceiver::Protocol Protocol;
+
+static constexpr uint16_t maxUniversePixels = 170;
+static constexpr uint32_t frameIntervalMs = 25;
+static constexpr uint32_t streamTimeoutMs = 2500;
+
+
+// Writes E1.31 and Art-Net DMX data packets.  Each frame's pixels are
+// made from its universe and sequence number, so that a test can tell
+// which frame it is looking at.
+class StreamSender {
+public:
+    explicit StreamSender(Protocol protocol) : protocol(protocol) {}
+
+    static CRGB framePixel(uint16_t universe, uint8_t sequence, uint16_t pixelIdx)
+    {
+        return CRGB(sequence, universe * 32 + 1, pixelIdx);
+    }
+
+    void sendFrame(uint16_t universe, uint8_t sequence, uint16_t numPixels = maxUniversePixels)
+    {
+        uint8_t data[maxUniversePixels * 3];
+        for (uint16_t i = 0; i < numPixels; ++i) {
+            CRGB pixel = framePixel(universe, sequence, i);
+            memcpy(data + i * 3, pixel.raw, 3);
+        }
+        send(universe, sequence, data, numPixels * 3, false);
+    }
+
+    // E1.31's Stream_Terminated option
+    void sendTermination(uint16_t universe, uint8_t sequence)
+    {
+        uint8_t data[3] = {};
+        send(universe, sequence, data, sizeof(data), true);
+    }
+
+    void sendRunt()
+    {
+        uint8_t packet[16] = {};
+        host::sendUdp(port(), packet, sizeof(packet));
+    }
+
+    const char* name() const { return Protocol::e131 == protocol ? "E1.31" : "Art-Net"; }
+
+    const Protocol protocol;
+
+private:
+    uint16_t port() const
+    {
+        return Protocol::e131 == protocol ? PixelStreamReceiver::e131Port : PixelStreamReceiver::artNetPort;
+    }
+
+    void send(uint16_t universe, uint8_t sequence, const uint8_t* data, uint16_t length, bool terminated)
+    {
+        std::vector<uint8_t> packet;
+        if (Protocol::e131 == protocol) {
+            packet.assign(126, 0);
+            packet[1] = 0x10;                                       // preamble size
+            memcpy(&packet[4], "ASC-E1.17", 9);
+            putFlagsAndLength(packet, 16, length);                  // root layer
+            packet[21] = 0x04;                                      // VECTOR_ROOT_E131_DATA
+            putFlagsAndLength(packet, 38, length);                  // framing layer
+            packet[43] = 0x02;                                      // VECTOR_E131_DATA_PACKET
+            strcpy((char*) &packet[44], "pixelStreamTest");
+            packet[108] = 100;                                      // priority
+            packet[111] = sequence;
+            packet[112] = terminated ? 0x40 : 0;
+            packet[113] = universe >> 8;
+            packet[114] = universe;
+            putFlagsAndLength(packet, 115, length);                 // DMP layer
+            packet[117] = 0x02;                                     // VECTOR_DMP_SET_PROPERTY
+            packet[118] = 0xa1;                                     // address and data type
+            packet[122] = 1;                                        // address increment
+            packet[123] = (length + 1) >> 8;                        // property value count,
+            packet[124] = length + 1;                               // including the start code
+        }
+        else {
+            packet.assign(18, 0);
+            memcpy(&packet[0], "Art-Net", 8);
+            packet[9] = 0x50;                                       // OpDmx
+            packet[11] = 14;                                        // protocol version
+            packet[12] = sequence;
+            packet[14] = universe;                                  // SubUni
+            packet[15] = (universe >> 8) & 0x7f;                    // Net
+            packet[16] = length >> 8;
+            packet[17] = length;
+        }
+        packet.insert(packet.end(), data, data + length);
+        host::sendUdp(port(), packet.data(), packet.size());
+    }
+
+    static void putFlagsAndLength(std::vector<uint8_t>& packet, uint16_t offset, uint16_t dataLength)
+    {
+        uint16_t pduLength = 126 + dataLength - offset;
+        packet[offset] = 0x70 | (pduLength >> 8);
+        packet[offset + 1] = pduLength;
+    }
+};
+
+
+static bool pixelsMatchFrame(const CRGB* pixels, uint16_t numPixels, uint16_t universe, uint8_t sequence)
+{
+    for (uint16_t i = 0; i < numPixels; ++i) {
+        if (pixels[i] != StreamSender::framePixel(universe, sequence, i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// Frames that arrive out of order, and what each protocol does with them
+struct SequenceStep {
+    uint32_t afterMs;
+    uint8_t sequence;
+    bool e131IsShown;
+    bool artNetIsShown;
+};
+
+static const SequenceStep sequenceSteps[] = {
+    {frameIntervalMs, 10, true, true},
+    {frameIntervalMs, 10, false, false},            // a repeat
+    {frameIntervalMs, 9, false, false},             // one behind
+    {frameIntervalMs, 11, true, true},
+    {frameIntervalMs, 248, false, false},           // 19 behind, across the wrap
+    {frameIntervalMs, 247, true, true},             // 20 behind, so the sender restarted
+    {frameIntervalMs, 255, true, true},
+    {frameIntervalMs, 0, true, true},               // the wrap
+    {frameIntervalMs, 5, true, true},
+    {streamTimeoutMs - 1, 2, false, false},         // just within the timeout
+    {1, 3, true, true},                             // the timeout after frame 5
+    {frameIntervalMs, 0, false, true},              // Art-Net's 0 turns sequencing off
+    {frameIntervalMs, 0, false, true},
+    {frameIntervalMs, 2, false, true},
+    {frameIntervalMs, 2, false, false}
+};
+
+
+static bool testSequenceNumbers(StreamSender& sender)
+{
+    CRGB leds[maxUniversePixels];
+    PixelSet pixelSet(leds, maxUniversePixels, 0, 0, 1, maxUniversePixels, 255, 255);
+    PixelStreamReceiver receiver;
+    receiver.addUniverse(1, &pixelSet);
+    receiver.init(sender.protocol, streamTimeoutMs);
+
+    uint32_t numShown = 0;
+    uint32_t numDropped = 0;
+    uint8_t shownSequence = 0;
+    bool ok = true;
+
+    for (const SequenceStep& step : sequenceSteps) {
+        host::advanceUs(step.afterMs * 1000);
+        fill_solid(leds, maxUniversePixels, CRGB::Black);
+        sender.sendFrame(1, step.sequence);
+        receiver.poll();
+
+        bool isShown = Protocol::e131 == sender.protocol ? step.e131IsShown : step.artNetIsShown;
+        if (isShown) {
+            ++numShown;
+            shownSequence = step.sequence;
+        }
+        else {
+            ++numDropped;
+        }
+
+        bool pixelsAreNew = pixelsMatchFrame(leds, maxUniversePixels, 1, step.sequence);
+        if (pixelsAreNew != isShown || receiver.takeNewFrame(&pixelSet) != isShown) {
+            printf("%s sequence:  frame %u, %lu ms after the one before, was %s\n", sender.name(),
+                   step.sequence, (unsigned long) step.afterMs, pixelsAreNew ? "shown" : "dropped");
+            ok = false;
+        }
+    }
+
+    const PixelStreamReceiver::Stats& stats = receiver.getStats();
+    if (stats.numFrames != numShown || stats.numStaleFrames != numDropped) {
+        printf("%s sequence:  %lu frames and %lu stale rather than %lu and %lu\n", sender.name(),
+               (unsigned long) stats.numFrames, (unsigned long) stats.numStaleFrames,
+               (unsigned long) numShown, (unsigned long) numDropped);
+        ok = false;
+    }
+    if (!receiver.isStreaming(&pixelSet)) {
+        printf("%s sequence:  not streaming after frame %u\n", sender.name(), shownSequence);
+        ok = false;
+    }
+
+    if (ok) {
+        printf("%s sequence:  %u frames, %lu shown, %lu dropped as stale\n", sender.name(),
+               (unsigned int) (sizeof(sequenceSteps) / sizeof(sequenceSteps[0])),
+               (unsigned long) numShown, (unsigned long) numDropped);
+    }
+    return ok;
+}
+
+
+static bool testTwoUniverses(StreamSender& sender)
+{
+    // 200 pixels, the first 170 in universe 1 and the other 30 in universe 2,
+    // with a pixel after them that the stream mustn't touch
+    static constexpr uint16_t numPixels = 200;
+    static constexpr uint16_t secondUniversePixels = numPixels - maxUniversePixels;
+    static const CRGB guard(0x5a, 0xa5, 0x5a);
+
+    CRGB leds[numPixels + 1];
+    fill_solid(leds, numPixels, CRGB::Black);
+    leds[numPixels] = guard;
+    PixelSet pixelSet(leds, numPixels, 0, 0, 1, numPixels, 255, 255);
+    PixelStreamReceiver receiver;
+    bool ok = receiver.addUniverse(1, &pixelSet, 0) && receiver.addUniverse(2, &pixelSet, maxUniversePixels);
+    receiver.init(sender.protocol, streamTimeoutMs);
+
+    // Universe 2's frame is full length, as senders often make them.
+    host::advanceUs(frameIntervalMs * 1000);
+    sender.sendFrame(1, 1);
+    sender.sendFrame(2, 1);
+    sender.sendFrame(3, 1);
+    sender.sendRunt();
+    receiver.poll();
+    if (!pixelsMatchFrame(leds, maxUniversePixels, 1, 1)
+        || !pixelsMatchFrame(leds + maxUniversePixels, secondUniversePixels, 2, 1)
+        || leds[numPixels] != guard
+        || !receiver.takeNewFrame(&pixelSet)
+        || receiver.takeNewFrame(&pixelSet))
+    {
+        printf("%s two universes:  the first frame wasn't shown once\n", sender.name());
+        ok = false;
+    }
+
+    // The universes are independent, so each keeps its last frame.
+    host::advanceUs(frameIntervalMs * 1000);
+    sender.sendFrame(2, 2, secondUniversePixels);
+    receiver.poll();
+    if (!pixelsMatchFrame(leds, maxUniversePixels, 1, 1)
+        || !pixelsMatchFrame(leds + maxUniversePixels, secondUniversePixels, 2, 2)
+        || !receiver.takeNewFrame(&pixelSet))
+    {
+        printf("%s two universes:  universe 2's second frame wasn't shown with universe 1's first\n", sender.name());
+        ok = false;
+    }
+
+    const PixelStreamReceiver::Stats& stats = receiver.getStats();
+    if (stats.numFrames != 3 || stats.numIgnoredPackets != 1 || stats.numBadPackets != 1) {
+        printf("%s two universes:  %lu frames, %lu ignored, and %lu bad rather than 3, 1, and 1\n", sender.name(),
+               (unsigned long) stats.numFrames, (unsigned long) stats.numIgnoredPackets,
+               (unsigned long) stats.numBadPackets);
+        ok = false;
+    }
+
+    if (ok) {
+        printf("%s two universes:  %u + %u pixels shown, other universe ignored, runt dropped\n",
+               sender.name(), maxUniversePixels, secondUniversePixels);
+    }
+    return ok;
+}
+
+
+// The sketch's local pattern and the stream, as in ESP8266PixelPatternFrameworkTest.
+// The stream's receiver is filled in by each test.
+static const SolidColor::PatternConfig solidRed PROGMEM = {HUE_RED, HUE_RED, 255, 1000, false};
+static StreamedPixels::PatternConfig streamedPixels = {nullptr};
+static const PatternDef fallbackPatternDefs[] PROGMEM = {
+    {SolidColor::id, 0L, &solidRed, "Red"},
+    {StreamedPixels::id, 0L, &streamedPixels, "Streamed"},
+};
+static constexpr uint8_t localPatternNum = 0;
+static constexpr uint8_t streamPatternNum = 1;
+
+static CRGB fallbackLeds[maxUniversePixels];
+static CRGB shownLeds[maxUniversePixels];
+static uint32_t numBlackShows;
+
+static void recordShownLeds()
+{
+    memcpy(shownLeds, fallbackLeds, sizeof(shownLeds));
+    if (CRGB(CRGB::Black) == shownLeds[0]) {
+        ++numBlackShows;
+    }
+}
+
+
+// Runs the sketch's loop, a poll and a controller update every ms,
+// until the LEDs show the stream's frame or the local pattern.
+class FallbackLoop {
+public:
+    FallbackLoop(PixelStreamReceiver& receiver, PixelPatternController& controller, PatternSequence& patternSequence)
+        : receiver(receiver)
+        , controller(controller)
+        , patternSequence(patternSequence)
+    {
+    }
+
+    bool isShowingLocal() const
+    {
+        return localPatternNum == patternSequence.currentPatternNum && shownLeds[0] == CRGB(CRGB::Red);
+    }
+
+    bool isShowingFrame(uint8_t sequence) const
+    {
+        return streamPatternNum == patternSequence.currentPatternNum
+            && pixelsMatchFrame(shownLeds, maxUniversePixels, 1, sequence);
+    }
+
+    // Returns how many ms it took, or UINT32_MAX if it didn't happen
+    // within maxMs.
+    template <typename Done>
+    uint32_t runUntil(Done done, uint32_t maxMs)
+    {
+        for (uint32_t ms = 0; ms <= maxMs; ++ms) {
+            if (ms > 0) {
+                host::advanceUs(1000);
+            }
+            receiver.poll();
+            controller.update();
+            if (done()) {
+                return ms;
+            }
+        }
+        return UINT32_MAX;
+    }
+
+    // Sends frames every frameIntervalMs for durationMs, each of which
+    // must be shown before the next one arrives.  The frame that starts
+    // the stream is the exception:  the pattern changes to show it, which
+    // clears it, so the LEDs show the local pattern until the next one.
+    bool stream(StreamSender& sender, uint8_t* pSequence, uint32_t durationMs, uint32_t* pMaxShowMs)
+    {
+        bool isStarting = streamPatternNum != patternSequence.currentPatternNum;
+        for (uint32_t ms = 0; ms < durationMs; ms += frameIntervalMs) {
+            uint8_t sequence = ++*pSequence;
+            sender.sendFrame(1, sequence);
+            uint32_t showMs = runUntil([&] { return isShowingFrame(sequence); }, frameIntervalMs - 1);
+            if (isStarting && UINT32_MAX == showMs && streamPatternNum == patternSequence.currentPatternNum) {
+                showMs = frameIntervalMs - 1;
+            }
+            else if (UINT32_MAX == showMs) {
+                printf("%s fallback:  frame %u wasn't shown\n", sender.name(), sequence);
+                return false;
+            }
+            else {
+                *pMaxShowMs = max(*pMaxShowMs, showMs);
+            }
+            isStarting = false;
+            host::advanceUs((frameIntervalMs - showMs) * 1000);
+        }
+        return true;
+    }
+
+private:
+    PixelStreamReceiver& receiver;
+    PixelPatternController& controller;
+    PatternSequence& patternSequence;
+};
+
+
+static bool testFallback(StreamSender& sender)
+{
+    PixelSet pixelSet(fallbackLeds, maxUniversePixels, 0, 0, 1, maxUniversePixels, 255, 255);
+    PixelStreamReceiver receiver;
+    receiver.addUniverse(1, &pixelSet);
+    receiver.init(sender.protocol, streamTimeoutMs);
+    streamedPixels.receiver = &receiver;
+
+    ExternalControlSelector localSelector;
+    StreamSelector streamSelector(&receiver, &pixelSet, streamPatternNum, &localSelector);
+    PatternSequence patternSequence(fallbackPatternDefs, 2, &streamSelector);
+    PixelPatternController controller;
+    controller.addPatternSequence(&patternSequence, &pixelSet);
+    localSelector.setPatternNum(localPatternNum);
+    controller.init();
+    FastLED.showHook = recordShownLeds;
+    numBlackShows = 0;
+
+    FallbackLoop loop(receiver, controller, patternSequence);
+    uint8_t sequence = 0;
+    uint32_t maxShowMs = 0;
+    bool ok = true;
+
+    if (UINT32_MAX == loop.runUntil([&] { return loop.isShowingLocal(); }, 100)) {
+        printf("%s fallback:  the local pattern didn't start\n", sender.name());
+        ok = false;
+    }
+
+    // The stream stops without a word, so the local pattern comes back
+    // after the timeout.
+    ok = ok && loop.stream(sender, &sequence, 1000, &maxShowMs);
+    // stream() returns when the next frame would have arrived.  The local
+    // pattern is shown by the update after the one that changes to it.
+    uint32_t timeoutFallbackMs = ok ? loop.runUntil([&] { return loop.isShowingLocal(); }, streamTimeoutMs * 2) : 0;
+    if (UINT32_MAX != timeoutFallbackMs) {
+        timeoutFallbackMs += frameIntervalMs;
+    }
+    if (ok && (timeoutFallbackMs < streamTimeoutMs || timeoutFallbackMs > streamTimeoutMs + 1)) {
+        printf("%s fallback:  the local pattern came back %lu ms after the last frame\n",
+               sender.name(), (unsigned long) timeoutFallbackMs);
+        ok = false;
+    }
+
+    // An E1.31 sender can say that it's done.  The sequence numbers carry
+    // on, as they do when a sender pauses.
+    uint32_t terminationFallbackMs = 0;
+    if (ok && Protocol::e131 == sender.protocol) {
+        ok = loop.stream(sender, &sequence, 500, &maxShowMs);
+        sender.sendTermination(1, ++sequence);
+        terminationFallbackMs = ok ? loop.runUntil([&] { return loop.isShowingLocal(); }, frameIntervalMs) : 0;
+        if (ok && UINT32_MAX == terminationFallbackMs) {
+            printf("%s fallback:  the local pattern didn't come back when the stream was terminated\n", sender.name());
+            ok = false;
+        }
+    }
+
+    FastLED.showHook = nullptr;
+
+    if (ok && 0 != numBlackShows) {
+        printf("%s fallback:  the LEDs were blacked out %lu times\n", sender.name(), (unsigned long) numBlackShows);
+        ok = false;
+    }
+
+    if (ok) {
+        printf("%s fallback:  frames shown within %lu ms, local pattern back %lu ms after the last frame",
+               sender.name(), (unsigned long) maxShowMs, (unsigned long) timeoutFallbackMs);
+        if (Protocol::e131 == sender.protocol) {
+            printf(" and %lu ms after termination", (unsigned long) terminationFallbackMs);
+        }
+        printf("\n");
+    }
+    return ok;
+}
+
+
+int main(int argc, char**)
+{
+    if (argc != 1) {
+        fprintf(stderr, "usage:  pixelStreamTest\n");
+        return 2;
+    }
+
+    bool ok = true;
+    for (Protocol protocol : {Protocol::e131, Protocol::artNet}) {
+        StreamSender sender(protocol);
+        ok &= testSequenceNumbers(sender);
+        ok &= testTwoUniverses(sender);
+        ok &= testFallback(sender);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,521 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Sensor Filter Bank Test                                         *
+ *                                                                 *
+ * Checks the SensorFilters.h filter banks against the code that   *
+ * they replaced or against straightforward reference filters,     *
+ * and then times each bank against its reference.                 *
+ *                                                                 *
+ * usage:  sensorFiltersTest                                       *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include <SensorFilters.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <vector>
+
+using namespace pixelPattern;
+
+static constexpr uint32_t numTestValues = 20000;
+static constexpr uint32_t benchmarkPasses = 50;
+
+// Tiltarama, IBG, and VL53L1XTest average 9 channels over 8 values.
+static constexpr uint8_t numMaSets = 9;
+static constexpr uint8_t maLengthShift = 3;
+static constexpr uint8_t maLength = 1 << maLengthShift;
+
+// LampshadeHat's battery filter
+static constexpr uint8_t vBattFilterLengthShift = 4;
+
+static constexpr uint8_t emaAlphaShift = 3;
+static constexpr uint8_t medianLength = 5;
+
+// The one-euro filter's settings, and how far it may be from the float
+// filter once the value has held still for a while and while it moves.
+// Its smoothing factors are in 1/256ths, so while the value moves quickly
+// it can be a few tenths of a percent of the swing from the float filter.
+static constexpr uint16_t oneEuroMinCutoffMilliHz = 1000;
+static constexpr uint16_t oneEuroBetaMilliHz = 50;
+static constexpr uint32_t oneEuroIntervalMs = 10;
+static constexpr uint32_t oneEuroSettleValues = 100;
+static constexpr float maxSettledOneEuroError = 2.0;
+static constexpr float maxMovingOneEuroError = 20.0;
+
+static volatile int32_t benchmarkSink;
+
+
+// The moving average that Tiltarama, IBG, and VL53L1XTest used before the
+// BoxcarFilterBank.
+class LegacyMovingAverages {
+public:
+    LegacyMovingAverages() { clear(); }
+
+    void clear()
+    {
+        for (uint8_t i = 0; i < numMaSets; ++i) {
+            for (uint8_t j = 0; j < maLength; ++j) {
+                maValues[i][j] = 0;
+            }
+            maSums[i] = 0;
+            maNextSlotIdx[i] = 0;
+            maSetFull[i] = false;
+        }
+    }
+
+    void update(uint8_t setIdx, int16_t newValue)
+    {
+        maSums[setIdx] -= maValues[setIdx][maNextSlotIdx[setIdx]];
+        maSums[setIdx] += newValue;
+        maValues[setIdx][maNextSlotIdx[setIdx]] = newValue;
+
+        ++maNextSlotIdx[setIdx];
+        if (maNextSlotIdx[setIdx] >= maLength) {
+            maSetFull[setIdx] = true;
+            maNextSlotIdx[setIdx] = 0;
+        }
+    }
+
+    int16_t get(uint8_t setIdx) const
+    {
+        int32_t avg;
+        if (maSetFull[setIdx]) {
+            avg = maSums[setIdx] / (int32_t) maLength;
+        }
+        else {
+            avg = maNextSlotIdx[setIdx] > 0 ? (int32_t) maSums[setIdx] / (int32_t) maNextSlotIdx[setIdx] : 0;
+        }
+        return avg;
+    }
+
+    // The old detectMovingAverageChange() difference, oldest less newest,
+    // which is only right once the window is full.
+    int16_t getFullChange(uint8_t setIdx) const
+    {
+        uint8_t latestSlotIdx = maNextSlotIdx[setIdx] == 0 ? maLength - 1 : maNextSlotIdx[setIdx] - 1;
+        return maValues[setIdx][maNextSlotIdx[setIdx]] - maValues[setIdx][latestSlotIdx];
+    }
+
+    bool getIsFull(uint8_t setIdx) const { return maSetFull[setIdx]; }
+
+private:
+    int16_t maValues[numMaSets][maLength];
+    int32_t maSums[numMaSets];
+    uint8_t maNextSlotIdx[numMaSets];
+    bool maSetFull[numMaSets];
+};
+
+
+// The battery filter that LampshadeHat used before the BoxcarFilterBank,
+// with the AVR's 16-bit unsigned int.
+class LegacyVBattFilter {
+public:
+    uint16_t update(uint16_t vBattAdcReading)
+    {
+        if (!filterIsFull) {
+            filterIsFull = true;
+            for (uint8_t i = 0; i < filterLength; vBattAdcReadings[i++] = vBattAdcReading);
+            vBattSum = vBattAdcReading * filterLength;
+            oldestReadingIdx = 0;
+        }
+
+        vBattSum = vBattSum - vBattAdcReadings[oldestReadingIdx] + vBattAdcReading;
+        vBattAdcReadings[oldestReadingIdx] = vBattAdcReading;
+        if (++oldestReadingIdx == filterLength)
+            oldestReadingIdx = 0;
+        return vBattSum >> vBattFilterLengthShift;
+    }
+
+private:
+    static constexpr uint8_t filterLength = 1 << vBattFilterLengthShift;
+
+    bool filterIsFull = false;
+    uint16_t vBattAdcReadings[filterLength] = {};
+    uint16_t vBattSum = 0;
+    uint8_t oldestReadingIdx = 0;
+};
+
+
+// A float one-euro filter, as in Casiez, Roussel, and Vogel's paper.
+class FloatOneEuroFilter {
+public:
+    FloatOneEuroFilter(float minCutoffHz, float beta, float derivativeCutoffHz)
+        : minCutoffHz(minCutoffHz)
+        , beta(beta)
+        , derivativeCutoffHz(derivativeCutoffHz)
+        , isPrimed(false)
+        , value(0)
+        , rate(0)
+    {
+    }
+
+    void update(float x, float dtSec)
+    {
+        if (!isPrimed) {
+            isPrimed = true;
+            value = x;
+            rate = 0;
+            return;
+        }
+        rate += ((x - value) / dtSec - rate) * alpha(derivativeCutoffHz, dtSec);
+        value += (x - value) * alpha(minCutoffHz + beta * fabsf(rate), dtSec);
+    }
+
+    float get() const { return value; }
+
+private:
+    static float alpha(float cutoffHz, float dtSec)
+    {
+        float r = 2 * (float) PI * cutoffHz * dtSec;
+        return r / (r + 1);
+    }
+
+    float minCutoffHz;
+    float beta;
+    float derivativeCutoffHz;
+    bool isPrimed;
+    float value;
+    float rate;
+};
+
+
+// xorshift32, for test values that are the same every run
+static uint32_t randomState = 1;
+
+static uint32_t nextRandom()
+{
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+
+// A sensor-like value:  a slow swing with noise and an occasional spike,
+// often negative, which is where rounding differs.
+static int16_t testValue(uint32_t i)
+{
+    int32_t v = lround(3000 * sin(i / 150.0)) + (int32_t) (nextRandom() % 201) - 100;
+    if (nextRandom() % 50 == 0) {
+        v += (int32_t) (nextRandom() % 20001) - 10000;
+    }
+    return constrain(v, -32768, 32767);
+}
+
+
+static double nsPer(std::chrono::steady_clock::time_point start, uint32_t n)
+{
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / n;
+}
+
+
+static bool checkBoxcar()
+{
+    BoxcarFilterBank<numMaSets, maLengthShift> bank;
+    LegacyMovingAverages legacy;
+    std::deque<int16_t> windows[numMaSets];
+
+    randomState = 1;
+    for (uint32_t i = 0; i < numTestValues; ++i) {
+        // Clear now and then to check partly filled windows again.
+        if (i % 5000 == 0) {
+            bank.clear();
+            legacy.clear();
+            for (uint8_t c = 0; c < numMaSets; ++c) {
+                windows[c].clear();
+            }
+        }
+
+        // Channels are updated out of step so that they fill at different times.
+        uint8_t c = nextRandom() % numMaSets;
+        int16_t v = testValue(i);
+        bank.update(c, v);
+        legacy.update(c, v);
+        windows[c].push_back(v);
+        if (windows[c].size() > maLength) {
+            windows[c].pop_front();
+        }
+
+        if (bank.get(c) != legacy.get(c)) {
+            printf("boxcar:  value %lu on channel %u, the average is %d rather than %d\n",
+                   (unsigned long) i, c, bank.get(c), legacy.get(c));
+            return false;
+        }
+        if (bank.getIsFull(c) != legacy.getIsFull(c)) {
+            printf("boxcar:  value %lu on channel %u, getIsFull() is %d\n", (unsigned long) i, c, bank.getIsFull(c));
+            return false;
+        }
+        int16_t change = windows[c].back() - windows[c].front();
+        if (bank.getChange(c) != change || (legacy.getIsFull(c) && -bank.getChange(c) != legacy.getFullChange(c))) {
+            printf("boxcar:  value %lu on channel %u, the change is %d rather than %d\n",
+                   (unsigned long) i, c, bank.getChange(c), change);
+            return false;
+        }
+    }
+
+    // Sums of the largest and smallest values
+    bank.clear();
+    legacy.clear();
+    for (uint32_t i = 0; i < 3 * maLength; ++i) {
+        int16_t v = i < 2 * maLength ? INT16_MIN : INT16_MAX;
+        bank.update(0, v);
+        legacy.update(0, v);
+        if (bank.get(0) != legacy.get(0)) {
+            printf("boxcar:  extreme value %lu, the average is %d rather than %d\n",
+                   (unsigned long) i, bank.get(0), legacy.get(0));
+            return false;
+        }
+    }
+
+    // LampshadeHat's unsigned battery filter, which starts with fill()
+    BoxcarFilterBank<1, vBattFilterLengthShift, uint16_t, uint16_t> vBattFilter;
+    LegacyVBattFilter legacyVBattFilter;
+    for (uint32_t i = 0; i < numTestValues; ++i) {
+        uint16_t reading = 560 + lround(40 * sin(i / 30.0)) + nextRandom() % 8;
+        if (!vBattFilter.getIsFull(0)) {
+            vBattFilter.fill(0, reading);
+        }
+        vBattFilter.update(0, reading);
+        uint16_t expected = legacyVBattFilter.update(reading);
+        if (vBattFilter.get(0) != expected) {
+            printf("battery filter:  reading %lu, the average is %u rather than %u\n",
+                   (unsigned long) i, vBattFilter.get(0), expected);
+            return false;
+        }
+    }
+
+    printf("boxcar:  %lu values match\n", (unsigned long) numTestValues * 2);
+    return true;
+}
+
+
+static bool checkEma()
+{
+    EmaFilterBank<2, emaAlphaShift> bank;
+    float expected[2];
+
+    // The fixed-point state floors what it subtracts, and get() floors the
+    // state, so each can be up to a unit low.
+    constexpr float maxError = 2.0;
+
+    randomState = 1;
+    for (uint32_t i = 0; i < numTestValues; ++i) {
+        uint8_t c = i & 1;
+        int16_t v = testValue(i);
+        bank.update(c, v);
+        expected[c] = i < 2 ? v : expected[c] + (v - expected[c]) / (1 << emaAlphaShift);
+
+        if (fabsf(bank.get(c) - expected[c]) > maxError) {
+            printf("ema:  value %lu on channel %u, the average is %d rather than %.2f\n",
+                   (unsigned long) i, c, bank.get(c), expected[c]);
+            return false;
+        }
+    }
+
+    printf("ema:  %lu values within %.0f\n", (unsigned long) numTestValues, maxError);
+    return true;
+}
+
+
+static bool checkMedian()
+{
+    MedianFilterBank<2, medianLength> bank;
+    std::deque<int16_t> windows[2];
+
+    randomState = 1;
+    for (uint32_t i = 0; i < numTestValues; ++i) {
+        uint8_t c = nextRandom() & 1;
+        if (i % 5000 == 0) {
+            bank.clear(c);
+            windows[c].clear();
+        }
+
+        // Few distinct values, so that there are plenty of ties
+        int16_t v = i % 3 == 0 ? testValue(i) : (int16_t) (nextRandom() % 7) - 3;
+        bank.update(c, v);
+        windows[c].push_back(v);
+        if (windows[c].size() > medianLength) {
+            windows[c].pop_front();
+        }
+
+        std::vector<int16_t> sorted(windows[c].begin(), windows[c].end());
+        std::sort(sorted.begin(), sorted.end());
+        if (bank.get(c) != sorted[sorted.size() / 2]) {
+            printf("median:  value %lu on channel %u, the median is %d rather than %d\n",
+                   (unsigned long) i, c, bank.get(c), sorted[sorted.size() / 2]);
+            return false;
+        }
+    }
+
+    printf("median:  %lu values match\n", (unsigned long) numTestValues);
+    return true;
+}
+
+
+// Checks the one-euro filter on a signal that holds still, jumps, ramps,
+// and swings, with noise.
+static bool checkOneEuro()
+{
+    OneEuroFilterBank<1> bank(oneEuroMinCutoffMilliHz, oneEuroBetaMilliHz);
+    FloatOneEuroFilter reference(oneEuroMinCutoffMilliHz / 1000.0, oneEuroBetaMilliHz / 1000.0,
+                                 OneEuroFilterBank<1>::derivativeCutoffMilliHz / 1000.0);
+
+    float worstSettledError = 0;
+    float worstMovingError = 0;
+    randomState = 1;
+    for (uint32_t i = 0; i < numTestValues; ++i) {
+        int32_t v;
+        uint32_t phase = i % 2000;
+        if (phase < 500) {
+            v = 100;
+        }
+        else if (phase < 1000) {
+            v = 2000;
+        }
+        else if (phase < 1500) {
+            v = 2000 - (int32_t) (phase - 1000) * 8;
+        }
+        else {
+            v = lround(1500 * sin(phase / 20.0));
+        }
+        v += (int32_t) (nextRandom() % 21) - 10;
+
+        bank.update(0, v, i * oneEuroIntervalMs);
+        reference.update(v, oneEuroIntervalMs / 1000.0);
+
+        // get() floors the value, so compare it with the floor.
+        float error = fabsf(bank.get(0) - floorf(reference.get()));
+        bool isSettled = phase < 1000 && phase % 500 >= oneEuroSettleValues;
+        float& worstError = isSettled ? worstSettledError : worstMovingError;
+        if (error > worstError) {
+            worstError = error;
+        }
+        if (error > (isSettled ? maxSettledOneEuroError : maxMovingOneEuroError)) {
+            printf("one-euro:  value %lu (%ld), the filtered value is %d rather than %.2f\n",
+                   (unsigned long) i, (long) v, bank.get(0), reference.get());
+            return false;
+        }
+    }
+
+    printf("one-euro:  %lu values, worst difference %.0f settled and %.0f moving\n",
+           (unsigned long) numTestValues, worstSettledError, worstMovingError);
+    return true;
+}
+
+
+// Times update() and get() on one channel of a bank and of its reference,
+// the way the sketches call them, once per reading.
+template <typename Bank, typename Reference>
+static void benchmark(const char* name, Bank& bank, Reference& reference)
+{
+    std::vector<int16_t> values(1000);
+    randomState = 1;
+    for (uint32_t i = 0; i < values.size(); ++i) {
+        values[i] = testValue(i);
+    }
+    uint32_t numUpdates = benchmarkPasses * values.size();
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t pass = 0; pass < benchmarkPasses; ++pass) {
+        for (uint32_t i = 0; i < values.size(); ++i) {
+            reference.update(values[i], i);
+            benchmarkSink = reference.get();
+        }
+    }
+    double referenceNs = nsPer(start, numUpdates);
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t pass = 0; pass < benchmarkPasses; ++pass) {
+        for (uint32_t i = 0; i < values.size(); ++i) {
+            bank.update(values[i], i);
+            benchmarkSink = bank.get();
+        }
+    }
+    double bankNs = nsPer(start, numUpdates);
+
+    printf("%s:  reference %.1f ns, bank %.1f ns per update and get\n", name, referenceNs, bankNs);
+}
+
+
+// Adapters that give the banks and the references the same interface for
+// benchmark().  The time argument is only used by the one-euro filters.
+template <typename Bank>
+struct BankChannel {
+    Bank bank;
+    void update(int16_t v, uint32_t) { bank.update(0, v); }
+    int32_t get() { return bank.get(0); }
+};
+
+struct LegacyChannel {
+    LegacyMovingAverages legacy;
+    void update(int16_t v, uint32_t) { legacy.update(0, v); }
+    int32_t get() { return legacy.get(0); }
+};
+
+struct FloatEmaChannel {
+    float value = 0;
+    void update(int16_t v, uint32_t) { value += (v - value) / (1 << emaAlphaShift); }
+    int32_t get() { return value; }
+};
+
+struct SortedMedianChannel {
+    std::deque<int16_t> window;
+    void update(int16_t v, uint32_t)
+    {
+        window.push_back(v);
+        if (window.size() > medianLength) {
+            window.pop_front();
+        }
+    }
+    int32_t get()
+    {
+        int16_t sorted[medianLength];
+        std::copy(window.begin(), window.end(), sorted);
+        std::sort(sorted, sorted + window.size());
+        return sorted[window.size() / 2];
+    }
+};
+
+struct OneEuroChannel {
+    OneEuroFilterBank<1> bank{oneEuroMinCutoffMilliHz, oneEuroBetaMilliHz};
+    void update(int16_t v, uint32_t i) { bank.update(0, v, i * oneEuroIntervalMs); }
+    int32_t get() { return bank.get(0); }
+};
+
+struct FloatOneEuroChannel {
+    FloatOneEuroFilter filter{oneEuroMinCutoffMilliHz / 1000.0, oneEuroBetaMilliHz / 1000.0,
+                              OneEuroFilterBank<1>::derivativeCutoffMilliHz / 1000.0};
+    void update(int16_t v, uint32_t) { filter.update(v, oneEuroIntervalMs / 1000.0); }
+    int32_t get() { return filter.get(); }
+};
+
+
+int main()
+{
+    bool ok = checkBoxcar() && checkEma() && checkMedian() && checkOneEuro();
+
+    if (ok) {
+        BankChannel<BoxcarFilterBank<1, maLengthShift>> boxcar;
+        LegacyChannel legacy;
+        benchmark("boxcar", boxcar, legacy);
+
+        BankChannel<EmaFilterBank<1, emaAlphaShift>> ema;
+        FloatEmaChannel floatEma;
+        benchmark("ema", ema, floatEma);
+
+        BankChannel<MedianFilterBank<1, medianLength>> median;
+        SortedMedianChannel sortedMedian;
+        benchmark("median", median, sortedMedian);
+
+        OneEuroChannel oneEuro;
+        FloatOneEuroChannel floatOneEuro;
+        benchmark("one-euro", oneEuro, floatOneEuro);
+    }
+
+    return ok ? 0 : 1;
+}
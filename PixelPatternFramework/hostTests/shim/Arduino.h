@@ -0,0 +1,175 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Host Test Shim:  Arduino Core                                   *
+ *                                                                 *
+ * Just enough of the Arduino core to build the framework and the  *
+ * pattern sketches on a PC.  Time only passes when a test         *
+ * advances it or when the code under test calls delay().          *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __HOST_ARDUINO_H
+#define __HOST_ARDUINO_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+#define A6 20
+#define A7 21
+
+#define PI 3.1415926535897932384626433832795
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+#define bit(b) (1UL << (b))
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+using std::min;
+using std::max;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+// avr-libc's float formatting, from its stdlib.h.
+char* dtostrf(double val, signed char width, unsigned char prec, char* s);
+
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+
+class String : public std::string {
+public:
+    String() {}
+    String(const char* s) : std::string(s ? s : "") {}
+    String(const std::string& s) : std::string(s) {}
+    explicit String(int v) : std::string(std::to_string(v)) {}
+    explicit String(unsigned int v) : std::string(std::to_string(v)) {}
+    explicit String(long v) : std::string(std::to_string(v)) {}
+    explicit String(unsigned long v) : std::string(std::to_string(v)) {}
+    explicit String(unsigned char v) : std::string(std::to_string(v)) {}
+
+    int indexOf(const String& s, unsigned int from = 0) const
+    {
+        size_t i = find(s, from);
+        return npos == i ? -1 : (int) i;
+    }
+    String substring(unsigned int from, unsigned int to) const { return String(substr(from, to - from)); }
+    long toInt() const { return atol(c_str()); }
+};
+
+inline String operator +(const String& a, const String& b) { return String((const std::string&) a + (const std::string&) b); }
+inline String operator +(const char* a, const String& b) { return String(a + (const std::string&) b); }
+inline String operator +(const String& a, const char* b) { return String((const std::string&) a + b); }
+
+
+// Print writes to the host's stdout.
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) { return fputc(c, stdout) == EOF ? 0 : 1; }
+    virtual size_t write(const uint8_t* buf, size_t n) { return fwrite(buf, 1, n, stdout); }
+    size_t write(const char* s) { return fputs(s, stdout) < 0 ? 0 : strlen(s); }
+
+    size_t print(const __FlashStringHelper* s) { return write((const char*) s); }
+    size_t print(const char* s) { return write(s); }
+    size_t print(const String& s) { return write(s.c_str()); }
+    size_t print(char c) { return write((uint8_t) c); }
+    size_t print(unsigned char v, int base = 10) { return print((unsigned long) v, base); }
+    size_t print(int v, int base = 10) { return print((long) v, base); }
+    size_t print(unsigned int v, int base = 10) { return print((unsigned long) v, base); }
+    size_t print(long v, int base = 10) { return base == 10 ? printf("%ld", v) : print((unsigned long) v, base); }
+    size_t print(unsigned long v, int base = 10) { return printf(base == 16 ? "%lX" : "%lu", v); }
+    size_t print(double v, int digits = 2) { return printf("%.*f", digits, v); }
+
+    template <typename T>
+    size_t println(T v) { return print(v) + println(); }
+    template <typename T>
+    size_t println(T v, int base) { return print(v, base) + println(); }
+    size_t println() { return write("\r\n"); }
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+// Serial never has anything to read.
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long) {}
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+
+// Hooks that let a test drive the shim.
+namespace host {
+
+// Moves the clock forward.  delay() does the same thing.
+void advanceUs(uint32_t us);
+
+// Sets what digitalRead() returns for a pin.  Pins read HIGH until set.
+void setPinInput(uint8_t pin, int value);
+
+// Sets what analogRead() returns for a channel (0 or A0, etc.).
+// Channels read 0 until set.
+void setAnalogInput(uint8_t channel, int value);
+
+// An AVR's division routines return all ones for a zero divisor rather
+// than trapping.  Code that depends on that is patched to divide with this.
+inline long avrDivide(long dividend, long divisor) { return 0 != divisor ? dividend / divisor : -1; }
+
+}
+
+#endif  // #ifndef __HOST_ARDUINO_H
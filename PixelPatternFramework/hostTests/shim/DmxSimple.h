@@ -0,0 +1,42 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Host Test Shim:  DmxSimple                                      *
+ *                                                                 *
+ * Stands in for the DMX line:  it keeps the value last written to *
+ * each channel, which is what the fixtures would be showing, and  *
+ * counts the writes.                                              *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __HOST_DMX_SIMPLE_H
+#define __HOST_DMX_SIMPLE_H
+
+#include <stdint.h>
+
+class DmxSimpleClass {
+public:
+    static constexpr int dmxSize = 512;
+
+    void maxChannel(int channel) { maxChannelNum = channel; }
+    void usePin(uint8_t pin) { outputPin = pin; }
+
+    void write(int channel, uint8_t value)
+    {
+        if (channel >= 1 && channel <= dmxSize) {
+            channels[channel] = value;
+        }
+        ++numWrites;
+    }
+
+    // 1-based, as the channel numbers are
+    uint8_t channels[dmxSize + 1] = {};
+    int maxChannelNum = 0;
+    uint8_t outputPin = 0;
+    uint32_t numWrites = 0;
+};
+
+inline DmxSimpleClass DmxSimple;
+
+#endif  // #ifndef __HOST_DMX_SIMPLE_H
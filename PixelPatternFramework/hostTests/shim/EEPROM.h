@@ -0,0 +1,30 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Host Test Shim:  EEPROM                                         *
+ *                                                                 *
+ * A blank (erased) EEPROM that forgets its contents at exit.      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __HOST_EEPROM_H
+#define __HOST_EEPROM_H
+
+#include <stdint.h>
+#include <string.h>
+
+class EEPROMClass {
+public:
+    EEPROMClass() { memset(cells, 0xff, sizeof(cells)); }
+    uint8_t read(int idx) { return cells[idx & (sizeof(cells) - 1)]; }
+    void write(int idx, uint8_t val) { cells[idx & (sizeof(cells) - 1)] = val; }
+    void update(int idx, uint8_t val) { write(idx, val); }
+
+private:
+    uint8_t cells[1024];
+};
+
+static EEPROMClass EEPROM;
+
+#endif  // #ifndef __HOST_EEPROM_H
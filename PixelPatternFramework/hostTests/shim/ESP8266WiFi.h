@@ -0,0 +1,213 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Host Test Shim:  ESP8266WiFi                                    *
+ *                                                                 *
+ * Only the calls that Esp8266WebPage makes.  WiFi's setup calls   *
+ * are ignored, and the station is never connected.  A test opens *
+ * a TCP connection to a WiFiServer's port with host::connectTcp,  *
+ * which queues it until the server takes it with available().     *
+ * The client's request trickles in a segment at a time, as a      *
+ * browser's does over a busy network, and whatever the server     *
+ * writes is kept in the connection for the test to look at.       *
+ * Writes take writeUsPerByte, about what an ESP8266 manages over  *
+ * WiFi, so a server's time budget gets used up as it would be.    *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __HOST_ESP8266WIFI_H
+#define __HOST_ESP8266WIFI_H
+
+#include <Arduino.h>
+#include <deque>
+#include <memory>
+
+typedef enum { WIFI_OFF, WIFI_STA, WIFI_AP, WIFI_AP_STA } WiFiMode_t;
+typedef enum { WL_IDLE_STATUS = 0, WL_CONNECTED = 3, WL_DISCONNECTED = 6 } wl_status_t;
+
+
+class IPAddress {
+public:
+    IPAddress() : bytes{0, 0, 0, 0} {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : bytes{a, b, c, d} {}
+
+    bool fromString(const String& s)
+    {
+        unsigned int a[4];
+        char end;
+        if (4 != sscanf(s.c_str(), "%u.%u.%u.%u%c", &a[0], &a[1], &a[2], &a[3], &end)) {
+            return false;
+        }
+        for (uint8_t i = 0; i < 4; ++i) {
+            if (a[i] > 255) {
+                return false;
+            }
+            bytes[i] = a[i];
+        }
+        return true;
+    }
+
+    uint8_t operator [](int i) const { return bytes[i]; }
+
+private:
+    uint8_t bytes[4];
+};
+
+
+class ESP8266WiFiClass {
+public:
+    bool mode(WiFiMode_t) { return true; }
+    bool disconnect() { return true; }
+    bool isConnected() { return false; }
+    bool hostname(const char*) { return true; }
+    bool softAP(const char*, const char*) { return true; }
+    wl_status_t begin(const char*, const char*) { return WL_DISCONNECTED; }
+    bool config(const IPAddress&, const IPAddress&, const IPAddress&) { return true; }
+    bool setAutoReconnect(bool) { return true; }
+    IPAddress softAPIP() { return IPAddress(192, 168, 4, 1); }
+    IPAddress localIP() { return IPAddress(); }
+    wl_status_t status() { return WL_DISCONNECTED; }
+};
+
+inline ESP8266WiFiClass WiFi;
+
+
+class EspClass {
+public:
+    uint32_t getFreeHeap() { return 40000; }
+};
+
+inline EspClass ESP;
+
+
+namespace host {
+
+// One TCP connection, as both ends see it
+struct TcpConnection {
+    TcpConnection(uint16_t port, const String& request, uint16_t segmentBytes, uint32_t segmentIntervalMs)
+        : port(port)
+        , request(request)
+        , segmentBytes(segmentBytes)
+        , segmentIntervalMs(segmentIntervalMs)
+        , connectMs(millis())
+    {
+    }
+
+    uint16_t port;
+    String request;
+    uint16_t segmentBytes;
+    uint32_t segmentIntervalMs;
+    uint32_t connectMs;
+
+    size_t numBytesRead = 0;
+    String response;
+    bool isAccepted = false;
+    uint32_t acceptMs = 0;
+    bool isClosed = false;
+    uint32_t closeMs = 0;
+
+    // The request arrives segmentBytes at a time, the first segment
+    // when the client connects and another every segmentIntervalMs.
+    size_t numBytesArrived() const
+    {
+        size_t n = (size_t) segmentBytes * (1 + (millis() - connectMs) / segmentIntervalMs);
+        return min(n, request.length());
+    }
+};
+
+static constexpr uint32_t writeUsPerByte = 8;
+
+// Connections that haven't been taken by their server yet
+inline std::deque<std::shared_ptr<TcpConnection>> tcpBacklog;
+
+inline std::shared_ptr<TcpConnection> connectTcp(uint16_t port,
+                                                 const String& request,
+                                                 uint16_t segmentBytes,
+                                                 uint32_t segmentIntervalMs)
+{
+    std::shared_ptr<TcpConnection> conn(new TcpConnection(port, request, segmentBytes, segmentIntervalMs));
+    tcpBacklog.push_back(conn);
+    return conn;
+}
+
+}
+
+
+class WiFiClient {
+public:
+    WiFiClient() {}
+    explicit WiFiClient(const std::shared_ptr<host::TcpConnection>& conn) : conn(conn) {}
+
+    operator bool() const { return conn != nullptr; }
+
+    int available()
+    {
+        return conn && !conn->isClosed ? conn->numBytesArrived() - conn->numBytesRead : 0;
+    }
+
+    int read(uint8_t* buf, size_t size)
+    {
+        size_t n = min(size, (size_t) available());
+        memcpy(buf, conn->request.data() + conn->numBytesRead, n);
+        conn->numBytesRead += n;
+        return n;
+    }
+
+    // The client stays connected until it has a response.
+    uint8_t connected() { return conn && !conn->isClosed; }
+
+    void stop()
+    {
+        if (conn && !conn->isClosed) {
+            conn->isClosed = true;
+            conn->closeMs = millis();
+        }
+    }
+
+    size_t write(const uint8_t* buf, size_t size)
+    {
+        if (!connected()) {
+            return 0;
+        }
+        host::advanceUs(size * host::writeUsPerByte);
+        conn->response.append((const char*) buf, size);
+        return size;
+    }
+
+    size_t write_P(PGM_P buf, size_t size) { return write((const uint8_t*) buf, size); }
+    size_t print(const String& s) { return write((const uint8_t*) s.c_str(), s.length()); }
+
+private:
+    std::shared_ptr<host::TcpConnection> conn;
+};
+
+
+class WiFiServer {
+public:
+    explicit WiFiServer(uint16_t port) : port(port) {}
+
+    void begin() { isListening = true; }
+
+    WiFiClient available()
+    {
+        if (isListening) {
+            for (auto i = host::tcpBacklog.begin(); i != host::tcpBacklog.end(); ++i) {
+                if ((*i)->port == port) {
+                    std::shared_ptr<host::TcpConnection> conn = *i;
+                    host::tcpBacklog.erase(i);
+                    conn->isAccepted = true;
+                    conn->acceptMs = millis();
+                    return WiFiClient(conn);
+                }
+            }
+        }
+        return WiFiClient();
+    }
+
+private:
+    uint16_t port;
+    bool isListening = false;
+};
+
+#endif  // #ifndef __HOST_ESP8266WIFI_H
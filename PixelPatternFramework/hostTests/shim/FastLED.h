@@ -0,0 +1,157 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Host Test Shim:  FastLED                                        *
+ *                                                                 *
+ * The parts of FastLED that the framework and the pattern         *
+ * sketches use, with the same integer math, so that patterns can *
+ * be run and compared on a PC.  FastLED.show() hands the pixel    *
+ * arrays to a test's hook instead of writing them out.            *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __HOST_FASTLED_H
+#define __HOST_FASTLED_H
+
+#include <Arduino.h>
+
+typedef uint8_t fract8;
+
+enum HSVHue {
+    HUE_RED = 0,
+    HUE_ORANGE = 32,
+    HUE_YELLOW = 64,
+    HUE_GREEN = 96,
+    HUE_AQUA = 128,
+    HUE_BLUE = 160,
+    HUE_PURPLE = 192,
+    HUE_PINK = 224
+};
+
+enum EOrder { RGB, RBG, GRB, GBR, BRG, BGR };
+
+
+uint8_t scale8(uint8_t i, fract8 scale);
+uint8_t scale8_video(uint8_t i, fract8 scale);
+uint8_t qadd8(uint8_t i, uint8_t j);
+uint8_t qsub8(uint8_t i, uint8_t j);
+uint8_t triwave8(uint8_t in);
+uint8_t quadwave8(uint8_t in);
+uint8_t cubicwave8(uint8_t in);
+uint8_t sin8(uint8_t theta);
+
+uint8_t random8();
+uint8_t random8(uint8_t lim);
+uint16_t random16();
+uint16_t random16(uint16_t lim);
+void random16_set_seed(uint16_t seed);
+
+
+struct CHSV {
+    union {
+        struct {
+            union { uint8_t hue; uint8_t h; };
+            union { uint8_t sat; uint8_t s; };
+            union { uint8_t val; uint8_t v; };
+        };
+        uint8_t raw[3];
+    };
+
+    CHSV() {}
+    CHSV(uint8_t ih, uint8_t is, uint8_t iv) : hue(ih), sat(is), val(iv) {}
+};
+
+
+struct CRGB;
+void hsv2rgb_rainbow(const CHSV& hsv, CRGB& rgb);
+
+struct CRGB {
+    union {
+        struct {
+            union { uint8_t r; uint8_t red; };
+            union { uint8_t g; uint8_t green; };
+            union { uint8_t b; uint8_t blue; };
+        };
+        uint8_t raw[3];
+    };
+
+    typedef enum {
+        Black = 0x000000,
+        Blue = 0x0000FF,
+        Chocolate = 0xD2691E,
+        Cyan = 0x00FFFF,
+        DarkGoldenrod = 0xB8860B,
+        DarkGreen = 0x006400,
+        DarkOrange = 0xFF8C00,
+        DarkRed = 0x8B0000,
+        Green = 0x008000,
+        Indigo = 0x4B0082,
+        MidnightBlue = 0x191970,
+        Orange = 0xFFA500,
+        Purple = 0x800080,
+        Red = 0xFF0000,
+        White = 0xFFFFFF,
+        Yellow = 0xFFFF00
+    } HTMLColorCode;
+
+    CRGB() {}
+    CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+    CRGB(uint32_t colorcode) : r(colorcode >> 16), g(colorcode >> 8), b(colorcode) {}
+    CRGB(HTMLColorCode colorcode) : r(colorcode >> 16), g(colorcode >> 8), b(colorcode) {}
+    CRGB(const CHSV& rhs) { hsv2rgb_rainbow(rhs, *this); }
+
+    CRGB& operator =(const CHSV& rhs) { hsv2rgb_rainbow(rhs, *this); return *this; }
+    CRGB& operator =(uint32_t colorcode) { r = colorcode >> 16; g = colorcode >> 8; b = colorcode; return *this; }
+
+    uint8_t& operator [](uint8_t x) { return raw[x]; }
+    const uint8_t& operator [](uint8_t x) const { return raw[x]; }
+
+    CRGB& nscale8_video(uint8_t scaledown);
+    CRGB& nscale8(uint8_t scaledown);
+};
+
+inline bool operator ==(const CRGB& lhs, const CRGB& rhs) { return lhs.r == rhs.r && lhs.g == rhs.g && lhs.b == rhs.b; }
+inline bool operator !=(const CRGB& lhs, const CRGB& rhs) { return !(lhs == rhs); }
+
+
+void fill_solid(CRGB* leds, int numToFill, const CRGB& color);
+void fill_rainbow(CRGB* pFirstLED, int numToFill, uint8_t initialhue, uint8_t deltahue = 5);
+CHSV& nblend(CHSV& existing, const CHSV& overlay, fract8 amountOfOverlay);
+
+
+// Controller types are only tags on the host.  The pixel arrays are kept
+// track of so that a test can see what would have been written to them.
+template <uint8_t DATA_PIN, EOrder RGB_ORDER> class WS2811 {};
+template <uint8_t DATA_PIN, EOrder RGB_ORDER> class WS2812B {};
+template <uint8_t DATA_PIN, EOrder RGB_ORDER> class DMXSIMPLE {};
+
+class CFastLED {
+public:
+    static constexpr uint8_t maxStrips = 4;
+
+    template <template <uint8_t, EOrder> class CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+    CFastLED& addLeds(CRGB* data, int nLedsOrOffset, int nLedsIfOffset = 0)
+    {
+        if (numStrips < maxStrips) {
+            strips[numStrips] = data + (nLedsIfOffset > 0 ? nLedsOrOffset : 0);
+            stripLengths[numStrips] = nLedsIfOffset > 0 ? nLedsIfOffset : nLedsOrOffset;
+            ++numStrips;
+        }
+        return *this;
+    }
+
+    void show();
+    void setBrightness(uint8_t) {}
+
+    uint8_t numStrips = 0;
+    CRGB* strips[maxStrips];
+    int stripLengths[maxStrips];
+
+    // Called by show().
+    void (*showHook)() = nullptr;
+};
+
+extern CFastLED FastLED;
+
+#endif  // #ifndef __HOST_FASTLED_H
@@ -0,0 +1,144 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Host Test Shim:  I2Cdev MPU6050                                 *
+ *                                                                 *
+ * Only the calls that MpuMotionActivity and MpuFifoReader make.   *
+ * The mode register writes and the number of I2C transfers are    *
+ * recorded.  run() plays the MPU forward in time:  while the DMP  *
+ * is enabled, it writes packet to the FIFO every 10 ms and raises *
+ * the data ready bit, and while the motion interrupt is enabled,  *
+ * it compares motionMg with the threshold at the wake frequency   *
+ * (or every ms when not cycling) and raises the motion bit.       *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __HOST_MPU6050_H
+#define __HOST_MPU6050_H
+
+#include <stdint.h>
+#include <deque>
+
+#define MPU6050_CLOCK_INTERNAL   0x00
+#define MPU6050_CLOCK_PLL_XGYRO  0x01
+
+class MPU6050 {
+public:
+    static constexpr uint8_t packetSize = 42;
+    static constexpr uint16_t fifoSize = 1024;
+    static constexpr uint32_t dmpIntervalMs = 10;
+
+    static constexpr uint8_t motionIntBit = 0x40;
+    static constexpr uint8_t fifoOverflowIntBit = 0x10;
+    static constexpr uint8_t dmpDataReadyIntBit = 0x02;
+
+    uint8_t getClockSource() { ++numTransfers; return clockSource; }
+    void setClockSource(uint8_t source) { clockSource = source; modeWrite(); }
+    void setDMPEnabled(bool enabled) { dmpEnabled = enabled; modeWrite(); }
+    void setIntMotionEnabled(bool enabled) { intMotionEnabled = enabled; motionCount = 0; modeWrite(); }
+    void setWakeCycleEnabled(bool enabled) { wakeCycleEnabled = enabled; lastWakeMs = nowMs; modeWrite(); }
+    void setWakeFrequency(uint8_t frequency) { wakeFrequency = frequency; modeWrite(); }
+    void setStandbyXGyroEnabled(bool enabled) { gyroStandby[0] = enabled; modeWrite(); }
+    void setStandbyYGyroEnabled(bool enabled) { gyroStandby[1] = enabled; modeWrite(); }
+    void setStandbyZGyroEnabled(bool enabled) { gyroStandby[2] = enabled; modeWrite(); }
+    void setMotionDetectionThreshold(uint8_t threshold) { motionThreshold = threshold; modeWrite(); }
+    void setMotionDetectionCounterDecrement(uint8_t decrement) { motionDecrement = decrement; modeWrite(); }
+    void setMotionDetectionDuration(uint8_t duration) { motionDuration = duration; modeWrite(); }
+
+    uint8_t getIntStatus()
+    {
+        ++numTransfers;
+        uint8_t status = intStatus;
+        intStatus = 0;
+        return status;
+    }
+
+    uint16_t getFIFOCount() { ++numTransfers; return fifo.size(); }
+
+    void getFIFOBytes(uint8_t* data, uint8_t length)
+    {
+        ++numTransfers;
+        for (uint8_t i = 0; i < length; ++i) {
+            data[i] = fifo.empty() ? 0 : fifo.front();
+            if (!fifo.empty()) {
+                fifo.pop_front();
+            }
+        }
+    }
+
+    void resetFIFO() { ++numTransfers; fifo.clear(); }
+
+    // Plays the MPU forward to nowMs.  Returns true if it raised its
+    // interrupt pin.
+    bool run(uint32_t newNowMs)
+    {
+        uint8_t oldIntStatus = intStatus;
+
+        while (nowMs != newNowMs) {
+            ++nowMs;
+
+            if (dmpEnabled && ++msSincePacket >= dmpIntervalMs) {
+                msSincePacket = 0;
+                // A full FIFO loses its oldest bytes, so it ends up out
+                // of step with the packets.
+                for (uint8_t i = 0; i < packetSize; ++i) {
+                    if (fifo.size() >= fifoSize) {
+                        fifo.pop_front();
+                        intStatus |= fifoOverflowIntBit;
+                    }
+                    fifo.push_back(packet[i]);
+                }
+                intStatus |= dmpDataReadyIntBit;
+            }
+
+            static const uint16_t wakeIntervalsMs[] = {800, 400, 200, 100};
+            uint32_t sampleIntervalMs = wakeCycleEnabled ? wakeIntervalsMs[wakeFrequency & 3] : 1;
+            if (intMotionEnabled && nowMs - lastWakeMs >= sampleIntervalMs) {
+                lastWakeMs = nowMs;
+                // The threshold is in 2 mg units.
+                if (motionMg > 2 * motionThreshold) {
+                    ++motionCount;
+                }
+                else {
+                    motionCount = motionCount > motionDecrement ? motionCount - motionDecrement : 0;
+                }
+                if (motionCount >= motionDuration) {
+                    motionCount = 0;
+                    intStatus |= motionIntBit;
+                }
+            }
+        }
+
+        return intStatus & ~oldIntStatus;
+    }
+
+    // What the DMP writes next, and what the motion detector sees
+    uint8_t packet[packetSize] = {};
+    uint16_t motionMg = 0;
+
+    uint8_t clockSource = MPU6050_CLOCK_PLL_XGYRO;
+    bool dmpEnabled = true;
+    bool intMotionEnabled = false;
+    bool wakeCycleEnabled = false;
+    uint8_t wakeFrequency = 0;
+    bool gyroStandby[3] = {false, false, false};
+    uint8_t motionThreshold = 0;
+    uint8_t motionDecrement = 0;
+    uint8_t motionDuration = 0;
+
+    uint32_t numModeWrites = 0;
+    uint32_t numTransfers = 0;
+
+private:
+    void modeWrite() { ++numModeWrites; ++numTransfers; }
+
+    std::deque<uint8_t> fifo;
+    uint8_t intStatus = 0;
+    uint32_t nowMs = 0;
+    uint32_t msSincePacket = 0;
+    uint32_t lastWakeMs = 0;
+    uint8_t motionCount = 0;
+};
+
+#endif  // #ifndef __HOST_MPU6050_H
@@ -0,0 +1,111 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Host Test Shim:  TMRh20 RF24                                    *
+ *                                                                 *
+ * The setup calls are recorded and otherwise ignored.  A test     *
+ * puts payloads in the receive FIFO with receive(), which, like   *
+ * the nRF24L01+, drops them when the three-payload FIFO is full.  *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __HOST_RF24_H
+#define __HOST_RF24_H
+
+#include <stdint.h>
+#include <string.h>
+#include <deque>
+
+typedef enum { RF24_PA_MIN, RF24_PA_LOW, RF24_PA_HIGH, RF24_PA_MAX, RF24_PA_ERROR } rf24_pa_dbm_e;
+typedef enum { RF24_1MBPS, RF24_2MBPS, RF24_250KBPS } rf24_datarate_e;
+typedef enum { RF24_CRC_DISABLED, RF24_CRC_8, RF24_CRC_16 } rf24_crclength_e;
+
+class RF24 {
+public:
+    static constexpr uint8_t rxFifoSize = 3;
+    static constexpr uint8_t maxPayloadSize = 32;
+
+    RF24(uint8_t cePin, uint8_t csnPin) : cePin(cePin), csnPin(csnPin) {}
+
+    bool begin() { return true; }
+    void setPALevel(uint8_t level) { paLevel = level; }
+    void setRetries(uint8_t delay, uint8_t count) { retryDelay = delay; retryCount = count; }
+    bool setDataRate(rf24_datarate_e rate) { dataRate = rate; return true; }
+    void setChannel(uint8_t channel) { rfChannel = channel; }
+    void setAutoAck(bool enable) { autoAck = enable; }
+    void enableDynamicPayloads() { dynamicPayloads = true; }
+    void setCRCLength(rf24_crclength_e length) { crcLength = length; }
+    void openReadingPipe(uint8_t pipeNum, const uint8_t*) { openPipes |= 1 << pipeNum; }
+    void printDetails() {}
+    void startListening() { isListening = true; }
+
+    bool available() { return !rxFifo.empty(); }
+
+    bool available(uint8_t* pipeNum)
+    {
+        if (rxFifo.empty()) {
+            return false;
+        }
+        *pipeNum = rxFifo.front().pipeNum;
+        return true;
+    }
+
+    // A size over 32 is what a corrupt payload looks like.
+    uint8_t getDynamicPayloadSize() { return rxFifo.empty() ? 0 : rxFifo.front().size; }
+
+    void read(void* buf, uint8_t len)
+    {
+        if (rxFifo.empty()) {
+            return;
+        }
+        memcpy(buf, rxFifo.front().payload, min(len, maxPayloadSize));
+        rxFifo.pop_front();
+    }
+
+    void flush_rx() { rxFifo.clear(); }
+
+    bool rxFifoFull() { return rxFifo.size() >= rxFifoSize; }
+
+    // Puts a payload in the receive FIFO.  Returns false if it was full.
+    bool receive(uint8_t pipeNum, const uint8_t* payload, uint8_t size)
+    {
+        if (!isListening || !(openPipes & 1 << pipeNum) || rxFifoFull()) {
+            ++numPayloadsDropped;
+            return false;
+        }
+        Payload p;
+        p.pipeNum = pipeNum;
+        p.size = size;
+        memcpy(p.payload, payload, min(size, maxPayloadSize));
+        rxFifo.push_back(p);
+        return true;
+    }
+
+    uint8_t cePin;
+    uint8_t csnPin;
+    uint8_t paLevel = RF24_PA_MAX;
+    uint8_t retryDelay = 5;
+    uint8_t retryCount = 15;
+    rf24_datarate_e dataRate = RF24_1MBPS;
+    uint8_t rfChannel = 76;
+    bool autoAck = true;
+    bool dynamicPayloads = false;
+    rf24_crclength_e crcLength = RF24_CRC_16;
+    uint8_t openPipes = 0;
+    bool isListening = false;
+    uint32_t numPayloadsDropped = 0;
+
+private:
+    static uint8_t min(uint8_t a, uint8_t b) { return a < b ? a : b; }
+
+    struct Payload {
+        uint8_t pipeNum;
+        uint8_t size;
+        uint8_t payload[maxPayloadSize];
+    };
+
+    std::deque<Payload> rxFifo;
+};
+
+#endif  // #ifndef __HOST_RF24_H
@@ -0,0 +1,14 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Host Test Shim:  SPI                                            *
+ *                                                                 *
+ * The sketches include it for RF24, whose shim doesn't need it.   *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __HOST_SPI_H
+#define __HOST_SPI_H
+
+#endif  // #ifndef __HOST_SPI_H
@@ -0,0 +1,29 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Host Test Shim:  Pololu VL53L1X                                 *
+ *                                                                 *
+ * Only the region of interest calls, which are recorded so that a *
+ * test can see which zone the sensor would measure next.          *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __HOST_VL53L1X_H
+#define __HOST_VL53L1X_H
+
+#include <stdint.h>
+
+class VL53L1X {
+public:
+    void setROISize(uint8_t width, uint8_t height) { roiWidth = width; roiHeight = height; ++numRoiSizeWrites; }
+    void setROICenter(uint8_t spadNumber) { roiCenterSpad = spadNumber; ++numRoiCenterWrites; }
+
+    uint8_t roiWidth = 16;
+    uint8_t roiHeight = 16;
+    uint8_t roiCenterSpad = 199;
+    uint16_t numRoiSizeWrites = 0;
+    uint16_t numRoiCenterWrites = 0;
+};
+
+#endif  // #ifndef __HOST_VL53L1X_H
@@ -0,0 +1,80 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Host Test Shim:  ESP8266 WiFiUdp                                *
+ *                                                                 *
+ * Only the calls that PixelStreamReceiver makes.  A test sends a  *
+ * datagram to a port with host::sendUdp, which queues it until a  *
+ * WiFiUDP that has begun on that port takes it with parsePacket().*
+ * As with lwIP, parsePacket() drops whatever wasn't read of the   *
+ * previous datagram.                                              *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __HOST_WIFIUDP_H
+#define __HOST_WIFIUDP_H
+
+#include <Arduino.h>
+#include <deque>
+#include <vector>
+
+namespace host {
+
+struct UdpDatagram {
+    uint16_t port;
+    std::vector<uint8_t> data;
+};
+
+// Datagrams that haven't been taken by their socket yet
+inline std::deque<UdpDatagram> udpQueue;
+
+inline void sendUdp(uint16_t port, const uint8_t* data, size_t length)
+{
+    udpQueue.push_back({port, std::vector<uint8_t>(data, data + length)});
+}
+
+}
+
+
+class WiFiUDP {
+public:
+    uint8_t begin(uint16_t newPort)
+    {
+        port = newPort;
+        return 1;
+    }
+
+    int parsePacket()
+    {
+        datagram.clear();
+        readPos = 0;
+        if (0 != port) {
+            for (auto i = host::udpQueue.begin(); i != host::udpQueue.end(); ++i) {
+                if (i->port == port) {
+                    datagram = i->data;
+                    host::udpQueue.erase(i);
+                    break;
+                }
+            }
+        }
+        return datagram.size();
+    }
+
+    int available() { return datagram.size() - readPos; }
+
+    int read(uint8_t* buf, size_t length)
+    {
+        size_t n = min(length, (size_t) available());
+        memcpy(buf, datagram.data() + readPos, n);
+        readPos += n;
+        return n;
+    }
+
+private:
+    uint16_t port = 0;
+    std::vector<uint8_t> datagram;
+    size_t readPos = 0;
+};
+
+#endif  // #ifndef __HOST_WIFIUDP_H
@@ -0,0 +1,42 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Host Test Shim:  AVR I/O Registers                              *
+ *                                                                 *
+ * Only the ATmega328 ADC registers, as plain variables, so that   *
+ * AudioSampler can be started on the host and fed samples by a    *
+ * test.                                                           *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __HOST_AVR_IO_H
+#define __HOST_AVR_IO_H
+
+#include <stdint.h>
+
+namespace host {
+
+extern volatile uint8_t adcsra;
+extern volatile uint8_t adcsrb;
+extern volatile uint8_t admux;
+extern volatile uint8_t didr0;
+
+}
+
+#define ADCSRA host::adcsra
+#define ADCSRB host::adcsrb
+#define ADMUX host::admux
+#define DIDR0 host::didr0
+
+#define ADPS0 0
+#define ADPS1 1
+#define ADPS2 2
+#define ADIE 3
+#define ADIF 4
+#define ADATE 5
+#define ADSC 6
+#define ADEN 7
+#define REFS0 6
+
+#endif  // #ifndef __HOST_AVR_IO_H
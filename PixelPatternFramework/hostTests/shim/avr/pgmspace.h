@@ -0,0 +1,52 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Host Test Shim:  Program Memory                                 *
+ *                                                                 *
+ * Flash is ordinary memory on the host.  The word and dword reads *
+ * return the whole member they are given, because the sketches    *
+ * read 16-bit AVR pointers out of flash with pgm_read_word().     *
+ * A test can watch what is copied out of flash with memcpy_P().   *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __HOST_AVR_PGMSPACE_H
+#define __HOST_AVR_PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+
+namespace host {
+
+template <typename W, typename T>
+inline T pgmReadWide(const T* p) { return *p; }
+
+template <typename W>
+inline W pgmReadWide(const void* p) { W w; memcpy(&w, p, sizeof(W)); return w; }
+
+// memcpy_P() calls this hook, if set, before copying.
+extern void (*memcpyPHook)(const void* src, size_t n);
+
+void* memcpyP(void* dest, const void* src, size_t n);
+
+}
+
+#define pgm_read_byte(addr)  (*(const uint8_t*) (addr))
+#define pgm_read_word(addr)  (::host::pgmReadWide<uint16_t>(addr))
+#define pgm_read_dword(addr) (::host::pgmReadWide<uint32_t>(addr))
+#define pgm_read_float(addr) (*(const float*) (addr))
+#define pgm_read_ptr(addr)   (*(void* const*) (addr))
+
+#define memcpy_P  ::host::memcpyP
+#define strlen_P  strlen
+#define strnlen_P strnlen
+#define strcpy_P  strcpy
+#define strncpy_P strncpy
+#define strcmp_P  strcmp
+
+#endif  // #ifndef __HOST_AVR_PGMSPACE_H
@@ -0,0 +1,29 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Host Test Shim:  Watchdog Timer                                 *
+ *                                                                 *
+ * There's no watchdog on the host, so nothing ever resets.        *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __HOST_AVR_WDT_H
+#define __HOST_AVR_WDT_H
+
+#define WDTO_15MS   0
+#define WDTO_30MS   1
+#define WDTO_60MS   2
+#define WDTO_120MS  3
+#define WDTO_250MS  4
+#define WDTO_500MS  5
+#define WDTO_1S     6
+#define WDTO_2S     7
+#define WDTO_4S     8
+#define WDTO_8S     9
+
+inline void wdt_enable(uint8_t) {}
+inline void wdt_disable() {}
+inline void wdt_reset() {}
+
+#endif  // #ifndef __HOST_AVR_WDT_H
@@ -0,0 +1,172 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Host Test Shim:  Arduino Core                                   *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+
+HardwareSerial Serial;
+
+volatile uint8_t host::adcsra;
+volatile uint8_t host::adcsrb;
+volatile uint8_t host::admux;
+volatile uint8_t host::didr0;
+
+static uint64_t nowUs = 0;
+static int pinInputs[64];
+static bool pinInputIsSet[64];
+static int analogInputs[8];
+
+// avr-libc's random() state
+static unsigned long randomNext = 1;
+
+void (*host::memcpyPHook)(const void* src, size_t n) = nullptr;
+
+
+void host::advanceUs(uint32_t us)
+{
+    nowUs += us;
+}
+
+
+void host::setPinInput(uint8_t pin, int value)
+{
+    if (pin < 64) {
+        pinInputs[pin] = value;
+        pinInputIsSet[pin] = true;
+    }
+}
+
+
+void host::setAnalogInput(uint8_t channel, int value)
+{
+    if (channel >= A0) {
+        channel -= A0;
+    }
+    if (channel < 8) {
+        analogInputs[channel] = value;
+    }
+}
+
+
+void* host::memcpyP(void* dest, const void* src, size_t n)
+{
+    if (memcpyPHook) {
+        (*memcpyPHook)(src, n);
+    }
+    return memcpy(dest, src, n);
+}
+
+
+unsigned long millis()
+{
+    return (uint32_t) (nowUs / 1000);
+}
+
+
+unsigned long micros()
+{
+    return (uint32_t) nowUs;
+}
+
+
+void delay(unsigned long ms)
+{
+    nowUs += (uint64_t) ms * 1000;
+}
+
+
+void delayMicroseconds(unsigned int us)
+{
+    nowUs += us;
+}
+
+
+void pinMode(uint8_t, uint8_t)
+{
+}
+
+
+int digitalRead(uint8_t pin)
+{
+    return pin < 64 && pinInputIsSet[pin] ? pinInputs[pin] : HIGH;
+}
+
+
+void digitalWrite(uint8_t, uint8_t)
+{
+}
+
+
+int analogRead(uint8_t channel)
+{
+    if (channel >= A0) {
+        channel -= A0;
+    }
+    return channel < 8 ? analogInputs[channel] : 0;
+}
+
+
+void analogWrite(uint8_t, int)
+{
+}
+
+
+static long doRandom(unsigned long* ctx)
+{
+    // avr-libc's Park-Miller minimal standard generator
+    long x = *ctx;
+    if (0 == x) {
+        x = 123459876L;
+    }
+    long hi = x / 127773L;
+    long lo = x % 127773L;
+    x = 16807L * lo - 2836L * hi;
+    if (x < 0) {
+        x += 0x7fffffffL;
+    }
+    *ctx = x;
+    return x % 0x80000000L;
+}
+
+
+long random(long howBig)
+{
+    if (0 == howBig) {
+        return 0;
+    }
+    return doRandom(&randomNext) % howBig;
+}
+
+
+long random(long howSmall, long howBig)
+{
+    if (howSmall >= howBig) {
+        return howSmall;
+    }
+    return random(howBig - howSmall) + howSmall;
+}
+
+
+void randomSeed(unsigned long seed)
+{
+    if (0 != seed) {
+        randomNext = seed;
+    }
+}
+
+
+long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+
+char* dtostrf(double val, signed char width, unsigned char prec, char* s)
+{
+    sprintf(s, "%*.*f", width, prec, val);
+    return s;
+}
@@ -0,0 +1,339 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Host Test Shim:  FastLED                                        *
+ *                                                                 *
+ * These follow FastLED 3.1's C implementations (with              *
+ * FASTLED_SCALE8_FIXED) so that the results match the AVR builds. *
+ *                                                                 *
+ *******************************************************************/
+
+#include <FastLED.h>
+
+CFastLED FastLED;
+
+static uint16_t rand16seed = 1337;
+
+
+void CFastLED::show()
+{
+    if (showHook) {
+        (*showHook)();
+    }
+}
+
+
+uint8_t scale8(uint8_t i, fract8 scale)
+{
+    return ((uint16_t) i * (1 + (uint16_t) scale)) >> 8;
+}
+
+
+uint8_t scale8_video(uint8_t i, fract8 scale)
+{
+    return (((int) i * (int) scale) >> 8) + ((i && scale) ? 1 : 0);
+}
+
+
+uint8_t qadd8(uint8_t i, uint8_t j)
+{
+    unsigned int t = i + j;
+    return t > 255 ? 255 : t;
+}
+
+
+uint8_t qsub8(uint8_t i, uint8_t j)
+{
+    int t = i - j;
+    return t < 0 ? 0 : t;
+}
+
+
+uint8_t triwave8(uint8_t in)
+{
+    if (in & 0x80) {
+        in = 255 - in;
+    }
+    return in << 1;
+}
+
+
+static uint8_t ease8InOutQuad(uint8_t i)
+{
+    uint8_t j = i;
+    if (j & 0x80) {
+        j = 255 - j;
+    }
+    uint8_t jj = scale8(j, j);
+    uint8_t jj2 = jj << 1;
+    if (i & 0x80) {
+        jj2 = 255 - jj2;
+    }
+    return jj2;
+}
+
+
+static uint8_t ease8InOutCubic(uint8_t i)
+{
+    uint8_t ii = scale8(i, i);
+    uint8_t iii = scale8(ii, i);
+    uint16_t r1 = (3 * (uint16_t) ii) - (2 * (uint16_t) iii);
+    uint8_t result = r1;
+    if (r1 & 0x100) {
+        result = 255;
+    }
+    return result;
+}
+
+
+uint8_t quadwave8(uint8_t in)
+{
+    return ease8InOutQuad(triwave8(in));
+}
+
+
+uint8_t cubicwave8(uint8_t in)
+{
+    return ease8InOutCubic(triwave8(in));
+}
+
+
+uint8_t sin8(uint8_t theta)
+{
+    static const uint8_t b_m16_interleave[] = { 0, 49, 49, 41, 90, 27, 117, 10 };
+
+    uint8_t offset = theta;
+    if (theta & 0x40) {
+        offset = (uint8_t) 255 - offset;
+    }
+    offset &= 0x3F;
+
+    uint8_t secoffset = offset & 0x0F;
+    if (theta & 0x40) {
+        ++secoffset;
+    }
+
+    uint8_t section = offset >> 4;
+    const uint8_t* p = b_m16_interleave + section * 2;
+    uint8_t b = p[0];
+    uint8_t m16 = p[1];
+    uint8_t mx = (m16 * secoffset) >> 4;
+
+    int8_t y = mx + b;
+    if (theta & 0x80) {
+        y = -y;
+    }
+    y += 128;
+    return y;
+}
+
+
+uint8_t random8()
+{
+    rand16seed = rand16seed * 2053 + 13849;
+    return (uint8_t) ((uint8_t) (rand16seed & 0xFF) + (uint8_t) (rand16seed >> 8));
+}
+
+
+uint8_t random8(uint8_t lim)
+{
+    return ((uint16_t) random8() * lim) >> 8;
+}
+
+
+uint16_t random16()
+{
+    rand16seed = rand16seed * 2053 + 13849;
+    return rand16seed;
+}
+
+
+uint16_t random16(uint16_t lim)
+{
+    return ((uint32_t) random16() * lim) >> 16;
+}
+
+
+void random16_set_seed(uint16_t seed)
+{
+    rand16seed = seed;
+}
+
+
+CRGB& CRGB::nscale8_video(uint8_t scaledown)
+{
+    r = scale8_video(r, scaledown);
+    g = scale8_video(g, scaledown);
+    b = scale8_video(b, scaledown);
+    return *this;
+}
+
+
+CRGB& CRGB::nscale8(uint8_t scaledown)
+{
+    r = scale8(r, scaledown);
+    g = scale8(g, scaledown);
+    b = scale8(b, scaledown);
+    return *this;
+}
+
+
+void hsv2rgb_rainbow(const CHSV& hsv, CRGB& rgb)
+{
+    // FastLED's default yellow boost (Y1) and no green scaling
+    const uint8_t K255 = 255;
+    const uint8_t K171 = 171;
+    const uint8_t K170 = 170;
+    const uint8_t K85 = 85;
+
+    uint8_t hue = hsv.hue;
+    uint8_t sat = hsv.sat;
+    uint8_t val = hsv.val;
+
+    uint8_t offset8 = (hue & 0x1F) << 3;
+    uint8_t third = scale8(offset8, 256 / 3);
+
+    uint8_t r, g, b;
+
+    if (!(hue & 0x80)) {
+        if (!(hue & 0x40)) {
+            if (!(hue & 0x20)) {
+                r = K255 - third;
+                g = third;
+                b = 0;
+            }
+            else {
+                r = K171;
+                g = K85 + third;
+                b = 0;
+            }
+        }
+        else {
+            if (!(hue & 0x20)) {
+                uint8_t twothirds = scale8(offset8, (256 * 2) / 3);
+                r = K171 - twothirds;
+                g = K170 + third;
+                b = 0;
+            }
+            else {
+                r = 0;
+                g = K255 - third;
+                b = third;
+            }
+        }
+    }
+    else {
+        if (!(hue & 0x40)) {
+            if (!(hue & 0x20)) {
+                uint8_t twothirds = scale8(offset8, (256 * 2) / 3);
+                r = 0;
+                g = K171 - twothirds;
+                b = K85 + twothirds;
+            }
+            else {
+                r = third;
+                g = 0;
+                b = K255 - third;
+            }
+        }
+        else {
+            if (!(hue & 0x20)) {
+                r = K85 + third;
+                g = 0;
+                b = K171 - third;
+            }
+            else {
+                r = K170 + third;
+                g = 0;
+                b = K85 - third;
+            }
+        }
+    }
+
+    if (sat != 255) {
+        if (0 == sat) {
+            r = 255;
+            g = 255;
+            b = 255;
+        }
+        else {
+            uint8_t desat = 255 - sat;
+            desat = scale8(desat, desat);
+            uint8_t satscale = 255 - desat;
+            r = scale8(r, satscale);
+            g = scale8(g, satscale);
+            b = scale8(b, satscale);
+            r += desat;
+            g += desat;
+            b += desat;
+        }
+    }
+
+    if (val != 255) {
+        val = scale8_video(val, val);
+        if (0 == val) {
+            r = 0;
+            g = 0;
+            b = 0;
+        }
+        else {
+            r = scale8(r, val);
+            g = scale8(g, val);
+            b = scale8(b, val);
+        }
+    }
+
+    rgb.r = r;
+    rgb.g = g;
+    rgb.b = b;
+}
+
+
+void fill_solid(CRGB* leds, int numToFill, const CRGB& color)
+{
+    for (int i = 0; i < numToFill; ++i) {
+        leds[i] = color;
+    }
+}
+
+
+void fill_rainbow(CRGB* pFirstLED, int numToFill, uint8_t initialhue, uint8_t deltahue)
+{
+    CHSV hsv(initialhue, 240, 255);
+    for (int i = 0; i < numToFill; ++i) {
+        pFirstLED[i] = hsv;
+        hsv.hue += deltahue;
+    }
+}
+
+
+CHSV& nblend(CHSV& existing, const CHSV& overlay, fract8 amountOfOverlay)
+{
+    // always blends along the shortest way around the hue wheel
+
+    if (0 == amountOfOverlay) {
+        return existing;
+    }
+
+    if (255 == amountOfOverlay) {
+        existing = overlay;
+        return existing;
+    }
+
+    fract8 amountOfKeep = 255 - amountOfOverlay;
+
+    uint8_t huedelta8 = overlay.hue - existing.hue;
+    if (huedelta8 > 127) {
+        huedelta8 = -huedelta8;
+        existing.hue = existing.hue - scale8(huedelta8, amountOfOverlay);
+    }
+    else {
+        existing.hue = existing.hue + scale8(huedelta8, amountOfOverlay);
+    }
+
+    existing.sat = scale8(existing.sat, amountOfKeep) + scale8(overlay.sat, amountOfOverlay);
+    existing.val = scale8(existing.val, amountOfKeep) + scale8(overlay.val, amountOfOverlay);
+
+    return existing;
+}
@@ -0,0 +1,172 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Time-of-Flight Zone Scanner Trace Replay Test                   *
+ *                                                                 *
+ * Replays a trace of VL53L1X ranges through a TofZoneScanner set  *
+ * up the way TofOctoFlashy sets up its scanner, and checks the    *
+ * scanner's target against the trace's expect lines.              *
+ *                                                                 *
+ * usage:  tofZoneScannerTest trace.txt                            *
+ *                                                                 *
+ * Each range line in the trace is                                 *
+ *                                                                 *
+ *   ms zone rangeMm rangeStatus signalKcps ambientKcps            *
+ *                                                                 *
+ * where zone is the zone that the range was measured in, which    *
+ * must be the zone that the scanner last selected.  An expect     *
+ * line checks the scanner after the range before it:              *
+ *                                                                 *
+ *   expect noTarget                                               *
+ *   expect target [lateral min max] [nearest min max]             *
+ *                 [approach min max]                              *
+ *                                                                 *
+ * Blank lines and lines that start with # are skipped.            *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include <TofZoneScanner.h>
+#include <VL53L1X.h>
+
+using namespace pixelPattern;
+
+// TofOctoFlashy's zones and settings
+static const TofZone zones[] = {
+    {167, 8, 16, -1000},
+    {231, 8, 16, 1000},
+};
+static constexpr uint8_t numZones = sizeof(zones) / sizeof(zones[0]);
+static constexpr TofRangeFilterConfig filterConfig = {250, 100, 400, 3};
+static constexpr uint16_t maxRangeMm = 3000;
+static constexpr uint16_t zoneTimeoutMs = 500;
+
+
+static bool checkBounds(const char* what, int32_t value, int32_t minValue, int32_t maxValue, int lineNum)
+{
+    if (value < minValue || value > maxValue) {
+        printf("line %d:  %s is %ld, not %ld to %ld\n", lineNum, what, (long) value, (long) minValue, (long) maxValue);
+        return false;
+    }
+    return true;
+}
+
+
+static bool checkExpect(const TofZoneScanner& scanner, char* args, int lineNum)
+{
+    char* word = strtok(args, " \t\r\n");
+    if (0 == word) {
+        printf("line %d:  expect what?\n", lineNum);
+        return false;
+    }
+
+    bool expectTarget = 0 == strcmp(word, "target");
+    if (!expectTarget && 0 != strcmp(word, "noTarget")) {
+        printf("line %d:  unknown expectation %s\n", lineNum, word);
+        return false;
+    }
+    if (scanner.getHasTarget() != expectTarget) {
+        printf("line %d:  the scanner %s a target\n", lineNum, scanner.getHasTarget() ? "has" : "doesn't have");
+        return false;
+    }
+
+    while ((word = strtok(0, " \t\r\n")) != 0) {
+        char* minWord = strtok(0, " \t\r\n");
+        char* maxWord = strtok(0, " \t\r\n");
+        if (0 == maxWord) {
+            printf("line %d:  %s needs a min and a max\n", lineNum, word);
+            return false;
+        }
+        int32_t minValue = atol(minWord);
+        int32_t maxValue = atol(maxWord);
+
+        bool ok;
+        if (0 == strcmp(word, "lateral")) {
+            ok = checkBounds("the lateral position", scanner.getLateralPosition(), minValue, maxValue, lineNum);
+        }
+        else if (0 == strcmp(word, "nearest")) {
+            ok = checkBounds("the nearest range", scanner.getNearestRangeMm(), minValue, maxValue, lineNum);
+        }
+        else if (0 == strcmp(word, "approach")) {
+            ok = checkBounds("the approach speed", scanner.getApproachMmPerSec(), minValue, maxValue, lineNum);
+        }
+        else {
+            printf("line %d:  unknown value %s\n", lineNum, word);
+            ok = false;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+int main(int argc, char** argv)
+{
+    if (argc != 2) {
+        fprintf(stderr, "usage:  %s trace.txt\n", argv[0]);
+        return 2;
+    }
+
+    FILE* trace = fopen(argv[1], "r");
+    if (0 == trace) {
+        perror(argv[1]);
+        return 2;
+    }
+
+    VL53L1X sensor;
+    TofZoneScanner scanner(sensor, zones, numZones, filterConfig, maxRangeMm, zoneTimeoutMs);
+    scanner.begin();
+
+    bool ok = true;
+    uint32_t numRanges = 0;
+    uint32_t numExpects = 0;
+    char line[200];
+    for (int lineNum = 1; ok && fgets(line, sizeof(line), trace); ++lineNum) {
+        unsigned long ms;
+        unsigned int zone;
+        unsigned int rangeMm;
+        unsigned int rangeStatus;
+        unsigned int signalKcps;
+        unsigned int ambientKcps;
+
+        if ('#' == line[0] || '\0' == line[strspn(line, " \t\r\n")]) {
+            continue;
+        }
+        if (0 == strncmp(line, "expect", 6)) {
+            ok = checkExpect(scanner, line + 6, lineNum);
+            ++numExpects;
+        }
+        else if (6 == sscanf(line, "%lu %u %u %u %u %u", &ms, &zone, &rangeMm, &rangeStatus, &signalKcps, &ambientKcps)) {
+            // The sensor must be measuring the zone that the range is for.
+            if (zone != scanner.getCurrentZone() || zone >= numZones
+                || sensor.roiCenterSpad != zones[zone].roiCenterSpad
+                || sensor.roiWidth != zones[zone].roiWidth || sensor.roiHeight != zones[zone].roiHeight) {
+                printf("line %d:  the range is from zone %u, but the scanner selected zone %u (ROI %ux%u at %u)\n",
+                       lineNum, zone, scanner.getCurrentZone(), sensor.roiWidth, sensor.roiHeight, sensor.roiCenterSpad);
+                ok = false;
+            }
+            scanner.addRange(rangeMm, rangeStatus, signalKcps, ambientKcps, ms);
+            ++numRanges;
+        }
+        else {
+            printf("line %d:  can't parse %s", lineNum, line);
+            ok = false;
+        }
+    }
+    fclose(trace);
+
+    // The zones are all the same size, so it is only written by begin().
+    if (ok && sensor.numRoiSizeWrites != 1) {
+        printf("the ROI size was written %u times\n", sensor.numRoiSizeWrites);
+        ok = false;
+    }
+
+    if (ok) {
+        printf("%s:  %lu ranges, %lu expectations met\n", argv[1], (unsigned long) numRanges, (unsigned long) numExpects);
+    }
+    return ok ? 0 : 1;
+}
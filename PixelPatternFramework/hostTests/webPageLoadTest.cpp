@@ -0,0 +1,211 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Web Page Load Test                                              *
+ *                                                                 *
+ * Runs simulated browsers against an Esp8266WebPage through the   *
+ * WiFiServer stand-in.  Each client makes a series of UI page,    *
+ * API, and classic page requests, one at a time, whose bytes      *
+ * trickle in over tens or hundreds of ms, and the sketch's loop   *
+ * calls doWiFi() once per ms.  For each number of clients, it     *
+ * prints the percentiles of the time from connecting to getting   *
+ * the whole response and the longest doWiFi() call, and checks    *
+ * that every request got the response that it should have before  *
+ * the web page's request timeout.                                 *
+ *                                                                 *
+ * usage:  webPageLoadTest numClients...                           *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <Esp8266WebPage.h>
+#include <Esp8266WebUiAssets.h>
+#include <algorithm>
+#include <unistd.h>
+#include <vector>
+
+using namespace pixelPattern;
+
+// Esp8266WebPage's
+static constexpr uint32_t requestTimeoutMs = 3000;
+
+static constexpr uint16_t requestsPerClient = 12;
+
+// The rest of the sketch's loop, between doWiFi() calls
+static constexpr uint32_t loopUs = 1000;
+
+// A client that hasn't finished by then is stuck.
+static constexpr uint32_t maxRunMs = 600000;
+
+// Esp8266WebPage logs each request on Serial, which the shim prints,
+// so the report goes to a copy of stdout and Serial to /dev/null.
+static FILE* report;
+
+
+struct RequestKind {
+    const char* path;
+    bool sendEtag;
+    const char* statusLine;
+};
+
+static const RequestKind requestKinds[] = {
+    {"/", false, "HTTP/1.1 200 OK\r\n"},
+    {"/", true, "HTTP/1.1 304 Not Modified\r\n"},
+    {"/api/sequences", false, "HTTP/1.1 200 OK\r\n"},
+    {"/api/stats", false, "HTTP/1.1 200 OK\r\n"},
+    {"/api/status", false, "HTTP/1.1 200 OK\r\n"},
+    {"/api/nothing", false, "HTTP/1.1 404 Not Found\r\n"},
+    {"/?doNothing", false, "HTTP/1.1 200 OK\r\n"}
+};
+
+static constexpr uint8_t numRequestKinds = sizeof(requestKinds) / sizeof(requestKinds[0]);
+
+
+struct Client {
+    uint16_t numRequests = 0;
+    uint32_t nextConnectMs = 0;
+    const RequestKind* kind = nullptr;
+    std::shared_ptr<host::TcpConnection> conn;
+};
+
+
+static String makeRequest(const RequestKind& kind)
+{
+    String request = String("GET ") + kind.path + " HTTP/1.1\r\n"
+                   + "Host: 192.168.4.1\r\n"
+                   + "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:109.0) Gecko/20100101 Firefox/115.0\r\n"
+                   + "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+                   + "Accept-Language: en-US,en;q=0.5\r\n"
+                   + "Accept-Encoding: gzip, deflate\r\n"
+                   + "Connection: keep-alive\r\n";
+    if (kind.sendEtag) {
+        request += String("If-None-Match: ") + webUiIndexHtmlGzEtag + "\r\n";
+    }
+    return request + "\r\n";
+}
+
+
+static bool checkResponse(const RequestKind& kind, const host::TcpConnection& conn)
+{
+    const String& response = conn.response;
+    if (0 != response.compare(0, strlen(kind.statusLine), kind.statusLine)) {
+        fprintf(report, "GET %s at %lu ms got \"%.*s\"\n", kind.path, (unsigned long) conn.connectMs,
+                (int) response.find('\r'), response.c_str());
+        return false;
+    }
+
+    if (0 == strcmp(kind.path, "/") && !kind.sendEtag) {
+        size_t headerLength = response.find("\r\n\r\n") + 4;
+        if (response.length() - headerLength != webUiIndexHtmlGzLength
+            || 0 != memcmp(response.data() + headerLength, webUiIndexHtmlGz, webUiIndexHtmlGzLength))
+        {
+            fprintf(report, "GET / at %lu ms didn't get the whole UI page\n", (unsigned long) conn.connectMs);
+            return false;
+        }
+    }
+    return true;
+}
+
+
+static uint32_t percentile(const std::vector<uint32_t>& sorted, uint8_t p)
+{
+    size_t rank = (sorted.size() * p + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+
+static bool runClients(uint8_t numClients)
+{
+    Esp8266WebPage webPage;
+    webPage.setAp("lamp", "password");
+    webPage.setSta("", "");
+    webPage.setTitleText("Load Test");
+    webPage.setStatusText("Running");
+    webPage.init();
+
+    randomSeed(numClients);
+    std::vector<Client> clients(numClients);
+    for (Client& client : clients) {
+        client.nextConnectMs = millis() + random(200);
+    }
+
+    std::vector<uint32_t> latenciesMs;
+    uint32_t maxBacklogMs = 0;
+    uint32_t maxDoWiFiUs = 0;
+    uint32_t startMs = millis();
+    bool ok = true;
+
+    while (latenciesMs.size() < (size_t) numClients * requestsPerClient) {
+        if (millis() - startMs >= maxRunMs) {
+            fprintf(report, "%u clients:  only %u requests finished in %lu ms\n",
+                    numClients, (unsigned int) latenciesMs.size(), (unsigned long) maxRunMs);
+            return false;
+        }
+
+        for (Client& client : clients) {
+            if (client.conn && client.conn->isClosed) {
+                uint32_t latencyMs = client.conn->closeMs - client.conn->connectMs;
+                latenciesMs.push_back(latencyMs);
+                maxBacklogMs = max(maxBacklogMs, client.conn->acceptMs - client.conn->connectMs);
+                ok &= checkResponse(*client.kind, *client.conn);
+                if (latencyMs >= requestTimeoutMs) {
+                    fprintf(report, "%u clients:  GET %s at %lu ms took %lu ms\n", numClients, client.kind->path,
+                            (unsigned long) client.conn->connectMs, (unsigned long) latencyMs);
+                    ok = false;
+                }
+                client.conn = nullptr;
+                client.nextConnectMs = millis() + random(500);
+            }
+
+            if (!client.conn && client.numRequests < requestsPerClient && millis() >= client.nextConnectMs) {
+                ++client.numRequests;
+                client.kind = &requestKinds[random(numRequestKinds)];
+                client.conn = host::connectTcp(80, makeRequest(*client.kind), random(8, 65), random(1, 41));
+            }
+        }
+
+        uint32_t startUs = micros();
+        webPage.doWiFi();
+        maxDoWiFiUs = max(maxDoWiFiUs, (uint32_t) (micros() - startUs));
+
+        host::advanceUs(loopUs);
+    }
+
+    std::sort(latenciesMs.begin(), latenciesMs.end());
+    fprintf(report, "%2u clients:  %3u requests, latency p50 %4lu ms, p90 %4lu ms, p99 %4lu ms, max %4lu ms; "
+            "longest wait for a connection %4lu ms, longest doWiFi %5lu us\n",
+            numClients, (unsigned int) latenciesMs.size(),
+            (unsigned long) percentile(latenciesMs, 50), (unsigned long) percentile(latenciesMs, 90),
+            (unsigned long) percentile(latenciesMs, 99), (unsigned long) latenciesMs.back(),
+            (unsigned long) maxBacklogMs, (unsigned long) maxDoWiFiUs);
+    return ok;
+}
+
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage:  %s numClients...\n", argv[0]);
+        return 2;
+    }
+
+    fflush(stdout);
+    report = fdopen(dup(fileno(stdout)), "w");
+    if (0 == report || 0 == freopen("/dev/null", "w", stdout)) {
+        perror("stdout");
+        return 2;
+    }
+
+    bool ok = true;
+    for (int i = 1; i < argc; ++i) {
+        int numClients = atoi(argv[i]);
+        if (numClients < 1 || numClients > 255) {
+            fprintf(stderr, "usage:  %s numClients...\n", argv[0]);
+            return 2;
+        }
+        ok &= runClients(numClients);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Widget Replay Test                                              *
+ *                                                                 *
+ * Replays a widget packet trace through a lamp controller         *
+ * sketch's WidgetPayloadRouter, route table, and updateLamps(),   *
+ * with the RF24 and DmxSimple stand-ins for the radio and the DMX *
+ * line.  Each packet goes into the radio's receive FIFO at its    *
+ * receive time and is polled from there, and then the lamps are   *
+ * updated as of that time, as ENABLE_PACKET_REPLAY does on the    *
+ * Arduino.  It prints how long the dispatch and the lamp update   *
+ * take per packet and the resulting DMX channels, checks that the *
+ * DMX line matches the DmxUniverse after every update, and checks *
+ * the link stats and channel values that the trace expects.       *
+ *                                                                 *
+ * The sketch is compiled into this test, as SKETCH_INO, so that   *
+ * its router and DMX universe, which are static, can be reached.  *
+ *                                                                 *
+ * usage:  widgetReplayTest trace.txt [-v]                         *
+ *                                                                 *
+ * The trace is WidgetPacketTrace lines ("T rxMs pipeNum hex") and *
+ *   expect widget id [packets n] [bytes n] [sizeMismatches n]     *
+ *          [gaps n] [maxGapMs n] [lastSeenMs n] [packetsPerSec n] *
+ *   expect unrouted n                                             *
+ *   expect channel num min max                                    *
+ * which are checked after the packets before them.  Other lines   *
+ * are skipped.  With -v, each packet gets a line with its times   *
+ * and the DMX channel values.                                     *
+ *                                                                 *
+ *******************************************************************/
+
+#include <Arduino.h>
+#include <WidgetPacketTrace.h>
+#include <chrono>
+
+#include SKETCH_INO
+
+using pixelPattern::WidgetLinkStats;
+using pixelPattern::WidgetTraceReader;
+
+
+// Hands WidgetTraceReader the trace one line at a time.
+class LineStream : public Stream {
+public:
+    void setLine(const char* s) { line = s; }
+    int available() override { return strlen(line); }
+    int read() override { return '\0' == *line ? -1 : *line++; }
+    int peek() override { return '\0' == *line ? -1 : *line; }
+
+private:
+    const char* line = "";
+};
+
+
+static bool verbose = false;
+
+
+static double nsSince(std::chrono::steady_clock::time_point start)
+{
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+
+static bool checkDmxLine(const char* fileName, uint32_t rxMs)
+{
+    for (uint16_t channelNum = 1; channelNum <= dmxUniverse.numChannels; ++channelNum) {
+        if (DmxSimple.channels[channelNum] != dmxUniverse.getChannel(channelNum)) {
+            printf("%s:  %lu ms:  DMX channel %u is %u on the line but %u in the universe\n",
+                   fileName, (unsigned long) rxMs, channelNum,
+                   DmxSimple.channels[channelNum], dmxUniverse.getChannel(channelNum));
+            return false;
+        }
+    }
+    return true;
+}
+
+
+static void printDmxChannels()
+{
+    for (uint16_t channelNum = 1; channelNum <= dmxUniverse.numChannels; ++channelNum) {
+        printf(" %u", DmxSimple.channels[channelNum]);
+    }
+    printf("\n");
+}
+
+
+static bool checkExpectation(const char* fileName, int lineNum, const char* line)
+{
+    unsigned long widgetId, n, min, max;
+    int length;
+
+    if (1 == sscanf(line, "expect widget %lu%n", &widgetId, &length)) {
+        const WidgetLinkStats* stats = widgetRouter.getLinkStats(widgetId);
+        if (0 == stats) {
+            printf("%s:%d:  widget %lu wasn't heard from\n", fileName, lineNum, widgetId);
+            return false;
+        }
+
+        bool ok = true;
+        char name[20];
+        int nameLength;
+        for (const char* p = line + length; 2 == sscanf(p, "%19s %lu%n", name, &n, &nameLength); p += nameLength) {
+            unsigned long actual;
+            if (0 == strcmp(name, "packets")) {
+                actual = stats->numPackets;
+            }
+            else if (0 == strcmp(name, "bytes")) {
+                actual = stats->numBytes;
+            }
+            else if (0 == strcmp(name, "sizeMismatches")) {
+                actual = stats->numSizeMismatches;
+            }
+            else if (0 == strcmp(name, "gaps")) {
+                actual = stats->numGaps;
+            }
+            else if (0 == strcmp(name, "maxGapMs")) {
+                actual = stats->maxGapMs;
+            }
+            else if (0 == strcmp(name, "lastSeenMs")) {
+                actual = stats->lastSeenMs;
+            }
+            else if (0 == strcmp(name, "packetsPerSec")) {
+                actual = stats->packetsPerSec;
+            }
+            else {
+                printf("%s:%d:  can't expect \"%s\"\n", fileName, lineNum, name);
+                return false;
+            }
+
+            if (actual != n) {
+                printf("%s:%d:  widget %lu %s is %lu rather than %lu\n", fileName, lineNum, widgetId, name, actual, n);
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    if (1 == sscanf(line, "expect unrouted %lu", &n)) {
+        if (widgetRouter.numPacketsUnrouted != n) {
+            printf("%s:%d:  %lu packets unrouted rather than %lu\n",
+                   fileName, lineNum, (unsigned long) widgetRouter.numPacketsUnrouted, n);
+            return false;
+        }
+        return true;
+    }
+
+    if (3 == sscanf(line, "expect channel %lu %lu %lu", &n, &min, &max)) {
+        uint8_t value = DmxSimple.channels[n < DmxSimpleClass::dmxSize ? n : 0];
+        if (value < min || value > max) {
+            printf("%s:%d:  DMX channel %lu is %u\n", fileName, lineNum, n, value);
+            return false;
+        }
+        return true;
+    }
+
+    printf("%s:%d:  can't parse \"%.*s\"\n", fileName, lineNum, (int) strcspn(line, "\r\n"), line);
+    return false;
+}
+
+
+static bool replayTrace(const char* fileName)
+{
+    FILE* file = fopen(fileName, "r");
+    if (0 == file) {
+        perror(fileName);
+        return false;
+    }
+
+    setup();
+    if (DmxSimple.maxChannelNum != dmxUniverse.numChannels) {
+        printf("%s:  DmxSimple was set up for %d channels rather than %u\n",
+               fileName, DmxSimple.maxChannelNum, dmxUniverse.numChannels);
+        fclose(file);
+        return false;
+    }
+
+    WidgetTraceReader traceReader;
+    LineStream lineStream;
+    WidgetPacket packet;
+    uint32_t numPackets = 0;
+    double totalPollNs = 0;
+    double totalUpdateLampsNs = 0;
+    double maxPollNs = 0;
+    double maxUpdateLampsNs = 0;
+
+    bool ok = true;
+    char line[200];
+    for (int lineNum = 1; ok && fgets(line, sizeof(line), file); ++lineNum) {
+        if (0 == strncmp(line, "expect ", 7)) {
+            ok = checkExpectation(fileName, lineNum, line);
+            continue;
+        }
+
+        lineStream.setLine(line);
+        if (!traceReader.read(lineStream, &packet)) {
+            continue;
+        }
+
+        if (packet.rxMs < millis()) {
+            printf("%s:%d:  the packets are out of order\n", fileName, lineNum);
+            ok = false;
+            break;
+        }
+        // Captured traces can start hours after the widget booted.
+        while (millis() != packet.rxMs) {
+            host::advanceUs(min(packet.rxMs - millis(), 1000000UL) * 1000);
+        }
+        radio.receive(packet.pipeNum, packet.payload, packet.payloadSize);
+
+        auto start = std::chrono::steady_clock::now();
+        widgetRouter.poll();
+        double pollNs = nsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        updateLamps(millis());
+        double updateLampsNs = nsSince(start);
+
+        ++numPackets;
+        totalPollNs += pollNs;
+        totalUpdateLampsNs += updateLampsNs;
+        maxPollNs = max(maxPollNs, pollNs);
+        maxUpdateLampsNs = max(maxUpdateLampsNs, updateLampsNs);
+
+        if (verbose) {
+            printf("P %lu poll %.0f ns, updateLamps %.0f ns, DMX", (unsigned long) packet.rxMs, pollNs, updateLampsNs);
+            printDmxChannels();
+        }
+
+        ok = checkDmxLine(fileName, packet.rxMs);
+    }
+    fclose(file);
+
+    if (ok && 0 == numPackets) {
+        printf("%s:  no packets\n", fileName);
+        ok = false;
+    }
+    if (ok) {
+        printf("%s:  %lu packets, %lu unrouted; poll %.0f ns (max %.0f), updateLamps %.0f ns (max %.0f) per packet\n",
+               fileName, (unsigned long) numPackets, (unsigned long) widgetRouter.numPacketsUnrouted,
+               totalPollNs / numPackets, maxPollNs, totalUpdateLampsNs / numPackets, maxUpdateLampsNs);
+        printf("%s:  DMX", fileName);
+        printDmxChannels();
+    }
+    return ok;
+}
+
+
+int main(int argc, char** argv)
+{
+    if (argc == 3 && 0 == strcmp(argv[2], "-v")) {
+        verbose = true;
+    }
+    else if (argc != 2) {
+        fprintf(stderr, "usage:  %s trace.txt [-v]\n", argv[0]);
+        return 2;
+    }
+
+    return replayTrace(argv[1]) ? 0 : 1;
+}
@@ -0,0 +1,24 @@
+/*******************************************************************
+ *                                                                 *
+ * Addressable LED Pixel Pattern Framework                         *
+ *                                                                 *
+ * Integer Math Helper Functions                                   *
+ *                                                                 *
+ * by Ross Butler   Dec. 2019                                      *
+ *                                                                 *
+ *******************************************************************/
+
+#ifndef __MATH_HELPERS_H
+#define __MATH_HELPERS_H
+
+#include <stdint.h>
+
+
+namespace pixelPattern {
+
+// Returns the integer square root of value, rounded down.
+uint16_t isqrt32(uint32_t value);
+
+}
+
+#endif  // #ifndef __MATH_HELPERS_H
@@ -20,6 +20,10 @@
 #include "MovingDot.h"
 #include "SplitRotation.h"
 #include "MultiWave.h"
+#include "SoundBands.h"
+#ifdef ESP8266
+#include "StreamedPixels.h"
+#endif
 
 
 namespace pixelPattern {
@@ -43,6 +47,12 @@ static PixelPattern* pixelPatternFactory(uint8_t patternId)
             return new SplitRotation;
         case MultiWave::id:
             return new MultiWave;
+        case SoundBands::id:
+            return new SoundBands;
+#ifdef ESP8266
+        case StreamedPixels::id:
+            return new StreamedPixels;
+#endif
         default:
             // TODO:  We need to return an ErrorPattern object that ignores the config and flashes all pixels a dim red.
             return new SolidColor;
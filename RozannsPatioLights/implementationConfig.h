@@ -47,6 +47,9 @@
 #define NUM_PANELS 1
 #define PANEL_NUM_PIXELS (NUM_PIXELS / NUM_PANELS)
 
+// FG_INTENSITY_SCALE_FACTOR sets the brightness of sparkles.
+#define FG_INTENSITY_SCALE_FACTOR 255
+
 // BG_INTENSITY_SCALE_FACTOR sets the maximum brightness for backgrounds.  It also
 // sets the brightness of the foreground of patterns that aren't doing some sort
 // of flashing or sparkle effect.  Although the range is 0 to 255, practical
@@ -99,6 +102,9 @@
 #define NUM_PANELS 1
 #define PANEL_NUM_PIXELS (NUM_PIXELS / NUM_PANELS)
 
+// FG_INTENSITY_SCALE_FACTOR sets the brightness of sparkles.
+#define FG_INTENSITY_SCALE_FACTOR 255
+
 // BG_INTENSITY_SCALE_FACTOR sets the maximum brightness for backgrounds.  It also
 // sets the brightness of the foreground of patterns that aren't doing some sort
 // of flashing or sparkle effect.  Although the range is 0 to 255, practical
@@ -159,6 +165,9 @@
 #define NUM_PANELS 1
 #define PANEL_NUM_PIXELS (NUM_PIXELS / NUM_PANELS)
 
+// FG_INTENSITY_SCALE_FACTOR sets the brightness of sparkles.
+#define FG_INTENSITY_SCALE_FACTOR 255
+
 // BG_INTENSITY_SCALE_FACTOR sets the maximum brightness for backgrounds.  It also
 // sets the brightness of the foreground of patterns that aren't doing some sort
 // of flashing or sparkle effect.  Although the range is 0 to 255, practical
@@ -210,6 +219,9 @@
 #define NUM_PANELS 1
 #define PANEL_NUM_PIXELS (NUM_PIXELS / NUM_PANELS)
 
+// FG_INTENSITY_SCALE_FACTOR sets the brightness of sparkles.
+#define FG_INTENSITY_SCALE_FACTOR 255
+
 // BG_INTENSITY_SCALE_FACTOR sets the maximum brightness for backgrounds.  It also
 // sets the brightness of the foreground of patterns that aren't doing some sort
 // of flashing or sparkle effect.  Although the range is 0 to 255, practical
@@ -233,14 +245,4 @@
 
 
 
-/**********
- * Common *
- **********/
- 
-#ifdef ENABLE_DMX_AMBIENCE_LIGHTS
-  #define FASTSPI_USE_DMX_SIMPLE
-  #define DMX_SIZE 27
-#endif
-
-
 #endif  // #ifndef __IMPLEMENTATION_CONFIG_H
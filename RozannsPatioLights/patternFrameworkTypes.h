@@ -8,11 +8,12 @@
  *                                                                 *
  *******************************************************************/
 
-#ifndef __PATTERN_FRAMEWORK_TYPES_H
-#define __PATTERN_FRAMEWORK_TYPES_H
+#ifndef __ROZANNS_PATTERN_FRAMEWORK_TYPES_H
+#define __ROZANNS_PATTERN_FRAMEWORK_TYPES_H
 
 
 #include "FastLED.h"
+#include "LegacyPatternSequence.h"
 
 
 // These are the waveforms that can be used in a multiWave pattern.  A good
@@ -153,30 +154,8 @@ struct patternDef {
 };
 
 
-// This structure contains pattern parameter metadata
-// and a pointer to the pattern function.
-typedef struct patternMetadata patternMetadata_t;
-struct patternMetadata {
-  uint8_t paramStructSize;
-  void    (*loopFun)(void*);
-};
-
-
-// The pattern functions are declared here so that we
-// can use them to build the pattern metadata table.
-void rainbow(void* patParams);
-void multiWave(void* patParams);
-void movingDot(void* patParams);
-void sparkle(void* patParams);
-void splitRotation(void* patParams);
-void xmasLights(void* patParams);
-void solidColor(void* patParams);
-void shine(void* patParams);
-void redWhiteAndBlue(void* patParams);
-
-
 // These are the pattern types.  Except for END_OF_AUTO_PATTERNS,
-// the values are indexes into the pattern metadata table.
+// the values are indexes into the legacy pattern type table.
 #define MOVING_DOT             0
 #define MULTI_WAVE             1
 #define RAINBOW                2
@@ -189,23 +168,24 @@ void redWhiteAndBlue(void* patParams);
 #define END_OF_AUTO_PATTERNS 255
 
 
-// Each pattern metadata entry must be in the element
-// position corresponding to its pattern type constant.
-patternMetadata_t patternMetadataTable[] = {
-  {sizeof(movingDotParams_t)    , movingDot},
-  {sizeof(multiWaveParams_t)    , multiWave},
-  {sizeof(rainbowParams_t)      , rainbow},
-  {sizeof(sparkleParams_t)      , sparkle},
-  {sizeof(splitRotationParams_t), splitRotation},
-  {sizeof(xmasLightsParams_t)   , xmasLights},
-  {sizeof(solidColorParams_t)   , solidColor},
-  {sizeof(shineParams_t)        , shine},
-  {sizeof(rwabParams_t)         , redWhiteAndBlue},
+// These are the ways that this sketch's original pattern functions
+// differed from the other sketches' copies.
+#define LEGACY_STYLE (pixelPattern::LegacyStyle::fullHueRainbow)
+
+// Each legacy pattern type entry must be in the element position
+// corresponding to its pattern type constant.  The patterns are drawn
+// by the framework patterns that replaced the original pattern functions.
+const pixelPattern::LegacyPatternType legacyPatternTypes[] = {
+  pixelPattern::legacyMovingDot<movingDotParams_t, LEGACY_STYLE>(),
+  pixelPattern::legacyMultiWave<multiWaveParams_t, LEGACY_STYLE>(),
+  pixelPattern::legacyRainbow<rainbowParams_t, LEGACY_STYLE>(),
+  pixelPattern::legacySparkle<sparkleParams_t, SPARKLE_DELAY, MAX_SPARKLE_DENSITY, LEGACY_STYLE>(),
+  pixelPattern::legacySplitRotation<splitRotationParams_t>(),
+  pixelPattern::legacyXmasLights<xmasLightsParams_t>(),
+  pixelPattern::legacySolidColor<solidColorParams_t, LEGACY_STYLE>(),
+  pixelPattern::legacyShine<shineParams_t>(),
+  pixelPattern::legacyRedWhiteAndBlue<rwabParams_t>(),
 };
 
 
-// the size of the buffer used when copying pattern parameters from flash to RAM
-#define PAT_PARAMS_BUF_SIZE 32
-
-
-#endif  // #ifndef __PATTERN_FRAMEWORK_TYPES_H
+#endif  // #ifndef __ROZANNS_PATTERN_FRAMEWORK_TYPES_H
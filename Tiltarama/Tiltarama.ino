@@ -19,6 +19,7 @@
 //#define PLOT_YAW_PITCH_ROLL
 //#define PLOT_REAL_ACCELERATION
 //#define PLOT_GYRO
+//#define ENABLE_TELEMETRY
 //#define ENABLE_DMX
 
 #if defined(ENABLE_LCD_16x2) || defined(ENABLE_LCD_20x4)
@@ -32,6 +33,12 @@
 // To view the plots, run arduino-plotter/listener/listener.pde in Processing.
 // The serial plotter tool built into the Arduino IDE will show only one value.
 
+// Telemetry sends every DMP packet's measurements as binary frames.  To
+// turn them into CSV, run PixelPatternFramework/telemetry/decodeTelemetry.
+#if defined(ENABLE_TELEMETRY) && (defined(ENABLE_PLOTTING) || defined(ENABLE_DEBUG_PRINT))
+  #error "Telemetry needs the serial port to itself.  Disable plotting and debug printing."
+#endif
+
 
 /************
  * Includes *
@@ -43,6 +50,12 @@
 
 #include "I2Cdev.h"
 #include "MPU6050_6Axis_MotionApps20.h"
+#include "DmpMotion.h"
+#include "FixedPointFormat.h"
+#include "MpuFifoReader.h"
+#include "MpuMotionActivity.h"
+#include "SensorFilters.h"
+#include "TelemetryWriter.h"
 // Arduino Wire library is required if I2Cdev I2CDEV_ARDUINO_WIRE implementation
 // is used in I2Cdev.h
 #if I2CDEV_IMPLEMENTATION == I2CDEV_ARDUINO_WIRE
@@ -51,6 +64,7 @@
 
 #ifdef ENABLE_LCD
 #include <LiquidCrystal.h>
+#include "LcdFrame.h"
 #endif
 
 #ifdef ENABLE_PLOTTING
@@ -62,17 +76,6 @@
 #endif
 
 
-/****************************
- * Constants and Data Types *
- ****************************/
-
-enum class MpuMode {
-  init,
-  cycle,
-  normal
-};
-
-
 /*****************
  * Configuration *
  *****************/
@@ -82,22 +85,28 @@ enum class MpuMode {
 #define TEMPERATURE_SAMPLE_INTERVAL_MS 500L
 #define DMX_TX_INTERVAL_MS 33L
 
-// There must be at least YPR_MOTION_CHANGE_THRESHOLD tenths of a degree
-// motion in yaw, pitch, or roll every MOTION_TIMEOUT_MS ms to keep us
-// out of standby mode.
+// In standby mode, the MPU wakes up when it sees MOTION_WAKE_THRESHOLD
+// (unit is 2mg) for MOTION_WAKE_DURATION_MS ms.  After that, there must
+// be more than YPR_MOTION_CHANGE_THRESHOLD tenths of a degree motion in
+// yaw, pitch, or roll within MOTION_CONFIRM_TIMEOUT_MS ms, then every
+// MOTION_TIMEOUT_MS ms, to keep us out of standby mode.
+#define MOTION_WAKE_THRESHOLD 1
+#define MOTION_WAKE_DURATION_MS 1
+#define MOTION_WAKE_FREQUENCY 0     // 0 = 1.25 Hz, 1 = 2.5 Hz, 2 = 5 Hz, 3 = 10 Hz
+#define MOTION_CONFIRM_TIMEOUT_MS 1000L
 #define MOTION_TIMEOUT_MS 5000L
 #define YPR_MOTION_CHANGE_THRESHOLD 1
 
 #define IMU_INTERRUPT_PIN 2
 
 #define NUM_MPU_VALUES_TO_SEND 9
-#define MA_LENGTH 8
+#define MA_LENGTH_SHIFT 3   // moving averages are over 2^MA_LENGTH_SHIFT values
 #define NUM_MA_SETS (NUM_MPU_VALUES_TO_SEND)
 
-// When we haven't retrieved packets from the MPU6050's DMP's FIFO fast enough,
-// data corruption becomes likely even before the FIFO overflows.  We'll clear
-// the FIFO when more than maxPacketsInFifoBeforeForcedClear packets are in it.
-constexpr uint8_t maxPacketsInFifoBeforeForcedClear = 2;
+// Whole packets waiting in the MPU6050's DMP's FIFO are read in one burst of
+// up to maxMpuPacketsPerRead packets, enough to ride out a slow LCD update.
+// Older packets than that are dropped.
+constexpr uint8_t maxMpuPacketsPerRead = 4;
 
 #define PLOT_NUM_POINTS 500
 #define PLOT_Z_COLOR "orange"
@@ -105,6 +114,11 @@ constexpr uint8_t maxPacketsInFifoBeforeForcedClear = 2;
 #define PLOT_X_COLOR "cyan"
 
 constexpr double countsPerG = 8192.0;
+constexpr int32_t countsPerGInt = 8192;
+
+#define TELEMETRY_TX_BUFFER_SIZE 128
+#define TELEMETRY_MOTION_SCHEMA_ID 1
+#define TELEMETRY_TEMPERATURE_SCHEMA_ID 2
 
 #define LCD_RS A1
 #define LCD_E  A0
@@ -113,6 +127,19 @@ constexpr double countsPerG = 8192.0;
 #define LCD_D6  7
 #define LCD_D7  8
 
+#if defined(ENABLE_LCD_16x2)
+#define LCD_NUM_COLS 20
+#define LCD_NUM_ROWS 2
+#elif defined(ENABLE_LCD_20x4)
+#define LCD_NUM_COLS 20
+#define LCD_NUM_ROWS 4
+#endif
+
+// Only changed characters are sent to the LCD, and no more than fit in
+// LCD_REFRESH_BUDGET_US each time through loop, so that a display update
+// doesn't hold up reading the MPU6050's FIFO.
+#define LCD_REFRESH_BUDGET_US 300
+
 #define DMX_OUTPUT_PIN 3
 
 #define DMX_NUM_CHANNELS 8
@@ -122,40 +149,39 @@ constexpr double countsPerG = 8192.0;
  * Globals *
  ***********/
 
-// standby/active control
-static MpuMode mpuMode = MpuMode::init;
-static uint32_t lastMotionDetectedMs;
-
 // moving average variables
-static int16_t maValues[NUM_MA_SETS][MA_LENGTH];
-static int32_t maSums[NUM_MA_SETS];
-static uint8_t maNextSlotIdx[NUM_MA_SETS];
-static bool maSetFull[NUM_MA_SETS];
+using pixelPattern::BoxcarFilterBank;
+static BoxcarFilterBank<NUM_MA_SETS, MA_LENGTH_SHIFT> movingAverages;
 
 static MPU6050 mpu;               // using default I2C address 0x68
 
 // MPU control/status vars
 static bool dmpReady = false;     // set true if DMP init was successful
-static uint16_t packetSize;       // expected DMP packet size (default is 42 bytes)
-static uint8_t packetBuffer[42];  // must be at least as large as packet size returned by dmpGetFIFOPacketSize
+using pixelPattern::MpuFifoReader;
+static MpuFifoReader mpuFifoReader(mpu, maxMpuPacketsPerRead);
+
+// standby/active control
+using pixelPattern::MpuMotionActivity;
+static MpuMotionActivity motionActivity(mpu, mpuFifoReader, {
+  MOTION_WAKE_THRESHOLD,
+  MOTION_WAKE_DURATION_MS,
+  MOTION_WAKE_FREQUENCY,
+  YPR_MOTION_CHANGE_THRESHOLD,
+  MOTION_CONFIRM_TIMEOUT_MS,
+  MOTION_TIMEOUT_MS});
 
 // orientation/motion vars
-static Quaternion quat;           // [w, x, y, z] quaternion container
-static VectorFloat gravity;       // [x, y, z] gravity vector
-static float ypr[3];              // [yaw, pitch, roll] yaw/pitch/roll container
-static VectorInt16 aa;            // [x, y, z] accel sensor measurements
-static VectorInt16 aaReal;        // [x, y, z] gravity-free accel sensor measurements
-static int16_t rawAccel[3];
-static int16_t gyro[3];
-static float mpuTemperatureC;
-static float mpuTemperatureF;
+using pixelPattern::DmpMotion;
+using pixelPattern::getDmpMotion;
+static DmpMotion dmpMotion;       // quaternion, gravity, ypr, accel, and gyro from the latest packet
+static int16_t mpuTemperatureTenthsC;
+static int16_t mpuTemperatureTenthsF;
 
 static volatile bool gotMpuInterrupt;
 
 // stuff for Plotter
 #ifdef ENABLE_PLOTTING
 static Plotter p;
-#endif
 static double plotYaw;
 static double plotPitch;
 static double plotRoll;
@@ -165,9 +191,19 @@ static double plotRealAccelZ;
 static double plotGyroX;
 static double plotGyroY;
 static double plotGyroZ;
+#endif
 
 #ifdef ENABLE_LCD
 static LiquidCrystal lcd(LCD_RS, LCD_E, LCD_D4, LCD_D5, LCD_D6, LCD_D7);
+using pixelPattern::LcdFrame;
+static LcdFrame lcdFrame(lcd, LCD_NUM_COLS, LCD_NUM_ROWS);
+#endif
+
+using pixelPattern::printFixedPoint;
+
+#ifdef ENABLE_TELEMETRY
+using pixelPattern::TelemetryWriter;
+static TelemetryWriter telemetry(Serial, TELEMETRY_TX_BUFFER_SIZE);
 #endif
 
 
@@ -181,48 +217,6 @@ void handleMpuInterrupt() {
 }
 
 
-void setMpuMode(MpuMode newMode, uint32_t now)
-{
-  switch (newMode)
-  {
-    case MpuMode::cycle:
-#ifdef ENABLE_DEBUG_PRINT
-      Serial.println(F("Setting mpuMode to cycle..."));
-#endif
-      mpu.setDMPEnabled(false);
-      // TODO:  motion detection should be configurable
-      // Set up motion detection.
-      mpu.setMotionDetectionThreshold(1);         // unit is 2mg
-      mpu.setMotionDetectionCounterDecrement(1);
-      mpu.setMotionDetectionDuration(1);          // unit is ms
-      // Put MPU-6050 in cycle mode.
-      mpuMode = MpuMode::cycle;
-      mpu.setWakeFrequency(0);                    // 0 = 1.25 Hz, 1 = 2.5 Hz, 2 - 5 Hz, 3 = 10 Hz
-      mpu.setWakeCycleEnabled(true);
-      mpu.setIntMotionEnabled(true);
-      break;
-
-    case MpuMode::normal:
-#ifdef ENABLE_DEBUG_PRINT
-      Serial.println(F("Setting mpuMode to normal..."));
-#endif
-      mpu.setIntMotionEnabled(false);
-      mpu.setWakeCycleEnabled(false);
-      clearMovingAverages();
-      mpuMode = MpuMode::normal;
-      mpu.setDMPEnabled(true);
-      lastMotionDetectedMs = now;
-      break;
-
-    default:
-#ifdef ENABLE_DEBUG_PRINT
-      Serial.println(F("*** Invalid newMode in setMpuMode"));
-#endif
-      break;
-  }
-}
-
-
 void initI2c()
 {
 #if I2CDEV_IMPLEMENTATION == I2CDEV_ARDUINO_WIRE
@@ -270,21 +264,16 @@ void initMpu()
 #endif
       attachInterrupt(digitalPinToInterrupt(IMU_INTERRUPT_PIN), handleMpuInterrupt, RISING);
 
-      // Get expected DMP packet size, and make sure packetBuffer is large enough.
-      packetSize = mpu.dmpGetFIFOPacketSize();
-      if (sizeof(packetBuffer) >= packetSize) {
+      if (mpuFifoReader.begin(mpu.dmpGetFIFOPacketSize())) {
 #ifdef ENABLE_DEBUG_PRINT
         Serial.println(F("DMP ready."));
 #endif
         dmpReady = true;
 
-        setMpuMode(MpuMode::cycle, millis());
+        motionActivity.begin(millis());
       }
       else {
-        Serial.print(F("*** FIFO packet size "));
-        Serial.print(packetSize);
-        Serial.print(F(" is larger than packetBuffer size "));
-        Serial.println(sizeof(packetBuffer));
+        Serial.println(F("*** Couldn't allocate the FIFO packet buffer."));
       }
     }
     else {
@@ -307,10 +296,8 @@ void initMpu()
 
 void initLcd()
 {
-#if defined(ENABLE_LCD_16x2)
-  lcd.begin(20, 2);
-#elif defined(ENABLE_LCD_20x4)
-  lcd.begin(20, 4);
+#ifdef ENABLE_LCD
+  lcdFrame.begin();
 #endif
 }
 
@@ -344,6 +331,17 @@ void initPlotting()
 }
 
 
+void initTelemetry()
+{
+#ifdef ENABLE_TELEMETRY
+  telemetry.begin();
+  telemetry.addSchema(TELEMETRY_MOTION_SCHEMA_ID,
+                      F("motion:yaw/10,pitch/10,roll/10,ax/8192,ay/8192,az/8192,gx,gy,gz"));
+  telemetry.addSchema(TELEMETRY_TEMPERATURE_SCHEMA_ID, F("temperature:tempC/10,tempF/10"));
+#endif
+}
+
+
 void initDmx()
 {
 #ifdef ENABLE_DMX
@@ -355,7 +353,7 @@ void initDmx()
 
 void setup()
 {
-#if defined(ENABLE_DEBUG_PRINT) || defined(ENABLE_PLOTTING)
+#if defined(ENABLE_DEBUG_PRINT) || defined(ENABLE_PLOTTING) || defined(ENABLE_TELEMETRY)
   Serial.begin(115200);
 #endif
 
@@ -363,6 +361,7 @@ void setup()
   initMpu();
   initLcd();
   initPlotting();
+  initTelemetry();
   initDmx();
 
   // Communication with the MPU6050 has proven to be problematic.
@@ -374,138 +373,40 @@ void setup()
 }
 
 
-void clearMovingAverages()
-{
-  for (uint8_t i = 0; i < NUM_MA_SETS; ++i) {
-    for (uint8_t j = 0; j < MA_LENGTH; ++j) {
-      maValues[i][j] = 0;
-    }
-    maSums[i] = 0;
-    maNextSlotIdx[i] = 0;
-    maSetFull[i] = false;
-  }
-}
-
-
-void updateMovingAverage(uint8_t setIdx, int16_t newValue)
+void gatherMotionMeasurements(uint8_t numPackets, uint32_t now)
 {
-  maSums[setIdx] -= maValues[setIdx][maNextSlotIdx[setIdx]];
-  maSums[setIdx] += newValue;
-  maValues[setIdx][maNextSlotIdx[setIdx]] = newValue;
-
-  ++maNextSlotIdx[setIdx];
-  if (maNextSlotIdx[setIdx] >= MA_LENGTH) {
-     maSetFull[setIdx] = true;
-     maNextSlotIdx[setIdx] = 0;
-  }
-}
-
-
-int16_t getMovingAverage(uint8_t setIdx)
-{
-  int32_t avg;
-  if (maSetFull[setIdx]) {
-    avg = maSums[setIdx] / (int32_t) MA_LENGTH;
-  }
-  else {
-    avg = maNextSlotIdx[setIdx] > 0 ? (int32_t) maSums[setIdx] / (int32_t) maNextSlotIdx[setIdx] : 0;
-  }
-
-//#ifdef ENABLE_DEBUG_PRINT
-//  Serial.print("getMovingAverage(");
-//  Serial.print(setIdx);
-//  Serial.print("):  ");
-//  for (uint8_t i = 0; i < (maSetFull[setIdx] ? MA_LENGTH : maNextSlotIdx[setIdx]); ++i) {
-//    Serial.print(i);
-//    Serial.print(":");
-//    Serial.print(maValues[setIdx][i]);
-//    Serial.print("  ");
-//  }
-//  Serial.print(maSums[setIdx]);
-//  Serial.print("  ");
-//  Serial.println(avg);
-//#endif
-
-  return avg;
-}
-
-
-bool detectMovingAverageChange(uint8_t setIdx, int16_t threshold)
-{
-  uint8_t latestSlotIdx;
-  if (maNextSlotIdx[setIdx] == 0) {
-    if (!maSetFull[setIdx]) {
-      return false;
-    }
-    latestSlotIdx = MA_LENGTH - 1;
-  }
-  else {
-    latestSlotIdx = maNextSlotIdx[setIdx] - 1;
-  }
-  int16_t diff = maValues[setIdx][maNextSlotIdx[setIdx]] - maValues[setIdx][latestSlotIdx];
-  return abs(diff) > threshold ? true : false;
-}
-
-
-void clearMpuFifo()
-{
-#ifdef ENABLE_DEBUG_PRINT
-  Serial.println(F("Clearing FIFO..."));
-#endif
-
-  uint16_t fifoCount = mpu.getFIFOCount();
-  while (fifoCount != 0) {
-    uint8_t readLength = fifoCount >= packetSize ? packetSize : fifoCount;
-    mpu.getFIFOBytes(packetBuffer, readLength);
-    //fifoCount = mpu.getFIFOCount();
-    fifoCount -= readLength;
-  }
-
-#ifdef ENABLE_DEBUG_PRINT
-    Serial.println(F("Cleared FIFO."));
-#endif
-}
-
-
-void gatherMotionMeasurements(uint32_t now)
-{
-  uint16_t fifoCount = mpu.getFIFOCount();
-  while (fifoCount >= packetSize) {
-    mpu.getFIFOBytes(packetBuffer, packetSize);
-    fifoCount -= packetSize;
-
-//#ifdef ENABLE_DEBUG_PRINT
-//    // Careful:  We might not be able to keep up if this debug print is enabled.
-//    Serial.print(F("Got packet from fifo.  fifoCount now "));
-//    Serial.println(fifoCount);
-//#endif
-
-    mpu.dmpGetGyro(gyro, packetBuffer);
-    mpu.dmpGetQuaternion(&quat, packetBuffer);
-    mpu.dmpGetGravity(&gravity, &quat);
-    mpu.dmpGetYawPitchRoll(ypr, &quat, &gravity);
-    mpu.dmpGetAccel(&aa, packetBuffer);
-    mpu.dmpGetLinearAccel(&aaReal, &aa, &gravity);
-
-    updateMovingAverage(0, ypr[0] * (float) 1800 / M_PI);
-    updateMovingAverage(1, ypr[1] * (float) 1800 / M_PI);
-    updateMovingAverage(2, ypr[2] * (float) 1800 / M_PI);
-    updateMovingAverage(3, aaReal.x);
-    updateMovingAverage(4, aaReal.y);
-    updateMovingAverage(5, aaReal.z);
-//    updateMovingAverage(3, aa.x);
-//    updateMovingAverage(4, aa.y);
-//    updateMovingAverage(5, aa.z);
-    updateMovingAverage(6, gyro[0]);
-    updateMovingAverage(7, gyro[1]);
-    updateMovingAverage(8, gyro[2]);
+  for (uint8_t packetIdx = 0; packetIdx < numPackets; ++packetIdx) {
+    const uint8_t* packetBuffer = mpuFifoReader.getPacket(packetIdx);
+
+    getDmpMotion(packetBuffer, &dmpMotion);
+
+#ifdef ENABLE_TELEMETRY
+    int16_t telemetryFields[9] = {
+      dmpMotion.yprTenths[0], dmpMotion.yprTenths[1], dmpMotion.yprTenths[2],
+      dmpMotion.linearAccel[0], dmpMotion.linearAccel[1], dmpMotion.linearAccel[2],
+      dmpMotion.gyro[0], dmpMotion.gyro[1], dmpMotion.gyro[2]};
+    telemetry.sendRecord(TELEMETRY_MOTION_SCHEMA_ID, telemetryFields, 9);
+#endif
+
+    movingAverages.update(0, dmpMotion.yprTenths[0]);
+    movingAverages.update(1, dmpMotion.yprTenths[1]);
+    movingAverages.update(2, dmpMotion.yprTenths[2]);
+    movingAverages.update(3, dmpMotion.linearAccel[0]);
+    movingAverages.update(4, dmpMotion.linearAccel[1]);
+    movingAverages.update(5, dmpMotion.linearAccel[2]);
+//    movingAverages.update(3, dmpMotion.accel[0]);
+//    movingAverages.update(4, dmpMotion.accel[1]);
+//    movingAverages.update(5, dmpMotion.accel[2]);
+    movingAverages.update(6, dmpMotion.gyro[0]);
+    movingAverages.update(7, dmpMotion.gyro[1]);
+    movingAverages.update(8, dmpMotion.gyro[2]);
 
 #ifdef ENABLE_WATCHDOG
     // If we're here and we got non-zero data, communication
     // with the MPU6050 is probably working, so kick the dog.
     bool gotNonzeroData = false;
     for (uint8_t i = 0; i < 3; ++i) {
-      if (ypr[i] > 0.001 || gyro[i] != 0) {
+      if (dmpMotion.yprTenths[i] != 0 || dmpMotion.gyro[i] != 0) {
         gotNonzeroData = true;
         break;
       }
@@ -516,33 +417,35 @@ void gatherMotionMeasurements(uint32_t now)
 #endif
 
   // If there was sufficient motion, keep us out of standby mode for now.
+  uint16_t maxYprChange = 0;
   for (uint8_t i = 0; i <= 2; ++i) {
-    if (detectMovingAverageChange(i, YPR_MOTION_CHANGE_THRESHOLD)) {
-      lastMotionDetectedMs = now;
-      break;
+    uint16_t change = abs(movingAverages.getChange(i));
+    if (change > maxYprChange) {
+      maxYprChange = change;
     }
   }
+  motionActivity.reportActivity(maxYprChange, now);
 
 //#ifdef ENABLE_DEBUG_PRINT
 //      // Careful:  We might not be able to keep up if this debug print is enabled.
-//    Serial.print("ypr:  ");
-//    Serial.print(ypr[0]);
+//    Serial.print("yprTenths:  ");
+//    Serial.print(dmpMotion.yprTenths[0]);
 //    Serial.print(", ");
-//    Serial.print(ypr[1]);
+//    Serial.print(dmpMotion.yprTenths[1]);
 //    Serial.print(", ");
-//    Serial.print(ypr[2]);
-//    Serial.print("    aaReal:  ");
-//    Serial.print(aaReal.x);
+//    Serial.print(dmpMotion.yprTenths[2]);
+//    Serial.print("    linearAccel:  ");
+//    Serial.print(dmpMotion.linearAccel[0]);
 //    Serial.print(", ");
-//    Serial.print(aaReal.y);
+//    Serial.print(dmpMotion.linearAccel[1]);
 //    Serial.print(", ");
-//    Serial.print(aaReal.z);
+//    Serial.print(dmpMotion.linearAccel[2]);
 //    Serial.print("    gyro:  ");
-//    Serial.print(gyro[0]);
+//    Serial.print(dmpMotion.gyro[0]);
 //    Serial.print(", ");
-//    Serial.print(gyro[1]);
+//    Serial.print(dmpMotion.gyro[1]);
 //    Serial.print(", ");
-//    Serial.println(gyro[2]);
+//    Serial.println(dmpMotion.gyro[2]);
 //#endif
   }
 }
@@ -551,16 +454,20 @@ void gatherMotionMeasurements(uint32_t now)
 void gatherTemperatureMeasurement()
 {
   int16_t rawTemperature = mpu.getTemperature();
-  mpuTemperatureC = (float) rawTemperature / 340.0 + 36.53;
-  mpuTemperatureF = mpuTemperatureC * 9.0/5.0 + 32.0;
+  // degrees C = raw / 340 + 36.53, and degrees F = raw * 9 / 1700 + 97.754,
+  // both rounded to tenths
+  mpuTemperatureTenthsC = ((int32_t) rawTemperature * 10 + 124202 + 170) / 340;
+  mpuTemperatureTenthsF = ((int32_t) rawTemperature * 90 + 1661818 + 850) / 1700;
+
+#ifdef ENABLE_TELEMETRY
+  int16_t telemetryFields[2] = {mpuTemperatureTenthsC, mpuTemperatureTenthsF};
+  telemetry.sendRecord(TELEMETRY_TEMPERATURE_SCHEMA_ID, telemetryFields, 2);
+#endif
 }
 
 
 void processMpuInterrupt(uint32_t now)
 {
-  static bool needClearMpuFifo;
-  uint16_t fifoCount;
-
   uint8_t mpuIntStatus = mpu.getIntStatus();
 //#ifdef ENABLE_DEBUG_PRINT
 //  Serial.print("0x");
@@ -576,107 +483,34 @@ void processMpuInterrupt(uint32_t now)
     return;
   }
 
-  switch (mpuMode)
-  {
-    case MpuMode::init:
-      // Don't do anything because the MPU isn't ready yet.
-      break;
-
-    case MpuMode::cycle:
-      if (mpuIntStatus & 0x40) {
-        setMpuMode(MpuMode::normal, now);
-        clearMpuFifo();
-      }
-      break;
-
-    case MpuMode::normal:
-
-      fifoCount = mpu.getFIFOCount();
-
-      // Check if FIFO overflowed.  If it did, clear it, then wait for another
-      // data-ready interrupt and clear the FIFO again so that we are back in
-      // sync (i.e., any partial packets have been cleared out).  Based on some
-      // brief testing, it appears that bits 0 and 1 always appear set together.
-      if (mpuIntStatus & 0x10) {
-#ifdef ENABLE_DEBUG_PRINT
-        Serial.print(F("*** FIFO overflow!  fifoCount is "));
-        Serial.println(fifoCount);
-#endif
-        clearMpuFifo();
-        needClearMpuFifo = true;    // clear it again after next interrupt to get in sync
-        return;
-      }
-
-      // The MPU6050 register map document says that bit 0 indicates data ready and bit 1
-      // is reserved.  However, the I2C data analyzer dump from Jeff Rowberg found at
-      // https://www.i2cdevlib.com/tools/analyzer/1 shows that bit 0 indicates raw data
-      // ready and bit 1 indicates DMP data ready.
-      if (!(mpuIntStatus & 0x02)) {
+  // MpuMotionActivity wakes the DMP up on motion, and MpuFifoReader
+  // takes care of FIFO overflows and partial packets.
+  uint8_t numPackets = motionActivity.processInterrupt(mpuIntStatus, now);
+  if (motionActivity.checkModeChange() && motionActivity.getIsActive()) {
 #ifdef ENABLE_DEBUG_PRINT
-        Serial.print(F("Got interrupt but not for data ready.  mpuIntStatus=0x"));
-        Serial.print((int) mpuIntStatus, HEX);
-        Serial.print(F(", fifoCount="));
-        Serial.println(fifoCount);
+    Serial.println(F("Woke up on motion."));
 #endif
-        return;
-      }
-
-      if (needClearMpuFifo) {
-        needClearMpuFifo = false;
-        clearMpuFifo();
-        return;
-      }
-
-      // If we've missed retrieving more than a few packets in time, the FIFO has
-      // probably already overflowed (even though we haven't gotten that interrupt)
-      // or otherwise become corrupted.  We need to reset it to avoid getting bad data.
-      if (fifoCount > packetSize * maxPacketsInFifoBeforeForcedClear) {
-#ifdef ENABLE_DEBUG_PRINT
-        Serial.print(F("*** Missed too many packets.  fifoCount="));
-        Serial.println(fifoCount);
-#endif
-        clearMpuFifo();
-        return;
-      }
-
-      // If the FIFO length is not a multiple of the packet size, there is a partial
-      // packet in the FIFO, either due to the FIFO being filled right now or due to some
-      // sort of FIFO corruption.  We need to clear the FIFO to avoid getting bad data.
-      if (fifoCount % packetSize != 0) {
-#ifdef ENABLE_DEBUG_PRINT
-        Serial.print(F("////////// *** Partial packet in FIFO.  fifoCount="));
-        Serial.println(fifoCount);
-#endif
-        clearMpuFifo();
-        needClearMpuFifo = true;    // clear it again after next interrupt to get in sync
-        return;
-      }
-
-//#ifdef ENABLE_DEBUG_PRINT
-//      Serial.print(F("Got data ready interrupt 0x"));
-//      Serial.print((int) mpuIntStatus, HEX);
-//      Serial.print(F(", fifoCount="));
-//      Serial.println(fifoCount);
-//#endif
-      gatherMotionMeasurements(now);
-      break;
+    movingAverages.clear();
   }
+  gatherMotionMeasurements(numPackets, now);
 }
 
 
 void sendMeasurements()
 {
-  plotYaw = getMovingAverage(0) / 10.0;
-  plotPitch = getMovingAverage(1) / 10.0;
-  plotRoll = getMovingAverage(2) / 10.0;
-  plotRealAccelX = getMovingAverage(3) / countsPerG;
-  plotRealAccelY = getMovingAverage(4) / countsPerG;
-  plotRealAccelZ = getMovingAverage(5) / countsPerG;
-  plotGyroX = getMovingAverage(6);
-  plotGyroY = getMovingAverage(7);
-  plotGyroZ = getMovingAverage(8);
+  // The yaw, pitch, and roll averages and the temperatures are all in
+  // tenths of a degree, so only the plotter needs floating point.
 
 #ifdef ENABLE_PLOTTING
+  plotYaw = movingAverages.get(0) / 10.0;
+  plotPitch = movingAverages.get(1) / 10.0;
+  plotRoll = movingAverages.get(2) / 10.0;
+  plotRealAccelX = movingAverages.get(3) / countsPerG;
+  plotRealAccelY = movingAverages.get(4) / countsPerG;
+  plotRealAccelZ = movingAverages.get(5) / countsPerG;
+  plotGyroX = movingAverages.get(6);
+  plotGyroY = movingAverages.get(7);
+  plotGyroZ = movingAverages.get(8);
   p.Plot();
 #endif
 
@@ -685,46 +519,50 @@ void sendMeasurements()
   // -ddd.d-dd.d-dd.d
   // -dddd-dddd-dddd
   // ddd.dxC  ddd.dxF
-  char buf[17];
-  lcd.setCursor(0, 0);
-  lcd.print(dtostrf(plotYaw, 6, 1, buf));
-  lcd.print(dtostrf(plotPitch, 5, 1, buf));
-  lcd.print(dtostrf(plotRoll, 5, 1, buf));
-  lcd.setCursor(0, 1);
+  lcdFrame.setCursor(0, 0);
+  printFixedPoint(lcdFrame, movingAverages.get(0), 1, 6);
+  printFixedPoint(lcdFrame, movingAverages.get(1), 1, 5);
+  printFixedPoint(lcdFrame, movingAverages.get(2), 1, 5);
+  lcdFrame.setCursor(0, 1);
 //  // Display real acceleration as raw count values / 100.
-//  sprintf(buf, "% 4d% 4d% 4d", getMovingAverage(3) / 100, getMovingAverage(4) / 100, getMovingAverage(5) / 100);
-//  lcd.print(buf);
-  lcd.print(dtostrf(mpuTemperatureC, 5, 1, buf));
-  lcd.print((char) 223);    // degree symbol
-  lcd.print("C  ");
-  lcd.print(dtostrf(mpuTemperatureF, 5, 1, buf));
-  lcd.print((char) 223);    // degree symbol
-  lcd.print("F");
+//  printFixedPoint(lcdFrame, movingAverages.get(3) / 100, 0, 5);
+//  printFixedPoint(lcdFrame, movingAverages.get(4) / 100, 0, 5);
+//  printFixedPoint(lcdFrame, movingAverages.get(5) / 100, 0, 5);
+  printFixedPoint(lcdFrame, mpuTemperatureTenthsC, 1, 5);
+  lcdFrame.print((char) 223);    // degree symbol
+  lcdFrame.print("C  ");
+  printFixedPoint(lcdFrame, mpuTemperatureTenthsF, 1, 5);
+  lcdFrame.print((char) 223);    // degree symbol
+  lcdFrame.print("F");
 #endif
 
 #ifdef ENABLE_DEBUG_PRINT
   Serial.print(F("yaw="));
-  Serial.print(plotYaw);
+  printFixedPoint(Serial, movingAverages.get(0), 1);
   Serial.print(F(" pitch="));
-  Serial.print(plotPitch);
+  printFixedPoint(Serial, movingAverages.get(1), 1);
   Serial.print(F(" roll="));
-  Serial.print(plotRoll);
+  printFixedPoint(Serial, movingAverages.get(2), 1);
+  // real acceleration in hundredths of a g
   Serial.print(F("   realAccelX="));
-  Serial.print(plotRealAccelX);
+  printFixedPoint(Serial, (int32_t) movingAverages.get(3) * 100 / countsPerGInt, 2);
   Serial.print(F(" realAccelY="));
-  Serial.print(plotRealAccelY);
+  printFixedPoint(Serial, (int32_t) movingAverages.get(4) * 100 / countsPerGInt, 2);
   Serial.print(F(" realAccelZ="));
-  Serial.print(plotRealAccelZ);
+  printFixedPoint(Serial, (int32_t) movingAverages.get(5) * 100 / countsPerGInt, 2);
   Serial.print(F("   gyroX="));
-  Serial.print(plotGyroX);
+  Serial.print(movingAverages.get(6));
   Serial.print(F(" gyroY="));
-  Serial.print(plotGyroY);
+  Serial.print(movingAverages.get(7));
   Serial.print(F(" gyroZ="));
-  Serial.print(plotGyroZ);
+  Serial.print(movingAverages.get(8));
   Serial.print(F("   tempC="));
-  Serial.print(mpuTemperatureC);
+  printFixedPoint(Serial, mpuTemperatureTenthsC, 1);
   Serial.print(F(" tempF="));
-  Serial.println(mpuTemperatureF);
+  printFixedPoint(Serial, mpuTemperatureTenthsF, 1);
+  Serial.println();
+  mpuFifoReader.printStats(Serial);
+  motionActivity.printStats(Serial, millis());
 #endif
 }
 
@@ -741,7 +579,7 @@ void sendDmx()
   }
 
   // Normalize roll to 0-180 degrees.
-  float roll = getMovingAverage(2) / 10.0 + 90.0;
+  float roll = movingAverages.get(2) / 10.0 + 90.0;
 
   int section = floor(roll / channelAngleStep);
   // Fix up section if measurement is 180 degrees or more.
@@ -782,7 +620,7 @@ void loop()
 #ifdef ENABLE_WATCHDOG
   // We don't get data periodically from the MPU when it
   // is in cycle mode, so we need to kick the dog here.
-  if (mpuMode == MpuMode::cycle) {
+  if (motionActivity.getIsIdle()) {
     wdt_reset();
   }
 #endif
@@ -792,7 +630,7 @@ void loop()
     gatherTemperatureMeasurement();
   }
 
-  if (now - lastDisplayTxMs >= (mpuMode == MpuMode::cycle ? STANDBY_DISPLAY_TX_INTERVAL_MS : ACTIVE_DISPLAY_TX_INTERVAL_MS)) {
+  if (now - lastDisplayTxMs >= (motionActivity.getIsActive() ? ACTIVE_DISPLAY_TX_INTERVAL_MS : STANDBY_DISPLAY_TX_INTERVAL_MS)) {
     lastDisplayTxMs = now;
     sendMeasurements();
   }
@@ -802,14 +640,20 @@ void loop()
     sendDmx();
   }
 
-  if (mpuMode == MpuMode::normal && now - lastMotionDetectedMs >= MOTION_TIMEOUT_MS) {
-#ifdef ENABLE_DEBUG_PRINT
-    Serial.print(F("Going standby because no motion from "));
-    Serial.print(lastMotionDetectedMs);
-    Serial.print(F(" to "));
-    Serial.println(now);
+#ifdef ENABLE_LCD
+  lcdFrame.refresh(LCD_REFRESH_BUDGET_US);
+#endif
+
+#ifdef ENABLE_TELEMETRY
+  telemetry.pump();
 #endif
-    setMpuMode(MpuMode::cycle, now);
+
+  motionActivity.update(now);
+#ifdef ENABLE_DEBUG_PRINT
+  if (motionActivity.checkModeChange() && !motionActivity.getIsActive()) {
+    Serial.print(F("Going standby because no motion since "));
+    Serial.println(motionActivity.getLastActivityMs());
   }
+#endif
 }
 
@@ -15,6 +15,9 @@
 #define ENABLE_WATCHDOG
 //#define ENABLE_DEBUG_PRINT
 
+// Strobe the lamps when a mic on MIC_PIN hears something loud.
+//#define ENABLE_MIC
+
 
 /************
  * Includes *
@@ -34,6 +37,14 @@
 #else
 #include "printf.h"
 #endif
+#include "DmxUniverse.h"
+#include "LampCrossfade.h"
+#include "MotionInterpolator.h"
+#include "TofRangeFilter.h"
+#include "TofZoneScanner.h"
+#ifdef ENABLE_MIC
+#include "AudioSampler.h"
+#endif
 
 
 /*********************************************
@@ -46,12 +57,59 @@
 #define LAMP_TEST_ACTIVE LOW
 #define LAMP_TEST_INTENSITY 255
 
-#define SENSOR_POLL_INTERVAL_MS 100L
 #define DMX_TX_INTERVAL_MS 33L
 
+// The mic's peak-to-peak level is measured over windows of
+// 2^AUDIO_WINDOW_SHIFT samples (26.6 ms at 9615 samples per second).
+#define MIC_PIN A3
+#define AUDIO_WINDOW_SHIFT 8
+
+// The sensor's GPIO1 pin goes low when a new range is ready.  If we miss
+// that, we ask the sensor after TOF_STALL_MS ms without a range.  The
+// inter-measurement period leaves time after the timing budget to read
+// each range and move the region of interest to the next zone before the
+// next measurement starts.
+#define TOF_INTERRUPT_PIN 2
+#define TOF_TIMING_BUDGET_US 33000
+#define TOF_INTER_MEASUREMENT_MS 50
+#define TOF_STALL_MS 200L
+
+// The sensor alternates between the left and right halves of its field
+// of view.  (The 8x16 regions of interest centered on SPADs 167 and 231
+// are the halves ST uses for people counting.)  Swap the lateral
+// positions if the sensor is mounted upside down.  A zone that doesn't
+// see anything within maxColorRangeMm for tofZoneTimeoutMs is ignored.
+constexpr pixelPattern::TofZone tofZones[] = {
+  {167, 8, 16, -1000},
+  {231, 8, 16, 1000},
+};
+constexpr uint16_t tofZoneTimeoutMs = 500;
+
+// Ranges from minColorRangeMm to maxColorRangeMm sweep the color angle
+// from one extreme to the other.
+constexpr uint16_t minColorRangeMm = 200;
+constexpr uint16_t maxColorRangeMm = 3000;
+
+// Each zone's ranges with a weak signal, or with not much more signal
+// than ambient light, are thrown out.  A jump of more than maxJumpMm has
+// to be seen numJumpConfirmations times in a row before it is believed.
+constexpr pixelPattern::TofRangeFilterConfig tofRangeFilterConfig = {
+  250,    // minSignalKcps
+  100,    // minSignalToAmbientPct
+  400,    // maxJumpMm
+  3       // numJumpConfirmations
+};
+
 // Restrict color and lamp selection angles to avoid gimbal lock.
-constexpr float maxColorAngleDegrees = 180;
-constexpr float maxLampAngleDegrees = 180;
+constexpr int16_t maxColorAngleTenths = 1800;
+constexpr int16_t maxLampAngleTenths = 1800;
+
+// Widget angles are extrapolated between packets and slewed at no more
+// than maxAngleSlewTenthsPerSec.  If a widget stops sending, its angles
+// drift back to center after angleTimeoutMs.
+constexpr uint16_t maxAngleSlewTenthsPerSec = 1800;
+constexpr uint16_t maxAnglePredictionMs = 150;
+constexpr uint16_t angleTimeoutMs = 5000;
 
 constexpr int16_t minPpSoundForStrobe = 300;
 constexpr int16_t maxPpSoundForStrobe = 500;
@@ -97,6 +155,14 @@ constexpr uint8_t maxStrobeValue = 250;
 #endif
 #define DMX_NUM_CHANNELS (NUM_LAMPS * DMX_NUM_CHANNELS_PER_LAMP)
 
+#if defined(LAMP_HAS_CONTROL_CHANNEL)
+#define DMX_LAMP_FIXTURE_TYPE DmxUniverse::FixtureType::dimmerRgb
+#elif defined(SKIP_DIMMER_FOURTH_CHANNEL)
+#define DMX_LAMP_FIXTURE_TYPE DmxUniverse::FixtureType::rgbSkipFourth
+#else
+#define DMX_LAMP_FIXTURE_TYPE DmxUniverse::FixtureType::rgb
+#endif
+
 // Let the scale8 function stolen from the FastLED library use assembly code if we're on an AVR chip.
 #if defined(__AVR__)
 #define SCALE8_AVRASM 1
@@ -112,18 +178,49 @@ typedef uint8_t fract8;   ///< ANSI: unsigned short _Fract
  ***********/
 
 VL53L1X sensor;
+static volatile bool gotTofInterrupt;
+static uint32_t lastTofRangeMs;
 
-static float currentColorAngle;
-static float currentLampAngle;
+using pixelPattern::TofZoneScanner;
+static TofZoneScanner tofZoneScanner(sensor, tofZones, sizeof(tofZones) / sizeof(tofZones[0]),
+                                     tofRangeFilterConfig, maxColorRangeMm, tofZoneTimeoutMs);
+
+using pixelPattern::MotionInterpolator;
+static MotionInterpolator colorAngle(0, maxAngleSlewTenthsPerSec, maxAnglePredictionMs, angleTimeoutMs);   // tenths of a degree
+static MotionInterpolator lampAngle(0, maxAngleSlewTenthsPerSec, maxAnglePredictionMs, angleTimeoutMs);    // tenths of a degree
 static int16_t currentPpSound;
 
+#ifdef ENABLE_MIC
+using pixelPattern::AudioSampler;
+static AudioSampler audioSampler(AUDIO_WINDOW_SHIFT, 0);
+#endif
+
 static int colorChannelIntensities[NUM_LAMPS][NUM_COLORS_PER_LAMP];
 
+using pixelPattern::DmxUniverse;
+static DmxUniverse dmxUniverse(DMX_NUM_CHANNELS);
+
+typedef pixelPattern::LampCrossfade<NUM_COLORS_PER_LAMP, 0, 255, maxColorAngleTenths * 2 / 10> ColorFade;
+typedef pixelPattern::LampCrossfade<NUM_LAMPS, LAMP_MIN_INTENSITY, 255, maxLampAngleTenths * 2 / 10> LampFade;
+
 
 /******************
  * Implementation *
  ******************/
 
+// top half of the ToF sensor ISR (bottom half is pollTofSensor)
+void handleTofInterrupt() {
+  gotTofInterrupt = true;
+}
+
+
+#ifdef ENABLE_MIC
+ISR(ADC_vect) {
+  audioSampler.addSample(ADC);
+}
+#endif
+
+
 void initTofSensor()
 {
   sensor.setTimeout(500);
@@ -134,26 +231,34 @@ void initTofSensor()
 #endif
   }
 
-  // Use long distance mode and allow up to 50000 us (50 ms) for a measurement.
+  // Use long distance mode and allow up to 33000 us (33 ms) for a measurement.
   // You can change these settings to adjust the performance of the sensor, but
   // the minimum timing budget is 20 ms for short distance mode and 33 ms for
   // medium and long distance modes. See the VL53L1X datasheet for more
   // information on range and timing limits.
   sensor.setDistanceMode(VL53L1X::Long);
-  sensor.setMeasurementTimingBudget(50000);
+  sensor.setMeasurementTimingBudget(TOF_TIMING_BUDGET_US);
+  tofZoneScanner.begin();
 
   // Start continuous readings at a rate of one measurement every 50 ms (the
   // inter-measurement period). This period should be at least as long as the
-  // timing budget.
-  sensor.startContinuous(50);
+  // timing budget.  Each one is read when the sensor interrupts, so the
+  // lamps don't wait for it.
+  pinMode(TOF_INTERRUPT_PIN, INPUT);
+  attachInterrupt(digitalPinToInterrupt(TOF_INTERRUPT_PIN), handleTofInterrupt, FALLING);
+  sensor.startContinuous(TOF_INTER_MEASUREMENT_MS);
+  lastTofRangeMs = millis();
 }
 
 
 void initDmx()
 {
+  for (uint8_t lampIdx = 0; lampIdx < NUM_LAMPS; ++lampIdx) {
+    dmxUniverse.addFixture(DMX_LAMP_FIXTURE_TYPE);
+  }
+
 #ifndef ENABLE_DEBUG_PRINT
-  DmxSimple.usePin(DMX_OUTPUT_PIN);
-  DmxSimple.maxChannel(DMX_NUM_CHANNELS);
+  dmxUniverse.init(DMX_OUTPUT_PIN);
 #endif
 }
 
@@ -172,6 +277,10 @@ void setup()
   initDmx();
   initTofSensor();
 
+#ifdef ENABLE_MIC
+  audioSampler.begin(MIC_PIN);
+#endif
+
 #ifdef LAMP_TEST_PIN
 #if LAMP_TEST_ACTIVE == LOW
   pinMode(LAMP_TEST_PIN, INPUT_PULLUP);
@@ -294,33 +403,33 @@ bool handleMeasurementVectorPayload(MeasurementVectorPayload* payload, uint8_t p
 
     case 1:
       // Tilt-1's pitch is the lamp selection angle.
-      currentLampAngle = payload->measurements[1] / 10.0;
+      lampAngle.addSample(payload->measurements[1], millis());
 #ifdef ENABLE_DEBUG_PRINT
       Serial.print(F("got pitch "));
-      Serial.print(currentLampAngle);
+      Serial.print(lampAngle.getLastSample());
       Serial.println(F(" for lamp angle from widget 1"));
 #endif
       break;
 
     case 2:
       // Tilt-2's pitch is the color selection angle.
-      currentColorAngle = payload->measurements[1] / 10.0;
+      colorAngle.addSample(payload->measurements[1], millis());
 #ifdef ENABLE_DEBUG_PRINT
       Serial.print(F("got pitch "));
-      Serial.print(currentColorAngle);
+      Serial.print(colorAngle.getLastSample());
       Serial.println(F(" for color angle from widget 2"));
 #endif
       break;
 
     case 3:
       // Tilt-Test's pitch is the lamp selection angle, and its roll is the color selection angle.
-      currentLampAngle = payload->measurements[1] / 10.0;
-      currentColorAngle = payload->measurements[2] / 10.0;
+      lampAngle.addSample(payload->measurements[1], millis());
+      colorAngle.addSample(payload->measurements[2], millis());
 #ifdef ENABLE_DEBUG_PRINT
       Serial.print(F("got pitch "));
-      Serial.print(currentLampAngle);
+      Serial.print(lampAngle.getLastSample());
       Serial.print(F(" for lamp angle and roll "));
-      Serial.print(currentColorAngle);
+      Serial.print(colorAngle.getLastSample());
       Serial.println(F(" for color angle from widget 2"));
 #endif
       break;
@@ -328,14 +437,14 @@ bool handleMeasurementVectorPayload(MeasurementVectorPayload* payload, uint8_t p
     case 4:
     // TODO:  fix the damn comment below
       // Rainstick's pitch is the color selection angle, and its pitch is the color selection angle.
-      currentColorAngle = payload->measurements[1] / 10.0;
-      currentLampAngle = payload->measurements[2] / 10.0;
+      colorAngle.addSample(payload->measurements[1], millis());
+      lampAngle.addSample(payload->measurements[2], millis());
       currentPpSound = payload->measurements[13];
 #ifdef ENABLE_DEBUG_PRINT
       Serial.print(F("got pitch "));
-      Serial.print(currentColorAngle);
+      Serial.print(colorAngle.getLastSample());
       Serial.print(F(" for color angle, roll "));
-      Serial.print(currentLampAngle);
+      Serial.print(lampAngle.getLastSample());
       Serial.print(F(" for lamp angle, and p-p sound "));
       Serial.println(currentPpSound);
 #endif
@@ -347,16 +456,77 @@ bool handleMeasurementVectorPayload(MeasurementVectorPayload* payload, uint8_t p
 #endif
 
 
-void pollTofSensor()
+// color angle tenths of a degree per mm of range, times 65536
+constexpr int32_t colorTenthsPerMmQ16 = ((int32_t) maxColorAngleTenths * 2 << 16) / (maxColorRangeMm - minColorRangeMm);
+
+
+// Maps a range to a color angle with a multiply and a shift rather than
+// map()'s division.
+int16_t colorAngleFromRange(uint16_t rangeMm)
 {
-  sensor.read();
-  
-  bool gotMeasurements = false;
-  if (sensor.ranging_data.range_status == VL53L1X::RangeValid) {
-    gotMeasurements = true;
+
+  if (rangeMm <= minColorRangeMm) {
+    return -maxColorAngleTenths;
+  }
+  if (rangeMm >= maxColorRangeMm) {
+    return maxColorAngleTenths;
+  }
+  return -maxColorAngleTenths + (int16_t) ((int32_t) (rangeMm - minColorRangeMm) * colorTenthsPerMmQ16 >> 16);
+}
+
+
+// Maps an approach speed to a color angle rate with the same slope as
+// colorAngleFromRange.
+int16_t colorAngleRateFromApproach(int16_t mmPerSec)
+{
+  int32_t tenthsPerSec = (int32_t) mmPerSec * colorTenthsPerMmQ16 >> 16;
+  return constrain(tenthsPerSec, -INT16_MAX, INT16_MAX);
+}
+
+
+// Maps the target's position across the sensor's field of view to a lamp
+// angle.
+int16_t lampAngleFromLateralPosition(int16_t lateralPosition)
+{
+  return (int32_t) lateralPosition * maxLampAngleTenths / 1000;
+}
+
+
+uint16_t kcpsFromMcps(float mcps)
+{
+  return mcps < 65.535 ? mcps * 1000 : UINT16_MAX;
+}
+
+
+void pollTofSensor(uint32_t now)
+{
+  // If an interrupt is missed, GPIO1 stays low until the range is read,
+  // so there won't be another one.  Asking the sensor once in a while
+  // gets things going again.
+  if (!gotTofInterrupt && !(now - lastTofRangeMs >= TOF_STALL_MS && sensor.dataReady())) {
+    return;
+  }
+  gotTofInterrupt = false;
+  lastTofRangeMs = now;
+
+  // The range is ready, so this doesn't wait.
+  sensor.read(false);
+
+#ifdef ENABLE_DEBUG_PRINT
+  uint8_t zone = tofZoneScanner.getCurrentZone();
+#endif
+  bool gotMeasurements = tofZoneScanner.addRange(
+    sensor.ranging_data.range_mm,
+    sensor.ranging_data.range_status,
+    kcpsFromMcps(sensor.ranging_data.peak_signal_count_rate_MCPS),
+    kcpsFromMcps(sensor.ranging_data.ambient_count_rate_MCPS),
+    now);
 
 #ifdef ENABLE_DEBUG_PRINT
-    Serial.print("range: ");
+  if (gotMeasurements) {
+    Serial.print("zone: ");
+    Serial.print(zone);
+    Serial.print("\trange: ");
     Serial.print(sensor.ranging_data.range_mm);
     Serial.print("\tstatus: ");
     Serial.print(VL53L1X::rangeStatusToString(sensor.ranging_data.range_status));
@@ -365,20 +535,27 @@ void pollTofSensor()
     Serial.print("\tambient: ");
     Serial.print(sensor.ranging_data.ambient_count_rate_MCPS);
     Serial.println();
+  }
 #endif
 
-    //currentLampAngle = map(sensor.ranging_data.range_mm, 0, 2500, -179.9, 179.9);
-    currentColorAngle = map(constrain((float) sensor.ranging_data.range_mm, 200.0, 3000.0), 200.0, 3000.0, (float) -179.9, (float) 179.9);
+  // The nearest zone's range sets the color, and how fast the target is
+  // approaching keeps the color moving between scans.  Where the target
+  // is across the field of view sets the lamp.
+  if (gotMeasurements && tofZoneScanner.getHasTarget()) {
+    colorAngle.addSample(colorAngleFromRange(tofZoneScanner.getNearestRangeMm()),
+                         colorAngleRateFromApproach(tofZoneScanner.getApproachMmPerSec()), now);
+    lampAngle.addSample(lampAngleFromLateralPosition(tofZoneScanner.getLateralPosition()), now);
   }
 
 #ifdef ENABLE_DEBUG_PRINT
   if (gotMeasurements) {
-    Serial.print(F(" currentColorAngle="));
-    Serial.print(currentColorAngle);
-    Serial.print(F(" currentLampAngle="));
-    Serial.print(currentLampAngle);
+    Serial.print(F(" colorAngle="));
+    Serial.print(colorAngle.getLastSample());
+    Serial.print(F(" lampAngle="));
+    Serial.print(lampAngle.getLastSample());
     Serial.print(F(" currentPpSound="));
     Serial.println(currentPpSound);
+    tofZoneScanner.printStats(Serial);
   }
 #endif
 }
@@ -386,9 +563,8 @@ void pollTofSensor()
 
 void sendDmx()
 {
-  uint8_t dmxChannelValues[DMX_NUM_CHANNELS + 1];
+  // Only the channels that changed since the last time get transmitted.
 
-  uint16_t dmxChannelNum = 1;
   for (uint8_t lampIdx = 0; lampIdx < NUM_LAMPS; ++lampIdx) {
 
 #if defined(LAMP_HAS_CONTROL_CHANNEL)
@@ -396,7 +572,7 @@ void sendDmx()
     if (currentPpSound >= minPpSoundForStrobe) {
       uint8_t strobeValue = map(constrain(currentPpSound, minPpSoundForStrobe, minPpSoundForStrobe),
                                 minPpSoundForStrobe, maxPpSoundForStrobe, minStrobeValue, maxStrobeValue);
-      dmxChannelValues[dmxChannelNum++] = strobeValue;
+      dmxUniverse.setFixtureDimmer(lampIdx, strobeValue);
 #ifdef ENABLE_DEBUG_PRINT
       Serial.print(F("strobeValue="));
       Serial.print(strobeValue);
@@ -415,39 +591,21 @@ void sendDmx()
     else {
       // Set the lamp to full brightness because we control its
       // overall brightness by way of the individual colors.
-      dmxChannelValues[dmxChannelNum++] = 127;
+      dmxUniverse.setFixtureDimmer(lampIdx, 127);
     }
 #endif
 
 #if (NUM_COLORS_PER_LAMP == 4)
-    dmxChannelValues[dmxChannelNum++] = colorChannelIntensities[lampIdx][0] + colorChannelIntensities[lampIdx][3];
+    uint8_t red = colorChannelIntensities[lampIdx][0] + colorChannelIntensities[lampIdx][3];
 #else
-    dmxChannelValues[dmxChannelNum++] = colorChannelIntensities[lampIdx][0];
-#endif
-    dmxChannelValues[dmxChannelNum++] = colorChannelIntensities[lampIdx][1];
-    dmxChannelValues[dmxChannelNum++] = colorChannelIntensities[lampIdx][2];      
-
-#ifdef SKIP_DIMMER_FOURTH_CHANNEL
-    dmxChannelValues[dmxChannelNum++] = 0;
+    uint8_t red = colorChannelIntensities[lampIdx][0];
 #endif
-  }
-
-  // Send zeros to any unused channels.
-  while (dmxChannelNum <= DMX_NUM_CHANNELS) {
-    dmxChannelValues[dmxChannelNum++] = 0;
+    dmxUniverse.setFixtureRgb(lampIdx, red, colorChannelIntensities[lampIdx][1], colorChannelIntensities[lampIdx][2]);
   }
 
   // Transmit the DMX channel values.
 #ifndef ENABLE_DEBUG_PRINT
-  for (dmxChannelNum = 1; dmxChannelNum <= DMX_NUM_CHANNELS; ++dmxChannelNum) {
-    DmxSimple.write(dmxChannelNum, dmxChannelValues[dmxChannelNum]);
-//#ifdef ENABLE_DEBUG_PRINT
-//    Serial.print(F("sent DMX ch "));
-//    Serial.print(dmxChannelNum);
-//    Serial.print(F(": "));
-//    Serial.println(dmxChannelValues[dmxChannelNum]);    
-//#endif
-  }
+  dmxUniverse.commit();
 #endif
 }
 
@@ -468,62 +626,20 @@ void updateLamps()
   }
 #endif
 
-  constexpr float colorAngleStep = maxColorAngleDegrees * 2 / (NUM_COLORS_PER_LAMP - 1);
-  constexpr float lampAngleStep = maxLampAngleDegrees * 2 / (NUM_LAMPS - 1);
-
-  int colorIntensities[NUM_COLORS_PER_LAMP];
-  for (uint8_t i = 0; i < NUM_COLORS_PER_LAMP; ++i) {
-    colorIntensities[i] = 0;
-  }
-
-  int lampIntensities[NUM_LAMPS];
-  for (uint8_t i = 0; i < NUM_LAMPS; ++i) {
-    lampIntensities[i] = LAMP_MIN_INTENSITY;
-  }
-
-  // Normalize and restrict color and lamp selection angles to [0, max___Degrees*2] degrees.
-  float normalizedColorAngle;
-  if (currentColorAngle <= - maxColorAngleDegrees) {
-    normalizedColorAngle = 0;
-  }
-  else if (currentColorAngle >= maxColorAngleDegrees) {
-    normalizedColorAngle = maxColorAngleDegrees * 2.0;
-  }
-  else {
-    normalizedColorAngle = currentColorAngle + maxColorAngleDegrees;
-  }
-  float normalizedLampAngle;
-  if (currentLampAngle <= - maxLampAngleDegrees) {
-    normalizedLampAngle = 0;
-  }
-  else if (currentLampAngle >= maxLampAngleDegrees) {
-    normalizedLampAngle = maxLampAngleDegrees * 2.0;
-  }
-  else {
-    normalizedLampAngle = currentLampAngle + maxLampAngleDegrees;
-  }
+  // Fade across the colors based on color selection angle and across the
+  // lamps based on lamp selection angle.  The angles are advanced to now
+  // here, at the DMX rate, rather than when packets arrive.  Angles beyond
+  // the maximums are treated as the maximums.
+  uint32_t now = millis();
+  uint8_t colorIntensities[NUM_COLORS_PER_LAMP];
+  ColorFade::fill(
+    ColorFade::positionFromRange(colorAngle.update(now), -maxColorAngleTenths, maxColorAngleTenths),
+    colorIntensities);
 
-  // Fade across the colors based on color selection angle.
-  int colorSection = floor(normalizedColorAngle / colorAngleStep);
-  // Fix up colorSection if measurement is maxColorAngleDegrees degrees or more.
-  if (colorSection >= NUM_COLORS_PER_LAMP - 1) {
-      colorSection = NUM_COLORS_PER_LAMP - 2;
-  }
-  colorIntensities[colorSection] =
-    map(normalizedColorAngle, colorAngleStep * colorSection, colorAngleStep * (colorSection + 1), 255, 0);
-  colorIntensities[colorSection + 1] =
-    map(normalizedColorAngle, colorAngleStep * colorSection, colorAngleStep * (colorSection + 1), 0, 255);
-
-  // Fade across the lamps based on lamp selection angle.
-  int lampSection = floor(normalizedLampAngle / lampAngleStep);
-  // Fix up lampSection if measurement is maxLampAngleDegrees degrees or more.
-  if (lampSection >= NUM_LAMPS - 1) {
-      lampSection = NUM_LAMPS - 2;
-  }
-  lampIntensities[lampSection] =
-    map(normalizedLampAngle, lampAngleStep * lampSection, lampAngleStep * (lampSection + 1), 255, LAMP_MIN_INTENSITY);
-  lampIntensities[lampSection + 1] =
-    map(normalizedLampAngle, lampAngleStep * lampSection, lampAngleStep * (lampSection + 1), LAMP_MIN_INTENSITY, 255);
+  uint8_t lampIntensities[NUM_LAMPS];
+  LampFade::fill(
+    LampFade::positionFromRange(lampAngle.update(now), -maxLampAngleTenths, maxLampAngleTenths),
+    lampIntensities);
 
   // For each lamp, scale the intensity of its colors by the corresponding color intensity.
   for (uint8_t lampIdx = 0; lampIdx < NUM_LAMPS; ++lampIdx) {
@@ -538,14 +654,19 @@ void updateLamps()
 
 void loop()
 {
-  static int32_t lastSensorPollMs;
   static int32_t lastDmxTxMs;
 
   uint32_t now = millis();
 
-  if (now - lastSensorPollMs >= SENSOR_POLL_INTERVAL_MS) {
-    pollTofSensor();
+  pollTofSensor(now);
+
+#ifdef ENABLE_MIC
+  // The envelope holds a loud sound's level for a few windows, so a short
+  // bang still makes it into a DMX frame.
+  if (audioSampler.update()) {
+    currentPpSound = audioSampler.getEnvelope();
   }
+#endif
 
   if (now - lastDmxTxMs >= DMX_TX_INTERVAL_MS) {
     lastDmxTxMs = now;